@@ -0,0 +1,124 @@
+/**
+ * @file BinaryFrame.h
+ * @brief Length-prefixed, CRC32-protected frames for binary transfers
+ *
+ * Used by OTA and CAN UPLOAD once a session has been started with the BIN
+ * option (see docs/protocols/OTA_PROTOCOL.md). Host → device:
+ *
+ * ┌──────┬──────┬──────┬─────────┬─────────┬──────────────┬───────────┐
+ * │ 0xA5 │ 0x5A │ Type │ Seq LE  │ Len LE  │ Payload[Len] │ CRC32 LE  │
+ * │      │      │ (1B) │  (2B)   │  (2B)   │              │   (4B)    │
+ * └──────┴──────┴──────┴─────────┴─────────┴──────────────┴───────────┘
+ *
+ * CRC32 = crc32_le(0, Type..Payload). The device answers with text lines
+ * (ACK / NAK), so clients keep their line reader.
+ *
+ * The decoder is a byte-driven state machine: bytes can arrive in any
+ * split. After a bad header or CRC the magic search restarts at the byte
+ * following the rejected A5 5A: the bytes already taken for that frame are
+ * scanned again (from the decoder's own buffers), so a corrupted length does
+ * not swallow the frames behind it.
+ */
+
+#ifndef BINARY_FRAME_H
+#define BINARY_FRAME_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// =============================================================================
+// CONFIGURATION (override with -D build flags)
+// =============================================================================
+
+#ifndef BIN_MAX_PAYLOAD
+#define BIN_MAX_PAYLOAD 4096    // Largest DATA payload (bytes)
+#endif
+#ifndef BIN_WINDOW
+#define BIN_WINDOW      4       // Frames the host may send ahead of the last ACK
+#endif
+
+#define BIN_MAGIC0      0xA5
+#define BIN_MAGIC1      0x5A
+#define BIN_OVERHEAD    11      // Magic + type + seq + len + CRC32
+
+// =============================================================================
+// TYPES
+// =============================================================================
+
+enum BinFrameType : uint8_t {
+    BIN_DATA  = 0x01,   // Next chunk of the file/image
+    BIN_END   = 0x02,   // All data sent: finalize (no payload)
+    BIN_ABORT = 0x03,   // Cancel the session (no payload)
+
+    // Device → host only (never accepted by the decoder)
+    BIN_CAN_LOG = 0x10  // LOG BIN packet of CAN frames (see CanStream.h)
+};
+
+enum class BinFrameResult : uint8_t {
+    NONE,           // All input consumed, no complete frame
+    FRAME,          // frame() holds a valid frame
+    BAD_CRC,        // Frame dropped (CRC mismatch)
+    BAD_HEADER      // Unknown type or length too large, resynchronizing
+};
+
+struct BinFrame {
+    uint8_t        type;
+    uint16_t       seq;
+    uint16_t       len;
+    const uint8_t* payload;     // Decoder buffer, valid until the next feed()
+};
+
+// =============================================================================
+// DECODER
+// =============================================================================
+
+class BinaryFrameDecoder {
+public:
+    BinaryFrameDecoder();
+
+    void reset();
+
+    /**
+     * @brief Consume input until one event or the end of the data
+     * @param data     Received bytes
+     * @param len      Number of bytes
+     * @param consumed Set to the bytes used; feed the rest on the next call
+     * @return FRAME / BAD_CRC / BAD_HEADER, or NONE when everything was used
+     */
+    BinFrameResult feed(const uint8_t* data, size_t len, size_t& consumed);
+
+    /**
+     * @brief true while bytes of a rejected frame are still to be scanned
+     *
+     * Call feed() again (even with no new data) until it returns NONE.
+     */
+    bool hasPending() const { return _replayPos < _replayLen; }
+
+    /** @brief Last frame returned with FRAME */
+    const BinFrame& frame() const { return _frame; }
+
+private:
+    enum State : uint8_t { MAGIC0, MAGIC1, HEADER, PAYLOAD, CRC };
+
+    State    _state;
+    uint8_t  _header[5];        // Type, seq, len
+    uint16_t _pos;              // Bytes collected in the current state
+    uint32_t _crc;              // Running CRC over header + payload
+    uint32_t _rxCrc;
+    BinFrame _frame;
+    uint8_t  _payload[BIN_MAX_PAYLOAD];
+
+    // Rescan of a rejected frame: header, payload, then its CRC bytes. A
+    // frame found meanwhile is written behind the read position, in place
+    uint16_t _replayPos;
+    uint16_t _replayLen;
+    uint16_t _replayPayload;    // Payload bytes in the rescan
+    uint32_t _replayCrc;        // Received CRC of the rejected frame
+
+    BinFrameResult step(uint8_t b);
+    BinFrameResult headerDone();
+    void startReplay(BinFrameResult result);
+    uint8_t replayByte(uint16_t pos) const;
+};
+
+#endif // BINARY_FRAME_H
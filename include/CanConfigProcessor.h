@@ -31,6 +31,144 @@
 #include <ESP32-TWAI-CAN.hpp>
 #include <ArduinoJson.h>
 #include "VehicleConfig.h"
+#include "SignalFilter.h"
+
+// =============================================================================
+// DISPATCH TABLE
+// =============================================================================
+
+#define CAN_DISPATCH_SIZE   2048    // One slot per 11-bit standard CAN ID (0x000-0x7FF)
+#define CAN_DISPATCH_MAX_FRAMES 254 // Slot stores frame index + 1 in a uint8_t
+
+static_assert(PROFILE_MAX_FRAMES <= CAN_DISPATCH_MAX_FRAMES,
+              "dispatch slots cannot index more than 254 frames");
+
+// Compiled entries: one per field, plus one header per shared-word group
+// (a group has at least two members), plus the header and member slots a
+// group being tried may use before it is rejected
+#define PROFILE_MAX_COMPILED (PROFILE_MAX_FIELDS + PROFILE_MAX_FIELDS / 2 + 2)
+
+// =============================================================================
+// COMPILED PROFILE CACHE
+// =============================================================================
+
+#ifndef PROFILE_CACHE_ENABLED
+#define PROFILE_CACHE_ENABLED 1     // 0 = always parse the JSON at boot
+#endif
+#define PROFILE_CACHE_EXT   ".pcache" // Replaces ".json" in the cache file name
+#define PROFILE_CACHE_PARAMS_SIZE 384 // Serialized vehicleParams, including the terminator
+
+// =============================================================================
+// HARDWARE ACCEPTANCE FILTER
+// =============================================================================
+
+/**
+ * @brief TWAI acceptance filter derived from the loaded profile
+ *
+ * Register layout follows the SJA1000 convention used by the ESP32 TWAI driver
+ * for standard (11-bit) frames:
+ * - Single filter: ID in bits [31:21], bits [20:0] (RTR + data) don't care
+ * - Dual filter:   filter 1 ID in bits [31:21], filter 2 ID in bits [15:5]
+ * Mask bits set to 1 are "don't care".
+ */
+struct CanAcceptanceFilter {
+    uint32_t code;          // Acceptance code
+    uint32_t mask;          // Acceptance mask (1 = don't care)
+    bool     singleFilter;  // true = one 32-bit filter, false = two 16-bit filters
+    uint16_t acceptedIds;   // Number of 11-bit IDs that pass the filter
+};
+
+// =============================================================================
+// COMPILED FIELD DECODERS
+// =============================================================================
+
+struct CompiledField;
+
+/**
+ * @brief Specialized decoder: extract + formula + store for one field shape
+ * @return Number of CompiledField entries consumed (1, or 1 + members for a
+ *         shared-word group)
+ */
+typedef uint8_t (*FieldKernel)(const uint8_t* data, const CompiledField& field);
+
+/**
+ * @brief Member of a shared-word group: mask + store from the cached word
+ */
+typedef void (*WordOpKernel)(int32_t word, const CompiledField& op);
+
+/**
+ * @brief FieldConfig resolved at load time into a ready-to-run decoder
+ *
+ * The kernel is a template instance for the field's (byteCount, byteOrder,
+ * dataType, formula, target type) combination, so the hot path does no
+ * format branching. Uncommon shapes use a generic kernel running the
+ * reference interpreter.
+ *
+ * Fields of one frame that read the same word (startByte, byteCount,
+ * byteOrder) with NONE/BITMASK_EXTRACT are compiled as a group: a header
+ * entry extracts the word once and is followed by its member entries, other
+ * members first, then DOOR_* members folded into a single currentDoors
+ * write. Header: bit = combined door mask, params[2] = other member count,
+ * params[3] = door member count. Members: params[0] = mask, params[1] = shift.
+ *
+ * Fields with a filter are never grouped: they use the filtered kernel and
+ * target points at their SignalFilter (state kept in the bank).
+ */
+struct CompiledField {
+    union {
+        FieldKernel  kernel;    // Decoder for this field's shape
+        WordOpKernel wordOp;    // Shared-word group member
+    };
+    void*       target;     // Pre-bound GlobalData variable
+    uint8_t     bit;        // currentDoors bit for DOOR_* targets
+    uint16_t    dirty;      // DIRTY_* bit marked when the value changes
+    FieldConfig config;     // Source config (SCALE params pre-sanitised)
+};
+
+/**
+ * @brief Everything processFrame() reads for one profile
+ *
+ * The processor keeps two banks: a new profile is parsed and compiled into
+ * the spare bank while the active one keeps decoding, then the active bank
+ * index is flipped between two frames.
+ */
+struct ProfileBank {
+    VehicleProfile profile;                 // Parsed frames and fields
+
+    // CAN ID → frame lookup
+    uint8_t  dispatch[CAN_DISPATCH_SIZE];   // Frame index + 1, 0 = not configured
+    uint16_t dispatchIdCount;               // Number of IDs present in the table
+    uint32_t dispatchBuildUs;               // Build duration (µs)
+
+    // Compiled decoders, grouped by frame: frame i uses
+    // compiled[compiledStart[i] .. compiledStart[i + 1])
+    CompiledField compiled[PROFILE_MAX_COMPILED];
+    uint16_t compiledStart[PROFILE_MAX_FRAMES + 1];
+    uint16_t compiledCount;                 // Entries used in compiled
+    uint16_t compiledFields;                // Profile fields compiled
+    uint16_t specializedFields;             // Fields not using the generic kernel
+    uint16_t sharedWordGroups;              // Shared-word groups emitted
+
+    // Filter state of the filtered fields, index = FieldConfig::filter - 1.
+    // Written by processFrame(): a new profile starts with fresh filters.
+    mutable SignalFilter filters[PROFILE_MAX_FILTERS];
+
+    // Profile is the one compiled into the firmware: processFrame() runs the
+    // generated bakedDecode() instead of the compiled kernels
+    bool baked;
+
+    void clear();
+};
+
+/**
+ * @brief Cost of the last profile swap (CAN LOAD / CAN RELOAD / boot)
+ */
+struct ProfileSwapStats {
+    uint32_t buildUs;           // Parse + compile into the spare bank
+    uint32_t flipUs;            // Bank flip and mode update
+    uint32_t framesDuringBuild; // Frames decoded by the old profile meanwhile
+    uint32_t swaps;             // Profiles activated since boot
+};
 
 /**
  * @brief Configurable CAN frame processor
@@ -51,17 +189,81 @@ public:
      *
      * If no config found, activates mock mode with default simulated data.
      *
+     * PROFILE_BAKED builds load the baked profile instead (see loadBaked())
+     * unless NVS names another saved file that exists, or nothing is saved
+     * and /vehicle.json exists.
+     *
      * @return true if config loaded successfully, false if using mock mode
      */
     bool begin();
 
     /**
      * @brief Load vehicle configuration from JSON file
+     *
+     * On success, also writes the binary cache image next to the file
+     * (see loadFromCache()). On failure (parse error, too large, a real
+     * profile without frames) the current profile stays active.
+     *
      * @param path Path to JSON file on SPIFFS (e.g., "/vehicle.json")
      * @return true if loaded and parsed successfully
      */
     bool loadFromJson(const char* path);
 
+    /**
+     * @brief Load the profile from the binary cache of a JSON file
+     *
+     * The image (name, mode, dispatch table, flattened fields) is only used
+     * if its format version and build stamp match this firmware and the
+     * CRC32 of the JSON file matches the one it was built from. The
+     * decoders are then recompiled from the cached fields. vehicleParams
+     * are cached as their JSON text and only parsed on a vehicle switch,
+     * which therefore behaves as with loadFromJson().
+     *
+     * @param jsonPath JSON file the cache belongs to
+     * @return true if the cache was valid and loaded
+     */
+    bool loadFromCache(const char* jsonPath);
+
+    /**
+     * @brief Activate an installed profile the fastest way available
+     *
+     * The baked profile if path is the file it was baked from, otherwise
+     * the binary cache if still valid, otherwise the JSON. vehicleParams
+     * are applied on a vehicle switch in every case.
+     *
+     * @param path JSON file on LittleFS
+     * @return true if loaded
+     */
+    bool loadProfile(const char* path);
+
+    /**
+     * @brief Cache file name for a JSON file ("/a.json" → "/a.pcache")
+     */
+    static void cachePathFor(const char* jsonPath, char* out, size_t outLen);
+
+    /**
+     * @brief true if the last successful load came from the binary cache
+     */
+    bool isLoadedFromCache() const { return _loadedFromCache; }
+
+    /**
+     * @brief Load the profile baked into the firmware (PROFILE_BAKED builds)
+     *
+     * Fills the spare bank from the constexpr tables generated by
+     * tools/bake_profile.py, compiles it like a JSON profile (filters,
+     * statistics, reference path) and makes processFrame() use the generated
+     * switch decoder. vehicleParams are applied on a vehicle switch, as with
+     * loadFromJson(). begin() picks it unless LittleFS holds an override.
+     *
+     * @return false if the firmware was built without a baked profile
+     */
+    bool loadBaked();
+
+    /**
+     * @brief true if the active profile is the baked one
+     */
+    bool isBaked() const { return active().baked; }
+
     /**
      * @brief Process a received CAN frame
      *
@@ -73,6 +275,44 @@ public:
      */
     bool processFrame(const CanFrame& frame);
 
+    /**
+     * @brief Process a frame with the reference interpreter
+     *
+     * Same result as processFrame() but walks the FieldConfig list through
+     * extractRawValue() / applyFormula() / writeToGlobalData(). Kept for
+     * verification of the compiled decoders and for benchmarks. Field
+     * filters are not applied: values are stored unfiltered.
+     *
+     * @param frame Reference to received CAN frame from TWAI
+     * @return true if frame was handled (CAN ID found in config)
+     */
+    bool processFrameReference(const CanFrame& frame);
+
+    /**
+     * @brief Get number of fields using a specialized (non-generic) kernel
+     */
+    uint16_t getSpecializedFieldCount() const { return active().specializedFields; }
+
+    /**
+     * @brief Get total number of compiled fields
+     */
+    uint16_t getCompiledFieldCount() const { return active().compiledFields; }
+
+    /**
+     * @brief Get number of shared-word groups (one word extraction each)
+     */
+    uint16_t getSharedWordGroupCount() const { return active().sharedWordGroups; }
+
+    /**
+     * @brief Get number of fields with a filter
+     */
+    uint8_t getFilteredFieldCount() const { return active().profile.filterCount; }
+
+    /**
+     * @brief Get changes held back by the field filters since the profile loaded
+     */
+    uint32_t getFilterHeldCount() const;
+
     /**
      * @brief Check if running in mock mode
      *
@@ -84,11 +324,67 @@ public:
      */
     bool isMockMode() const { return _mockMode; }
 
+    /**
+     * @brief Check if frames come from a recorded log (profile "replay")
+     *
+     * The profile decodes as usual but the CAN controller stays stopped;
+     * main.cpp feeds the log through CanReplay instead. Ignored in mock mode.
+     */
+    bool isReplayMode() const { return !_mockMode && active().profile.replayFile[0] != '\0'; }
+
+    /**
+     * @brief Check if the profile needs the CAN controller running
+     */
+    bool usesCanBus() const { return !_mockMode && active().profile.replayFile[0] == '\0'; }
+
+    /**
+     * @brief Mode for log output: "MOCK", "REPLAY" or "REAL CAN"
+     */
+    const char* getModeName() const {
+        return _mockMode ? "MOCK" : (isReplayMode() ? "REPLAY" : "REAL CAN");
+    }
+
+    /**
+     * @brief Replay settings of the loaded profile (see VehicleProfile)
+     */
+    const char* getReplayFile() const { return active().profile.replayFile; }
+    uint16_t getReplaySpeed() const { return active().profile.replaySpeed; }
+    bool getReplayLoop() const { return active().profile.replayLoop; }
+
     /**
      * @brief Get loaded profile name
      * @return Vehicle name from config, or "Unknown" if not loaded
      */
-    const char* getProfileName() const { return _profile.name.c_str(); }
+    const char* getProfileName() const { return active().profile.name; }
+
+    /**
+     * @brief Get profile arena bytes holding the loaded frames and fields
+     */
+    size_t getProfileBytesUsed() const { return active().profile.bytesUsed(); }
+
+    /**
+     * @brief Get RAM footprint of the profile arenas and compiled decoders
+     * @return Size in bytes of both banks (fixed, independent of the profile)
+     */
+    size_t getProfileMemory() const { return sizeof(_banks); }
+
+    /**
+     * @brief Get number of frames / fields in the loaded profile
+     */
+    uint16_t getProfileFrameCount() const { return active().profile.frameCount; }
+    uint16_t getProfileFieldCount() const { return active().profile.fieldCount; }
+
+    /**
+     * @brief Get the frames and fields of the loaded profile (read-only)
+     *
+     * Valid until the next profile load: the spare bank is rebuilt then.
+     */
+    const VehicleProfile& getProfile() const { return active().profile; }
+
+    /**
+     * @brief Get the cost of the last profile swap
+     */
+    const ProfileSwapStats& getSwapStats() const { return _swapStats; }
 
     /**
      * @brief Get count of successfully processed frames
@@ -102,18 +398,144 @@ public:
      */
     uint32_t getUnknownFrames() const { return _unknownFrames; }
 
+    /**
+     * @brief Get number of CAN IDs indexed in the dispatch table
+     */
+    uint16_t getDispatchIdCount() const { return active().dispatchIdCount; }
+
+    /**
+     * @brief Get time spent building the dispatch table on last load
+     * @return Build time in microseconds
+     */
+    uint32_t getDispatchBuildTime() const { return active().dispatchBuildUs; }
+
+    /**
+     * @brief Get RAM footprint of the dispatch table
+     * @return Size in bytes
+     */
+    size_t getDispatchMemory() const { return sizeof(ProfileBank::dispatch); }
+
+    /**
+     * @brief Get duration of the last loadFromJson() / loadFromCache()
+     * @return Load time in milliseconds (file read, parse, compile)
+     */
+    uint32_t getLoadTime() const { return _loadTimeMs; }
+
+    /**
+     * @brief Get peak heap used by the last loadFromJson()
+     *
+     * Largest drop of free heap below its value at the start of the load,
+     * sampled after each JSON pass/frame (when the documents are alive).
+     *
+     * @return Bytes
+     */
+    uint32_t getLoadPeakHeap() const { return _loadPeakHeap; }
+
+    /**
+     * @brief Compute the tightest TWAI acceptance filter for the configured IDs
+     *
+     * Evaluates one single filter and a set of dual-filter partitions (sorted
+     * splits and per-bit splits) and keeps the one letting the fewest
+     * unconfigured IDs through. Returns an accept-all filter when the profile
+     * has no frames.
+     *
+     * @return Filter covering every ID in the dispatch table
+     */
+    CanAcceptanceFilter computeAcceptanceFilter() const;
+
+    /**
+     * @brief Check whether an 11-bit ID passes a filter
+     * @param filter Filter to evaluate
+     * @param canId Standard CAN identifier
+     * @return true if the TWAI controller would accept the ID
+     */
+    static bool filterAccepts(const CanAcceptanceFilter& filter, uint16_t canId);
+
 private:
-    VehicleProfile _profile;        // Loaded vehicle configuration
+    // Active and spare profile; processFrame() only reads _banks[_activeBank]
+    ProfileBank _banks[2];
+    volatile uint8_t _activeBank;
     bool _mockMode;                 // true = simulating data, false = real CAN
     uint32_t _framesProcessed;      // Statistics: processed frame count
     uint32_t _unknownFrames;        // Statistics: unknown CAN ID count
 
+    // Last load cost
+    uint32_t _loadTimeMs;
+    uint32_t _loadPeakHeap;                 // Bytes below the starting free heap
+    bool _loadedFromCache;
+    ProfileSwapStats _swapStats;
+    uint32_t _buildStartUs;                 // Set by beginBuild()
+    uint32_t _buildStartFrames;
+
+    const ProfileBank& active() const { return _banks[_activeBank]; }
+
+    /**
+     * @brief Clear the spare bank and start timing a swap
+     * @return Bank to fill, not read by processFrame()
+     */
+    ProfileBank& beginBuild();
+
+    /**
+     * @brief Make the spare bank active (between two frames)
+     *
+     * The flip is a single byte store. The ingest task reads the index once
+     * per frame and never blocks inside processFrame(), and the ESP32-C3 is
+     * single core, so no decode is still using the old bank once this
+     * returns: the next build may reuse it.
+     */
+    void commitBuild();
+
+    /**
+     * @brief Write the binary cache image of the current profile
+     * @param jsonPath JSON file the profile was parsed from
+     * @param vehicleParams "vehicleParams" object of the profile (may be null)
+     */
+    void saveCache(const char* jsonPath, JsonObjectConst vehicleParams);
+
+    /**
+     * @brief Rebuild a bank's CAN ID dispatch table from its profile frames
+     *
+     * Called once per successful parse so processFrame() never has to scan
+     * the frame list. Duplicate IDs keep the first definition (same result
+     * as the former linear search).
+     */
+    static void buildDispatchTable(ProfileBank& bank);
+
+    /**
+     * @brief Resolve every FieldConfig of a bank's profile into a CompiledField
+     *
+     * Called after each successful parse, alongside buildDispatchTable().
+     */
+    static void compileProfile(ProfileBank& bank);
+
+    /**
+     * @brief Fallback kernel for shapes without a specialization
+     */
+    static uint8_t genericKernel(const uint8_t* data, const CompiledField& field);
+
+    /**
+     * @brief Kernel for fields with a filter: decode, filter, store if published
+     */
+    static uint8_t filteredKernel(const uint8_t* data, const CompiledField& field);
+
+    /**
+     * @brief Decode one frame with the baked profile's generated switch
+     * @return false if the ID is not in the baked profile
+     */
+    static bool processBaked(const uint8_t* data, uint32_t canId, SignalFilter* filters);
+
+    /**
+     * @brief Append one frame's fields to bank.compiled, grouping shared words
+     */
+    static void compileFrame(ProfileBank& bank, const FieldConfig* fields, uint16_t count);
+
     /**
      * @brief Find frame configuration for a CAN ID
+     * @param bank Profile to search
      * @param canId CAN identifier to search for
      * @return Pointer to FrameConfig if found, nullptr otherwise
      */
-    const FrameConfig* findFrameConfig(uint16_t canId) const;
+    static const FrameConfig* findFrameConfig(const ProfileBank& bank, uint32_t canId);
 
     /**
      * @brief Extract raw value from CAN frame bytes
@@ -124,7 +546,7 @@ private:
      * @param field Field configuration defining extraction parameters
      * @return Extracted raw value (before formula conversion)
      */
-    int32_t extractRawValue(const uint8_t* data, const FieldConfig& field) const;
+    static int32_t extractRawValue(const uint8_t* data, const FieldConfig& field);
 
     /**
      * @brief Apply conversion formula to raw value
@@ -135,7 +557,7 @@ private:
      * @param field Field configuration with formula and parameters
      * @return Converted value in standard units
      */
-    int32_t applyFormula(int32_t rawValue, const FieldConfig& field) const;
+    static int32_t applyFormula(int32_t rawValue, const FieldConfig& field);
 
     /**
      * @brief Write converted value to GlobalData variable
@@ -146,7 +568,7 @@ private:
      * @param target Which GlobalData field to update
      * @param value Converted value to write
      */
-    void writeToGlobalData(OutputField target, int32_t value);
+    static void writeToGlobalData(OutputField target, int32_t value);
 
     /**
      * @brief Apply vehicleParams overrides from JSON to in-memory config.
@@ -156,6 +578,17 @@ private:
      * configSave() afterwards to persist.
      */
     void applyVehicleParams(JsonObjectConst params);
+
+    /**
+     * @brief Record the loaded vehicle in NVS, resetting calibration on a switch
+     *
+     * A different file name than the saved one is a vehicle switch:
+     * configReset(), then vehicleParams (may be null), then configSave().
+     *
+     * @param filename Profile file name without the leading '/'
+     * @param vehicleParams "vehicleParams" object of the profile
+     */
+    void selectVehicle(const char* filename, JsonObjectConst vehicleParams);
 };
 
 #endif // CAN_CONFIG_PROCESSOR_H
@@ -0,0 +1,220 @@
+/**
+ * @file CanDriver.h
+ * @brief TWAI (CAN) controller lifecycle management
+ *
+ * Owns installation, start and stop of the ESP32 TWAI controller. The
+ * hardware acceptance filter is derived from the loaded vehicle profile so
+ * that frames the profile does not decode are dropped by the controller
+ * instead of being queued and read by the CPU.
+ *
+ * The filter can be bypassed with CFG SET canPromisc 1 (capture sessions).
+ *
+ * Frames are read and decoded by a dedicated FreeRTOS task running above
+ * loop() priority, so slow serial commands (uploads, NVS writes) do not
+ * stall ingestion.
+ *
+ * Bus-off and error-limit faults are recovered in place (CanRecovery.h):
+ * only the controller restarts, decoded data and the head-unit stream stay.
+ */
+
+#ifndef CAN_DRIVER_H
+#define CAN_DRIVER_H
+
+#include <Arduino.h>
+#include <ESP32-TWAI-CAN.hpp>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "CanConfigProcessor.h"
+#include "CanRecovery.h"
+
+// =============================================================================
+// HARDWARE PIN CONFIGURATION
+// =============================================================================
+
+#define CAN_TX 21
+#define CAN_RX 20
+
+// =============================================================================
+// RX BATCH DRAIN CONFIGURATION (override with -D build flags)
+// =============================================================================
+
+#ifndef CAN_RX_QUEUE_LEN
+#define CAN_RX_QUEUE_LEN      32    // TWAI driver RX queue depth (frames)
+#endif
+#ifndef CAN_DRAIN_MAX_FRAMES
+#define CAN_DRAIN_MAX_FRAMES  32    // Max frames handled per canDriverDrain() call
+#endif
+#ifndef CAN_DRAIN_BUDGET_US
+#define CAN_DRAIN_BUDGET_US   2000  // Time budget per canDriverDrain() call
+#endif
+#ifndef CAN_RX_WAIT_MS
+#define CAN_RX_WAIT_MS        5     // Max wait for the first frame (yields CPU on a quiet bus)
+#endif
+
+// =============================================================================
+// INGEST TASK CONFIGURATION (override with -D build flags)
+// =============================================================================
+
+#ifndef CAN_TASK_PRIORITY
+#define CAN_TASK_PRIORITY     5     // Above loop() (priority 1)
+#endif
+#ifndef CAN_TASK_STACK
+#define CAN_TASK_STACK        4096  // Stack size in bytes
+#endif
+#ifndef CAN_TASK_WAIT_MS
+#define CAN_TASK_WAIT_MS      20    // Max RX wait before re-checking stop requests
+#endif
+
+/**
+ * @brief RX queue statistics, used to size CAN_DRAIN_MAX_FRAMES / CAN_RX_QUEUE_LEN
+ */
+struct CanRxStats {
+    uint32_t batches;         // Drain calls that handled at least one frame
+    uint16_t lastBatch;       // Frames handled by the last drain call
+    uint16_t maxBatch;        // Largest batch seen
+    uint16_t queueHighWater;  // Most frames waiting in the RX queue at drain start
+    uint32_t overruns;        // Frames lost (RX queue full + hardware FIFO overrun)
+    uint32_t limitStops;      // Drains stopped by CAN_DRAIN_MAX_FRAMES
+    uint32_t budgetStops;     // Drains stopped by CAN_DRAIN_BUDGET_US
+};
+
+typedef void (*CanFrameHandler)(CanFrame& frame);
+
+// =============================================================================
+// PUBLIC API
+// =============================================================================
+
+/**
+ * @brief Install and start the TWAI controller
+ *
+ * Programs the acceptance filter computed by canProcessor, or an accept-all
+ * filter when canPromisc is set.
+ *
+ * @return true if the controller is running
+ */
+bool canDriverBegin();
+
+/**
+ * @brief Stop and uninstall the TWAI controller
+ *
+ * Waits for the ingest task to finish its current batch first, so the
+ * caller may safely modify the CAN profile afterwards.
+ */
+void canDriverEnd();
+
+/**
+ * @brief Reinstall the controller to apply a new filter
+ *
+ * Called after a canPromisc change (profile changes go through
+ * canDriverSyncProfile()). Does nothing if the driver is not running.
+ *
+ * @return true if the controller is running (or was not started)
+ */
+bool canDriverRestart();
+
+/**
+ * @brief Bring the controller in line with a newly activated profile
+ *
+ * Called after CAN LOAD / CAN RELOAD swapped the profile in:
+ * - mock profile: the controller is stopped
+ * - real profile, controller stopped: it is started (no reboot needed)
+ * - real profile, controller running: it is reinstalled only if the
+ *   acceptance filter changed (TWAI filters are fixed at install time), so
+ *   a reload of the same ID set never pauses reception
+ *
+ * Requires the ingest task (canDriverStartTask()) for frames to be decoded.
+ *
+ * @return true if the controller is in the expected state
+ */
+bool canDriverSyncProfile();
+
+/**
+ * @brief Record the IDs on the bus for a while, without taking part in it
+ *
+ * Installs the controller in listen-only mode (no ACK, no error frames)
+ * with an accept-all filter and sets bit (id & 7) of idBits[id >> 3] for
+ * every standard frame received, then uninstalls it. Ends early when no
+ * frame came within silenceMs. Only when the driver is stopped (boot
+ * profile auto-detection, before canDriverBegin()).
+ *
+ * @param windowMs Listen duration
+ * @param silenceMs Give up after this long without any frame
+ * @param idBits Bitmap of CAN_DISPATCH_SIZE bits, cleared first
+ * @return Frames received (0 if the bus was silent or the driver is running)
+ */
+uint32_t canDriverListen(uint32_t windowMs, uint32_t silenceMs, uint8_t* idBits);
+
+/**
+ * @brief Check whether the TWAI controller is running
+ */
+bool canDriverIsRunning();
+
+/**
+ * @brief Get the acceptance filter currently programmed in the controller
+ */
+const CanAcceptanceFilter& canDriverGetFilter();
+
+/**
+ * @brief Read a bounded batch of frames from the RX queue
+ *
+ * For use without the ingest task; returns 0 once the task owns the queue.
+ * Waits up to CAN_RX_WAIT_MS for the first frame, then reads without
+ * blocking until the queue is empty, CAN_DRAIN_MAX_FRAMES frames were
+ * handled, or CAN_DRAIN_BUDGET_US elapsed.
+ *
+ * @param handler Called for every frame read
+ * @return Number of frames handled
+ */
+uint16_t canDriverDrain(CanFrameHandler handler);
+
+/**
+ * @brief Get RX drain / queue statistics
+ */
+const CanRxStats& canDriverGetRxStats();
+
+/**
+ * @brief Check the controller for bus faults and run one recovery step
+ *
+ * Called periodically from loop() in real CAN mode. Reboots only once
+ * CAN_RECOVERY_MAX_ATTEMPTS consecutive recoveries failed.
+ */
+void canDriverCheckHealth();
+
+/**
+ * @brief A bus fault is being recovered (controller not confirmed running)
+ */
+bool canDriverIsRecovering();
+
+/**
+ * @brief Get bus fault / recovery counters
+ */
+const CanRecoveryStats& canDriverGetRecoveryStats();
+
+/**
+ * @brief Reboots caused by unrecoverable bus faults (kept across them)
+ */
+uint32_t canDriverGetFaultReboots();
+
+/**
+ * @brief Create the CAN ingest task
+ *
+ * The task drains the RX queue whenever the driver is running
+ * and calls handler for every frame.
+ *
+ * @param handler Frame handler (runs in the ingest task context)
+ * @return true if the task was created (or already exists)
+ */
+bool canDriverStartTask(CanFrameHandler handler);
+
+/**
+ * @brief Get the ingest task handle (nullptr if not started)
+ */
+TaskHandle_t canDriverGetTaskHandle();
+
+/**
+ * @brief Get cumulative time spent handling frames in the ingest task
+ * @return Busy time in microseconds
+ */
+uint64_t canDriverGetTaskBusyUs();
+
+#endif // CAN_DRIVER_H
@@ -0,0 +1,220 @@
+/**
+ * @file CanRecorder.h
+ * @brief High-rate CAN frame recorder to LittleFS
+ *
+ * The ingest task copies every accepted frame (16-byte record) into a RAM
+ * ring; a low-priority task writes the ring to flash in large chunks, so
+ * recording at full bus load never touches USB or blocks loop().
+ *
+ * Recording is written to two files used in turn (REC_FILE_0 / REC_FILE_1):
+ * when the current one reaches REC_FILE_MAX_BYTES the other is truncated
+ * and becomes current, so the last 1-2 files' worth of traffic is kept.
+ *
+ * File layout (little endian):
+ * ┌──────────────────────────┬──────────────────┬─────┐
+ * │ CanRecordHeader (16 B)   │ CanRecord (16 B) │ ... │
+ * └──────────────────────────┴──────────────────┴─────┘
+ *
+ * Only standard (11-bit) frames are recorded, as for the profile decoder;
+ * extended frames are counted and skipped.
+ */
+
+#ifndef CAN_RECORDER_H
+#define CAN_RECORDER_H
+
+#include <Arduino.h>
+#include <ESP32-TWAI-CAN.hpp>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+// =============================================================================
+// CONFIGURATION (override with -D build flags)
+// =============================================================================
+
+#ifndef REC_RING_FRAMES
+#define REC_RING_FRAMES      1024    // RAM ring (16 KB), power of two
+#endif
+#ifndef REC_FLUSH_FRAMES
+#define REC_FLUSH_FRAMES     256     // Records per flash write (4 KB)
+#endif
+#ifndef REC_FLUSH_MAX_MS
+#define REC_FLUSH_MAX_MS     1000    // Write a partial chunk after this long
+#endif
+#ifndef REC_FILE_MAX_BYTES
+#define REC_FILE_MAX_BYTES   262144  // Rotate to the other file at this size
+#endif
+#ifndef REC_MAX_FILTERS
+#define REC_MAX_FILTERS      8       // ID/mask filters (none = record all)
+#endif
+#ifndef REC_TASK_PRIORITY
+#define REC_TASK_PRIORITY    1       // Same as loop(), below otaWriter / canIngest
+#endif
+#ifndef REC_TASK_STACK
+#define REC_TASK_STACK       4096    // Stack size in bytes
+#endif
+#ifndef REC_TASK_POLL_MS
+#define REC_TASK_POLL_MS     20      // Ring check period
+#endif
+
+#define REC_FILE_0           "/rec0.bin"
+#define REC_FILE_1           "/rec1.bin"
+#define REC_MAGIC            0x43455243u   // "CREC"
+#define REC_VERSION          1
+
+static_assert((REC_RING_FRAMES & (REC_RING_FRAMES - 1)) == 0, "REC_RING_FRAMES must be a power of two");
+static_assert(REC_RING_FRAMES % REC_FLUSH_FRAMES == 0, "flush chunks must tile the ring");
+
+// =============================================================================
+// FILE FORMAT
+// =============================================================================
+
+#define REC_FLAG_RTR         0x01    // Remote frame (no data)
+#define REC_FLAG_TRIGGER     0x02    // Frame that fired REC TRIGGER
+
+/**
+ * @brief One recorded frame
+ */
+struct CanRecord {
+    uint32_t timestampUs;   // micros() when the ingest task read the frame
+    uint16_t id;            // 11-bit identifier
+    uint8_t  dlc;           // Data length (0-8)
+    uint8_t  flags;         // REC_FLAG_*
+    uint8_t  data[8];       // Bytes past dlc are zero
+};
+
+/**
+ * @brief Start of every recording file
+ */
+struct CanRecordHeader {
+    uint32_t magic;         // REC_MAGIC
+    uint16_t version;       // REC_VERSION
+    uint16_t recordSize;    // sizeof(CanRecord)
+    uint32_t startMs;       // millis() at REC START (same for both files)
+    uint16_t sequence;      // File number in this recording (0, 1, 2, ...)
+    uint16_t reserved;
+};
+
+static_assert(sizeof(CanRecord) == 16, "CanRecord is part of the file format");
+static_assert(sizeof(CanRecordHeader) == 16, "CanRecordHeader is part of the file format");
+
+// =============================================================================
+// TYPES
+// =============================================================================
+
+enum class CanRecorderState : uint8_t {
+    IDLE,           // Not recording
+    ARMED,          // Waiting for the trigger ID
+    RECORDING
+};
+
+/**
+ * @brief Recorder counters (kept after REC STOP for REC STATUS)
+ */
+struct CanRecorderStats {
+    uint32_t recorded;        // Frames put in the ring
+    uint32_t written;         // Frames written to flash
+    uint32_t dropped;         // Frames lost: ring full
+    uint32_t filtered;        // Frames rejected by the ID filters / not triggered yet
+    uint32_t extended;        // Extended frames skipped
+    uint32_t writeErrors;     // Failed or short file writes (records lost)
+    uint32_t writes;          // File write calls
+    uint32_t writeMaxUs;      // Slowest file write
+    uint32_t rotations;       // Switches to the other file
+    uint16_t ringHighWater;   // Most records waiting in the ring
+    uint8_t  fileIndex;       // Current file (0 = REC_FILE_0, 1 = REC_FILE_1)
+    uint32_t fileBytes;       // Size of the current file
+    unsigned long startMs;    // REC START
+    unsigned long triggerMs;  // Trigger fired, 0 if not armed / not yet
+    unsigned long stopMs;     // REC STOP, 0 while running
+};
+
+// =============================================================================
+// PUBLIC API
+// =============================================================================
+
+/**
+ * @brief Create the writer task (once, from setup())
+ *
+ * Without the task (unit tests) the ring is written by canRecorderFlush()
+ * and canRecorderStop() in the caller's context.
+ *
+ * @return false if the task could not be created
+ */
+bool canRecorderBegin();
+
+/**
+ * @brief Start a recording (replaces previous recording files)
+ * @param triggerId 11-bit ID starting the capture, or -1 to start now
+ * @return false if already recording, LittleFS has no room for both files
+ *         or the file cannot be created (see canRecorderError())
+ */
+bool canRecorderStart(int16_t triggerId = -1);
+
+/**
+ * @brief Why the last canRecorderStart() failed, or nullptr
+ */
+const char* canRecorderError();
+
+/**
+ * @brief Stop capturing, write everything left in the ring and close the file
+ *
+ * With the writer task, waits up to REC_STOP_TIMEOUT_MS for it to drain; on
+ * timeout the rest of the ring counts as write errors and the writer closes
+ * the file when its pending write returns.
+ */
+void canRecorderStop();
+
+/**
+ * @brief Record only IDs with (id & mask) == (filterId & mask)
+ *
+ * Filters are OR-ed; with no filter every standard frame is recorded.
+ * May be changed while recording.
+ *
+ * @return false if REC_MAX_FILTERS filters are already set
+ */
+bool canRecorderAddFilter(uint16_t id, uint16_t mask);
+
+void canRecorderClearFilters();
+
+uint8_t canRecorderGetFilterCount();
+
+/**
+ * @brief Get filter i (i < canRecorderGetFilterCount())
+ */
+void canRecorderGetFilter(uint8_t i, uint16_t& id, uint16_t& mask);
+
+/**
+ * @brief Queue one frame (ingest task context, constant time)
+ */
+void canRecorderCapture(const CanFrame& frame);
+
+/**
+ * @brief Write buffered records to the current file
+ *
+ * Writes full REC_FLUSH_FRAMES chunks, or whatever is buffered when force
+ * is set. Called by the writer task.
+ *
+ * @return Number of records taken from the ring
+ */
+uint16_t canRecorderFlush(bool force);
+
+CanRecorderState canRecorderGetState();
+
+const CanRecorderStats& canRecorderGetStats();
+
+/**
+ * @brief Records waiting in the RAM ring
+ */
+uint16_t canRecorderGetBuffered();
+
+/**
+ * @brief Path of recording file 0 or 1
+ */
+const char* canRecorderFilePath(uint8_t index);
+
+/**
+ * @brief Writer task handle (nullptr before canRecorderBegin())
+ */
+TaskHandle_t canRecorderGetTaskHandle();
+
+#endif // CAN_RECORDER_H
@@ -0,0 +1,145 @@
+/**
+ * @file CanRecovery.h
+ * @brief Bus-off / error-limit recovery policy for the TWAI controller
+ *
+ * Decides what the driver does about a bus fault, one step per health
+ * check (CanDriver.cpp runs the steps):
+ * - bus-off: initiate recovery (128 x 11 recessive bits), then start the
+ *   controller again once it reports STOPPED; reinstall the driver if that
+ *   takes longer than CAN_RECOVERY_TIMEOUT_MS
+ * - error counters above CAN_MAX_ERRORS: reinstall the driver (resets them)
+ *
+ * Decoded vehicle data and the head-unit stream are untouched meanwhile.
+ * Consecutive faults wait an exponential backoff before the next attempt
+ * (none for the first, then CAN_RECOVERY_BACKOFF_MS doubling up to
+ * CAN_RECOVERY_BACKOFF_MAX_MS). The count restarts after
+ * CAN_RECOVERY_STABLE_MS without a fault; beyond CAN_RECOVERY_MAX_ATTEMPTS
+ * the policy asks for a reboot.
+ *
+ * Pure logic (no driver calls), so it runs in the native tests.
+ */
+
+#ifndef CAN_RECOVERY_H
+#define CAN_RECOVERY_H
+
+#include <Arduino.h>
+
+// =============================================================================
+// CONFIGURATION (override with -D build flags)
+// =============================================================================
+
+#ifndef CAN_MAX_ERRORS
+#define CAN_MAX_ERRORS              100     // RX / bus error count treated as a fault (error passive ~127)
+#endif
+#ifndef CAN_RECOVERY_TIMEOUT_MS
+#define CAN_RECOVERY_TIMEOUT_MS     500     // Bus-off recovery not done by then: reinstall
+#endif
+#ifndef CAN_RECOVERY_BACKOFF_MS
+#define CAN_RECOVERY_BACKOFF_MS     100     // Wait before the 2nd consecutive attempt, doubled after
+#endif
+#ifndef CAN_RECOVERY_BACKOFF_MAX_MS
+#define CAN_RECOVERY_BACKOFF_MAX_MS 5000
+#endif
+#ifndef CAN_RECOVERY_MAX_ATTEMPTS
+#define CAN_RECOVERY_MAX_ATTEMPTS   8       // Consecutive faults before a reboot
+#endif
+#ifndef CAN_RECOVERY_STABLE_MS
+#define CAN_RECOVERY_STABLE_MS      10000   // Fault-free time that resets the attempt count
+#endif
+
+/**
+ * @brief Controller condition, as read from the driver status
+ */
+enum class CanBusCondition : uint8_t {
+    OK,             // Running, error counters below CAN_MAX_ERRORS
+    ERROR_LIMIT,    // Running, error counters above CAN_MAX_ERRORS
+    BUS_OFF,
+    RECOVERING,     // Bus-off recovery in progress
+    STOPPED,        // Installed, not started (bus-off recovery done)
+    OFFLINE         // Driver not installed (a reinstall failed)
+};
+
+/**
+ * @brief Next step for the driver
+ */
+enum class CanRecoveryAction : uint8_t {
+    NONE,
+    INITIATE_RECOVERY,  // twai_initiate_recovery()
+    START,              // twai_start()
+    REINSTALL,          // canDriverEnd() + canDriverBegin()
+    REBOOT              // Too many consecutive faults
+};
+
+/**
+ * @brief Fault and recovery counters (CAN STATUS)
+ */
+struct CanRecoveryStats {
+    uint32_t busOffs;           // Bus-off events
+    uint32_t errorLimits;       // Error counters above CAN_MAX_ERRORS
+    uint32_t recoveries;        // Faults cleared without a reboot
+    uint32_t failedAttempts;    // Attempts after which the bus was still down
+    uint32_t lastDowntimeMs;    // Fault -> controller running again
+    uint32_t maxDowntimeMs;
+    uint64_t totalDowntimeMs;
+};
+
+// =============================================================================
+// RECOVERY POLICY
+// =============================================================================
+
+class CanRecovery {
+public:
+    CanRecovery();
+
+    /**
+     * @brief Back to a healthy bus and zeroed counters
+     */
+    void reset();
+
+    /**
+     * @brief Feed one health check
+     * @param now Current time in ms
+     * @param condition Controller condition read just before
+     * @return What the driver should do now
+     */
+    CanRecoveryAction update(unsigned long now, CanBusCondition condition);
+
+    /**
+     * @brief A fault is being handled (bus not confirmed running yet)
+     */
+    bool isRecovering() const { return _state != State::RUNNING; }
+
+    /**
+     * @brief Consecutive faults since the last stable period
+     */
+    uint8_t getAttempts() const { return _attempts; }
+
+    const CanRecoveryStats& getStats() const { return _stats; }
+
+    /**
+     * @brief Wait before consecutive attempt n (1-based): 0 for the first
+     */
+    static uint32_t backoffMs(uint8_t attempt);
+
+private:
+    enum class State : uint8_t {
+        RUNNING,        // Bus healthy
+        BACKOFF,        // Waiting before the next attempt
+        RECOVERING,     // Bus-off recovery initiated, waiting for STOPPED
+        VERIFY          // Step done, next check tells if the bus is back
+    };
+
+    CanRecoveryAction fault(unsigned long now, CanBusCondition condition);
+    CanRecoveryAction attempt(unsigned long now, CanBusCondition condition);
+    void recovered(unsigned long now);
+
+    State _state;
+    uint8_t _attempts;
+    unsigned long _downSinceMs;     // Start of the current outage
+    unsigned long _upSinceMs;       // Bus running again since
+    unsigned long _stepMs;          // Start of the current step / backoff
+    uint32_t _waitMs;               // Backoff length
+    CanRecoveryStats _stats;
+};
+
+#endif // CAN_RECOVERY_H
@@ -0,0 +1,145 @@
+/**
+ * @file CanReplay.h
+ * @brief Replay of recorded CAN logs through the frame handler
+ *
+ * Frames from a log are handed to the same handler as bus frames
+ * (handleCanCapture() on the device), so a profile can be exercised with
+ * real bus timing, bursts and unknown IDs instead of MockDataGenerator's
+ * synthetic values.
+ *
+ * Supported logs, detected from the first bytes:
+ * - CanRecorder files (REC START, see CanRecorder.h)
+ * - candump -l text: "(1436509052.249713) can0 180#45E0000000000000"
+ *   (remote frames "180#R", extended IDs and CAN FD lines are skipped)
+ *
+ * On the device update() runs from loop() at the original speed or faster;
+ * on the host (env:native) run() feeds a whole log without waiting.
+ */
+
+#ifndef CAN_REPLAY_H
+#define CAN_REPLAY_H
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <ESP32-TWAI-CAN.hpp>
+
+// =============================================================================
+// CONFIGURATION (override with -D build flags)
+// =============================================================================
+
+#ifndef REPLAY_MAX_BURST
+#define REPLAY_MAX_BURST  64    // Frames per update(): loop() keeps serving serial/radio
+#endif
+#ifndef REPLAY_LINE_MAX
+#define REPLAY_LINE_MAX   96    // Longest candump line
+#endif
+
+typedef void (*CanReplayHandler)(CanFrame& frame);
+
+enum class CanReplayFormat : uint8_t {
+    NONE,           // No log open
+    RECORDER,       // CanRecorder binary file
+    CANDUMP         // candump -l text
+};
+
+/**
+ * @brief Replay counters (reset by begin())
+ */
+struct CanReplayStats {
+    uint32_t frames;          // Frames handed to the handler
+    uint32_t skipped;         // Lines/records not replayed (extended, CAN FD, malformed)
+    uint32_t loops;           // Restarts at the end of the log
+    uint32_t maxLateUs;       // Largest delay behind the log timing (update() only)
+    uint64_t logTimeUs;       // Log time of the last frame, from the first frame
+};
+
+// =============================================================================
+// CAN REPLAY CLASS
+// =============================================================================
+
+class CanReplay {
+public:
+    CanReplay();
+
+    /**
+     * @brief Open a log and start the replay clock
+     * @param path  LittleFS path
+     * @param speed 1 = original timing, N = N times faster, 0 = no delays
+     * @param loop  Restart at the end of the log
+     * @return false if the file is missing or not a supported log
+     */
+    bool begin(const char* path, uint16_t speed = 1, bool loop = false);
+
+    /**
+     * @brief Close the log
+     */
+    void end();
+
+    bool isActive() const { return _format != CanReplayFormat::NONE; }
+
+    /**
+     * @brief true once the end of a non-looping log has been reached
+     */
+    bool isFinished() const { return _finished; }
+
+    CanReplayFormat getFormat() const { return _format; }
+
+    /**
+     * @brief Hand over the frames that are due (call from loop())
+     * @return Number of frames handled, at most REPLAY_MAX_BURST
+     */
+    uint16_t update(CanReplayHandler handler);
+
+    /**
+     * @brief Milliseconds until update() has a frame to hand over
+     * @return 0 if one is due (or unknown yet), UINT32_MAX once finished
+     */
+    uint32_t msUntilNext() const;
+
+    /**
+     * @brief Hand over frames without waiting (host replay)
+     * @param maxFrames Stop after this many frames, 0 = whole log
+     * @return Number of frames handled
+     */
+    uint32_t run(CanReplayHandler handler, uint32_t maxFrames = 0);
+
+    /**
+     * @brief Read the next frame of the log
+     * @param timeUs Set to its log time, µs from the first frame
+     * @return false at the end of the log
+     */
+    bool next(CanFrame& frame, uint64_t& timeUs);
+
+    const CanReplayStats& getStats() const { return _stats; }
+
+private:
+    File _file;
+    CanReplayFormat _format;
+    uint16_t _speed;
+    bool _loop;
+    bool _finished;
+
+    // Log clock
+    bool _haveFirst;                // First frame of the current pass read
+    uint64_t _firstUs;              // candump: absolute time of the first frame
+    uint32_t _lastRecordUs;         // Recorder: previous 32-bit timestamp
+    uint64_t _recordTimeUs;         // Recorder: accumulated log time
+
+    // Wall clock (update())
+    uint32_t _lastNowUs;
+    uint64_t _elapsedUs;
+
+    // Frame read ahead, waiting for its time
+    CanFrame _pending;
+    uint64_t _pendingUs;
+    bool _hasPending;
+
+    CanReplayStats _stats;
+
+    bool rewind();
+    bool readRecord(CanFrame& frame, uint64_t& timeUs);
+    bool readCandump(CanFrame& frame, uint64_t& timeUs);
+    bool parseCandump(const char* line, CanFrame& frame, uint64_t& absUs);
+};
+
+#endif // CAN_REPLAY_H
@@ -0,0 +1,113 @@
+/**
+ * @file CanStream.h
+ * @brief Live binary CAN streaming over USB (LOG BIN)
+ *
+ * The ingest task puts accepted frames in a RAM ring; loop() packs them into
+ * BinaryFrame packets (type BIN_CAN_LOG) and writes each packet whole, only
+ * when the USB TX buffer has room, so text replies never land inside one.
+ *
+ * Packet payload (little endian):
+ * ┌────────────────┬───────────────┬──────────┬─────────┬─────────┬─────┐
+ * │ Base time (4B) │ Dropped (4B)  │ Count 2B │ Record  │ Record  │ ... │
+ * │ µs, record 0   │ total so far  │          │         │         │     │
+ * └────────────────┴───────────────┴──────────┴─────────┴─────────┴─────┘
+ * Record: delta µs from the previous record (2B, 0 for the first),
+ *         ID | DLC << 11 | RTR << 15 (2B), DLC data bytes.
+ *
+ * An 8-byte frame costs 12 bytes instead of ~40 characters of LOG ON text.
+ * The frame sequence number counts packets and Dropped counts frames lost
+ * on the device (ring full), so the host can tell both kinds of loss apart.
+ * Only standard (11-bit) frames are streamed.
+ */
+
+#ifndef CAN_STREAM_H
+#define CAN_STREAM_H
+
+#include <Arduino.h>
+#include <ESP32-TWAI-CAN.hpp>
+#include "BinaryFrame.h"
+
+// =============================================================================
+// CONFIGURATION (override with -D build flags)
+// =============================================================================
+
+#ifndef CANSTREAM_RING_FRAMES
+#define CANSTREAM_RING_FRAMES   512     // RAM ring (8 KB), power of two
+#endif
+#ifndef CANSTREAM_PACKET_MAX
+#define CANSTREAM_PACKET_MAX    240     // Payload bytes: packet fits the 256 B USB CDC TX buffer
+#endif
+#ifndef CANSTREAM_FLUSH_MS
+#define CANSTREAM_FLUSH_MS      10      // Send a partial packet once its oldest frame is this old
+#endif
+
+#define CANSTREAM_HEADER_SIZE   10      // Base time + dropped + count
+#define CANSTREAM_RECORD_MAX    12      // Delta + ID/DLC + 8 data bytes
+
+static_assert((CANSTREAM_RING_FRAMES & (CANSTREAM_RING_FRAMES - 1)) == 0,
+              "CANSTREAM_RING_FRAMES must be a power of two");
+static_assert(CANSTREAM_PACKET_MAX >= CANSTREAM_HEADER_SIZE + CANSTREAM_RECORD_MAX &&
+              CANSTREAM_PACKET_MAX <= BIN_MAX_PAYLOAD, "CANSTREAM_PACKET_MAX out of range");
+
+/**
+ * @brief Stream counters (reset by canStreamStart())
+ */
+struct CanStreamStats {
+    uint32_t queued;      // Frames put in the ring
+    uint32_t filtered;    // Rejected by the ID filter, or extended
+    uint32_t decimated;   // Skipped by decimation
+    uint32_t dropped;     // Lost: ring full (USB not keeping up)
+    uint32_t sent;        // Frames written to USB
+    uint32_t packets;     // Packets written
+    uint32_t bytes;       // Bytes written, framing included
+    uint16_t ringHighWater;
+};
+
+// =============================================================================
+// PUBLIC API
+// =============================================================================
+
+/**
+ * @brief Start streaming
+ * @param filterId   Stream IDs with (id & mask) == (filterId & mask)
+ * @param filterMask 0 = all IDs
+ * @param decimation Keep 1 frame in N of each ID (1 = all)
+ */
+void canStreamStart(uint16_t filterId = 0, uint16_t filterMask = 0, uint8_t decimation = 1);
+
+/**
+ * @brief Stop streaming; frames not yet sent are discarded
+ */
+void canStreamStop();
+
+bool canStreamIsActive();
+
+/**
+ * @brief Queue one frame (ingest task context, constant time)
+ */
+void canStreamCapture(const CanFrame& frame);
+
+/**
+ * @brief Send one packet if it is due and fits the USB TX buffer (loop())
+ */
+void canStreamPoll();
+
+/**
+ * @brief Pack buffered frames into one complete BIN_CAN_LOG frame
+ *
+ * Stops at CANSTREAM_PACKET_MAX or when a delta would not fit 16 bits (the
+ * next packet starts a new base time). Used by canStreamPoll().
+ *
+ * @param out Buffer of at least CANSTREAM_PACKET_MAX + BIN_OVERHEAD bytes
+ * @return Frame length, 0 if the ring is empty
+ */
+size_t canStreamBuildPacket(uint8_t* out);
+
+const CanStreamStats& canStreamGetStats();
+
+/**
+ * @brief Frames waiting in the ring
+ */
+uint16_t canStreamGetBuffered();
+
+#endif // CAN_STREAM_H
@@ -0,0 +1,249 @@
+/**
+ * @file CanStress.h
+ * @brief Synthetic bus load through the frame handler, to find throughput limits
+ *
+ * Encodes frames for every CAN ID of the loaded profile, with slowly moving
+ * values inside MockDataGenerator's realistic bounds (flags toggling), and
+ * hands them to the same handler as bus frames (ingestFrame() /
+ * handleCanCapture() on the device). Unlike mock mode, every frame goes
+ * through processFrame(), the signal filters and the radio wake path.
+ *
+ * Load model:
+ * - frames arrive at a target rate, up to STRESS_LINE_RATE (100% of a
+ *   500 kbps bus: 8-byte standard frames without stuff bits, 111 bits each)
+ * - a share of them carries IDs the profile does not decode (noise: the
+ *   frames canPromisc or a loose acceptance mask lets through)
+ * - bursts put a number of frames back-to-back at line rate
+ * - arrivals wait in a queue of CAN_RX_QUEUE_LEN frames like the TWAI RX
+ *   queue; what does not fit is lost, as on the bus
+ *
+ * A sweep raises the rate by STRESS_SWEEP_STEP_PCT of the line rate every
+ * STRESS_SWEEP_STEP_MS and stops at the first step losing frames: the last
+ * loss-free step is the maximum sustainable rate.
+ *
+ * On the device the load runs in its own task at the ingest task's
+ * priority while the CAN controller is stopped (STRESS START / SWEEP over
+ * USB serial); on the host (env:native) service() is called with a
+ * simulated clock.
+ */
+
+#ifndef CAN_STRESS_H
+#define CAN_STRESS_H
+
+#include <Arduino.h>
+#include <ESP32-TWAI-CAN.hpp>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "VehicleConfig.h"
+
+// =============================================================================
+// CONFIGURATION (override with -D build flags)
+// =============================================================================
+
+#ifndef STRESS_BUS_BITRATE
+#define STRESS_BUS_BITRATE    500000  // Bus the load is expressed against
+#endif
+#define STRESS_FRAME_BITS     111     // 8-byte standard frame + interframe space, no stuff bits
+#define STRESS_LINE_RATE      (STRESS_BUS_BITRATE / STRESS_FRAME_BITS)  // 4504 frames/s = 100%
+
+#ifndef STRESS_SWEEP_STEP_PCT
+#define STRESS_SWEEP_STEP_PCT 10      // Sweep rate increment, % of the line rate
+#endif
+#ifndef STRESS_SWEEP_STEP_MS
+#define STRESS_SWEEP_STEP_MS  3000    // Time spent at each sweep rate
+#endif
+#ifndef STRESS_TASK_STACK
+#define STRESS_TASK_STACK     4096    // Same as the ingest task (same handler)
+#endif
+#define STRESS_SWEEP_STEPS    (100 / STRESS_SWEEP_STEP_PCT)
+
+typedef void (*CanStressHandler)(CanFrame& frame);
+
+/**
+ * @brief One load run (STRESS START / STRESS SWEEP arguments)
+ */
+struct CanStressConfig {
+    uint32_t rate;            // Frames/s, capped at STRESS_LINE_RATE; 0 = sweep
+    uint8_t  noisePct;        // Share of frames with IDs the profile does not decode
+    uint16_t burstFrames;     // Frames per burst, 0 = no bursts
+    uint16_t burstPeriodMs;   // Time between two burst starts
+    uint32_t durationMs;      // Fixed rate: run length, 0 = until stop()
+    uint16_t queueLen;        // RX queue between the bus and the handler
+    uint16_t maxBatch;        // Frames handled per service() call
+    uint32_t budgetUs;        // Time budget per service() call
+};
+
+/**
+ * @brief Counters of the current or last run (reset by begin())
+ */
+struct CanStressStats {
+    uint32_t offered;         // Frames put on the simulated bus
+    uint32_t handled;         // Frames handed to the handler
+    uint32_t lost;            // Offered frames that found the queue full
+    uint32_t noise;           // Handled frames with an ID the profile does not decode
+    uint32_t bursts;          // Bursts started
+    uint16_t queueHighWater;  // Most frames waiting at a service() call
+    uint32_t elapsedMs;       // Simulated bus time since begin()
+    uint64_t busyUs;          // Time spent in the handler
+};
+
+/**
+ * @brief Result of one sweep rate
+ */
+struct CanStressStep {
+    uint32_t rate;            // Frames/s offered
+    uint32_t offered;
+    uint32_t lost;
+};
+
+// =============================================================================
+// CAN STRESS CLASS
+// =============================================================================
+
+class CanStress {
+public:
+    CanStress();
+
+    /**
+     * @brief Copy the frame layout of a profile and start the clock
+     *
+     * The layout is copied, so a profile swap during the run does not
+     * touch what the load encodes.
+     *
+     * @param profile Real CAN profile (at least one frame)
+     * @param config  Load to offer
+     * @param nowUs   Current time (micros())
+     * @return false if the profile has no frames
+     */
+    bool begin(const VehicleProfile& profile, const CanStressConfig& config, uint32_t nowUs);
+
+    /**
+     * @brief Stop the run; counters stay for the report
+     */
+    void end();
+
+    bool isActive() const { return _active; }
+
+    /**
+     * @brief true once the run length elapsed or the sweep completed
+     */
+    bool isFinished() const { return _finished; }
+
+    bool isSweep() const { return _config.rate == 0; }
+
+    /**
+     * @brief Advance the simulated bus and hand over the queued frames
+     * @param nowUs   Current time (micros())
+     * @param handler Frame handler
+     * @return Number of frames handled, at most config.maxBatch
+     */
+    uint16_t service(uint32_t nowUs, CanStressHandler handler);
+
+    /**
+     * @brief Encode the next frame of the load
+     *
+     * Profile IDs are sent in turn, noise frames are interleaved at
+     * config.noisePct. Values follow the run time.
+     *
+     * @param frame Frame to fill
+     * @param timeMs Run time the values are taken at
+     */
+    void nextFrame(CanFrame& frame, uint32_t timeMs);
+
+    /**
+     * @brief Frames waiting in the simulated RX queue
+     */
+    uint32_t getBacklog() const { return _stats.offered - _stats.handled - _stats.lost; }
+
+    /**
+     * @brief Rate offered now (current sweep step), frames/s
+     */
+    uint32_t getRate() const { return _rate; }
+
+    /**
+     * @brief Bus load of a rate, in % of STRESS_LINE_RATE
+     */
+    static uint8_t busLoadPct(uint32_t rate) {
+        return (uint8_t)(((uint64_t)rate * 100 + STRESS_LINE_RATE / 2) / STRESS_LINE_RATE);
+    }
+
+    const CanStressConfig& getConfig() const { return _config; }
+    const CanStressStats& getStats() const { return _stats; }
+
+    /**
+     * @brief Sweep steps run so far (the last one may be in progress)
+     */
+    uint8_t getStepCount() const { return _stepCount; }
+    const CanStressStep& getStep(uint8_t index) const { return _steps[index]; }
+
+    /**
+     * @brief Highest sweep rate without loss, 0 if the first step lost frames
+     */
+    uint32_t getMaxSustainedRate() const { return _maxSustained; }
+
+    /**
+     * @brief Set the handler of the device task
+     * @param handler Frame handler, in the same context as the ingest task's
+     */
+    void setHandler(CanStressHandler handler) { _handler = handler; }
+
+    /**
+     * @brief Start a run in the stress task (created on first use)
+     *
+     * The caller stops the CAN controller first: the stress task then is the
+     * only writer of GlobalData, as the ingest task is otherwise.
+     *
+     * @return false without a handler, task or profile frames
+     */
+    bool start(const VehicleProfile& profile, const CanStressConfig& config);
+
+    /**
+     * @brief Ask the stress task to end the run (isActive() drops shortly after)
+     */
+    void stop() { _stopRequest = true; }
+
+private:
+    // Copied frame layout
+    FrameConfig _frames[PROFILE_MAX_FRAMES];
+    FieldConfig _fields[PROFILE_MAX_FIELDS];
+    uint16_t _frameCount;
+    uint8_t _ids[256];              // Bit (id & 7) of _ids[id >> 3]: profile ID
+
+    CanStressConfig _config;
+    CanStressHandler _handler;
+    TaskHandle_t _task;
+    volatile bool _active;
+    volatile bool _stopRequest;
+    bool _finished;
+
+    // Simulated bus
+    uint32_t _rate;                 // Frames/s of the current run or step
+    uint32_t _lastUs;               // service() time the bus was advanced to
+    uint64_t _clockUs;              // Bus time since begin()
+    uint64_t _arrivalAcc;           // Fractional arrivals, frames x 1e6
+    uint64_t _nextBurstUs;          // Bus time of the next burst start
+    uint16_t _burstLeft;            // Frames of the current burst still to arrive
+    uint16_t _nextFrame;            // Round-robin profile frame
+    uint32_t _seed;                 // xorshift32 state (noise)
+
+    // Sweep
+    CanStressStep _steps[STRESS_SWEEP_STEPS];
+    uint8_t _stepCount;
+    uint64_t _stepStartUs;
+    uint32_t _stepBaseOffered;      // Counters when the step started
+    uint32_t _stepBaseLost;
+    uint32_t _maxSustained;
+
+    CanStressStats _stats;
+
+    void advance(uint32_t nowUs);
+    void offer(uint32_t frames);
+    void startStep(uint8_t index);
+    void checkProgress();
+    uint32_t random();
+    void encodeField(uint8_t* data, const FieldConfig& field, uint32_t timeMs) const;
+
+    static void taskBody(void* arg);
+};
+
+#endif // CAN_STRESS_H
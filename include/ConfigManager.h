@@ -4,6 +4,18 @@
  *
  * Stores vehicle-specific calibration values in non-volatile storage.
  * Values persist across reboots. Use configReset() to restore defaults.
+ *
+ * Calibration and the vehicle file name are stored together as one blob
+ * with a CRC32, read once by configInit(). Writes are deferred and
+ * coalesced: configSave(), configReset() and configSetVehicleFile() only
+ * record what must be persisted, and configPoll() (from loop()) writes the
+ * blob once CONFIG_FLUSH_QUIET_MS pass without another save, or at most
+ * CONFIG_FLUSH_MAX_DELAY_MS after the first one. configFlush() writes at
+ * once, for shutdown paths (standby, reboot, supply voltage drop). A flush
+ * with nothing changed since the last write does not touch the flash.
+ *
+ * Settings written by an older firmware (one NVS key per value) are read
+ * when no blob exists and replaced by the blob on the first flush.
  */
 
 #ifndef CONFIG_MANAGER_H
@@ -22,6 +34,23 @@
 #define DEFAULT_RPM_DIVISOR         7       // RPM = raw_value / 7
 #define DEFAULT_TANK_CAPACITY       45      // Tank size in liters
 #define DEFAULT_DTE_DIVISOR         283     // DTE = raw * 100 / 283
+#define DEFAULT_CAN_PROMISC         false   // Hardware acceptance filter enabled
+
+// =============================================================================
+// PERSISTENCE (override with -D build flags)
+// =============================================================================
+
+#ifndef CONFIG_FLUSH_QUIET_MS
+#define CONFIG_FLUSH_QUIET_MS       2000    // Write once saves stop for this long
+#endif
+#ifndef CONFIG_FLUSH_MAX_DELAY_MS
+#define CONFIG_FLUSH_MAX_DELAY_MS   10000   // ... but never later than this after the first
+#endif
+#ifndef CONFIG_FLUSH_LOW_VOLTAGE
+#define CONFIG_FLUSH_LOW_VOLTAGE    11.0f   // Battery below this (V): write at once
+#endif
+
+#define CONFIG_VEHICLE_FILE_SIZE    40      // Vehicle file name buffer, terminator included
 
 // =============================================================================
 // CONFIGURATION STRUCTURE
@@ -35,6 +64,20 @@ struct CanboxConfig {
     uint8_t  rpmDivisor;        // RPM divisor (typically 7)
     uint8_t  tankCapacity;      // Fuel tank capacity in liters
     uint16_t dteDivisor;        // DTE divisor * 100 (283 = 2.83)
+    bool     canPromisc;        // Accept all CAN IDs (bypass hardware filter, for captures)
+};
+
+/**
+ * @brief NVS persistence statistics (SYS INFO)
+ */
+struct ConfigStoreStats {
+    uint32_t saves;             // Persistence requests (save, reset, vehicle file)
+    uint32_t writes;            // NVS blob writes
+    uint32_t unchanged;         // Flushes skipped: flash already held the values
+    uint32_t failures;          // NVS writes that failed (retried on the next poll)
+    uint32_t lastFlushUs;       // Duration of the last NVS write
+    uint32_t maxFlushUs;
+    bool     bootFromBlob;      // configInit() found a valid blob (false: old keys or defaults)
 };
 
 // =============================================================================
@@ -49,15 +92,47 @@ void configInit();
 
 /**
  * @brief Save all current config values to NVS
- * Call after modifying config values to persist them.
+ *
+ * Call after modifying config values to persist them. The write itself is
+ * deferred (see configPoll()): saves in short succession cost one write.
  */
 void configSave();
 
 /**
  * @brief Reset all config values to defaults and save to NVS
+ *
+ * The vehicle file name is kept.
  */
 void configReset();
 
+/**
+ * @brief Write pending changes to NVS if their quiet period has passed
+ * Call from loop().
+ */
+void configPoll();
+
+/**
+ * @brief Write pending changes to NVS now
+ *
+ * For shutdown paths: light sleep, reboot, supply voltage drop.
+ *
+ * @return false if the NVS write failed (changes stay pending)
+ */
+bool configFlush();
+
+/**
+ * @brief true if saved values are waiting to be written
+ */
+bool configIsPending();
+
+/**
+ * @brief Time until configPoll() writes the pending changes
+ * @return Milliseconds, 0 if due now, UINT32_MAX if nothing is pending
+ */
+uint32_t configMsUntilFlush();
+
+const ConfigStoreStats& configGetStoreStats();
+
 /**
  * @brief Get pointer to current config (read-only access)
  */
@@ -74,6 +149,7 @@ uint16_t configGetIndicatorTimeout();
 uint8_t  configGetRpmDivisor();
 uint8_t  configGetTankCapacity();
 uint16_t configGetDteDivisor();
+bool     configGetCanPromisc();
 
 // =============================================================================
 // INDIVIDUAL SETTERS (automatically marks config as dirty, call configSave() to persist)
@@ -86,6 +162,7 @@ void configSetIndicatorTimeout(uint16_t value);
 void configSetRpmDivisor(uint8_t value);
 void configSetTankCapacity(uint8_t value);
 void configSetDteDivisor(uint16_t value);
+void configSetCanPromisc(bool value);
 
 // =============================================================================
 // VEHICLE CONFIG FILE (stored separately from calibration)
@@ -99,6 +176,10 @@ const char* configGetVehicleFile();
 
 /**
  * @brief Save the vehicle config filename to NVS
+ *
+ * Only the file name is saved: calibration changed since the last
+ * configSave() stays unsaved. Written with the next flush.
+ *
  * @param filename The filename to save (without leading /)
  */
 void configSetVehicleFile(const char* filename);
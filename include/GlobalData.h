@@ -8,6 +8,15 @@
  * 
  * All variables use 'extern' to allow multiple translation units to
  * share the same data without linker errors.
+ *
+ * Concurrency: the CAN ingest task writes while the loop() task reads.
+ * Writers bracket updates with vehicleDataBeginWrite()/vehicleDataEndWrite();
+ * readers take a consistent copy with vehicleDataSnapshot() (seqlock, the
+ * reader retries instead of blocking the writer).
+ *
+ * Every signal also carries the micros() of the write section (CAN frame)
+ * that last changed it, so RadioSend can measure how old a change is when
+ * its command reaches the head-unit UART (LAT).
  */
 
 #ifndef GLOBAL_DATA_H
@@ -106,4 +115,131 @@ extern uint16_t elapsedTime;
  */
 void resetVehicleData();
 
+// =============================================================================
+// CONSISTENT SNAPSHOT (seqlock)
+// =============================================================================
+
+/** One change timestamp per DIRTY_* bit (see below) */
+const uint8_t VEHICLE_SIGNAL_COUNT = 13;
+
+/**
+ * @brief Copy of all vehicle data taken atomically with respect to writers
+ */
+struct VehicleDataSnapshot {
+    int16_t  currentSteer;
+    uint16_t engineRPM;
+    uint8_t  vehicleSpeed;
+    uint8_t  currentDoors;
+    uint8_t  fuelLevel;
+    float    voltBat;
+    int16_t  dteValue;
+    float    fuelConsoMoy;
+    int8_t   tempExt;
+    uint32_t currentOdo;
+
+    bool indicatorLeft;
+    bool indicatorRight;
+    bool headlightsOn;
+    bool highBeamOn;
+    bool parkingLightsOn;
+    unsigned long lastLeftIndicatorTime;
+    unsigned long lastRightIndicatorTime;
+
+    uint16_t fuelConsumptionInst;
+    uint16_t fuelConsumptionAvg;
+    uint16_t averageSpeed;
+    uint16_t elapsedTime;
+
+    uint32_t changedUs[VEHICLE_SIGNAL_COUNT];   // By DIRTY_* bit number
+};
+
+/**
+ * @brief Start a group of writes (e.g. all fields of one CAN frame)
+ *
+ * Suspends the scheduler so writers never interleave, and marks the data
+ * as being modified. Keep the section short and non-blocking.
+ */
+void vehicleDataBeginWrite();
+
+/**
+ * @brief End a group of writes started with vehicleDataBeginWrite()
+ */
+void vehicleDataEndWrite();
+
+/**
+ * @brief Take a consistent copy of all vehicle data
+ *
+ * Never blocks the writer: retries if a write happened during the copy.
+ *
+ * @param out Destination snapshot
+ */
+void vehicleDataSnapshot(VehicleDataSnapshot& out);
+
+// =============================================================================
+// DIRTY SET (change-driven radio updates)
+// =============================================================================
+// Writers mark a signal dirty only when its value actually changes; RadioSend
+// takes the set each pass and sends the matching commands.
+
+const uint16_t DIRTY_STEERING       = 0x0001;
+const uint16_t DIRTY_RPM            = 0x0002;
+const uint16_t DIRTY_SPEED          = 0x0004;
+const uint16_t DIRTY_DOORS          = 0x0008;
+const uint16_t DIRTY_LIGHTS         = 0x0010;
+const uint16_t DIRTY_FUEL_LEVEL     = 0x0020;
+const uint16_t DIRTY_ODOMETER       = 0x0040;
+const uint16_t DIRTY_VOLTAGE        = 0x0080;
+const uint16_t DIRTY_TEMPERATURE    = 0x0100;
+const uint16_t DIRTY_DTE            = 0x0200;
+const uint16_t DIRTY_FUEL_CONS_INST = 0x0400;
+const uint16_t DIRTY_FUEL_CONS_AVG  = 0x0800;
+const uint16_t DIRTY_TRIP           = 0x1000;   // averageSpeed / elapsedTime
+const uint16_t DIRTY_ALL            = 0x1FFF;
+
+static_assert(DIRTY_ALL == (1u << VEHICLE_SIGNAL_COUNT) - 1, "one timestamp per dirty bit");
+
+/** Pending dirty signals (only modified inside a write section) */
+extern volatile uint16_t vehicleDirty;
+
+/** micros() at the start of the current write section (the frame being decoded) */
+extern uint32_t vehicleDataWriteUs;
+
+/** micros() of the write section that last changed each signal, by bit number */
+extern volatile uint32_t vehicleChangedUs[VEHICLE_SIGNAL_COUNT];
+
+/**
+ * @brief Mark signals dirty (call between vehicleDataBeginWrite/EndWrite)
+ *
+ * Also stamps them with the time of the current write section.
+ */
+inline void vehicleDataMarkDirty(uint16_t bits) {
+    vehicleDirty = vehicleDirty | bits;
+    for (uint16_t b = bits & DIRTY_ALL; b; b &= b - 1) {
+        vehicleChangedUs[__builtin_ctz(b)] = vehicleDataWriteUs;
+    }
+}
+
+/**
+ * @brief Store a value, marking it dirty only if it changed
+ *
+ * Call between vehicleDataBeginWrite()/vehicleDataEndWrite().
+ */
+template <typename T>
+inline void vehicleDataStore(T& dst, T value, uint16_t dirtyBit) {
+    if (dst != value) {
+        dst = value;
+        vehicleDataMarkDirty(dirtyBit);
+    }
+}
+
+/**
+ * @brief Atomically read and clear the dirty set
+ *
+ * Call before vehicleDataSnapshot(): a write landing in between is then
+ * either in the snapshot or still dirty next pass, never lost.
+ *
+ * @return Dirty bits accumulated since the previous call
+ */
+uint16_t vehicleDataTakeDirty();
+
 #endif
@@ -0,0 +1,70 @@
+/**
+ * @file LatencyHistogram.h
+ * @brief Fixed-size latency histogram with percentiles (SYS LAT)
+ *
+ * Log-linear buckets in microseconds: values below 4 µs are exact, then
+ * every power of two is split into 4 equal sub-buckets (at most 25% error
+ * on a percentile), up to LAT_HIST_MAX_US. The largest value is kept
+ * exactly. No allocation: one histogram is LAT_HIST_BUCKETS counters.
+ *
+ * Not thread-safe: record and read from the same task (loop()).
+ */
+
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <Arduino.h>
+
+// =============================================================================
+// CONFIGURATION
+// =============================================================================
+
+#define LAT_HIST_SUB_BITS   2                               // 4 sub-buckets per octave
+#define LAT_HIST_SUB        (1u << LAT_HIST_SUB_BITS)
+#define LAT_HIST_OCTAVES    20                              // 4 µs ... 4 s (2^22 µs)
+#define LAT_HIST_BUCKETS    (LAT_HIST_SUB + LAT_HIST_OCTAVES * LAT_HIST_SUB)
+#define LAT_HIST_MAX_US     ((LAT_HIST_SUB << LAT_HIST_OCTAVES) - 1)
+
+// =============================================================================
+// LATENCY HISTOGRAM CLASS
+// =============================================================================
+
+class LatencyHistogram {
+public:
+    LatencyHistogram();
+
+    void reset();
+
+    /**
+     * @brief Add one sample (values above LAT_HIST_MAX_US go to the last bucket)
+     */
+    void record(uint32_t us);
+
+    uint32_t getCount() const { return _count; }
+    uint32_t getMax() const { return _max; }
+
+    /**
+     * @brief Value below which pct percent of the samples fall
+     * @param pct 0-100 (50 = median)
+     * @return Upper bound of the bucket holding that sample, never above
+     *         getMax(); 0 when empty
+     */
+    uint32_t percentile(uint8_t pct) const;
+
+    /**
+     * @brief Bucket index for a value
+     */
+    static uint8_t bucketFor(uint32_t us);
+
+    /**
+     * @brief Largest value that falls in bucket i
+     */
+    static uint32_t bucketUpper(uint8_t i);
+
+private:
+    uint32_t _count;
+    uint32_t _max;
+    uint32_t _buckets[LAT_HIST_BUCKETS];
+};
+
+#endif // LATENCY_HISTOGRAM_H
@@ -0,0 +1,64 @@
+/**
+ * @file LoopWake.h
+ * @brief Event-driven loop(): block until there is work instead of polling
+ *
+ * loop() ends with loopWait(timeout), where the timeout is its next
+ * deadline (radio command due, mock update, replay frame, health check).
+ * Events end the wait early through a FreeRTOS task notification:
+ * - a decoded CAN frame changed a signal (ingest task, loopWake())
+ * - bytes received from the head unit (radio UART RX callback)
+ * - bytes received on USB serial (CDC RX event)
+ *
+ * While loop() is blocked the idle task runs (WFI, watchdog feeding).
+ */
+
+#ifndef LOOP_WAKE_H
+#define LOOP_WAKE_H
+
+#include <Arduino.h>
+
+// =============================================================================
+// CONFIGURATION (override with -D build flags)
+// =============================================================================
+
+#ifndef LOOP_MAX_WAIT_MS
+#define LOOP_MAX_WAIT_MS  100   // Longest sleep: CAN health checks, heartbeat LED
+#endif
+
+/**
+ * @brief Wait statistics (SYS INFO)
+ */
+struct LoopWakeStats {
+    uint32_t waits;           // loopWait() calls
+    uint32_t eventWakes;      // Waits ended by an event
+    uint32_t timeouts;        // Waits ended by their deadline
+    uint64_t sleptUs;         // Total time blocked
+};
+
+// =============================================================================
+// PUBLIC API
+// =============================================================================
+
+/**
+ * @brief Register the calling task (loop()) and hook the RX events
+ *
+ * Call from setup() after Serial and radioBegin().
+ */
+void loopWakeBegin();
+
+/**
+ * @brief Wake loop() now (any task, not from an ISR)
+ */
+void loopWake();
+
+/**
+ * @brief Block until loopWake() or timeoutMs, whichever comes first
+ *
+ * Blocks at least one tick, so loop() never runs more often than before
+ * (vTaskDelay(1) per pass). timeoutMs is clamped to LOOP_MAX_WAIT_MS.
+ */
+void loopWait(uint32_t timeoutMs);
+
+const LoopWakeStats& loopWakeGetStats();
+
+#endif // LOOP_WAKE_H
@@ -82,6 +82,24 @@ public:
      */
     void setUpdateInterval(uint16_t intervalMs) { _updateInterval = intervalMs; }
 
+    /**
+     * @brief Milliseconds until update() produces new values (0 = now)
+     */
+    unsigned long msUntilUpdate() const {
+        unsigned long elapsed = millis() - _lastUpdate;
+        return elapsed >= _updateInterval ? 0 : _updateInterval - elapsed;
+    }
+
+    /**
+     * @brief Get bounds configuration for a specific field
+     *
+     * Also used by CanStress to encode realistic values into frames.
+     *
+     * @param field OutputField to look up
+     * @return Pointer to bounds, or nullptr if not configured
+     */
+    static const MockFieldBounds* getBounds(OutputField field);
+
 private:
     // Timing
     unsigned long _lastUpdate;          // Timestamp of last update
@@ -102,13 +120,6 @@ private:
      * that RadioSend reads from.
      */
     void writeToGlobalData();
-
-    /**
-     * @brief Get bounds configuration for a specific field
-     * @param field OutputField to look up
-     * @return Pointer to bounds, or nullptr if not configured
-     */
-    const MockFieldBounds* getBounds(OutputField field) const;
 };
 
 #endif // MOCK_DATA_GENERATOR_H
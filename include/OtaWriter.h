@@ -0,0 +1,130 @@
+/**
+ * @file OtaWriter.h
+ * @brief Sector-aligned, double-buffered firmware writes
+ *
+ * Received firmware bytes are collected in 4 KB buffers, one flash sector
+ * each. A full buffer is handed to the otaWriter task, which erases and
+ * programs the sector (Update.write()) and adds it to the MD5, while the
+ * serial path keeps filling the other buffer. Reception only waits when
+ * both buffers are in flight, so the transfer runs at flash speed instead
+ * of one erase per round trip.
+ *
+ * With OTA_PIPELINED=0 the same sector buffers are written inline from the
+ * caller, for comparison with the pipelined path.
+ *
+ * Update.begin() / Update.end() stay with the caller; between
+ * otaWriterBegin() and otaWriterFinish() only this module touches Update.
+ * Update.abort() belongs to otaWriterAbort(): the writer task runs it after
+ * the write in flight, so Update is never reset under a live write.
+ */
+
+#ifndef OTA_WRITER_H
+#define OTA_WRITER_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+// =============================================================================
+// CONFIGURATION (override with -D build flags)
+// =============================================================================
+
+#ifndef OTA_PIPELINED
+#define OTA_PIPELINED         1     // 1 = background writer task, 0 = inline writes
+#endif
+#ifndef OTA_SECTOR_SIZE
+#define OTA_SECTOR_SIZE       4096  // Flash erase unit, one buffer
+#endif
+#ifndef OTA_WRITER_PRIORITY
+#define OTA_WRITER_PRIORITY   2     // Above loop() (1), below canIngest (5)
+#endif
+#ifndef OTA_WRITER_STACK
+#define OTA_WRITER_STACK      4096  // Stack size in bytes
+#endif
+#ifndef OTA_WRITER_TIMEOUT_MS
+#define OTA_WRITER_TIMEOUT_MS 5000  // Max wait for a free buffer / the last write
+#endif
+
+/**
+ * @brief Transfer statistics (kept after the session for OTA STATUS)
+ */
+struct OtaWriterStats {
+    uint32_t bytes;           // Bytes accepted
+    uint32_t sectors;         // Buffers written to flash
+    uint32_t flashUs;         // Total time in Update.write() (erase + program)
+    uint32_t flashMaxUs;      // Slowest sector
+    uint32_t waitUs;          // Time the serial path waited for a free buffer
+    unsigned long startMs;    // otaWriterBegin()
+    unsigned long endMs;      // otaWriterFinish()/otaWriterAbort(), 0 while running
+};
+
+// =============================================================================
+// PUBLIC API
+// =============================================================================
+
+/**
+ * @brief Start a session (after Update.begin())
+ * @return false if the writer task could not be created, or an aborted
+ *         session is still being reset (otaWriterIsBusy())
+ */
+bool otaWriterBegin();
+
+/**
+ * @brief Accept firmware bytes
+ *
+ * Copies into the current sector buffer; hands it over when full. May wait
+ * for the writer while both buffers are busy.
+ *
+ * @return false if a previous sector failed to write (see otaWriterError())
+ *         or the writer timed out
+ */
+bool otaWriterWrite(const uint8_t* data, size_t len);
+
+/**
+ * @brief Write the last partial sector and wait for all writes
+ * @return false if any write failed
+ */
+bool otaWriterFinish();
+
+/**
+ * @brief Drop buffered data and reset Update (Update.abort())
+ *
+ * Also valid after a failed otaWriterFinish(). Pipelined, the reset is
+ * queued behind the sectors in flight and run by the writer task; waits up
+ * to OTA_WRITER_TIMEOUT_MS for it.
+ *
+ * @return false if the writer is still stuck in a write: Update is reset
+ *         when the write returns, otaWriterIsBusy() until then
+ */
+bool otaWriterAbort();
+
+/**
+ * @brief true while an aborted session waits for the writer to reset Update
+ *
+ * Do not call Update.begin() meanwhile.
+ */
+bool otaWriterIsBusy();
+
+/**
+ * @brief MD5 of everything written (valid after otaWriterFinish())
+ */
+String otaWriterMD5();
+
+/**
+ * @brief Update.errorString() of the first failed write, or nullptr
+ */
+const char* otaWriterError();
+
+/**
+ * @brief true between otaWriterBegin() and otaWriterFinish()/otaWriterAbort()
+ */
+bool otaWriterIsActive();
+
+const OtaWriterStats& otaWriterGetStats();
+
+/**
+ * @brief Writer task handle (nullptr before the first pipelined session)
+ */
+TaskHandle_t otaWriterGetTaskHandle();
+
+#endif // OTA_WRITER_H
@@ -0,0 +1,145 @@
+/**
+ * @file PerfStats.h
+ * @brief Hot-path cycle counters and latency histograms (SYS PERF)
+ *
+ * Compiled out unless PERF_STATS_ENABLED is 1 (env:esp32-c3-perf): the
+ * PERF_* macros below expand to nothing, PerfStats.cpp is empty and no
+ * counter RAM is reserved.
+ *
+ * Each stage keeps a call count, the sum and max of its CPU cycles, and a
+ * log2 histogram in microseconds: bucket 0 is < 1 µs, bucket i is
+ * [2^(i-1), 2^i) µs, the last bucket is everything longer.
+ *
+ * Stages are written by one task each (CAN_READ / PROCESS_FRAME by the
+ * ingest task, the rest by loop()), so no locking is needed. CAN_TO_UART is
+ * the time from the first decoded frame after a radio write to the next
+ * radio write: how long a CAN change waits before reaching the head unit.
+ */
+
+#ifndef PERF_STATS_H
+#define PERF_STATS_H
+
+#include <Arduino.h>
+
+// =============================================================================
+// CONFIGURATION (override with -D build flags)
+// =============================================================================
+
+#ifndef PERF_STATS_ENABLED
+#define PERF_STATS_ENABLED  0
+#endif
+#ifndef PERF_HIST_BUCKETS
+#define PERF_HIST_BUCKETS   18      // < 1 µs ... >= 65.5 ms
+#endif
+
+enum class PerfStage : uint8_t {
+    CAN_READ,           // One TWAI readFrame() from the RX queue
+    PROCESS_FRAME,      // CanConfigProcessor::processFrame()
+    CAN_TO_UART,        // Decoded frame -> next radio UART write
+    SERIAL_CMD,         // serialCommandProcess()
+    LOOP_BUSY,          // One loop() pass
+    LOOP_PERIOD,        // Start of one loop() pass to the next
+    RADIO_FLUSH,        // radioTxFlush()
+    RADIO_STEERING,     // send*Message() per head-unit message
+    RADIO_DOORS,
+    RADIO_LIGHTS,
+    RADIO_RPM,
+    RADIO_SPEED,
+    RADIO_ODOMETER,
+    RADIO_TEMP,
+    RADIO_RANGE,
+    RADIO_FUEL_INST,
+    RADIO_FUEL_AVG,
+    COUNT
+};
+
+struct PerfCounter {
+    uint32_t count;
+    uint32_t maxCycles;
+    uint64_t sumCycles;
+    uint32_t hist[PERF_HIST_BUCKETS];
+};
+
+// =============================================================================
+// PUBLIC API
+// =============================================================================
+
+/**
+ * @brief Current CPU cycle counter
+ */
+static inline uint32_t perfNow() {
+    return ESP.getCycleCount();
+}
+
+/**
+ * @brief Add one measurement to a stage
+ */
+void perfRecord(PerfStage stage, uint32_t cycles);
+
+/**
+ * @brief A CAN frame was decoded (starts CAN_TO_UART if not running)
+ */
+void perfMarkFrame();
+
+/**
+ * @brief Radio UART total after a flush (ends CAN_TO_UART if it grew)
+ */
+void perfMarkUart(uint32_t bytesWritten);
+
+/**
+ * @brief Start of a loop() pass (records LOOP_PERIOD from the previous one)
+ */
+void perfLoopStart();
+
+/**
+ * @brief Clear all counters (SYS PERF RESET)
+ */
+void perfReset();
+
+const PerfCounter& perfGet(PerfStage stage);
+const char* perfStageName(PerfStage stage);
+
+/**
+ * @brief Convert cycles to microseconds at the current CPU clock
+ */
+float perfCyclesToUs(uint64_t cycles);
+
+/**
+ * @brief Upper bound of histogram bucket i in µs (0 for the last, open bucket)
+ */
+uint32_t perfBucketLimitUs(uint8_t i);
+
+// =============================================================================
+// INSTRUMENTATION MACROS
+// =============================================================================
+
+#if PERF_STATS_ENABLED
+
+/**
+ * @brief Records the lifetime of a scope into a stage
+ */
+class PerfScope {
+public:
+    explicit PerfScope(PerfStage stage) : _stage(stage), _start(perfNow()) {}
+    ~PerfScope() { perfRecord(_stage, perfNow() - _start); }
+
+private:
+    PerfStage _stage;
+    uint32_t _start;
+};
+
+#define PERF_SCOPE(stage)        PerfScope perfScope_(PerfStage::stage)
+#define PERF_MARK_FRAME()        perfMarkFrame()
+#define PERF_MARK_UART(bytes)    perfMarkUart(bytes)
+#define PERF_LOOP_START()        perfLoopStart()
+
+#else
+
+#define PERF_SCOPE(stage)        do {} while (0)
+#define PERF_MARK_FRAME()        do {} while (0)
+#define PERF_MARK_UART(bytes)    do {} while (0)
+#define PERF_LOOP_START()        do {} while (0)
+
+#endif // PERF_STATS_ENABLED
+
+#endif // PERF_STATS_H
@@ -0,0 +1,188 @@
+/**
+ * @file ProfileIndex.h
+ * @brief On-flash index of the installed vehicle profiles and bus fingerprinting
+ *
+ * Every .json profile in the LittleFS root gets one entry in /profiles.idx:
+ * file, vehicle name, CRC32 and size of the JSON, kind (real, mock, replay)
+ * and the set of CAN IDs its "frames" decode, as a 2048-bit bitmap. The
+ * index is read at boot; every file is hashed, and only the entries whose
+ * size or CRC changed (or that appeared) are parsed again, with a filter
+ * keeping the ID list only, so
+ * listing or fingerprinting profiles never costs a full profile parse.
+ * CAN UPLOAD END and CAN DELETE update it in place.
+ *
+ * Auto-detection: at boot the CAN controller listens passively for a short
+ * window (canDriverListen()), and profileIndexMatch() scores the observed
+ * ID set against every real-CAN entry:
+ *
+ *   score = IDs of the profile seen on the bus * 1000 / IDs of the profile
+ *
+ * A profile only decodes part of what its vehicle sends, so IDs seen but
+ * not in the profile do not count against it. The best score wins, ties
+ * going to the profile matching more IDs (a superset profile of the same
+ * vehicle). A match needs AUTODETECT_MIN_SCORE and AUTODETECT_MIN_MATCHES,
+ * so a silent or unknown bus keeps the saved profile.
+ */
+
+#ifndef PROFILE_INDEX_H
+#define PROFILE_INDEX_H
+
+#include <Arduino.h>
+#include "VehicleConfig.h"
+
+// =============================================================================
+// INDEX CONFIGURATION
+// =============================================================================
+
+#define PROFILE_INDEX_PATH      "/profiles.idx"
+#ifndef PROFILE_INDEX_MAX
+#define PROFILE_INDEX_MAX       16      // Profiles indexed, further files are ignored
+#endif
+#define PROFILE_INDEX_FILE_SIZE 32      // "/name.json", including the terminator
+#define PROFILE_ID_BITMAP_SIZE  256     // One bit per 11-bit standard CAN ID
+
+// Entry flags
+#define PROFILE_FLAG_MOCK       0x01    // "isMock": true
+#define PROFILE_FLAG_REPLAY     0x02    // Has a "replay" log
+#define PROFILE_FLAG_INVALID    0x04    // Not a usable profile (parse error, no frames)
+
+// =============================================================================
+// AUTO-DETECTION CONFIGURATION (override with -D build flags)
+// =============================================================================
+
+#ifndef PROFILE_AUTODETECT
+#define PROFILE_AUTODETECT      1       // 0 = always boot the saved profile
+#endif
+#ifndef AUTODETECT_WINDOW_MS
+#define AUTODETECT_WINDOW_MS    500     // Passive listen window at boot
+#endif
+#ifndef AUTODETECT_SILENCE_MS
+#define AUTODETECT_SILENCE_MS   150     // Window ends early if no frame came by then
+#endif
+#ifndef AUTODETECT_MIN_SCORE
+#define AUTODETECT_MIN_SCORE    700     // Per mille of the profile's IDs seen on the bus
+#endif
+#ifndef AUTODETECT_MIN_MATCHES
+#define AUTODETECT_MIN_MATCHES  2       // Profile IDs that must be seen
+#endif
+
+/**
+ * @brief One installed profile
+ */
+struct ProfileIndexEntry {
+    char     file[PROFILE_INDEX_FILE_SIZE];  // Path on LittleFS ("/NissanJukeF15.json")
+    char     name[PROFILE_NAME_SIZE];        // "name" of the profile
+    uint32_t jsonCrc;                        // crc32_le(0, JSON file)
+    uint32_t jsonSize;
+    uint16_t idCount;                        // Bits set in ids
+    uint8_t  flags;                          // PROFILE_FLAG_*
+    uint8_t  reserved;
+    uint8_t  ids[PROFILE_ID_BITMAP_SIZE];    // Bit (id & 7) of ids[id >> 3]: frame configured
+};
+
+/**
+ * @brief Result of scoring an observed ID set against the index
+ */
+struct ProfileMatch {
+    char     file[PROFILE_INDEX_FILE_SIZE];  // Best real-CAN profile, "" = none indexed
+    uint16_t score;         // Its score (per mille)
+    uint16_t matches;       // Its IDs seen on the bus
+    uint16_t observedIds;   // Distinct IDs seen on the bus
+    uint16_t runnerUp;      // Score of the second best real-CAN profile
+    bool     accepted;      // Best profile reaches the detection thresholds
+};
+
+/**
+ * @brief Cost of the last profileIndexBegin()
+ */
+struct ProfileIndexStats {
+    uint8_t  entries;       // Profiles indexed
+    uint8_t  parsed;        // Entries (re)built from their JSON
+    bool     fromFile;      // /profiles.idx was valid
+    uint32_t syncUs;        // Read + check + rebuild + write
+};
+
+// =============================================================================
+// PUBLIC API
+// =============================================================================
+
+/**
+ * @brief Load /profiles.idx and bring it in line with the filesystem
+ *
+ * Entries of deleted files are dropped, new or resized files are indexed,
+ * and the index is written back if anything changed. LittleFS must be
+ * mounted (CanConfigProcessor::begin()).
+ *
+ * @return Number of profiles indexed
+ */
+uint8_t profileIndexBegin();
+
+/**
+ * @brief (Re)index one profile file and write the index
+ * @param path Path of the JSON file ("/name.json")
+ * @return false if the index is full or cannot be written
+ */
+bool profileIndexUpdate(const char* path);
+
+/**
+ * @brief Drop the entry of a deleted profile and write the index
+ * @return true if an entry was removed
+ */
+bool profileIndexRemove(const char* path);
+
+/**
+ * @brief Get the number of indexed profiles
+ */
+uint8_t profileIndexCount();
+
+/**
+ * @brief Get an entry (nullptr if out of range)
+ */
+const ProfileIndexEntry* profileIndexGet(uint8_t index);
+
+/**
+ * @brief Find the entry of a file, with or without the leading '/'
+ */
+const ProfileIndexEntry* profileIndexFind(const char* path);
+
+/**
+ * @brief Fill an entry from a JSON profile (filtered parse of the ID list)
+ * @param path Path of the JSON file
+ * @param entry Entry to fill; flagged PROFILE_FLAG_INVALID if unusable
+ * @return false if the file cannot be read
+ */
+bool profileIndexBuildEntry(const char* path, ProfileIndexEntry& entry);
+
+/**
+ * @brief Score a profile ID bitmap against the IDs seen on the bus
+ * @param profileIds Bitmap of the profile
+ * @param idCount Bits set in profileIds
+ * @param observed Bitmap of the IDs seen
+ * @param matches Set to the number of profile IDs seen
+ * @return Per mille of the profile IDs seen (0 for an empty profile)
+ */
+uint16_t profileFingerprintScore(const uint8_t* profileIds, uint16_t idCount,
+                                 const uint8_t* observed, uint16_t& matches);
+
+/**
+ * @brief Pick the real-CAN profile best matching the IDs seen on the bus
+ *
+ * Mock, replay and invalid entries never match. The result is kept for
+ * profileIndexGetLastMatch().
+ *
+ * @param observed Bitmap of the IDs seen (PROFILE_ID_BITMAP_SIZE bytes)
+ * @return Best match, accepted only if it reaches the thresholds
+ */
+const ProfileMatch& profileIndexMatch(const uint8_t* observed);
+
+/**
+ * @brief Get the result of the last profileIndexMatch() (all zero if none ran)
+ */
+const ProfileMatch& profileIndexGetLastMatch();
+
+/**
+ * @brief Get the cost of the last profileIndexBegin()
+ */
+const ProfileIndexStats& profileIndexGetStats();
+
+#endif // PROFILE_INDEX_H
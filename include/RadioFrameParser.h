@@ -0,0 +1,149 @@
+/**
+ * @file RadioFrameParser.h
+ * @brief Incremental parser for the 0x2E head-unit protocol (RX side)
+ *
+ * Bytes are appended to a ring buffer (directly from the UART with pump(),
+ * or with feed()) and next() hands out one event at a time:
+ *
+ *   FRAME         0x2E cmd len payload checksum, checksum OK
+ *   ACK / NACK    single 0xFF / 0xF0 byte between frames
+ *   BAD_CHECKSUM  a header whose checksum failed; the parser resynchronizes
+ *                 on the next 0x2E after that header byte
+ *
+ * Frames are not copied: RadioFrameView points into the ring buffer (two
+ * segments when the frame wraps) and stays valid until the next call to
+ * next() or reset(). Each instance is independent, so the head-unit UART
+ * and the v1.9 passthrough input can each own one.
+ *
+ * Every next() call is O(bytes consumed), and a frame's checksum is only
+ * computed once all of it is buffered, so a partial frame costs nothing
+ * until the rest arrives.
+ */
+
+#ifndef RADIO_FRAME_PARSER_H
+#define RADIO_FRAME_PARSER_H
+
+#include <Arduino.h>
+
+// =============================================================================
+// CONFIGURATION (override with -D build flags)
+// =============================================================================
+
+#ifndef RADIO_RX_BUFFER
+#define RADIO_RX_BUFFER 512     // Ring size (power of two, > max frame of 259 B)
+#endif
+
+static_assert((RADIO_RX_BUFFER & (RADIO_RX_BUFFER - 1)) == 0, "RADIO_RX_BUFFER must be a power of two");
+static_assert(RADIO_RX_BUFFER > 259, "RADIO_RX_BUFFER must hold the largest frame");
+
+// Protocol bytes
+#define RADIO_FRAME_HEADER 0x2E
+#define RADIO_ACK          0xFF
+#define RADIO_NACK         0xF0
+
+// =============================================================================
+// TYPES
+// =============================================================================
+
+enum class RadioParseResult : uint8_t {
+    NONE,           // Need more bytes
+    FRAME,          // Valid frame in the view
+    ACK,
+    NACK,
+    BAD_CHECKSUM    // Frame rejected, resynchronizing
+};
+
+/**
+ * @brief Zero-copy view of one frame inside the parser ring
+ *
+ * seg[0]/seg[1] cover the whole frame (header to checksum); seg[1] is only
+ * used when the frame wraps around the end of the ring.
+ */
+struct RadioFrameView {
+    uint8_t        cmd;
+    uint8_t        len;         // Payload length
+    const uint8_t* seg[2];
+    uint16_t       segLen[2];
+
+    /** @brief Total frame size (len + 4) */
+    uint16_t size() const { return segLen[0] + segLen[1]; }
+
+    /** @brief Byte i of the frame (0 = header) */
+    uint8_t at(uint16_t i) const {
+        return i < segLen[0] ? seg[0][i] : seg[1][i - segLen[0]];
+    }
+
+    /** @brief Payload byte i */
+    uint8_t payload(uint8_t i) const { return at(3 + i); }
+
+    /** @brief Copy the whole frame out (dst must hold size() bytes) */
+    void copyTo(uint8_t* dst) const {
+        memcpy(dst, seg[0], segLen[0]);
+        if (segLen[1]) memcpy(dst + segLen[0], seg[1], segLen[1]);
+    }
+};
+
+struct RadioParserStats {
+    uint32_t bytesIn;
+    uint32_t frames;
+    uint32_t acks;
+    uint32_t nacks;
+    uint32_t badChecksums;
+    uint32_t junkBytes;     // Bytes skipped outside any frame
+    uint32_t overflows;     // feed()/pump() calls that found the ring full
+};
+
+// =============================================================================
+// PARSER
+// =============================================================================
+
+class RadioFrameParser {
+public:
+    RadioFrameParser();
+
+    /**
+     * @brief Append bytes to the ring
+     * @return Bytes accepted (less than len if the ring is full)
+     */
+    size_t feed(const uint8_t* data, size_t len);
+
+    /**
+     * @brief Move bytes already received by the UART driver into the ring
+     *
+     * Reads at most what available() reports and what fits, so it never
+     * blocks. Bytes that do not fit stay in the driver.
+     *
+     * @return Bytes read
+     */
+    size_t pump(HardwareSerial& port);
+
+    /**
+     * @brief Parse the next event
+     *
+     * Releases the frame returned by the previous call. On FRAME, the view
+     * is filled and stays valid until the next call.
+     */
+    RadioParseResult next(RadioFrameView& frame);
+
+    /** @brief Drop buffered bytes and statistics */
+    void reset();
+
+    /** @brief Bytes waiting in the ring (including an unreleased frame) */
+    uint16_t getBuffered() const { return _head - _tail; }
+
+    const RadioParserStats& getStats() const { return _stats; }
+
+private:
+    static const uint16_t MASK = RADIO_RX_BUFFER - 1;
+
+    uint8_t at(uint16_t offset) const { return _buf[(_tail + offset) & MASK]; }
+
+    uint8_t  _buf[RADIO_RX_BUFFER];
+    uint16_t _head;         // Free-running write index
+    uint16_t _tail;         // Free-running read index
+    uint16_t _release;      // Size of the frame handed out by the last next()
+    uint16_t _noAck;        // Bytes of a rejected frame: not ACK/NACK candidates
+    RadioParserStats _stats;
+};
+
+#endif
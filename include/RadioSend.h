@@ -4,20 +4,130 @@
  * 
  * Declares the main function for sending vehicle data to the Android head unit
  * using the VW Polo UART protocol.
+ *
+ * Frames are queued in the RadioTx priority scheduler (see RadioTx.h) and
+ * flushed once per pass without blocking.
  */
 
 #ifndef RADIO_SEND_H
 #define RADIO_SEND_H
 
+#include <Arduino.h>
+#include "RadioTx.h"
+#include "RadioFrameParser.h"
+#include "LatencyHistogram.h"
+
+// =============================================================================
+// HARDWARE CONFIGURATION
+// =============================================================================
+
+#define RADIO_TX_PIN 5      // ESP32 -> head unit RX
+#define RADIO_RX_PIN 6      // Head unit TX -> ESP32
+#define RADIO_BAUD   RADIO_LINK_BAUD
+
+// =============================================================================
+// CONFIGURATION (override with build flags)
+// =============================================================================
+
+/**
+ * 1 = send each command when its signal changes (minimum spacing + slower
+ *     keep-alive, see RadioSend.cpp); 0 = fixed send intervals.
+ */
+#ifndef RADIO_CHANGE_DRIVEN
+#define RADIO_CHANGE_DRIVEN 1
+#endif
+
+#ifndef RADIO_UART_TX_BUFFER
+#define RADIO_UART_TX_BUFFER  256   // UART driver TX buffer on top of the 128 B FIFO
+#endif
+#ifndef RADIO_STRETCH_FACTOR
+#define RADIO_STRETCH_FACTOR  4     // Slow-interval multiplier while the link is saturated
+#endif
+#ifndef RADIO_DRAIN_POLL_MS
+#define RADIO_DRAIN_POLL_MS   2     // Next pass while frames wait for UART room (~7 bytes at 38400)
+#endif
+
+// =============================================================================
+// PUBLIC API
+// =============================================================================
+
+/**
+ * @brief Configure and start the radio UART
+ */
+void radioBegin();
+
+/**
+ * @brief Head-unit input statistics (frames, ACK/NACK, checksum errors)
+ */
+const RadioParserStats& radioGetRxStats();
+
+/**
+ * @brief millis() of the last ACK received from the head unit (0 = never)
+ */
+unsigned long radioGetLastAckTime();
+
 /**
  * @brief Process and send all pending vehicle data updates to the radio
  * 
  * This function should be called from the main loop. It handles:
- * - Protocol handshake with the head unit
- * - Steering wheel angle updates (100ms interval)
- * - Dashboard data: RPM, speed, battery, temperature, fuel (400ms interval)
- * - Door status updates (on change only)
+ * - Head-unit input: ACK/NACK tracking, replies to host frames
+ * - Steering wheel angle, doors and lights (on change, fast)
+ * - Dashboard data: RPM, speed, temperature, fuel, range, odometer
+ *
+ * With RADIO_CHANGE_DRIVEN, commands follow the GlobalData dirty set.
+ * All frames due in one pass are coalesced and flushed as one burst; slow
+ * telemetry is stretched by RADIO_STRETCH_FACTOR while the link is saturated.
  */
 void processRadioUpdates();
 
+/**
+ * @brief Send every command on the next pass (head unit just powered up)
+ */
+void radioResync();
+
+/**
+ * @brief Milliseconds until processRadioUpdates() has something to send
+ *
+ * Earliest of: the next command due by its spacing or keep-alive, a blinker
+ * timing out, or RADIO_DRAIN_POLL_MS while frames wait for UART room.
+ * Signals that change later wake loop() through the dirty set instead.
+ *
+ * @return 0 if a command is due now
+ */
+unsigned long radioNextDueMs();
+
+// =============================================================================
+// LATENCY TRACING (SYS LAT)
+// =============================================================================
+
+/**
+ * @brief Number of radio commands with a latency histogram
+ */
+uint8_t radioLatencySlotCount();
+
+/**
+ * @brief Short command name for a slot ("STEERING", "RPM", ...)
+ */
+const char* radioLatencySlotName(uint8_t slot);
+
+/**
+ * @brief CAN-frame-to-UART age of every change sent by one command (µs)
+ *
+ * Recorded after the flush that writes the command, so it includes the
+ * decode, the wait for the send schedule and the pass itself. Keep-alive
+ * resends are not counted.
+ */
+const LatencyHistogram& radioGetLatency(uint8_t slot);
+
+/**
+ * @brief Clear all latency histograms
+ */
+void radioLatencyReset();
+
+/**
+ * @brief Print "LAT <command> <us>" on USB serial for every recorded sample
+ */
+void radioSetLatencyTrace(bool enabled);
+bool radioIsLatencyTracing();
+
 #endif
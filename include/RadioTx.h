@@ -0,0 +1,163 @@
+/**
+ * @file RadioTx.h
+ * @brief Priority-aware TX scheduler for the head-unit UART
+ *
+ * Every frame sent to the head unit goes through one of four class queues:
+ *
+ *   SAFETY    > STEERING > LIGHTS > TELEMETRY
+ *   (parking/   (camera    (lights,  (RPM, speed, fuel, range,
+ *    BSD, ext)   lines)     doors)    temperature, odometer)
+ *
+ * radioTxFlush() hands frames to the UART in priority order, whole frames
+ * only (a started frame is always finished first, so sources never
+ * interleave at byte level), and never more than the driver accepts
+ * without blocking.
+ *
+ * Starvation guard: a frame waiting longer than RADIO_STARVATION_MS is
+ * served ahead of higher classes. Link utilization is measured over
+ * RADIO_UTIL_WINDOW_MS windows; above RADIO_SATURATION_PCT the link is
+ * reported saturated and RadioSend stretches its slow intervals.
+ *
+ * External frames (v1.9 passthrough) enter with radioTxQueueRaw().
+ * One-byte ACK/NACK replies to the head unit (radioTxQueueAck()) go out at
+ * the next frame boundary, ahead of every class.
+ */
+
+#ifndef RADIO_TX_H
+#define RADIO_TX_H
+
+#include <Arduino.h>
+
+// =============================================================================
+// CONFIGURATION (override with -D build flags)
+// =============================================================================
+
+#ifndef RADIO_TX_QUEUE_BYTES
+#define RADIO_TX_QUEUE_BYTES   256   // Ring size per class (bytes)
+#endif
+#ifndef RADIO_TX_QUEUE_FRAMES
+#define RADIO_TX_QUEUE_FRAMES  32    // Max frames waiting per class
+#endif
+#ifndef RADIO_STARVATION_MS
+#define RADIO_STARVATION_MS    250   // Oldest frame served first past this age
+#endif
+#ifndef RADIO_UTIL_WINDOW_MS
+#define RADIO_UTIL_WINDOW_MS   500   // Link utilization measurement window
+#endif
+#ifndef RADIO_SATURATION_PCT
+#define RADIO_SATURATION_PCT   80    // Utilization considered saturated
+#endif
+#ifndef RADIO_TX_ACK_SLOTS
+#define RADIO_TX_ACK_SLOTS     8     // ACK/NACK bytes waiting for a frame boundary
+#endif
+#ifndef RADIO_LINK_BAUD
+#define RADIO_LINK_BAUD        38400
+#endif
+
+// 8N1: 10 bits on the wire per byte
+#define RADIO_LINK_BYTES_PER_SEC (RADIO_LINK_BAUD / 10)
+
+/**
+ * @brief Scheduling class, highest priority first
+ */
+enum class RadioClass : uint8_t {
+    SAFETY,         // Parking sensors, blind spot (external canbox)
+    STEERING,       // Steering angle (camera guidelines)
+    LIGHTS,         // Lights, indicators, doors
+    TELEMETRY,      // RPM, speed, fuel, temperature, range, odometer
+    COUNT
+};
+
+/**
+ * @brief Per-class statistics
+ */
+struct RadioClassStats {
+    uint32_t framesQueued;    // Frames accepted into the class queue
+    uint32_t framesSent;      // Frames fully handed to the UART
+    uint32_t framesDropped;   // Frames rejected (queue full)
+    uint32_t bytesSent;
+    uint32_t latencySumMs;    // Queue-to-UART latency of sent frames
+    uint16_t latencyMaxMs;
+    uint16_t queueHighWater;  // Most bytes waiting
+    uint32_t promotions;      // Frames served early by the starvation guard
+};
+
+/**
+ * @brief Link-wide statistics
+ */
+struct RadioTxStats {
+    uint32_t bytesWritten;    // Bytes handed to the UART driver
+    uint32_t bursts;          // Flushes that wrote at least one byte
+    uint16_t maxBurst;        // Largest single flush (bytes)
+    uint32_t blockedUs;       // Total time spent inside UART write calls
+    uint8_t  utilization;     // % of link capacity used in the last window
+    uint8_t  peakUtilization; // Highest window utilization seen
+    uint32_t saturatedWindows;// Windows at or above RADIO_SATURATION_PCT
+    uint32_t acksSent;        // ACK/NACK bytes written
+    uint32_t firstFrameMs;    // millis() when the first frame was fully written, 0 = none yet
+};
+
+// =============================================================================
+// PUBLIC API
+// =============================================================================
+
+/**
+ * @brief Build a 0x2E frame in place in the class queue
+ *
+ * Checksum = (cmd + len + payload...) XOR 0xFF.
+ *
+ * @return false if the queue is full (frame dropped and counted)
+ */
+bool radioTxQueue(RadioClass cls, uint8_t cmd, const uint8_t* payload, uint8_t len);
+
+/**
+ * @brief Queue an already complete 0x2E frame (external source)
+ * @param frame Header, cmd, len, payload, checksum
+ * @param size  Total frame size; must equal frame[2] + 4
+ * @return false if malformed or the queue is full
+ */
+bool radioTxQueueRaw(RadioClass cls, const uint8_t* frame, uint8_t size);
+
+/**
+ * @brief Queue a one-byte ACK (0xFF) or NACK (0xF0) reply
+ *
+ * Sent before any further frame, but never inside one.
+ *
+ * @return false if RADIO_TX_ACK_SLOTS replies are already waiting
+ */
+bool radioTxQueueAck(uint8_t code);
+
+/**
+ * @brief Send queued frames in priority order without blocking
+ */
+void radioTxFlush();
+
+/**
+ * @brief true when the last utilization window reached RADIO_SATURATION_PCT
+ */
+bool radioTxIsSaturated();
+
+/**
+ * @brief Bytes waiting in all class queues
+ */
+uint16_t radioTxGetPending();
+
+/**
+ * @brief Bytes waiting in one class queue
+ */
+uint16_t radioTxGetPending(RadioClass cls);
+
+const RadioTxStats& radioTxGetStats();
+const RadioClassStats& radioTxGetClassStats(RadioClass cls);
+
+/**
+ * @brief Short class name for status output ("SAFETY", "STEER", ...)
+ */
+const char* radioTxClassName(RadioClass cls);
+
+/**
+ * @brief Clear all queues and statistics
+ */
+void radioTxReset();
+
+#endif
@@ -30,7 +30,7 @@
 
 #define CMD_BUFFER_SIZE     320  // Max command length (16 prefix + 240 base64 + 1 null + margin)
 #define CMD_PROMPT          "> " // Command prompt (optional)
-#define CAN_UPLOAD_MAX_SIZE 8192 // Max JSON config file size (8KB)
+#define CAN_UPLOAD_MAX_SIZE 65536 // Max JSON config file size (64KB, streamed to LittleFS)
 
 // =============================================================================
 // PUBLIC API
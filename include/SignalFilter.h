@@ -0,0 +1,85 @@
+/**
+ * @file SignalFilter.h
+ * @brief Per-field smoothing between decode and GlobalData (JSON "filter")
+ *
+ * Jittery signals (steering angle, speed, a sloshing fuel gauge) would
+ * otherwise make every frame a change: the head unit redraws constantly
+ * and the change-driven radio path spends UART time on noise. A filtered
+ * field runs its converted value through, in order:
+ *
+ * 1. median of the last `median` values (drops single-frame spikes)
+ * 2. exponential average: avg += (value - avg) / 2^emaShift
+ * 3. deadband: a value closer than `deadband` to the published one is held
+ * 4. rate limit: at most one published change every `minIntervalMs`
+ *
+ * Only a published value reaches GlobalData and can mark it dirty. A held
+ * change is published by a later frame of the same ID once it passes the
+ * deadband / interval, so a steady signal always settles.
+ *
+ * Integer math only (the average is Q16 fixed point), no allocation.
+ * Called from the ingest task only.
+ */
+
+#ifndef SIGNAL_FILTER_H
+#define SIGNAL_FILTER_H
+
+#include <Arduino.h>
+#include "VehicleConfig.h"
+
+// =============================================================================
+// CONFIGURATION
+// =============================================================================
+
+#define FILTER_MEDIAN_MAX     5     // Longest median window
+#define FILTER_EMA_MAX_SHIFT  8     // Slowest average: weight 1/256
+#define FILTER_EMA_FRAC_BITS  16    // Fixed-point fraction of the average
+
+// =============================================================================
+// SIGNAL FILTER CLASS
+// =============================================================================
+
+class SignalFilter {
+public:
+    /**
+     * @brief Take a configuration and forget all previous values
+     */
+    void begin(const FieldFilterConfig& config);
+
+    /**
+     * @brief Feed one converted value
+     * @param value Value after the field formula
+     * @param nowMs Current time in ms
+     * @param out Value to publish when returning true
+     * @return true if out differs from the published value and may be stored
+     */
+    bool apply(int32_t value, uint32_t nowMs, int32_t& out);
+
+    /**
+     * @brief Clamp a configuration to the supported ranges
+     * @return false if every stage is disabled (no filter needed)
+     */
+    static bool sanitize(FieldFilterConfig& config);
+
+    const FieldFilterConfig& getConfig() const { return _config; }
+
+    /**
+     * @brief Changes held back by the deadband or the rate limit
+     */
+    uint32_t getHeld() const { return _held; }
+
+private:
+    int32_t median(int32_t value);
+
+    FieldFilterConfig _config;
+    int32_t _window[FILTER_MEDIAN_MAX];  // Last values, ring buffer
+    bool _windowFull;                    // Primed with the first value
+    uint8_t _windowHead;
+    bool _averaging;                     // _average holds a value
+    bool _published;                     // _last holds a value
+    int64_t _average;                    // Q(FILTER_EMA_FRAC_BITS)
+    int32_t _last;                       // Last published value
+    uint32_t _lastMs;                    // ... and when
+    uint32_t _held;
+};
+
+#endif // SIGNAL_FILTER_H
@@ -0,0 +1,97 @@
+/**
+ * @file Standby.h
+ * @brief Ignition-off standby: TWAI parked, light-sleep, wake on CAN activity
+ *
+ * After CAN_STANDBY_TIMEOUT_MS of bus silence (ignition off) loop() calls
+ * standbyEnter() instead of rebooting. The controller is uninstalled, the
+ * CAN RX pin (GPIO20, recessive high) is armed as a low-level wake source
+ * and the chip light-sleeps. RAM is kept: the compiled profile, GlobalData
+ * and the calibration stay loaded, so on wake the controller is reinstalled
+ * and decoding resumes within milliseconds. The frame that woke the chip
+ * is lost (the controller was off).
+ *
+ * A wake with no frame decoded within STANDBY_WAKE_GRACE_MS (noise on the
+ * bus) goes back to sleep. Light-sleep drops the USB link, so it is skipped
+ * while a host has the serial port open: the controller stays up and the
+ * silence timer simply restarts.
+ *
+ * Timing of each wake is kept for SYS INFO: wake to first decoded frame,
+ * and wake to the first steering frame written to the head unit
+ * ("key-on to steering").
+ */
+
+#ifndef STANDBY_H
+#define STANDBY_H
+
+#include <Arduino.h>
+
+// =============================================================================
+// CONFIGURATION (override with -D build flags)
+// =============================================================================
+
+#ifndef CAN_STANDBY_TIMEOUT_MS
+#define CAN_STANDBY_TIMEOUT_MS  30000   // Bus silence before standby (ignition off)
+#endif
+#ifndef STANDBY_WAKE_GRACE_MS
+#define STANDBY_WAKE_GRACE_MS   2000    // A wake without a frame by then was noise
+#endif
+
+/**
+ * @brief Standby counters and last wake timing
+ */
+struct StandbyStats {
+    uint32_t entries;             // Light-sleeps entered
+    uint32_t spuriousWakes;       // Wakes without a frame within the grace time
+    uint32_t skippedUsb;          // Silence timeouts with the USB port open (no sleep)
+    uint64_t sleptMs;             // Total time in light-sleep
+    uint32_t lastWakeToFrameMs;   // Wake -> first decoded frame
+    uint32_t lastWakeToSteerMs;   // Wake -> first steering frame on the head-unit UART
+    uint32_t bestWakeToSteerMs;   // Fastest and slowest of all wakes
+    uint32_t worstWakeToSteerMs;
+};
+
+// =============================================================================
+// PUBLIC API
+// =============================================================================
+
+/**
+ * @brief Has the bus been silent long enough for standby?
+ *
+ * CAN_STANDBY_TIMEOUT_MS since the last frame (or since the last wake /
+ * skipped standby), or STANDBY_WAKE_GRACE_MS after a wake that has not
+ * produced a frame yet.
+ *
+ * @param lastFrameMs millis() of the last decoded CAN frame
+ */
+bool standbyDue(uint32_t lastFrameMs);
+
+/**
+ * @brief Park the controller and light-sleep until CAN activity
+ *
+ * Returns after a wake with the controller running again, or at once
+ * (no sleep) while the USB port is open. Called from loop().
+ */
+void standbyEnter();
+
+/**
+ * @brief Woken, no frame decoded yet (the ingest task wakes loop() on the first)
+ */
+bool standbyAwaitingFrame();
+
+/**
+ * @brief Track the resume after a wake (call every loop() pass)
+ *
+ * @param lastFrameMs millis() of the last decoded CAN frame
+ * @return true once per wake, on the pass where the first frame after it
+ *         was decoded: the radio output should be refreshed in full
+ */
+bool standbyCheckResume(uint32_t lastFrameMs);
+
+/**
+ * @brief The pass that resumed has flushed its radio frames (steering timing)
+ */
+void standbyResumeSent();
+
+const StandbyStats& standbyGetStats();
+
+#endif // STANDBY_H
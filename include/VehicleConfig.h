@@ -14,6 +14,8 @@
  * │ {                                                               │
  * │   "name": "Vehicle Name",                                       │
  * │   "isMock": false,         // true = simulate data              │
+ * │   "replay": { "file": "/drive.log", "speed": 1, "loop": true }, │
+ * │                            // optional: recorded log, no bus    │
  * │   "frames": [                                                   │
  * │     {                                                           │
  * │       "canId": "0x180",                                         │
@@ -22,7 +24,8 @@
  * │           "target": "ENGINE_RPM",                               │
  * │           "startByte": 0, "byteCount": 2,                       │
  * │           "byteOrder": "BE", "dataType": "UINT16",              │
- * │           "formula": "SCALE", "params": [1, 7, 0]               │
+ * │           "formula": "SCALE", "params": [1, 7, 0],              │
+ * │           "filter": { "median": 3, "deadband": 20 }  // optional│
  * │         }                                                       │
  * │       ]                                                         │
  * │     }                                                           │
@@ -35,13 +38,38 @@
  * - SCALE:          (value * mult / div) + offset  [params: mult, div, offset]
  * - MAP_RANGE:      map(value, inMin, inMax, outMin, outMax)
  * - BITMASK_EXTRACT: (value & mask) >> shift      [params: mask, shift]
+ *
+ * Optional per-field filter (SignalFilter.h), applied after the formula:
+ * - median:        median of the last N values, N <= FILTER_MEDIAN_MAX
+ * - emaShift:      exponential average, weight 1/2^n, n <= FILTER_EMA_MAX_SHIFT
+ * - deadband:      changes smaller than this are not published
+ * - minIntervalMs: at most one published change per interval
  */
 
 #ifndef VEHICLE_CONFIG_H
 #define VEHICLE_CONFIG_H
 
 #include <Arduino.h>
-#include <vector>
+
+// =============================================================================
+// PROFILE CAPACITY (override with -D build flags)
+// =============================================================================
+
+#ifndef PROFILE_MAX_FRAMES
+#define PROFILE_MAX_FRAMES  64      // CAN IDs per profile
+#endif
+#ifndef PROFILE_MAX_FIELDS
+#define PROFILE_MAX_FIELDS  128     // Fields per profile, all frames together
+#endif
+#ifndef PROFILE_NAME_SIZE
+#define PROFILE_NAME_SIZE   48      // Vehicle name, including the terminator
+#endif
+#ifndef PROFILE_MAX_FILTERS
+#define PROFILE_MAX_FILTERS 16      // Fields with a "filter" per profile
+#endif
+#ifndef PROFILE_REPLAY_PATH_SIZE
+#define PROFILE_REPLAY_PATH_SIZE 32 // Replay log path, including the terminator
+#endif
 
 // =============================================================================
 // DATA TYPE DEFINITIONS
@@ -141,20 +169,39 @@ struct FieldConfig {
     ByteOrder   byteOrder;    // Byte ordering for multi-byte values
     DataType    dataType;     // How to interpret the extracted bytes
     FormulaType formula;      // Conversion formula to apply
+    uint8_t     filter;       // 1 + index in VehicleProfile::filters, 0 = unfiltered
     int32_t     params[4];    // Formula parameters:
                               //   SCALE: [multiplier, divisor, offset, unused]
                               //   MAP_RANGE: [inMin, inMax, outMin, outMax]
                               //   BITMASK_EXTRACT: [mask, shift, unused, unused]
 };
 
+static_assert(sizeof(FieldConfig) == 24, "FieldConfig should stay packed (7 x uint8_t + 4 x int32_t)");
+
+/**
+ * @brief Smoothing / rate limiting of one field (JSON "filter" object)
+ *
+ * Stages run in this order; a zero disables a stage. See SignalFilter.h.
+ */
+struct FieldFilterConfig {
+    int32_t  deadband;        // Min change from the published value
+    uint16_t minIntervalMs;   // Min time between two published changes
+    uint8_t  median;          // Median window length (0/1 = off)
+    uint8_t  emaShift;        // EMA weight 1/2^emaShift
+};
+
+static_assert(PROFILE_MAX_FILTERS <= 255, "FieldConfig::filter indexes filters in a uint8_t");
+
 /**
  * @brief Defines a CAN frame and all its extractable fields
  *
- * Groups all data fields that share the same CAN identifier.
+ * Groups all data fields that share the same CAN identifier. The fields
+ * themselves live in VehicleProfile::fields, stored frame after frame.
  */
 struct FrameConfig {
-    uint16_t canId;                    // CAN identifier (11-bit standard, 0x000-0x7FF)
-    std::vector<FieldConfig> fields;   // Fields to extract from this frame
+    uint16_t canId;         // CAN identifier (11-bit standard, 0x000-0x7FF)
+    uint16_t firstField;    // Index of the frame's first field in VehicleProfile::fields
+    uint16_t fieldCount;    // Number of fields of this frame
 };
 
 /**
@@ -162,12 +209,45 @@ struct FrameConfig {
  *
  * Represents all CAN frames and fields for a specific vehicle.
  * Loaded from JSON file on SPIFFS at startup.
+ *
+ * Fixed-size arena: one frames array and one fields array sorted by frame,
+ * so loading a profile never allocates and a reload reuses the same memory.
+ * Profiles larger than PROFILE_MAX_FRAMES / PROFILE_MAX_FIELDS are rejected
+ * at load time.
  */
 struct VehicleProfile {
-    String name;                       // Vehicle name for logging/identification
+    char name[PROFILE_NAME_SIZE];      // Vehicle name for logging/identification
     bool isMock;                       // true = mock mode (generate simulated data)
                                        // false = real CAN mode (read from bus)
-    std::vector<FrameConfig> frames;   // All CAN frames to process
+    char replayFile[PROFILE_REPLAY_PATH_SIZE]; // Recorded log fed instead of the bus, "" = none
+    uint16_t replaySpeed;              // 1 = original timing, N = N times faster, 0 = no delays
+    bool replayLoop;                   // Restart the log at its end
+    uint16_t frameCount;               // Entries used in frames[]
+    uint16_t fieldCount;               // Entries used in fields[]
+    uint8_t filterCount;               // Entries used in filters[]
+    FrameConfig frames[PROFILE_MAX_FRAMES];  // All CAN frames to process
+    FieldConfig fields[PROFILE_MAX_FIELDS];  // Fields of all frames, in frame order
+    FieldFilterConfig filters[PROFILE_MAX_FILTERS];  // Referenced by FieldConfig::filter
+
+    void clear() {
+        name[0] = '\0';
+        isMock = false;
+        replayFile[0] = '\0';
+        replaySpeed = 1;
+        replayLoop = false;
+        frameCount = 0;
+        fieldCount = 0;
+        filterCount = 0;
+    }
+
+    /** @brief First field of a frame (fieldCount entries follow) */
+    const FieldConfig* fieldsOf(const FrameConfig& frame) const { return &fields[frame.firstField]; }
+
+    /** @brief Arena bytes holding the loaded profile */
+    size_t bytesUsed() const {
+        return sizeof(name) + frameCount * sizeof(FrameConfig) + fieldCount * sizeof(FieldConfig)
+             + filterCount * sizeof(FieldFilterConfig);
+    }
 };
 
 // =============================================================================
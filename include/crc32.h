@@ -0,0 +1,22 @@
+#ifndef CRC32_H
+#define CRC32_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @brief CRC32 (polynomial 0xEDB88320, reflected), init and final XOR left
+ *        to the caller.
+ *
+ * crc32_le(0, data, len) is what the OTA protocol uses (Android OtaProtocol.kt,
+ * Python binascii.crc32(data, 0)). Chainable:
+ * crc32_le(crc32_le(0, a, n), b, m) == crc32_le(0, a+b, n+m).
+ *
+ * @param crc  Running CRC (0 to start)
+ * @param buf  Data
+ * @param len  Number of bytes
+ * @return Updated CRC
+ */
+uint32_t crc32_le(uint32_t crc, const uint8_t* buf, size_t len);
+
+#endif // CRC32_H
@@ -0,0 +1,145 @@
+/**
+ * @file BinaryFrame.cpp
+ * @brief Length-prefixed, CRC32-protected frames for binary transfers
+ */
+
+#include "BinaryFrame.h"
+#include "crc32.h"
+#include <string.h>
+
+BinaryFrameDecoder::BinaryFrameDecoder() {
+    reset();
+}
+
+void BinaryFrameDecoder::reset() {
+    _state = MAGIC0;
+    _pos = 0;
+    _crc = 0;
+    _rxCrc = 0;
+    memset(&_frame, 0, sizeof(_frame));
+    _replayPos = 0;
+    _replayLen = 0;
+    _replayPayload = 0;
+    _replayCrc = 0;
+}
+
+BinFrameResult BinaryFrameDecoder::feed(const uint8_t* data, size_t len, size_t& consumed) {
+    consumed = 0;
+
+    // Bytes of a rejected frame first. A bad frame found in them is only
+    // reported: the rescan goes on after it
+    while (_replayPos < _replayLen) {
+        BinFrameResult result = step(replayByte(_replayPos++));
+        if (result != BinFrameResult::NONE) return result;
+    }
+
+    size_t i = 0;
+    while (i < len) {
+        if (_state == PAYLOAD) {
+            // Bulk copy: the payload is most of the traffic
+            size_t chunk = _frame.len - _pos;
+            if (chunk > len - i) chunk = len - i;
+            memcpy(&_payload[_pos], &data[i], chunk);
+            _crc = crc32_le(_crc, &data[i], chunk);
+            _pos += chunk;
+            i += chunk;
+            if (_pos == _frame.len) {
+                _pos = 0;
+                _rxCrc = 0;
+                _state = CRC;
+            }
+            continue;
+        }
+
+        BinFrameResult result = step(data[i++]);
+        if (result != BinFrameResult::NONE) {
+            if (result != BinFrameResult::FRAME) startReplay(result);
+            consumed = i;
+            return result;
+        }
+    }
+
+    consumed = i;
+    return BinFrameResult::NONE;
+}
+
+BinFrameResult BinaryFrameDecoder::step(uint8_t b) {
+    switch (_state) {
+        case MAGIC0:
+            // Skip anything that is not a frame start (stray CR/LF, noise)
+            if (b == BIN_MAGIC0) _state = MAGIC1;
+            break;
+
+        case MAGIC1:
+            if (b == BIN_MAGIC1) {
+                _state = HEADER;
+                _pos = 0;
+            } else if (b != BIN_MAGIC0) {
+                _state = MAGIC0;
+            }
+            break;
+
+        case HEADER:
+            _header[_pos++] = b;
+            if (_pos == sizeof(_header)) return headerDone();
+            break;
+
+        case PAYLOAD:
+            // Rescan only, feed() copies payloads in bulk
+            _payload[_pos++] = b;
+            _crc = crc32_le(_crc, &b, 1);
+            if (_pos == _frame.len) {
+                _pos = 0;
+                _rxCrc = 0;
+                _state = CRC;
+            }
+            break;
+
+        case CRC:
+            _rxCrc |= (uint32_t)b << (8 * _pos);
+            if (++_pos == 4) {
+                _state = MAGIC0;
+                return _rxCrc == _crc ? BinFrameResult::FRAME : BinFrameResult::BAD_CRC;
+            }
+            break;
+    }
+    return BinFrameResult::NONE;
+}
+
+BinFrameResult BinaryFrameDecoder::headerDone() {
+    _frame.type = _header[0];
+    _frame.seq = (uint16_t)(_header[1] | (_header[2] << 8));
+    _frame.len = (uint16_t)(_header[3] | (_header[4] << 8));
+    _frame.payload = _payload;
+
+    bool known = _frame.type == BIN_DATA || _frame.type == BIN_END ||
+                 _frame.type == BIN_ABORT;
+    if (!known || _frame.len > BIN_MAX_PAYLOAD) {
+        _state = MAGIC0;
+        return BinFrameResult::BAD_HEADER;
+    }
+
+    _crc = crc32_le(0, _header, sizeof(_header));
+    _pos = 0;
+    _state = _frame.len ? PAYLOAD : CRC;
+    _rxCrc = 0;
+    return BinFrameResult::NONE;
+}
+
+/**
+ * @brief Queue the bytes taken since the rejected frame's magic for a rescan
+ */
+void BinaryFrameDecoder::startReplay(BinFrameResult result) {
+    bool crc = result == BinFrameResult::BAD_CRC;
+    _replayPayload = crc ? _frame.len : 0;
+    _replayCrc = _rxCrc;
+    _replayLen = (uint16_t)(sizeof(_header) + _replayPayload + (crc ? 4 : 0));
+    _replayPos = 0;
+}
+
+uint8_t BinaryFrameDecoder::replayByte(uint16_t pos) const {
+    if (pos < sizeof(_header)) return _header[pos];
+    pos -= sizeof(_header);
+    if (pos < _replayPayload) return _payload[pos];
+    return (uint8_t)(_replayCrc >> (8 * (pos - _replayPayload)));
+}
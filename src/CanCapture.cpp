@@ -12,6 +12,9 @@
 #include "GlobalData.h"
 #include "ConfigManager.h"
 #include "SerialCommand.h"
+#include "CanRecorder.h"
+#include "CanStream.h"
+#include "PerfStats.h"
 
 #define LED_HEARTBEAT 8
 
@@ -23,8 +26,17 @@ extern CanConfigProcessor canProcessor;
  * @param rxFrame Reference to the received CAN frame
  */
 void handleCanCapture(CanFrame &rxFrame) {
+    // Recorder first: timestamp as close to reception as possible
+    canRecorderCapture(rxFrame);
+    canStreamCapture(rxFrame);
+
     // Process frame through configurable processor
-    bool processed = canProcessor.processFrame(rxFrame);
+    bool processed;
+    {
+        PERF_SCOPE(PROCESS_FRAME);
+        processed = canProcessor.processFrame(rxFrame);
+    }
+    if (processed) PERF_MARK_FRAME();
 
     // LED heartbeat on steering frame (0x002) for activity indication
     // This is kept regardless of configuration for visual feedback
@@ -9,38 +9,129 @@
  * JSON Configuration Loading:
  * 1. Mount LittleFS filesystem
  * 2. Search for config files (/vehicle.json, /NissanJukeF15.json)
- * 3. Parse JSON using ArduinoJson
- * 4. Build internal VehicleProfile structure
+ * 3. Parse the top-level keys with an ArduinoJson filter (frames skipped)
+ * 4. Stream the "frames" array one object at a time into VehicleProfile
+ * 5. Build the CAN ID dispatch table (2048-entry index)
+ * 6. Compile each field into a specialized decoder kernel
+ * 7. Write the binary cache image (restored by begin() on the next boot
+ *    instead of steps 3-5)
  *
  * Frame Processing:
- * 1. Look up CAN ID in configuration
- * 2. For each field in the frame config:
- *    a. Extract raw bytes according to startByte, byteCount, byteOrder
- *    b. Apply conversion formula (SCALE, MAP_RANGE, BITMASK_EXTRACT)
- *    c. Write result to appropriate GlobalData variable
+ * 1. Look up CAN ID in the dispatch table (O(1), unknown IDs rejected first)
+ * 2. For each field in the frame config, call its compiled kernel, which:
+ *    a. Extracts raw bytes according to startByte, byteCount, byteOrder
+ *    b. Applies the conversion formula (SCALE, MAP_RANGE, BITMASK_EXTRACT)
+ *    c. Writes the result to the pre-bound GlobalData variable
+ *    (filtered fields run the value through their SignalFilter first and
+ *    only write it when the filter publishes it)
+ *
+ * processFrameReference() keeps the original interpreter (steps a-c as
+ * runtime switches) for verification and benchmarks.
+ *
+ * PROFILE_BAKED builds also carry one profile generated at build time by
+ * tools/bake_profile.py (BakedProfile.h): its tables fill a bank like a
+ * parsed JSON and processFrame() calls its switch(canId) decoder, with the
+ * formulas inlined as constants, instead of the kernels.
  */
 
 #include "CanConfigProcessor.h"
 #include "GlobalData.h"
 #include "ConfigManager.h"
+#include "crc32.h"
 #include <LittleFS.h>
 #include <ArduinoJson.h>
 
+#if PROFILE_BAKED
+// GlobalData stores of the generated decoder, defined with writeToGlobalData()
+template <OutputField Target> static inline void bakedStore(int32_t value);
+template <OutputField Target> static inline void bakedStoreFiltered(SignalFilter& filter, int32_t value);
+#include "BakedProfile.h"
+#endif
+
 // =============================================================================
 // CONSTRUCTOR
 // =============================================================================
 
+void ProfileBank::clear() {
+    profile.clear();
+    memset(dispatch, 0, sizeof(dispatch));
+    dispatchIdCount = 0;
+    dispatchBuildUs = 0;
+    memset(compiledStart, 0, sizeof(compiledStart));
+    compiledCount = 0;
+    compiledFields = 0;
+    specializedFields = 0;
+    sharedWordGroups = 0;
+    baked = false;
+}
+
 CanConfigProcessor::CanConfigProcessor()
-    : _mockMode(true)           // Default to mock until config loaded
+    : _activeBank(0)
+    , _mockMode(true)           // Default to mock until config loaded
     , _framesProcessed(0)
     , _unknownFrames(0)
+    , _loadTimeMs(0)
+    , _loadPeakHeap(0)
+    , _loadedFromCache(false)
+    , _swapStats()
+    , _buildStartUs(0)
+    , _buildStartFrames(0)
 {
+    _banks[0].clear();
+    _banks[1].clear();
+}
+
+// =============================================================================
+// PROFILE BANKS
+// =============================================================================
+
+ProfileBank& CanConfigProcessor::beginBuild() {
+    _buildStartUs = micros();
+    _buildStartFrames = _framesProcessed;
+
+    ProfileBank& bank = _banks[_activeBank ^ 1];
+    bank.clear();
+    return bank;
+}
+
+void CanConfigProcessor::commitBuild() {
+    uint32_t flipStart = micros();
+    _swapStats.buildUs = flipStart - _buildStartUs;
+    _swapStats.framesDuringBuild = _framesProcessed - _buildStartFrames;
+
+    // Frame boundary: a decode in progress finishes on the old bank
+    _activeBank ^= 1;
+    _mockMode = active().profile.isMock;
+
+    _swapStats.flipUs = micros() - flipStart;
+    _swapStats.swaps++;
 }
 
 // =============================================================================
 // INITIALIZATION
 // =============================================================================
 
+#if PROFILE_BAKED
+/**
+ * @brief true if LittleFS holds a profile that replaces the baked one
+ *
+ * The file saved in NVS wins if it still exists (a CAN LOAD of another
+ * vehicle), otherwise /vehicle.json does. MockDemo.json and the JSON the
+ * profile was baked from are always present and never override it.
+ */
+static bool hasProfileOverride() {
+    const char* savedFile = configGetVehicleFile();
+    if (savedFile[0] != '\0') {
+        if (strcmp(savedFile, BAKED_PROFILE_FILE) == 0) return false;
+
+        char savedPath[48];
+        snprintf(savedPath, sizeof(savedPath), "/%s", savedFile);
+        if (LittleFS.exists(savedPath)) return true;
+    }
+    return LittleFS.exists("/vehicle.json");
+}
+#endif
+
 /**
  * @brief Initialize processor and load configuration from SPIFFS
  *
@@ -51,10 +142,23 @@ bool CanConfigProcessor::begin() {
     // Initialize LittleFS filesystem
     if (!LittleFS.begin(true)) {
         Serial.println("[CanConfig] LittleFS mount failed");
+#if PROFILE_BAKED
+        return loadBaked();
+#else
         _mockMode = true;
         return false;
+#endif
     }
 
+#if PROFILE_BAKED
+    if (!hasProfileOverride()) {
+        loadBaked();
+        Serial.printf("[CanConfig] Loaded: %s (%u frames) - %s mode, baked\n",
+                      getProfileName(), getProfileFrameCount(), getModeName());
+        return true;
+    }
+#endif
+
     // Check if a previously loaded config is saved in NVS
     const char* savedFile = configGetVehicleFile();
     if (savedFile[0] != '\0') {
@@ -62,11 +166,13 @@ bool CanConfigProcessor::begin() {
         snprintf(savedPath, sizeof(savedPath), "/%s", savedFile);
         if (LittleFS.exists(savedPath)) {
             Serial.printf("[CanConfig] Restoring saved config: %s\n", savedPath);
-            if (loadFromJson(savedPath)) {
-                Serial.printf("[CanConfig] Loaded: %s (%d frames) - %s mode\n",
-                              _profile.name.c_str(),
-                              _profile.frames.size(),
-                              _mockMode ? "MOCK" : "REAL CAN");
+            if (loadProfile(savedPath)) {
+                Serial.printf("[CanConfig] Loaded: %s (%u frames) - %s mode, %s in %lu ms\n",
+                              getProfileName(),
+                              getProfileFrameCount(),
+                              getModeName(),
+                              _loadedFromCache ? "cache" : "JSON",
+                              (unsigned long)_loadTimeMs);
                 return true;
             }
         }
@@ -83,11 +189,12 @@ bool CanConfigProcessor::begin() {
     for (const char* path : configPaths) {
         if (LittleFS.exists(path)) {
             Serial.printf("[CanConfig] Found config: %s\n", path);
-            if (loadFromJson(path)) {
-                Serial.printf("[CanConfig] Loaded: %s (%d frames) - %s mode\n",
-                              _profile.name.c_str(),
-                              _profile.frames.size(),
-                              _mockMode ? "MOCK" : "REAL CAN");
+            if (loadProfile(path)) {
+                Serial.printf("[CanConfig] Loaded: %s (%u frames) - %s mode, %s\n",
+                              getProfileName(),
+                              getProfileFrameCount(),
+                              getModeName(),
+                              _loadedFromCache ? "cache" : "JSON");
                 return true;
             }
         }
@@ -99,6 +206,16 @@ bool CanConfigProcessor::begin() {
     return false;
 }
 
+bool CanConfigProcessor::loadProfile(const char* path) {
+#if PROFILE_BAKED
+    const char* filename = (path[0] == '/') ? path + 1 : path;
+    if (strcmp(filename, BAKED_PROFILE_FILE) == 0) {
+        return loadBaked();
+    }
+#endif
+    return loadFromCache(path) || loadFromJson(path);
+}
+
 // =============================================================================
 // JSON CONFIGURATION LOADING
 // =============================================================================
@@ -115,6 +232,168 @@ bool CanConfigProcessor::begin() {
  *   ]
  * }
  */
+/**
+ * @brief Position the file just inside a top-level array ("key": [ ...)
+ *
+ * Minimal scanner (strings, escapes, nesting) so that the array can be
+ * deserialized one element at a time. The document has already been
+ * validated by the first pass.
+ */
+static bool seekTopLevelArray(File& file, const char* key) {
+    size_t keyLen = strlen(key);
+    int depth = 0;
+    bool inString = false;
+    bool escape = false;
+    bool keyMatch = false;      // String being read equals key so far
+    size_t keyPos = 0;
+    bool afterKey = false;      // Last token at depth 1 was the key
+    int c;
+
+    while ((c = file.read()) >= 0) {
+        if (inString) {
+            if (escape) {
+                escape = false;
+                keyMatch = false;
+            } else if (c == '\\') {
+                escape = true;
+            } else if (c == '"') {
+                inString = false;
+                afterKey = depth == 1 && keyMatch && keyPos == keyLen;
+            } else if (keyPos < keyLen && c == key[keyPos]) {
+                keyPos++;
+            } else {
+                keyMatch = false;
+            }
+            continue;
+        }
+        if (isspace(c)) continue;
+
+        if (c == ':' && afterKey) {
+            do { c = file.read(); } while (c >= 0 && isspace(c));
+            return c == '[';
+        }
+        afterKey = false;
+
+        if (c == '"') {
+            inString = true;
+            keyMatch = true;
+            keyPos = 0;
+        } else if (c == '{' || c == '[') {
+            depth++;
+        } else if (c == '}' || c == ']') {
+            depth--;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Skip whitespace and return the next character without consuming it
+ */
+static int peekToken(File& file) {
+    while (file.available() && isspace(file.peek())) {
+        file.read();
+    }
+    return file.peek();
+}
+
+/**
+ * @brief Append one frame and its fields to a profile arena
+ * @return false if the frame does not fit (PROFILE_MAX_FRAMES/FIELDS)
+ */
+static bool parseFrameConfig(JsonObjectConst frameObj, VehicleProfile& profile) {
+    JsonArrayConst fieldsArray = frameObj["fields"];
+    if (profile.frameCount >= PROFILE_MAX_FRAMES ||
+        profile.fieldCount + fieldsArray.size() > PROFILE_MAX_FIELDS) {
+        return false;
+    }
+
+    FrameConfig& frame = profile.frames[profile.frameCount++];
+    frame.firstField = profile.fieldCount;
+    frame.fieldCount = 0;
+
+    // Parse CAN ID - supports both string ("0x180") and integer (384) formats
+    const char* canIdStr = frameObj["canId"];
+    if (canIdStr) {
+        frame.canId = (uint16_t)strtol(canIdStr, nullptr, 0);  // Auto-detect base
+    } else {
+        frame.canId = frameObj["canId"].as<uint16_t>();
+    }
+
+    // Parse fields array for this frame
+    for (JsonObjectConst fieldObj : fieldsArray) {
+        FieldConfig& field = profile.fields[profile.fieldCount++];
+        frame.fieldCount++;
+
+        // Target GlobalData field
+        field.target = parseOutputField(fieldObj["target"] | "STEERING");
+
+        // Byte extraction parameters
+        field.startByte = fieldObj["startByte"] | 0;
+        field.byteCount = fieldObj["byteCount"] | 1;
+        field.byteOrder = parseByteOrder(fieldObj["byteOrder"] | "BE");
+        field.dataType = parseDataType(fieldObj["dataType"] | "UINT8");
+
+        // Conversion formula
+        field.formula = parseFormulaType(fieldObj["formula"] | "NONE");
+
+        // Initialize formula parameters to zero
+        memset(field.params, 0, sizeof(field.params));
+        field.filter = 0;
+
+        // Parse formula parameters array [mult, div, offset] or [mask, shift]
+        JsonArrayConst paramsArray = fieldObj["params"];
+        if (paramsArray) {
+            int i = 0;
+            for (JsonVariantConst v : paramsArray) {
+                if (i < 4) {
+                    field.params[i++] = v.as<int32_t>();
+                }
+            }
+        }
+
+        // Optional smoothing / rate limit (SignalFilter.h)
+        JsonObjectConst filterObj = fieldObj["filter"];
+        if (filterObj) {
+            FieldFilterConfig filter;
+            filter.median = filterObj["median"] | 0;
+            filter.emaShift = filterObj["emaShift"] | 0;
+            filter.deadband = filterObj["deadband"] | 0;
+            filter.minIntervalMs = filterObj["minIntervalMs"] | 0;
+            if (SignalFilter::sanitize(filter)) {
+                if (profile.filterCount >= PROFILE_MAX_FILTERS) {
+                    return false;
+                }
+                profile.filters[profile.filterCount++] = filter;
+                field.filter = profile.filterCount;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Load and parse vehicle configuration from JSON file
+ *
+ * JSON Structure:
+ * {
+ *   "name": "Vehicle Name",
+ *   "isMock": false,
+ *   "replay": { "file": "/drive.log", "speed": 1, "loop": true },  (optional)
+ *   "frames": [
+ *     { "canId": "0x180", "fields": [...] }
+ *   ]
+ * }
+ *
+ * "replay" may also be just the file name ("replay": "/drive.log").
+ *
+ * The file is read twice so that no JsonDocument ever holds the whole
+ * profile: pass 1 keeps only name/isMock/vehicleParams (the filter drops
+ * "frames" while still checking its syntax), pass 2 deserializes one frame
+ * object at a time. Peak heap is about one frame plus the parsed profile,
+ * instead of the file, its JsonDocument and the profile together. The
+ * current profile is only replaced once the whole file has parsed.
+ */
 bool CanConfigProcessor::loadFromJson(const char* path) {
     // Open configuration file
     File file = LittleFS.open(path, "r");
@@ -123,99 +402,346 @@ bool CanConfigProcessor::loadFromJson(const char* path) {
         return false;
     }
 
-    // Parse JSON document
+    unsigned long start = millis();
+    uint32_t heapBefore = ESP.getFreeHeap();
+    uint32_t heapMin = heapBefore;
+
+    // Pass 1: top-level keys only
+    JsonDocument filter;
+    filter["name"] = true;
+    filter["isMock"] = true;
+    filter["replay"] = true;
+    filter["vehicleParams"] = true;
+
     JsonDocument doc;
-    DeserializationError error = deserializeJson(doc, file);
-    file.close();
+    DeserializationError error = deserializeJson(doc, file, DeserializationOption::Filter(filter));
+    heapMin = min(heapMin, ESP.getFreeHeap());
 
     if (error) {
+        file.close();
         Serial.printf("[CanConfig] JSON parse error: %s\n", error.c_str());
         return false;
     }
 
-    // Clear any existing profile data
-    _profile.frames.clear();
-    _profile.name = doc["name"] | "Unknown";
-    _profile.isMock = doc["isMock"] | false;  // Default to real CAN if not specified
+    // Pass 2: frames, one object at a time, into the spare bank
+    ProfileBank& bank = beginBuild();
+    VehicleProfile& profile = bank.profile;
+    bool fits = true;
+    file.seek(0);
+    if (seekTopLevelArray(file, "frames")) {
+        JsonDocument frameDoc;
+        while (peekToken(file) != ']') {
+            error = deserializeJson(frameDoc, file);
+            heapMin = min(heapMin, ESP.getFreeHeap());
+            if (error) break;
 
-    // Parse frames array
-    JsonArray framesArray = doc["frames"];
-    for (JsonObject frameObj : framesArray) {
-        FrameConfig frame;
+            fits = parseFrameConfig(frameDoc.as<JsonObjectConst>(), profile);
+            if (!fits) break;
 
-        // Parse CAN ID - supports both string ("0x180") and integer (384) formats
-        const char* canIdStr = frameObj["canId"];
-        if (canIdStr) {
-            frame.canId = (uint16_t)strtol(canIdStr, nullptr, 0);  // Auto-detect base
-        } else {
-            frame.canId = frameObj["canId"].as<uint16_t>();
+            // Separator: ',' before the next frame, ']' at the end
+            if (peekToken(file) == ',') file.read();
         }
+    }
+    file.close();
 
-        // Parse fields array for this frame
-        JsonArray fieldsArray = frameObj["fields"];
-        for (JsonObject fieldObj : fieldsArray) {
-            FieldConfig field;
-
-            // Target GlobalData field
-            field.target = parseOutputField(fieldObj["target"] | "STEERING");
-
-            // Byte extraction parameters
-            field.startByte = fieldObj["startByte"] | 0;
-            field.byteCount = fieldObj["byteCount"] | 1;
-            field.byteOrder = parseByteOrder(fieldObj["byteOrder"] | "BE");
-            field.dataType = parseDataType(fieldObj["dataType"] | "UINT8");
-
-            // Conversion formula
-            field.formula = parseFormulaType(fieldObj["formula"] | "NONE");
-
-            // Initialize formula parameters to zero
-            memset(field.params, 0, sizeof(field.params));
-
-            // Parse formula parameters array [mult, div, offset] or [mask, shift]
-            JsonArray paramsArray = fieldObj["params"];
-            if (paramsArray) {
-                int i = 0;
-                for (JsonVariant v : paramsArray) {
-                    if (i < 4) {
-                        field.params[i++] = v.as<int32_t>();
-                    }
-                }
-            }
+    if (error) {
+        Serial.printf("[CanConfig] JSON parse error in frames: %s\n", error.c_str());
+        return false;
+    }
+    if (!fits) {
+        Serial.printf("[CanConfig] Profile too large: max %d frames, %d fields, %d filters\n",
+                      PROFILE_MAX_FRAMES, PROFILE_MAX_FIELDS, PROFILE_MAX_FILTERS);
+        return false;
+    }
 
-            frame.fields.push_back(field);
-        }
+    JsonVariantConst replay = doc["replay"];
+    const char* replayFile = replay.is<const char*>() ? replay.as<const char*>()
+                                                      : (replay["file"] | "");
+    if (strlen(replayFile) >= sizeof(profile.replayFile)) {
+        Serial.printf("[CanConfig] Replay path too long (max %d chars)\n",
+                      PROFILE_REPLAY_PATH_SIZE - 1);
+        return false;
+    }
 
-        _profile.frames.push_back(frame);
+    snprintf(profile.name, sizeof(profile.name), "%s", doc["name"] | "Unknown");
+    profile.isMock = doc["isMock"] | false;  // Default to real CAN if not specified
+    snprintf(profile.replayFile, sizeof(profile.replayFile), "%s", replayFile);
+    profile.replaySpeed = replay["speed"] | 1;
+    profile.replayLoop = replay["loop"] | false;
+
+    // A real profile without frames would decode nothing: keep the current one
+    if (!profile.isMock && profile.frameCount == 0) {
+        Serial.println("[CanConfig] Profile has no frames");
+        return false;
     }
 
-    // Update mock mode flag from config
-    _mockMode = _profile.isMock;
+    buildDispatchTable(bank);
+    compileProfile(bank);
 
-    bool isValid = _profile.isMock || _profile.frames.size() > 0;
+    // Replace the current profile and update the mock mode flag from it
+    commitBuild();
 
-    if (isValid) {
-        const char* filename = (path[0] == '/') ? path + 1 : path;
-        const char* currentFile = configGetVehicleFile();
-        bool isVehicleSwitch = (currentFile[0] == '\0') || (strcmp(currentFile, filename) != 0);
+    selectVehicle((path[0] == '/') ? path + 1 : path, doc["vehicleParams"]);
 
-        if (isVehicleSwitch) {
-            if (currentFile[0] != '\0') {
-                Serial.printf("[CanConfig] Vehicle switch: '%s' → '%s'\n", currentFile, filename);
-            }
-            configReset();
-            JsonObjectConst vp = doc["vehicleParams"];
-            if (vp) {
-                applyVehicleParams(vp);
-            }
-            configSave();
-        } else {
-            Serial.printf("[CanConfig] Same vehicle — calibration preserved from NVS\n");
+    _loadTimeMs = millis() - start;
+    _loadPeakHeap = heapBefore > heapMin ? heapBefore - heapMin : 0;
+    _loadedFromCache = false;
+
+    saveCache(path, doc["vehicleParams"]);
+    return true;
+}
+
+// =============================================================================
+// COMPILED PROFILE CACHE
+// =============================================================================
+
+#define PROFILE_CACHE_MAGIC   0x48435050u   // "PPCH"
+#define PROFILE_CACHE_VERSION 5
+
+/**
+ * @brief Cache file header, followed by the payload
+ *
+ * Payload: name[nameLen], replayFile[replayLen], vehicleParams[paramsLen]
+ * (serialized JSON object), dispatch[CAN_DISPATCH_SIZE],
+ * FrameConfig[frameCount], FieldConfig[fieldCount],
+ * FieldFilterConfig[filterCount] - the used part of the
+ * profile arena, as its in-memory image, hence fieldSize and the build
+ * stamp: another firmware build may lay it out differently.
+ */
+struct ProfileCacheHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t fieldSize;         // sizeof(FieldConfig)
+    char     build[24];         // PROFILE_CACHE_BUILD
+    uint32_t sourceCrc;         // crc32_le(0, JSON file)
+    uint32_t sourceSize;
+    uint16_t frameCount;
+    uint16_t fieldCount;
+    uint8_t  isMock;
+    uint8_t  nameLen;
+    uint8_t  replayLen;         // strlen(replayFile), 0 = no replay
+    uint8_t  replayLoop;
+    uint16_t replaySpeed;
+    uint8_t  filterCount;
+    uint8_t  reserved;
+    uint16_t paramsLen;         // Serialized vehicleParams length, 0 = none
+    uint16_t reserved2;
+    uint32_t payloadSize;
+    uint32_t payloadCrc;        // crc32_le(0, payload)
+};
+
+// Changes whenever this file is rebuilt, i.e. whenever FieldConfig or the
+// enums it holds may have changed
+static const char PROFILE_CACHE_BUILD[] = __DATE__ " " __TIME__;
+static_assert(sizeof(PROFILE_CACHE_BUILD) <= sizeof(ProfileCacheHeader::build),
+              "build stamp does not fit the cache header");
+
+/**
+ * @brief Sequential payload writer/reader keeping a running CRC
+ */
+struct CacheStream {
+    File&    file;
+    uint32_t crc;
+    uint32_t size;
+    bool     ok;
+
+    void put(const void* data, size_t len) {
+        ok = ok && file.write((const uint8_t*)data, len) == len;
+        crc = crc32_le(crc, (const uint8_t*)data, len);
+        size += len;
+    }
+
+    void get(void* data, size_t len) {
+        ok = ok && file.read((uint8_t*)data, len) == len;
+        crc = crc32_le(crc, (const uint8_t*)data, len);
+        size += len;
+    }
+};
+
+/**
+ * @brief CRC32 and size of a file, read in small blocks
+ */
+static bool fileCrc32(const char* path, uint32_t& crc, uint32_t& size) {
+    File file = LittleFS.open(path, "r");
+    if (!file) return false;
+
+    uint8_t buf[256];
+    size_t n;
+    crc = 0;
+    size = 0;
+    while ((n = file.read(buf, sizeof(buf))) > 0) {
+        crc = crc32_le(crc, buf, n);
+        size += n;
+    }
+    file.close();
+    return true;
+}
+
+void CanConfigProcessor::cachePathFor(const char* jsonPath, char* out, size_t outLen) {
+    size_t len = strlen(jsonPath);
+    if (len >= 5 && strcasecmp(jsonPath + len - 5, ".json") == 0) {
+        len -= 5;
+    }
+    snprintf(out, outLen, "%.*s%s", (int)len, jsonPath, PROFILE_CACHE_EXT);
+}
+
+void CanConfigProcessor::saveCache(const char* jsonPath, JsonObjectConst vehicleParams) {
+#if PROFILE_CACHE_ENABLED
+    ProfileCacheHeader header = {};
+    if (!fileCrc32(jsonPath, header.sourceCrc, header.sourceSize)) return;
+
+    char params[PROFILE_CACHE_PARAMS_SIZE];
+    if (vehicleParams) {
+        size_t len = measureJson(vehicleParams);
+        if (len >= sizeof(params)) {
+            Serial.printf("[CanConfig] vehicleParams too large to cache (%u bytes)\n", (unsigned)len);
+            return;
         }
+        header.paramsLen = (uint16_t)serializeJson(vehicleParams, params, sizeof(params));
+    }
+
+    header.magic = PROFILE_CACHE_MAGIC;
+    header.version = PROFILE_CACHE_VERSION;
+    header.fieldSize = sizeof(FieldConfig);
+    memcpy(header.build, PROFILE_CACHE_BUILD, sizeof(PROFILE_CACHE_BUILD));
+    const ProfileBank& bank = active();
+    const VehicleProfile& profile = bank.profile;
+    header.frameCount = profile.frameCount;
+    header.fieldCount = profile.fieldCount;
+    header.isMock = profile.isMock;
+    header.nameLen = (uint8_t)strlen(profile.name);
+    header.replayLen = (uint8_t)strlen(profile.replayFile);
+    header.replayLoop = profile.replayLoop;
+    header.replaySpeed = profile.replaySpeed;
+    header.filterCount = profile.filterCount;
 
-        configSetVehicleFile(filename);
+    char cachePath[56];
+    cachePathFor(jsonPath, cachePath, sizeof(cachePath));
+    File file = LittleFS.open(cachePath, "w");
+    if (!file) return;
+
+    // Placeholder header, payload, then the real header with its CRC
+    CacheStream out = { file, 0, 0, true };
+    bool ok = file.write((const uint8_t*)&header, sizeof(header)) == sizeof(header);
+
+    out.put(profile.name, header.nameLen);
+    out.put(profile.replayFile, header.replayLen);
+    out.put(params, header.paramsLen);
+    out.put(bank.dispatch, sizeof(bank.dispatch));
+    out.put(profile.frames, header.frameCount * sizeof(FrameConfig));
+    out.put(profile.fields, header.fieldCount * sizeof(FieldConfig));
+    out.put(profile.filters, header.filterCount * sizeof(FieldFilterConfig));
+
+    header.payloadSize = out.size;
+    header.payloadCrc = out.crc;
+    ok = ok && out.ok && file.seek(0) &&
+         file.write((const uint8_t*)&header, sizeof(header)) == sizeof(header);
+    file.close();
+
+    if (!ok) {
+        // Filesystem full or write error: never leave a partial image
+        LittleFS.remove(cachePath);
+        Serial.printf("[CanConfig] Failed to write cache %s\n", cachePath);
     }
+#else
+    (void)jsonPath;
+    (void)vehicleParams;
+#endif
+}
+
+bool CanConfigProcessor::loadFromCache(const char* jsonPath) {
+#if PROFILE_CACHE_ENABLED
+    unsigned long start = millis();
+    uint32_t heapBefore = ESP.getFreeHeap();
+
+    char cachePath[56];
+    cachePathFor(jsonPath, cachePath, sizeof(cachePath));
+    if (!LittleFS.exists(cachePath)) return false;
+
+    File file = LittleFS.open(cachePath, "r");
+    if (!file) return false;
+
+    ProfileCacheHeader header;
+    uint32_t sourceCrc = 0, sourceSize = 0;
+    bool ok = file.read((uint8_t*)&header, sizeof(header)) == sizeof(header) &&
+              header.magic == PROFILE_CACHE_MAGIC &&
+              header.version == PROFILE_CACHE_VERSION &&
+              header.fieldSize == sizeof(FieldConfig) &&
+              strncmp(header.build, PROFILE_CACHE_BUILD, sizeof(header.build)) == 0 &&
+              header.frameCount <= PROFILE_MAX_FRAMES &&
+              header.fieldCount <= PROFILE_MAX_FIELDS &&
+              header.filterCount <= PROFILE_MAX_FILTERS &&
+              header.nameLen < PROFILE_NAME_SIZE &&
+              header.replayLen < PROFILE_REPLAY_PATH_SIZE &&
+              header.paramsLen < PROFILE_CACHE_PARAMS_SIZE &&
+              fileCrc32(jsonPath, sourceCrc, sourceSize) &&
+              sourceCrc == header.sourceCrc && sourceSize == header.sourceSize;
+
+    // Payload, read straight into the spare bank
+    ProfileBank& bank = beginBuild();
+    VehicleProfile& profile = bank.profile;
+    char params[PROFILE_CACHE_PARAMS_SIZE];
+    CacheStream in = { file, 0, 0, ok };
+    if (ok) {
+        in.get(profile.name, header.nameLen);
+        profile.name[header.nameLen] = '\0';
+        in.get(profile.replayFile, header.replayLen);
+        profile.replayFile[header.replayLen] = '\0';
+        in.get(params, header.paramsLen);
+        profile.replaySpeed = header.replaySpeed;
+        profile.replayLoop = header.replayLoop != 0;
+        in.get(bank.dispatch, sizeof(bank.dispatch));
+        in.get(profile.frames, header.frameCount * sizeof(FrameConfig));
+        in.get(profile.fields, header.fieldCount * sizeof(FieldConfig));
+        in.get(profile.filters, header.filterCount * sizeof(FieldFilterConfig));
+        profile.frameCount = header.frameCount;
+        profile.fieldCount = header.fieldCount;
+        profile.filterCount = header.filterCount;
+        profile.isMock = header.isMock != 0;
+    }
+    file.close();
 
-    return isValid;
+    ok = in.ok && in.size == header.payloadSize && in.crc == header.payloadCrc;
+    for (uint16_t i = 0; ok && i < profile.frameCount; i++) {
+        const FrameConfig& frame = profile.frames[i];
+        ok = frame.firstField + frame.fieldCount <= profile.fieldCount;
+    }
+    for (uint16_t i = 0; ok && i < profile.fieldCount; i++) {
+        ok = profile.fields[i].filter <= profile.filterCount;
+    }
+    for (size_t id = 0; ok && id < CAN_DISPATCH_SIZE; id++) {
+        ok = bank.dispatch[id] <= header.frameCount;
+    }
+    if (!ok) {
+        Serial.printf("[CanConfig] Cache %s stale or invalid, parsing JSON\n", cachePath);
+        return false;
+    }
+    uint32_t heapAfter = ESP.getFreeHeap();
+
+    for (uint8_t slot : bank.dispatch) {
+        if (slot) bank.dispatchIdCount++;
+    }
+    compileProfile(bank);
+
+    // Replace the current profile
+    commitBuild();
+
+    // vehicleParams are only parsed on a vehicle switch
+    const char* filename = (jsonPath[0] == '/') ? jsonPath + 1 : jsonPath;
+    JsonDocument paramsDoc;
+    if (header.paramsLen > 0 && strcmp(configGetVehicleFile(), filename) != 0) {
+        deserializeJson(paramsDoc, params, header.paramsLen);
+    }
+    selectVehicle(filename, paramsDoc.as<JsonObjectConst>());
+
+    _loadTimeMs = millis() - start;
+    _loadPeakHeap = heapBefore > heapAfter ? heapBefore - heapAfter : 0;
+    _loadedFromCache = true;
+    return true;
+#else
+    (void)jsonPath;
+    return false;
+#endif
 }
 
 // =============================================================================
@@ -272,40 +798,714 @@ void CanConfigProcessor::applyVehicleParams(JsonObjectConst params) {
     Serial.printf("[CanConfig] %d vehicle param(s) applied\n", applied);
 }
 
+void CanConfigProcessor::selectVehicle(const char* filename, JsonObjectConst vehicleParams) {
+    const char* currentFile = configGetVehicleFile();
+    bool isVehicleSwitch = (currentFile[0] == '\0') || (strcmp(currentFile, filename) != 0);
+
+    if (isVehicleSwitch) {
+        if (currentFile[0] != '\0') {
+            Serial.printf("[CanConfig] Vehicle switch: '%s' → '%s'\n", currentFile, filename);
+        }
+        configReset();
+        if (vehicleParams) {
+            applyVehicleParams(vehicleParams);
+        }
+        configSave();
+    } else {
+        Serial.printf("[CanConfig] Same vehicle — calibration preserved from NVS\n");
+    }
+
+    configSetVehicleFile(filename);
+}
+
 // =============================================================================
 // FRAME LOOKUP
 // =============================================================================
 
+/**
+ * @brief Rebuild the 11-bit CAN ID dispatch table
+ *
+ * Most bus traffic is for IDs that are not in the JSON, so the lookup must be
+ * cheapest for the miss case: one bounds check and one byte read.
+ */
+void CanConfigProcessor::buildDispatchTable(ProfileBank& bank) {
+    unsigned long start = micros();
+
+    memset(bank.dispatch, 0, sizeof(bank.dispatch));
+    bank.dispatchIdCount = 0;
+
+    for (uint16_t i = 0; i < bank.profile.frameCount; i++) {
+        uint16_t canId = bank.profile.frames[i].canId;
+
+        if (canId >= CAN_DISPATCH_SIZE) {
+            Serial.printf("[CanConfig] Ignoring frame 0x%X: not an 11-bit ID\n", canId);
+            continue;
+        }
+        if (bank.dispatch[canId] != 0) {
+            Serial.printf("[CanConfig] Duplicate frame 0x%03X ignored\n", canId);
+            continue;
+        }
+
+        bank.dispatch[canId] = (uint8_t)(i + 1);
+        bank.dispatchIdCount++;
+    }
+
+    bank.dispatchBuildUs = micros() - start;
+}
+
 /**
  * @brief Find frame configuration for a given CAN ID
  *
- * Linear search through configured frames. For small configs (< 20 frames)
- * this is efficient enough. Could be optimized with a lookup table if needed.
+ * Constant-time lookup through the dispatch table. IDs outside the 11-bit
+ * range are never configured.
+ */
+const FrameConfig* CanConfigProcessor::findFrameConfig(const ProfileBank& bank, uint32_t canId) {
+    if (canId >= CAN_DISPATCH_SIZE) {
+        return nullptr;
+    }
+    uint8_t slot = bank.dispatch[canId];
+    return slot ? &bank.profile.frames[slot - 1] : nullptr;
+}
+
+// =============================================================================
+// HARDWARE ACCEPTANCE FILTER
+// =============================================================================
+
+// Number of IDs covered by one filter: 2^(don't-care bits)
+static uint16_t filterSpan(uint16_t mask) {
+    return (uint16_t)(1u << __builtin_popcount(mask & 0x7FF));
+}
+
+// Shared code/mask for a group of IDs
+static void filterForGroup(const uint16_t* ids, size_t count, uint16_t& code, uint16_t& mask) {
+    code = ids[0];
+    mask = 0;
+    for (size_t i = 1; i < count; i++) {
+        mask |= (ids[i] ^ code);
+    }
+    code &= ~mask & 0x7FF;
+}
+
+// |A ∪ B| for two ID cubes
+static uint16_t dualSpan(uint16_t c1, uint16_t m1, uint16_t c2, uint16_t m2) {
+    uint16_t overlap = 0;
+    if (((c1 ^ c2) & ~(m1 | m2) & 0x7FF) == 0) {
+        overlap = filterSpan(m1 & m2);
+    }
+    return filterSpan(m1) + filterSpan(m2) - overlap;
+}
+
+bool CanConfigProcessor::filterAccepts(const CanAcceptanceFilter& filter, uint16_t canId) {
+    bool first = ((((uint32_t)canId << 21) ^ filter.code) & ~filter.mask & 0xFFE00000u) == 0;
+    if (filter.singleFilter) {
+        return first;
+    }
+    bool second = ((((uint32_t)canId << 5) ^ filter.code) & ~filter.mask & 0x0000FFE0u) == 0;
+    return first || second;
+}
+
+/**
+ * @brief Derive the TWAI acceptance filter from the dispatch table
+ *
+ * A single filter accepts 2^k IDs where k is the number of bit positions on
+ * which configured IDs disagree. Splitting the set in two often reduces that
+ * drastically (e.g. 0x0xx steering vs 0x5xx/0x6xx body frames), so a few
+ * cheap partitions are tried and the smallest accepted set wins.
  */
-const FrameConfig* CanConfigProcessor::findFrameConfig(uint16_t canId) const {
-    for (const auto& frame : _profile.frames) {
-        if (frame.canId == canId) {
-            return &frame;
+CanAcceptanceFilter CanConfigProcessor::computeAcceptanceFilter() const {
+    CanAcceptanceFilter result = { 0, 0xFFFFFFFFu, true, CAN_DISPATCH_SIZE };
+
+    // Collect configured IDs (sorted by construction)
+    uint16_t ids[CAN_DISPATCH_MAX_FRAMES];
+    size_t count = 0;
+    const uint8_t* dispatch = active().dispatch;
+    for (uint16_t id = 0; id < CAN_DISPATCH_SIZE && count < CAN_DISPATCH_MAX_FRAMES; id++) {
+        if (dispatch[id]) ids[count++] = id;
+    }
+    if (count == 0) {
+        return result;
+    }
+
+    // Candidate 1: single filter
+    uint16_t code, mask;
+    filterForGroup(ids, count, code, mask);
+    uint16_t best = filterSpan(mask);
+    result.code = (uint32_t)code << 21;
+    result.mask = ((uint32_t)mask << 21) | 0x001FFFFFu;
+    result.singleFilter = true;
+    result.acceptedIds = best;
+
+    if (count < 2) {
+        return result;
+    }
+
+    uint16_t groupA[CAN_DISPATCH_MAX_FRAMES];
+    uint16_t groupB[CAN_DISPATCH_MAX_FRAMES];
+
+    // Candidates 2..n: dual filter over sorted splits, then per-bit splits
+    for (size_t split = 1; split < count + 11; split++) {
+        size_t countA = 0, countB = 0;
+        if (split < count) {
+            for (size_t i = 0; i < count; i++) {
+                if (i < split) groupA[countA++] = ids[i]; else groupB[countB++] = ids[i];
+            }
+        } else {
+            uint16_t bit = 1u << (split - count);
+            for (size_t i = 0; i < count; i++) {
+                if (ids[i] & bit) groupA[countA++] = ids[i]; else groupB[countB++] = ids[i];
+            }
+            if (countA == 0 || countB == 0) continue;
+        }
+
+        uint16_t c1, m1, c2, m2;
+        filterForGroup(groupA, countA, c1, m1);
+        filterForGroup(groupB, countB, c2, m2);
+        uint16_t span = dualSpan(c1, m1, c2, m2);
+
+        if (span < best) {
+            best = span;
+            result.code = ((uint32_t)c1 << 21) | ((uint32_t)c2 << 5);
+            result.mask = ((uint32_t)m1 << 21) | 0x001F0000u |
+                          ((uint32_t)m2 << 5)  | 0x0000001Fu;
+            result.singleFilter = false;
+            result.acceptedIds = span;
         }
     }
+
+    return result;
+}
+
+// =============================================================================
+// FIELD COMPILATION
+// =============================================================================
+
+namespace {
+
+// --- Extraction: N bytes at compile time, optional sign extension ----------
+
+template <uint8_t N, bool BigEndian, DataType Type>
+struct Extract {
+    static inline int32_t read(const uint8_t* p) {
+        uint32_t raw = 0;
+        for (uint8_t i = 0; i < N; i++) {
+            raw = (raw << 8) | p[BigEndian ? i : N - 1 - i];
+        }
+        if (Type == DataType::INT8)  return (int8_t)raw;
+        if (Type == DataType::INT16) return (int16_t)raw;
+        return (int32_t)raw;
+    }
+};
+
+// --- Formulas (same arithmetic as applyFormula) -----------------------------
+
+template <FormulaType F>
+inline int32_t applyKernelFormula(int32_t v, const int32_t* p) {
+    switch (F) {
+        case FormulaType::SCALE:           return ((v * p[0]) / p[1]) + p[2];
+        case FormulaType::MAP_RANGE:       return map(v, p[0], p[1], p[2], p[3]);
+        case FormulaType::BITMASK_EXTRACT: return (v & p[0]) >> p[1];
+        default:                           return v;
+    }
+}
+
+// --- Sinks: how the value lands in GlobalData -------------------------------
+
+enum class SinkKind : uint8_t { STORE8, STORE16, STORE32, DECIVOLT, FLAG, DOOR_BIT, TIMESTAMP };
+
+struct SinkStore8 {
+    static inline void write(const CompiledField& f, int32_t v) { vehicleDataStore(*(uint8_t*)f.target, (uint8_t)v, f.dirty); }
+};
+struct SinkStore16 {
+    static inline void write(const CompiledField& f, int32_t v) { vehicleDataStore(*(uint16_t*)f.target, (uint16_t)v, f.dirty); }
+};
+struct SinkStore32 {
+    static inline void write(const CompiledField& f, int32_t v) { vehicleDataStore(*(uint32_t*)f.target, (uint32_t)v, f.dirty); }
+};
+struct SinkDecivolt {
+    static inline void write(const CompiledField& f, int32_t v) { vehicleDataStore(*(float*)f.target, v * 0.1f, f.dirty); }
+};
+struct SinkFlag {
+    static inline void write(const CompiledField& f, int32_t v) { vehicleDataStore(*(bool*)f.target, v != 0, f.dirty); }
+};
+struct SinkDoorBit {
+    static inline void write(const CompiledField& f, int32_t v) {
+        uint8_t& doors = *(uint8_t*)f.target;
+        vehicleDataStore(doors, (uint8_t)(v ? (doors | f.bit) : (doors & ~f.bit)), f.dirty);
+    }
+};
+// RadioSend derives the blinker state from the timestamp age. Only the start
+// of a blink sequence is marked dirty (the loop sleeps until something
+// changes); the end is a timeout RadioSend schedules itself.
+static inline void stampIndicator(unsigned long& lastTime) {
+    unsigned long now = millis();
+    if (lastTime == 0 || now - lastTime >= configGetIndicatorTimeout()) {
+        vehicleDataMarkDirty(DIRTY_LIGHTS);
+    }
+    lastTime = now;
+}
+struct SinkTimestamp {
+    static inline void write(const CompiledField& f, int32_t v) {
+        if (v) stampIndicator(*(unsigned long*)f.target);
+    }
+};
+
+// --- Kernel ------------------------------------------------------------------
+
+template <class E, FormulaType F, class S>
+uint8_t fieldKernel(const uint8_t* data, const CompiledField& f) {
+    S::write(f, applyKernelFormula<F>(E::read(data + f.config.startByte), f.config.params));
+    return 1;
+}
+
+// Numeric targets: every formula is specialized
+template <class E, class S>
+FieldKernel selectFormula(FormulaType formula) {
+    switch (formula) {
+        case FormulaType::NONE:            return &fieldKernel<E, FormulaType::NONE, S>;
+        case FormulaType::SCALE:           return &fieldKernel<E, FormulaType::SCALE, S>;
+        case FormulaType::MAP_RANGE:       return &fieldKernel<E, FormulaType::MAP_RANGE, S>;
+        case FormulaType::BITMASK_EXTRACT: return &fieldKernel<E, FormulaType::BITMASK_EXTRACT, S>;
+    }
     return nullptr;
 }
 
+// Flag targets: only the formulas that make sense for bits
+template <class E, class S>
+FieldKernel selectFlagFormula(FormulaType formula) {
+    switch (formula) {
+        case FormulaType::NONE:            return &fieldKernel<E, FormulaType::NONE, S>;
+        case FormulaType::BITMASK_EXTRACT: return &fieldKernel<E, FormulaType::BITMASK_EXTRACT, S>;
+        default:                           return nullptr;
+    }
+}
+
+template <class E>
+FieldKernel selectSink(SinkKind sink, FormulaType formula) {
+    switch (sink) {
+        case SinkKind::STORE8:    return selectFormula<E, SinkStore8>(formula);
+        case SinkKind::STORE16:   return selectFormula<E, SinkStore16>(formula);
+        case SinkKind::STORE32:   return selectFormula<E, SinkStore32>(formula);
+        case SinkKind::DECIVOLT:  return selectFormula<E, SinkDecivolt>(formula);
+        case SinkKind::FLAG:      return selectFlagFormula<E, SinkFlag>(formula);
+        case SinkKind::DOOR_BIT:  return selectFlagFormula<E, SinkDoorBit>(formula);
+        case SinkKind::TIMESTAMP: return selectFlagFormula<E, SinkTimestamp>(formula);
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Pick the specialized kernel for a field, nullptr if none exists
+ *
+ * Specialized shapes: 1-4 unsigned bytes (BE/LE), INT8 on 1 byte and INT16
+ * on 2 bytes. Anything else (e.g. INT8 on a 2-byte word) stays generic.
+ */
+FieldKernel selectKernel(const FieldConfig& field, SinkKind sink) {
+    if (field.startByte + field.byteCount > 8) {
+        return nullptr;
+    }
+
+    bool be = (field.byteOrder == ByteOrder::MSB_FIRST);
+    bool s8 = (field.dataType == DataType::INT8);
+    bool s16 = (field.dataType == DataType::INT16);
+
+    switch (field.byteCount) {
+        case 1:
+            if (s16) return nullptr;
+            return s8 ? selectSink<Extract<1, true, DataType::INT8>>(sink, field.formula)
+                      : selectSink<Extract<1, true, DataType::UINT8>>(sink, field.formula);
+        case 2:
+            if (s8) return nullptr;
+            if (s16) {
+                return be ? selectSink<Extract<2, true,  DataType::INT16>>(sink, field.formula)
+                          : selectSink<Extract<2, false, DataType::INT16>>(sink, field.formula);
+            }
+            return be ? selectSink<Extract<2, true,  DataType::UINT16>>(sink, field.formula)
+                      : selectSink<Extract<2, false, DataType::UINT16>>(sink, field.formula);
+        case 3:
+            if (s8 || s16) return nullptr;
+            return be ? selectSink<Extract<3, true,  DataType::UINT32>>(sink, field.formula)
+                      : selectSink<Extract<3, false, DataType::UINT32>>(sink, field.formula);
+        case 4:
+            if (s8 || s16) return nullptr;
+            return be ? selectSink<Extract<4, true,  DataType::UINT32>>(sink, field.formula)
+                      : selectSink<Extract<4, false, DataType::UINT32>>(sink, field.formula);
+        default:
+            return nullptr;
+    }
+}
+
+// --- Shared-word groups ------------------------------------------------------
+
+// Member: (word & mask) >> shift, then the usual sink
+template <class S>
+void wordOpKernel(int32_t word, const CompiledField& op) {
+    S::write(op, (word & op.config.params[0]) >> op.config.params[1]);
+}
+
+/**
+ * @brief Extract the shared word once, run the members, fold the doors
+ *
+ * Door members hold a pre-shifted test mask, so each one is a single AND
+ * and the whole set lands in currentDoors with one read-modify-write.
+ */
+template <class E>
+uint8_t wordGroupKernel(const uint8_t* data, const CompiledField& head) {
+    int32_t word = E::read(data + head.config.startByte);
+
+    const CompiledField* op = &head + 1;
+    const CompiledField* end = op + head.config.params[2];
+    for (; op != end; op++) {
+        op->wordOp(word, *op);
+    }
+
+    if (head.bit) {
+        end = op + head.config.params[3];
+        uint8_t set = 0;
+        for (; op != end; op++) {
+            if (word & op->config.params[0]) set |= op->bit;
+        }
+        uint8_t& doors = *(uint8_t*)head.target;
+        vehicleDataStore(doors, (uint8_t)((doors & ~head.bit) | set), head.dirty);
+    }
+
+    return (uint8_t)(1 + head.config.params[2] + head.config.params[3]);
+}
+
+WordOpKernel selectWordOp(SinkKind sink) {
+    switch (sink) {
+        case SinkKind::STORE8:    return &wordOpKernel<SinkStore8>;
+        case SinkKind::STORE16:   return &wordOpKernel<SinkStore16>;
+        case SinkKind::STORE32:   return &wordOpKernel<SinkStore32>;
+        case SinkKind::DECIVOLT:  return &wordOpKernel<SinkDecivolt>;
+        case SinkKind::FLAG:      return &wordOpKernel<SinkFlag>;
+        case SinkKind::TIMESTAMP: return &wordOpKernel<SinkTimestamp>;
+        default:                  return nullptr;   // DOOR_BIT is folded
+    }
+}
+
+FieldKernel selectWordGroup(uint8_t byteCount, ByteOrder order) {
+    bool be = (order == ByteOrder::MSB_FIRST);
+    switch (byteCount) {
+        case 1: return &wordGroupKernel<Extract<1, true, DataType::UINT32>>;
+        case 2: return be ? &wordGroupKernel<Extract<2, true,  DataType::UINT32>>
+                          : &wordGroupKernel<Extract<2, false, DataType::UINT32>>;
+        case 3: return be ? &wordGroupKernel<Extract<3, true,  DataType::UINT32>>
+                          : &wordGroupKernel<Extract<3, false, DataType::UINT32>>;
+        case 4: return be ? &wordGroupKernel<Extract<4, true,  DataType::UINT32>>
+                          : &wordGroupKernel<Extract<4, false, DataType::UINT32>>;
+        default: return nullptr;
+    }
+}
+
+/**
+ * @brief Can this field read its value from a cached shared word?
+ *
+ * Only unsigned words with NONE/BITMASK_EXTRACT qualify: both reduce to
+ * (word & mask) >> shift, so members differ only by mask and shift.
+ */
+bool isWordGroupable(const FieldConfig& field) {
+    if (field.filter) {
+        return false;   // Filter state is per field
+    }
+    if (field.byteCount < 1 || field.byteCount > 4 || field.startByte + field.byteCount > 8) {
+        return false;
+    }
+    if (field.dataType == DataType::INT8 || field.dataType == DataType::INT16) {
+        return false;
+    }
+    if (field.formula == FormulaType::NONE) {
+        return true;
+    }
+    return field.formula == FormulaType::BITMASK_EXTRACT
+        && field.params[1] >= 0 && field.params[1] < 32;
+}
+
+bool sameWord(const FieldConfig& a, const FieldConfig& b) {
+    return a.startByte == b.startByte && a.byteCount == b.byteCount
+        && a.byteOrder == b.byteOrder;
+}
+
+/**
+ * @brief Bind a target to its GlobalData variable (mirrors writeToGlobalData)
+ * @return false for unknown targets
+ */
+bool bindTarget(OutputField target, CompiledField& out, SinkKind& sink) {
+    out.bit = 0;
+    out.dirty = 0;
+    switch (target) {
+        case OutputField::STEERING:        out.target = &currentSteer;        sink = SinkKind::STORE16; out.dirty = DIRTY_STEERING; return true;
+        case OutputField::ENGINE_RPM:      out.target = &engineRPM;           sink = SinkKind::STORE16; out.dirty = DIRTY_RPM; return true;
+        case OutputField::VEHICLE_SPEED:   out.target = &vehicleSpeed;        sink = SinkKind::STORE8;  out.dirty = DIRTY_SPEED; return true;
+        case OutputField::FUEL_LEVEL:      out.target = &fuelLevel;           sink = SinkKind::STORE8;  out.dirty = DIRTY_FUEL_LEVEL; return true;
+        case OutputField::ODOMETER:        out.target = &currentOdo;          sink = SinkKind::STORE32; out.dirty = DIRTY_ODOMETER; return true;
+        case OutputField::VOLTAGE:         out.target = &voltBat;             sink = SinkKind::DECIVOLT; out.dirty = DIRTY_VOLTAGE; return true;
+        case OutputField::TEMPERATURE:     out.target = &tempExt;             sink = SinkKind::STORE8;  out.dirty = DIRTY_TEMPERATURE; return true;
+        case OutputField::DTE:             out.target = &dteValue;            sink = SinkKind::STORE16; out.dirty = DIRTY_DTE; return true;
+        case OutputField::FUEL_CONS_INST:  out.target = &fuelConsumptionInst; sink = SinkKind::STORE16; out.dirty = DIRTY_FUEL_CONS_INST; return true;
+        case OutputField::FUEL_CONS_AVG:   out.target = &fuelConsumptionAvg;  sink = SinkKind::STORE16; out.dirty = DIRTY_FUEL_CONS_AVG; return true;
+
+        case OutputField::DOOR_DRIVER:     out.target = &currentDoors; out.bit = 0x80; sink = SinkKind::DOOR_BIT; out.dirty = DIRTY_DOORS; return true;
+        case OutputField::DOOR_PASSENGER:  out.target = &currentDoors; out.bit = 0x40; sink = SinkKind::DOOR_BIT; out.dirty = DIRTY_DOORS; return true;
+        case OutputField::DOOR_REAR_LEFT:  out.target = &currentDoors; out.bit = 0x20; sink = SinkKind::DOOR_BIT; out.dirty = DIRTY_DOORS; return true;
+        case OutputField::DOOR_REAR_RIGHT: out.target = &currentDoors; out.bit = 0x10; sink = SinkKind::DOOR_BIT; out.dirty = DIRTY_DOORS; return true;
+        case OutputField::DOOR_BOOT:       out.target = &currentDoors; out.bit = 0x08; sink = SinkKind::DOOR_BIT; out.dirty = DIRTY_DOORS; return true;
+
+        case OutputField::INDICATOR_LEFT:  out.target = &lastLeftIndicatorTime;  sink = SinkKind::TIMESTAMP; return true;
+        case OutputField::INDICATOR_RIGHT: out.target = &lastRightIndicatorTime; sink = SinkKind::TIMESTAMP; return true;
+
+        case OutputField::HEADLIGHTS:      out.target = &headlightsOn;        sink = SinkKind::FLAG; out.dirty = DIRTY_LIGHTS; return true;
+        case OutputField::HIGH_BEAM:       out.target = &highBeamOn;          sink = SinkKind::FLAG; out.dirty = DIRTY_LIGHTS; return true;
+        case OutputField::PARKING_LIGHTS:  out.target = &parkingLightsOn;     sink = SinkKind::FLAG; out.dirty = DIRTY_LIGHTS; return true;
+
+        default:
+            out.target = nullptr;
+            return false;
+    }
+}
+
+} // namespace
+
+uint8_t CanConfigProcessor::genericKernel(const uint8_t* data, const CompiledField& field) {
+    int32_t rawValue = extractRawValue(data, field.config);
+    writeToGlobalData(field.config.target, applyFormula(rawValue, field.config));
+    return 1;
+}
+
+uint8_t CanConfigProcessor::filteredKernel(const uint8_t* data, const CompiledField& field) {
+    int32_t value = applyFormula(extractRawValue(data, field.config), field.config);
+    if (((SignalFilter*)field.target)->apply(value, millis(), value)) {
+        writeToGlobalData(field.config.target, value);
+    }
+    return 1;
+}
+
+uint32_t CanConfigProcessor::getFilterHeldCount() const {
+    const ProfileBank& bank = active();
+    uint32_t held = 0;
+    for (uint8_t i = 0; i < bank.profile.filterCount; i++) {
+        held += bank.filters[i].getHeld();
+    }
+    return held;
+}
+
+/**
+ * @brief Compile every field of the loaded profile
+ *
+ * Fields are laid out frame by frame so processFrame() walks one contiguous
+ * range per CAN ID.
+ */
+void CanConfigProcessor::compileProfile(ProfileBank& bank) {
+    bank.compiledCount = 0;
+    bank.compiledFields = 0;
+    bank.specializedFields = 0;
+    bank.sharedWordGroups = 0;
+
+    const VehicleProfile& profile = bank.profile;
+    for (uint16_t i = 0; i < profile.frameCount; i++) {
+        const FrameConfig& frame = profile.frames[i];
+        bank.compiledStart[i] = bank.compiledCount;
+        compileFrame(bank, profile.fieldsOf(frame), frame.fieldCount);
+    }
+    bank.compiledStart[profile.frameCount] = bank.compiledCount;
+}
+
+/**
+ * @brief Compile one frame, grouping fields that share a word
+ *
+ * A group is formed by two or more groupable fields with the same
+ * (startByte, byteCount, byteOrder). Grouping reorders writes within the
+ * frame, so it is skipped when two fields of the frame share a target
+ * (last-writer-wins must keep the profile order).
+ *
+ * Entries are written straight into bank.compiled: the group header slot is
+ * reserved first, members go after it (others, then doors) and the slots
+ * are given back if fewer than two members were found.
+ */
+void CanConfigProcessor::compileFrame(ProfileBank& bank, const FieldConfig* fields, uint16_t count) {
+    bool done[PROFILE_MAX_FIELDS] = {};
+
+    uint32_t seenTargets = 0;
+    bool canGroup = true;
+    for (uint16_t i = 0; i < count; i++) {
+        uint32_t bit = 1UL << ((uint8_t)fields[i].target & 31);
+        if (seenTargets & bit) canGroup = false;
+        seenTargets |= bit;
+    }
+
+    for (uint16_t i = 0; i < count; i++) {
+        if (done[i]) continue;
+        const FieldConfig& field = fields[i];
+
+        // --- Shared-word group starting at this field ---
+        if (canGroup && isWordGroupable(field)) {
+            uint16_t headIdx = bank.compiledCount++;
+            uint16_t others = 0;
+            uint16_t doors = 0;
+            uint8_t doorMask = 0;
+
+            // Pass 0 emits the non-door members, pass 1 the door members
+            for (uint8_t pass = 0; pass < 2; pass++) {
+                for (uint16_t j = i; j < count; j++) {
+                    if (done[j] || !sameWord(field, fields[j]) || !isWordGroupable(fields[j])) continue;
+
+                    CompiledField& member = bank.compiled[bank.compiledCount];
+                    SinkKind sink;
+                    if (!bindTarget(fields[j].target, member, sink)) continue;
+                    bool isDoor = sink == SinkKind::DOOR_BIT;
+                    if (isDoor != (pass == 1)) continue;
+
+                    member.config = fields[j];
+                    int32_t mask = -1;
+                    int32_t shift = 0;
+                    if (fields[j].formula == FormulaType::BITMASK_EXTRACT) {
+                        mask = fields[j].params[0];
+                        shift = fields[j].params[1];
+                    }
+
+                    if (isDoor) {
+                        // ((word & mask) >> shift) != 0  <=>  word & (mask without the shifted-out bits)
+                        member.wordOp = nullptr;
+                        member.config.params[0] = (int32_t)((uint32_t)mask & (0xFFFFFFFFU << shift));
+                        doorMask |= member.bit;
+                        doors++;
+                    } else {
+                        member.wordOp = selectWordOp(sink);
+                        member.config.params[0] = mask;
+                        member.config.params[1] = shift;
+                        others++;
+                    }
+                    bank.compiledCount++;
+                }
+            }
+
+            if (others + doors >= 2) {
+                CompiledField& head = bank.compiled[headIdx];
+                head.kernel = selectWordGroup(field.byteCount, field.byteOrder);
+                head.target = &currentDoors;
+                head.bit = doorMask;
+                head.dirty = DIRTY_DOORS;
+                head.config = field;
+                head.config.params[2] = (int32_t)others;
+                head.config.params[3] = (int32_t)doors;
+
+                // Same selection as above: these fields are now compiled
+                for (uint16_t j = i; j < count; j++) {
+                    CompiledField probe;
+                    SinkKind sink;
+                    if (!done[j] && sameWord(field, fields[j]) && isWordGroupable(fields[j]) &&
+                        bindTarget(fields[j].target, probe, sink)) {
+                        done[j] = true;
+                    }
+                }
+                bank.compiledFields += others + doors;
+                bank.specializedFields += others + doors;
+                bank.sharedWordGroups++;
+                continue;
+            }
+            bank.compiledCount = headIdx;
+        }
+
+        // --- Stand-alone field ---
+        CompiledField compiled;
+        compiled.config = field;
+
+        // Filtered: smoothing state bound once, store through writeToGlobalData()
+        if (field.filter) {
+            SignalFilter& filter = bank.filters[field.filter - 1];
+            filter.begin(bank.profile.filters[field.filter - 1]);
+            compiled.kernel = &CanConfigProcessor::filteredKernel;
+            compiled.target = &filter;
+            compiled.bit = 0;
+            compiled.dirty = 0;
+            bank.compiled[bank.compiledCount++] = compiled;
+            bank.compiledFields++;
+            done[i] = true;
+            continue;
+        }
+
+        // SCALE guards are resolved once instead of on every frame
+        if (field.formula == FormulaType::SCALE) {
+            if (compiled.config.params[0] == 0) compiled.config.params[0] = 1;
+            if (compiled.config.params[1] == 0) compiled.config.params[1] = 1;
+        }
+
+        SinkKind sink;
+        FieldKernel kernel = nullptr;
+        if (bindTarget(field.target, compiled, sink)) {
+            kernel = selectKernel(field, sink);
+        }
+
+        if (kernel) {
+            compiled.kernel = kernel;
+            bank.specializedFields++;
+        } else {
+            compiled.kernel = &CanConfigProcessor::genericKernel;
+        }
+
+        bank.compiled[bank.compiledCount++] = compiled;
+        bank.compiledFields++;
+        done[i] = true;
+    }
+}
+
 // =============================================================================
 // FRAME PROCESSING
 // =============================================================================
 
 /**
- * @brief Process a received CAN frame according to configuration
+ * @brief Process a received CAN frame using the compiled decoders
+ *
+ * One dispatch-table read, then one indirect call per field (or per
+ * shared-word group, which consumes its member entries). A baked profile
+ * runs its generated decoder instead, still behind the dispatch check.
+ */
+bool CanConfigProcessor::processFrame(const CanFrame& frame) {
+    // Bank index read once: the whole frame is decoded with one profile
+    const ProfileBank& bank = active();
+    uint8_t slot = (frame.extd || frame.identifier >= CAN_DISPATCH_SIZE)
+                       ? 0 : bank.dispatch[frame.identifier];
+
+    if (!slot) {
+        _unknownFrames++;
+        return false;
+    }
+
+    _framesProcessed++;
+
+#if PROFILE_BAKED
+    if (bank.baked) {
+        vehicleDataBeginWrite();
+        processBaked(frame.data, frame.identifier, bank.filters);
+        vehicleDataEndWrite();
+        return true;
+    }
+#endif
+
+    const CompiledField* field = bank.compiled + bank.compiledStart[slot - 1];
+    const CompiledField* end = bank.compiled + bank.compiledStart[slot];
+
+    // All fields of one frame are published together (readers use a snapshot)
+    vehicleDataBeginWrite();
+    while (field != end) {
+        field += field->kernel(frame.data, *field);
+    }
+    vehicleDataEndWrite();
+
+    return true;
+}
+
+/**
+ * @brief Process a received CAN frame with the reference interpreter
  *
  * For each field defined for this CAN ID:
  * 1. Extract raw value from specified bytes
  * 2. Apply conversion formula
  * 3. Write to GlobalData
  */
-bool CanConfigProcessor::processFrame(const CanFrame& frame) {
-    // Look up configuration for this CAN ID
-    const FrameConfig* config = findFrameConfig(frame.identifier);
+bool CanConfigProcessor::processFrameReference(const CanFrame& frame) {
+    // Look up configuration for this CAN ID (extended IDs are never configured)
+    const ProfileBank& bank = active();
+    const FrameConfig* config = frame.extd ? nullptr : findFrameConfig(bank, frame.identifier);
 
     if (!config) {
         _unknownFrames++;
@@ -314,8 +1514,14 @@ bool CanConfigProcessor::processFrame(const CanFrame& frame) {
 
     _framesProcessed++;
 
+    // All fields of one frame are published together (readers use a snapshot)
+    vehicleDataBeginWrite();
+
     // Process each field defined for this frame
-    for (const auto& field : config->fields) {
+    const FieldConfig* fields = bank.profile.fieldsOf(*config);
+    for (uint16_t i = 0; i < config->fieldCount; i++) {
+        const FieldConfig& field = fields[i];
+
         // Step 1: Extract raw value from CAN data bytes
         int32_t rawValue = extractRawValue(frame.data, field);
 
@@ -326,6 +1532,8 @@ bool CanConfigProcessor::processFrame(const CanFrame& frame) {
         writeToGlobalData(field.target, convertedValue);
     }
 
+    vehicleDataEndWrite();
+
     return true;
 }
 
@@ -344,7 +1552,7 @@ bool CanConfigProcessor::processFrame(const CanFrame& frame) {
  * @example For Big Endian 2-byte value at offset 0:
  *          data[0]=0x12, data[1]=0x34 → result = 0x1234 = 4660
  */
-int32_t CanConfigProcessor::extractRawValue(const uint8_t* data, const FieldConfig& field) const {
+int32_t CanConfigProcessor::extractRawValue(const uint8_t* data, const FieldConfig& field) {
     uint32_t rawUnsigned = 0;
 
     if (field.byteOrder == ByteOrder::MSB_FIRST) {
@@ -386,7 +1594,7 @@ int32_t CanConfigProcessor::extractRawValue(const uint8_t* data, const FieldConf
  * - BITMASK_EXTRACT: (value & mask) >> shift
  *          Example: Extract bit 20 from 24-bit status word
  */
-int32_t CanConfigProcessor::applyFormula(int32_t rawValue, const FieldConfig& field) const {
+int32_t CanConfigProcessor::applyFormula(int32_t rawValue, const FieldConfig& field) {
     switch (field.formula) {
         case FormulaType::NONE:
             return rawValue;
@@ -426,78 +1634,81 @@ int32_t CanConfigProcessor::applyFormula(int32_t rawValue, const FieldConfig& fi
  * - VOLTAGE: Converts from decivolts (141) to float (14.1)
  * - DOOR_*: Sets/clears bits in currentDoors bitmask
  * - INDICATOR_*: Updates timestamp for blink detection
+ *
+ * Always inlined: with a constant target (bakedStore()) the switch folds
+ * down to the one store.
  */
-void CanConfigProcessor::writeToGlobalData(OutputField target, int32_t value) {
+__attribute__((always_inline)) static inline void storeOutput(OutputField target, int32_t value) {
     switch (target) {
         // === Numeric Values ===
         case OutputField::STEERING:
-            currentSteer = (int16_t)value;
+            vehicleDataStore(currentSteer, (int16_t)value, DIRTY_STEERING);
             break;
         case OutputField::ENGINE_RPM:
-            engineRPM = (uint16_t)value;
+            vehicleDataStore(engineRPM, (uint16_t)value, DIRTY_RPM);
             break;
         case OutputField::VEHICLE_SPEED:
-            vehicleSpeed = (uint8_t)value;
+            vehicleDataStore(vehicleSpeed, (uint8_t)value, DIRTY_SPEED);
             break;
         case OutputField::FUEL_LEVEL:
-            fuelLevel = (uint8_t)value;
+            vehicleDataStore(fuelLevel, (uint8_t)value, DIRTY_FUEL_LEVEL);
             break;
         case OutputField::ODOMETER:
-            currentOdo = (uint32_t)value;
+            vehicleDataStore(currentOdo, (uint32_t)value, DIRTY_ODOMETER);
             break;
         case OutputField::VOLTAGE:
             // Value is in decivolts (e.g., 141 = 14.1V), convert to float
-            voltBat = value * 0.1f;
+            vehicleDataStore(voltBat, value * 0.1f, DIRTY_VOLTAGE);
             break;
         case OutputField::TEMPERATURE:
-            tempExt = (int8_t)value;
+            vehicleDataStore(tempExt, (int8_t)value, DIRTY_TEMPERATURE);
             break;
         case OutputField::DTE:
-            dteValue = (int16_t)value;
+            vehicleDataStore(dteValue, (int16_t)value, DIRTY_DTE);
             break;
         case OutputField::FUEL_CONS_INST:
-            fuelConsumptionInst = (uint16_t)value;
+            vehicleDataStore(fuelConsumptionInst, (uint16_t)value, DIRTY_FUEL_CONS_INST);
             break;
         case OutputField::FUEL_CONS_AVG:
-            fuelConsumptionAvg = (uint16_t)value;
+            vehicleDataStore(fuelConsumptionAvg, (uint16_t)value, DIRTY_FUEL_CONS_AVG);
             break;
 
         // === Door Status Flags ===
         // Map to currentDoors bitmask (Toyota RAV4 format)
         case OutputField::DOOR_DRIVER:
-            if (value) currentDoors |= 0x80; else currentDoors &= ~0x80;
+            vehicleDataStore(currentDoors, (uint8_t)(value ? (currentDoors | 0x80) : (currentDoors & ~0x80)), DIRTY_DOORS);
             break;
         case OutputField::DOOR_PASSENGER:
-            if (value) currentDoors |= 0x40; else currentDoors &= ~0x40;
+            vehicleDataStore(currentDoors, (uint8_t)(value ? (currentDoors | 0x40) : (currentDoors & ~0x40)), DIRTY_DOORS);
             break;
         case OutputField::DOOR_REAR_LEFT:
-            if (value) currentDoors |= 0x20; else currentDoors &= ~0x20;
+            vehicleDataStore(currentDoors, (uint8_t)(value ? (currentDoors | 0x20) : (currentDoors & ~0x20)), DIRTY_DOORS);
             break;
         case OutputField::DOOR_REAR_RIGHT:
-            if (value) currentDoors |= 0x10; else currentDoors &= ~0x10;
+            vehicleDataStore(currentDoors, (uint8_t)(value ? (currentDoors | 0x10) : (currentDoors & ~0x10)), DIRTY_DOORS);
             break;
         case OutputField::DOOR_BOOT:
-            if (value) currentDoors |= 0x08; else currentDoors &= ~0x08;
+            vehicleDataStore(currentDoors, (uint8_t)(value ? (currentDoors | 0x08) : (currentDoors & ~0x08)), DIRTY_DOORS);
             break;
 
         // === Turn Indicators ===
         // Update timestamp for blink detection (500ms timeout in RadioSend)
         case OutputField::INDICATOR_LEFT:
-            if (value) lastLeftIndicatorTime = millis();
+            if (value) stampIndicator(lastLeftIndicatorTime);
             break;
         case OutputField::INDICATOR_RIGHT:
-            if (value) lastRightIndicatorTime = millis();
+            if (value) stampIndicator(lastRightIndicatorTime);
             break;
 
         // === Light Status ===
         case OutputField::HEADLIGHTS:
-            headlightsOn = (value != 0);
+            vehicleDataStore(headlightsOn, value != 0, DIRTY_LIGHTS);
             break;
         case OutputField::HIGH_BEAM:
-            highBeamOn = (value != 0);
+            vehicleDataStore(highBeamOn, value != 0, DIRTY_LIGHTS);
             break;
         case OutputField::PARKING_LIGHTS:
-            parkingLightsOn = (value != 0);
+            vehicleDataStore(parkingLightsOn, value != 0, DIRTY_LIGHTS);
             break;
 
         default:
@@ -505,3 +1716,74 @@ void CanConfigProcessor::writeToGlobalData(OutputField target, int32_t value) {
             break;
     }
 }
+
+void CanConfigProcessor::writeToGlobalData(OutputField target, int32_t value) {
+    storeOutput(target, value);
+}
+
+// =============================================================================
+// BAKED PROFILE
+// =============================================================================
+
+#if PROFILE_BAKED
+
+template <OutputField Target>
+static inline void bakedStore(int32_t value) {
+    storeOutput(Target, value);
+}
+
+template <OutputField Target>
+static inline void bakedStoreFiltered(SignalFilter& filter, int32_t value) {
+    if (filter.apply(value, millis(), value)) {
+        storeOutput(Target, value);
+    }
+}
+
+bool CanConfigProcessor::processBaked(const uint8_t* data, uint32_t canId, SignalFilter* filters) {
+    return bakedDecode(data, canId, filters);
+}
+
+bool CanConfigProcessor::loadBaked() {
+    unsigned long start = millis();
+
+    ProfileBank& bank = beginBuild();
+    VehicleProfile& profile = bank.profile;
+    snprintf(profile.name, sizeof(profile.name), "%s", BAKED_PROFILE_NAME);
+    memcpy(profile.frames, BAKED_FRAMES, sizeof(BAKED_FRAMES));
+    memcpy(profile.fields, BAKED_FIELDS, sizeof(BAKED_FIELDS));
+    memcpy(profile.filters, BAKED_FILTERS, BAKED_FILTER_COUNT * sizeof(FieldFilterConfig));
+    profile.frameCount = BAKED_FRAME_COUNT;
+    profile.fieldCount = BAKED_FIELD_COUNT;
+    profile.filterCount = BAKED_FILTER_COUNT;
+
+    // Dispatch table and kernels too: the ID check, the filter state and
+    // processFrameReference() work as for a JSON profile
+    buildDispatchTable(bank);
+    compileProfile(bank);
+    bank.baked = true;
+    commitBuild();
+
+    // vehicleParams are only parsed on a vehicle switch
+    JsonDocument params;
+    if (BAKED_VEHICLE_PARAMS[0] != '\0' && strcmp(configGetVehicleFile(), BAKED_PROFILE_FILE) != 0) {
+        deserializeJson(params, BAKED_VEHICLE_PARAMS);
+    }
+    selectVehicle(BAKED_PROFILE_FILE, params.as<JsonObjectConst>());
+
+    _loadTimeMs = millis() - start;
+    _loadPeakHeap = 0;
+    _loadedFromCache = false;
+    return true;
+}
+
+#else
+
+bool CanConfigProcessor::processBaked(const uint8_t*, uint32_t, SignalFilter*) {
+    return false;
+}
+
+bool CanConfigProcessor::loadBaked() {
+    return false;
+}
+
+#endif // PROFILE_BAKED
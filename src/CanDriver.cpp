@@ -0,0 +1,385 @@
+/**
+ * @file CanDriver.cpp
+ * @brief TWAI controller lifecycle and acceptance filter programming
+ */
+
+#include "CanDriver.h"
+#include <ESP32-TWAI-CAN.hpp>
+#include "ConfigManager.h"
+#include "PerfStats.h"
+#include <esp_attr.h>
+
+// External reference to CAN processor (defined in main.cpp)
+extern CanConfigProcessor canProcessor;
+
+// =============================================================================
+// PRIVATE VARIABLES
+// =============================================================================
+
+static volatile bool driverRunning = false;
+static CanAcceptanceFilter activeFilter = { 0, 0xFFFFFFFF, true, CAN_DISPATCH_SIZE };
+static CanRxStats rxStats = {};
+static uint32_t lastDriverLost = 0;  // missed + overrun count reported by the driver
+
+// Ingest task state
+static TaskHandle_t ingestTask = nullptr;
+static CanFrameHandler ingestHandler = nullptr;
+static volatile bool ingestStopRequest = false;  // Set by canDriverEnd()
+static volatile bool ingestIdle = true;          // Task is not touching the driver
+static volatile uint64_t ingestBusyUs = 0;
+
+// Bus fault recovery (loop() context)
+static CanRecovery recovery;
+
+// Survive the reboot that ends an unrecoverable fault (not a power cycle)
+#define FAULT_REBOOT_MAGIC 0xB05F0FFu
+RTC_NOINIT_ATTR static uint32_t faultRebootMagic;
+RTC_NOINIT_ATTR static uint32_t faultReboots;
+
+// =============================================================================
+// PRIVATE FUNCTIONS
+// =============================================================================
+
+/**
+ * @brief Read a frame already in the RX queue (no wait)
+ */
+static bool readQueued(CanFrame& frame) {
+    PERF_SCOPE(CAN_READ);
+    return ESP32Can.readFrame(frame, 0);
+}
+
+/**
+ * @brief Drain one bounded batch from the RX queue
+ * @param handler Called for every frame read
+ * @param waitMs Max wait for the first frame
+ * @return Number of frames handled
+ */
+static uint16_t drainBatch(CanFrameHandler handler, uint32_t waitMs) {
+    // Queue depth and loss counters before draining
+    twai_status_info_t status;
+    if (twai_get_status_info(&status) == ESP_OK) {
+        if (status.msgs_to_rx > rxStats.queueHighWater) {
+            rxStats.queueHighWater = status.msgs_to_rx;
+        }
+        uint32_t lost = status.rx_missed_count + status.rx_overrun_count;
+        if (lost >= lastDriverLost) {
+            rxStats.overruns += lost - lastDriverLost;
+        }
+        lastDriverLost = lost;
+    }
+
+    CanFrame frame;
+    if (!ESP32Can.readFrame(frame, waitMs)) {
+        rxStats.lastBatch = 0;
+        return 0;
+    }
+
+    // Budget starts with the first frame, not with the wait
+    uint32_t start = micros();
+    uint16_t count = 0;
+
+    do {
+        handler(frame);
+        count++;
+
+        if (count >= CAN_DRAIN_MAX_FRAMES) {
+            rxStats.limitStops++;
+            break;
+        }
+        if (micros() - start >= CAN_DRAIN_BUDGET_US) {
+            rxStats.budgetStops++;
+            break;
+        }
+    } while (readQueued(frame));
+
+    ingestBusyUs += micros() - start;
+
+    rxStats.lastBatch = count;
+    rxStats.batches++;
+    if (count > rxStats.maxBatch) {
+        rxStats.maxBatch = count;
+    }
+
+    return count;
+}
+
+/**
+ * @brief CAN ingest task body
+ *
+ * Drains the RX queue while the driver runs. Blocks in readFrame() on a
+ * quiet bus, and parks when canDriverEnd() asks it to stop.
+ */
+static void canIngestTask(void* arg) {
+    (void)arg;
+    for (;;) {
+        // Clear idle before checking the stop flag (see canDriverEnd)
+        ingestIdle = false;
+        if (ingestStopRequest || !driverRunning) {
+            ingestIdle = true;
+            vTaskDelay(pdMS_TO_TICKS(CAN_TASK_WAIT_MS));
+            continue;
+        }
+        drainBatch(ingestHandler, CAN_TASK_WAIT_MS);
+    }
+}
+
+/**
+ * @brief Map the driver status to a recovery condition
+ */
+static CanBusCondition readBusCondition() {
+    if (!driverRunning) {
+        return CanBusCondition::OFFLINE;
+    }
+    twai_status_info_t status;
+    if (twai_get_status_info(&status) != ESP_OK) {
+        return CanBusCondition::OFFLINE;
+    }
+    switch (status.state) {
+        case TWAI_STATE_BUS_OFF:    return CanBusCondition::BUS_OFF;
+        case TWAI_STATE_RECOVERING: return CanBusCondition::RECOVERING;
+        case TWAI_STATE_STOPPED:    return CanBusCondition::STOPPED;
+        default:
+            break;
+    }
+    if (status.rx_error_counter > CAN_MAX_ERRORS || status.bus_error_count > CAN_MAX_ERRORS) {
+        return CanBusCondition::ERROR_LIMIT;
+    }
+    return CanBusCondition::OK;
+}
+
+// =============================================================================
+// PUBLIC API IMPLEMENTATION
+// =============================================================================
+
+bool canDriverBegin() {
+    if (driverRunning) {
+        return true;
+    }
+
+    if (configGetCanPromisc()) {
+        activeFilter = { 0, 0xFFFFFFFF, true, CAN_DISPATCH_SIZE };
+    } else {
+        activeFilter = canProcessor.computeAcceptanceFilter();
+    }
+
+    twai_filter_config_t filterConfig = {
+        .acceptance_code = activeFilter.code,
+        .acceptance_mask = activeFilter.mask,
+        .single_filter = activeFilter.singleFilter,
+    };
+
+    // 500kbps (Nissan Juke standard), default TX queue
+    driverRunning = ESP32Can.begin(TWAI_SPEED_500KBPS, CAN_TX, CAN_RX,
+                                   0xFFFF, CAN_RX_QUEUE_LEN, &filterConfig);
+    lastDriverLost = 0;  // Driver counters restart on install
+    ingestStopRequest = false;
+
+    if (driverRunning) {
+        Serial.printf("[CAN] Filter: %s code=0x%08lX mask=0x%08lX (%u IDs accepted)\n",
+                      activeFilter.singleFilter ? "single" : "dual",
+                      (unsigned long)activeFilter.code,
+                      (unsigned long)activeFilter.mask,
+                      activeFilter.acceptedIds);
+    }
+
+    return driverRunning;
+}
+
+void canDriverEnd() {
+    if (!driverRunning) {
+        return;
+    }
+
+    // Park the ingest task before uninstalling the driver under it
+    ingestStopRequest = true;
+    if (ingestTask && xTaskGetCurrentTaskHandle() != ingestTask) {
+        while (!ingestIdle) {
+            vTaskDelay(1);
+        }
+    }
+
+    ESP32Can.end();
+    driverRunning = false;
+}
+
+bool canDriverRestart() {
+    if (!driverRunning) {
+        return true;
+    }
+    canDriverEnd();
+    return canDriverBegin();
+}
+
+bool canDriverSyncProfile() {
+    if (!canProcessor.usesCanBus()) {
+        if (driverRunning) {
+            canDriverEnd();
+            Serial.printf("[CAN] Controller stopped (%s profile)\n", canProcessor.getModeName());
+        }
+        return true;
+    }
+
+    if (!driverRunning) {
+        bool ok = canDriverBegin();
+        Serial.printf("[CAN] Controller %s (real profile)\n", ok ? "started" : "failed to start");
+        return ok;
+    }
+
+    if (configGetCanPromisc()) {
+        return true;  // Accept-all filter does not depend on the profile
+    }
+    CanAcceptanceFilter wanted = canProcessor.computeAcceptanceFilter();
+    if (wanted.code == activeFilter.code && wanted.mask == activeFilter.mask &&
+        wanted.singleFilter == activeFilter.singleFilter) {
+        return true;  // Same filter: keep receiving
+    }
+    return canDriverRestart();
+}
+
+uint32_t canDriverListen(uint32_t windowMs, uint32_t silenceMs, uint8_t* idBits) {
+    memset(idBits, 0, CAN_DISPATCH_SIZE / 8);
+    if (driverRunning) {
+        return 0;
+    }
+
+    // Straight to the IDF driver: the library only installs normal mode
+    twai_general_config_t generalConfig =
+        TWAI_GENERAL_CONFIG_DEFAULT((gpio_num_t)CAN_TX, (gpio_num_t)CAN_RX, TWAI_MODE_LISTEN_ONLY);
+    generalConfig.rx_queue_len = CAN_RX_QUEUE_LEN;
+    twai_timing_config_t timingConfig = TWAI_TIMING_CONFIG_500KBITS();
+    twai_filter_config_t filterConfig = TWAI_FILTER_CONFIG_ACCEPT_ALL();
+
+    if (twai_driver_install(&generalConfig, &timingConfig, &filterConfig) != ESP_OK) {
+        return 0;
+    }
+    if (twai_start() != ESP_OK) {
+        twai_driver_uninstall();
+        return 0;
+    }
+
+    uint32_t frames = 0;
+    uint32_t start = millis();
+    for (;;) {
+        uint32_t elapsed = millis() - start;
+        uint32_t limit = frames ? windowMs : min(windowMs, silenceMs);
+        if (elapsed >= limit) {
+            break;
+        }
+        twai_message_t message;
+        if (twai_receive(&message, pdMS_TO_TICKS(limit - elapsed)) != ESP_OK) {
+            continue;
+        }
+        frames++;
+        if (!message.extd && message.identifier < CAN_DISPATCH_SIZE) {
+            idBits[message.identifier >> 3] |= 1 << (message.identifier & 7);
+        }
+    }
+
+    twai_stop();
+    twai_driver_uninstall();
+    return frames;
+}
+
+bool canDriverIsRunning() {
+    return driverRunning;
+}
+
+const CanAcceptanceFilter& canDriverGetFilter() {
+    return activeFilter;
+}
+
+uint16_t canDriverDrain(CanFrameHandler handler) {
+    if (!driverRunning || ingestTask) {
+        return 0;  // Ingest task owns the RX queue
+    }
+    return drainBatch(handler, CAN_RX_WAIT_MS);
+}
+
+const CanRxStats& canDriverGetRxStats() {
+    return rxStats;
+}
+
+bool canDriverStartTask(CanFrameHandler handler) {
+    if (ingestTask) {
+        return true;
+    }
+    ingestHandler = handler;
+    BaseType_t ok = xTaskCreate(canIngestTask, "canIngest", CAN_TASK_STACK,
+                                nullptr, CAN_TASK_PRIORITY, &ingestTask);
+    if (ok != pdPASS) {
+        ingestTask = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void canDriverCheckHealth() {
+    if (!driverRunning && !recovery.isRecovering()) {
+        return;  // Stopped on purpose (mock profile, standby)
+    }
+
+    static const char* const conditionNames[] = {
+        "ok", "error limit", "bus-off", "recovering", "stopped", "offline"
+    };
+    CanBusCondition condition = readBusCondition();
+    bool wasRecovering = recovery.isRecovering();
+    CanRecoveryAction action = recovery.update(millis(), condition);
+
+    if (wasRecovering && !recovery.isRecovering()) {
+        Serial.printf("[CAN] Bus recovered after %lu ms\n",
+                      (unsigned long)recovery.getStats().lastDowntimeMs);
+    }
+    if (action == CanRecoveryAction::NONE) {
+        return;
+    }
+    Serial.printf("[CAN] Bus fault (%s), attempt %u/%u: ", conditionNames[(uint8_t)condition],
+                  recovery.getAttempts(), CAN_RECOVERY_MAX_ATTEMPTS);
+
+    switch (action) {
+        case CanRecoveryAction::INITIATE_RECOVERY:
+            Serial.println("initiating bus-off recovery");
+            twai_initiate_recovery();
+            break;
+        case CanRecoveryAction::START:
+            Serial.println("restarting controller");
+            twai_start();
+            break;
+        case CanRecoveryAction::REINSTALL:
+            Serial.println("reinstalling driver");
+            canDriverEnd();
+            canDriverBegin();
+            break;
+        case CanRecoveryAction::REBOOT:
+        default:
+            Serial.println("not recovered, rebooting");
+            if (faultRebootMagic != FAULT_REBOOT_MAGIC) {
+                faultRebootMagic = FAULT_REBOOT_MAGIC;
+                faultReboots = 0;
+            }
+            faultReboots++;
+            configFlush();
+            delay(100);
+            ESP.restart();
+            break;
+    }
+}
+
+bool canDriverIsRecovering() {
+    return recovery.isRecovering();
+}
+
+const CanRecoveryStats& canDriverGetRecoveryStats() {
+    return recovery.getStats();
+}
+
+uint32_t canDriverGetFaultReboots() {
+    return faultRebootMagic == FAULT_REBOOT_MAGIC ? faultReboots : 0;
+}
+
+TaskHandle_t canDriverGetTaskHandle() {
+    return ingestTask;
+}
+
+uint64_t canDriverGetTaskBusyUs() {
+    return ingestBusyUs;
+}
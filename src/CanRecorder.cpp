@@ -0,0 +1,327 @@
+/**
+ * @file CanRecorder.cpp
+ * @brief High-rate CAN frame recorder to LittleFS
+ *
+ * The ring is single producer (canRecorderCapture(), ingest task) and single
+ * consumer (canRecorderFlush(), writer task). Indices are free-running
+ * 16-bit counters masked into the ring, so head - tail is the number of
+ * buffered records; each side only writes its own index.
+ */
+
+#include "CanRecorder.h"
+#include <LittleFS.h>
+#include <esp_task_wdt.h>
+
+#define REC_RING_MASK        (REC_RING_FRAMES - 1)
+#define REC_STOP_TIMEOUT_MS  2000    // Max wait for the writer to drain on REC STOP
+
+struct RecFilter {
+    uint16_t id;
+    uint16_t mask;
+};
+
+// =============================================================================
+// PRIVATE VARIABLES
+// =============================================================================
+
+static CanRecord ring[REC_RING_FRAMES];
+static volatile uint16_t ringHead = 0;      // Written by the ingest task
+static volatile uint16_t ringTail = 0;      // Written by the writer
+
+static volatile CanRecorderState state = CanRecorderState::IDLE;
+static int16_t triggerId = -1;
+static RecFilter filters[REC_MAX_FILTERS];
+static volatile uint8_t filterCount = 0;
+
+static CanRecorderStats stats = {};
+static File recFile;
+static uint16_t fileSequence = 0;
+static unsigned long lastWriteMs = 0;
+static const char* lastError = nullptr;
+
+static TaskHandle_t writerTask = nullptr;
+static volatile bool stopRequest = false;   // Writer drains, closes, clears it
+static volatile bool dropRequest = false;   // Stop timed out: writer drops the ring instead
+
+// =============================================================================
+// PRIVATE FUNCTIONS
+// =============================================================================
+
+/**
+ * @brief Truncate recording file `index` and write its header
+ */
+static bool openFile(uint8_t index) {
+    recFile = LittleFS.open(canRecorderFilePath(index), "w");
+    if (!recFile) return false;
+
+    CanRecordHeader header = {};
+    header.magic = REC_MAGIC;
+    header.version = REC_VERSION;
+    header.recordSize = sizeof(CanRecord);
+    header.startMs = stats.startMs;
+    header.sequence = fileSequence++;
+    if (recFile.write((const uint8_t*)&header, sizeof(header)) != sizeof(header)) {
+        recFile.close();
+        return false;
+    }
+
+    stats.fileIndex = index;
+    stats.fileBytes = sizeof(header);
+    return true;
+}
+
+static bool passesFilters(uint16_t id) {
+    uint8_t count = filterCount;
+    if (count == 0) return true;
+    for (uint8_t i = 0; i < count; i++) {
+        if (((id ^ filters[i].id) & filters[i].mask) == 0) return true;
+    }
+    return false;
+}
+
+static void canRecorderTask(void* arg) {
+    (void)arg;
+    for (;;) {
+        vTaskDelay(pdMS_TO_TICKS(REC_TASK_POLL_MS));
+        if (!recFile) continue;
+
+        bool closing = stopRequest;
+        while (!dropRequest && canRecorderFlush(closing) > 0) {
+            // Catch up: several chunks may be waiting after a busy period
+        }
+        if (closing) {
+            if (dropRequest) {
+                // Already counted as write errors by canRecorderStop()
+                ringTail = ringHead;
+                dropRequest = false;
+            }
+            recFile.close();
+            stopRequest = false;
+        }
+    }
+}
+
+// =============================================================================
+// PUBLIC API
+// =============================================================================
+
+bool canRecorderBegin() {
+    if (writerTask) return true;
+    BaseType_t ok = xTaskCreate(canRecorderTask, "canRecorder", REC_TASK_STACK,
+                                nullptr, REC_TASK_PRIORITY, &writerTask);
+    if (ok != pdPASS) {
+        writerTask = nullptr;
+        return false;
+    }
+    return true;
+}
+
+bool canRecorderStart(int16_t trigger) {
+    lastError = nullptr;
+    if (state != CanRecorderState::IDLE || recFile) {
+        lastError = "already recording";
+        return false;
+    }
+
+    // Previous recording is replaced: its space counts as free
+    LittleFS.remove(REC_FILE_0);
+    LittleFS.remove(REC_FILE_1);
+    size_t fsFree = LittleFS.totalBytes() - LittleFS.usedBytes();
+    if (fsFree < 2 * (size_t)REC_FILE_MAX_BYTES) {
+        lastError = "not enough free space for two files";
+        return false;
+    }
+
+    memset(&stats, 0, sizeof(stats));
+    stats.startMs = millis();
+    fileSequence = 0;
+    ringHead = 0;
+    ringTail = 0;
+    lastWriteMs = stats.startMs;
+    stopRequest = false;
+
+    if (!openFile(0)) {
+        lastError = "cannot create file";
+        return false;
+    }
+
+    triggerId = trigger;
+    __sync_synchronize();  // Ring and file ready before capture starts
+    state = trigger >= 0 ? CanRecorderState::ARMED : CanRecorderState::RECORDING;
+    return true;
+}
+
+void canRecorderStop() {
+    if (state == CanRecorderState::IDLE && !recFile) return;
+
+    state = CanRecorderState::IDLE;
+    stats.stopMs = millis();
+
+    if (writerTask) {
+        // Let the writer drain the ring and close the file
+        stopRequest = true;
+        unsigned long start = millis();
+        while (stopRequest && millis() - start < REC_STOP_TIMEOUT_MS) {
+            esp_task_wdt_reset();
+            vTaskDelay(pdMS_TO_TICKS(REC_TASK_POLL_MS));
+        }
+        if (!stopRequest) return;
+        // Writer stuck (flash error): the rest of the ring is lost. The file
+        // stays the writer's, it closes it once the write returns; until
+        // then canRecorderStart() refuses to reopen it
+        stats.writeErrors += canRecorderGetBuffered();
+        dropRequest = true;
+        return;
+    }
+
+    while (canRecorderFlush(true) > 0) {
+        // No writer task: drain inline
+    }
+    recFile.close();
+    stopRequest = false;
+}
+
+bool canRecorderAddFilter(uint16_t id, uint16_t mask) {
+    uint8_t count = filterCount;
+    if (count >= REC_MAX_FILTERS) return false;
+    filters[count].id = id & 0x7FF;
+    filters[count].mask = mask & 0x7FF;
+    __sync_synchronize();  // Entry complete before the ingest task can see it
+    filterCount = count + 1;
+    return true;
+}
+
+void canRecorderClearFilters() {
+    filterCount = 0;
+}
+
+uint8_t canRecorderGetFilterCount() {
+    return filterCount;
+}
+
+void canRecorderGetFilter(uint8_t i, uint16_t& id, uint16_t& mask) {
+    id = filters[i].id;
+    mask = filters[i].mask;
+}
+
+void canRecorderCapture(const CanFrame& frame) {
+    CanRecorderState current = state;
+    if (current == CanRecorderState::IDLE) return;
+
+    if (frame.extd) {
+        stats.extended++;
+        return;
+    }
+
+    uint16_t id = (uint16_t)(frame.identifier & 0x7FF);
+    uint8_t flags = frame.rtr ? REC_FLAG_RTR : 0;
+
+    if (current == CanRecorderState::ARMED) {
+        if (id != triggerId) {
+            stats.filtered++;
+            return;
+        }
+        // The trigger frame is kept even if the filters would reject it
+        state = CanRecorderState::RECORDING;
+        stats.triggerMs = millis();
+        flags |= REC_FLAG_TRIGGER;
+    } else if (!passesFilters(id)) {
+        stats.filtered++;
+        return;
+    }
+
+    uint16_t head = ringHead;
+    uint16_t buffered = head - ringTail;
+    if (buffered >= REC_RING_FRAMES) {
+        stats.dropped++;
+        return;
+    }
+
+    CanRecord& rec = ring[head & REC_RING_MASK];
+    uint8_t dlc = frame.data_length_code > 8 ? 8 : frame.data_length_code;
+    rec.timestampUs = micros();
+    rec.id = id;
+    rec.dlc = dlc;
+    rec.flags = flags;
+    memset(rec.data, 0, sizeof(rec.data));
+    if (!frame.rtr) memcpy(rec.data, frame.data, dlc);
+
+    __sync_synchronize();  // Record complete before the writer can see it
+    ringHead = head + 1;
+
+    stats.recorded++;
+    if (buffered + 1 > stats.ringHighWater) stats.ringHighWater = buffered + 1;
+}
+
+uint16_t canRecorderFlush(bool force) {
+    if (!recFile) return 0;
+
+    uint16_t tail = ringTail;
+    uint16_t buffered = ringHead - tail;
+    if (buffered == 0) return 0;
+    if (!force && buffered < REC_FLUSH_FRAMES && millis() - lastWriteMs < REC_FLUSH_MAX_MS) {
+        return 0;
+    }
+
+    // One contiguous run: chunks stay aligned on REC_FLUSH_FRAMES records
+    uint16_t idx = tail & REC_RING_MASK;
+    uint16_t count = buffered;
+    if (count > REC_FLUSH_FRAMES - (idx % REC_FLUSH_FRAMES)) {
+        count = REC_FLUSH_FRAMES - (idx % REC_FLUSH_FRAMES);
+    }
+
+    uint32_t room = (REC_FILE_MAX_BYTES - stats.fileBytes) / sizeof(CanRecord);
+    if (room == 0) {
+        recFile.close();
+        stats.rotations++;
+        if (!openFile(stats.fileIndex ^ 1)) {
+            // Nowhere to write: drop what is buffered
+            stats.writeErrors += buffered;
+            ringTail = tail + buffered;
+            return buffered;
+        }
+        room = (REC_FILE_MAX_BYTES - stats.fileBytes) / sizeof(CanRecord);
+    }
+    if (count > room) count = (uint16_t)room;
+
+    size_t bytes = (size_t)count * sizeof(CanRecord);
+    uint32_t start = micros();
+    size_t written = recFile.write((const uint8_t*)&ring[idx], bytes);
+    uint32_t elapsed = micros() - start;
+
+    stats.writes++;
+    if (elapsed > stats.writeMaxUs) stats.writeMaxUs = elapsed;
+    stats.fileBytes += written;
+    uint16_t whole = (uint16_t)(written / sizeof(CanRecord));
+    stats.written += whole;
+    stats.writeErrors += count - whole;
+    lastWriteMs = millis();
+
+    __sync_synchronize();  // Done reading the records before releasing them
+    ringTail = tail + count;
+    return count;
+}
+
+CanRecorderState canRecorderGetState() {
+    return state;
+}
+
+const CanRecorderStats& canRecorderGetStats() {
+    return stats;
+}
+
+const char* canRecorderError() {
+    return lastError;
+}
+
+uint16_t canRecorderGetBuffered() {
+    return ringHead - ringTail;
+}
+
+const char* canRecorderFilePath(uint8_t index) {
+    return index ? REC_FILE_1 : REC_FILE_0;
+}
+
+TaskHandle_t canRecorderGetTaskHandle() {
+    return writerTask;
+}
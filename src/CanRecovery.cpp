@@ -0,0 +1,127 @@
+/**
+ * @file CanRecovery.cpp
+ * @brief Bus-off / error-limit recovery policy (see CanRecovery.h)
+ */
+
+#include "CanRecovery.h"
+#include <string.h>
+
+CanRecovery::CanRecovery() {
+    reset();
+}
+
+// =============================================================================
+// PUBLIC API
+// =============================================================================
+
+void CanRecovery::reset() {
+    _state = State::RUNNING;
+    _attempts = 0;
+    _downSinceMs = 0;
+    _upSinceMs = 0;
+    _stepMs = 0;
+    _waitMs = 0;
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+CanRecoveryAction CanRecovery::update(unsigned long now, CanBusCondition condition) {
+    if (_state == State::RUNNING) {
+        if (condition == CanBusCondition::OK) {
+            if (_attempts && now - _upSinceMs >= CAN_RECOVERY_STABLE_MS) {
+                _attempts = 0;
+            }
+            return CanRecoveryAction::NONE;
+        }
+        if (condition == CanBusCondition::BUS_OFF) _stats.busOffs++;
+        if (condition == CanBusCondition::ERROR_LIMIT) _stats.errorLimits++;
+        _downSinceMs = now;
+        return fault(now, condition);
+    }
+
+    // Running again, whichever step (or a standby wake / profile load) did it
+    if (condition == CanBusCondition::OK) {
+        recovered(now);
+        return CanRecoveryAction::NONE;
+    }
+
+    switch (_state) {
+        case State::BACKOFF:
+            if (now - _stepMs < _waitMs) return CanRecoveryAction::NONE;
+            return attempt(now, condition);
+
+        case State::RECOVERING:
+            if (condition == CanBusCondition::STOPPED) {
+                _state = State::VERIFY;
+                return CanRecoveryAction::START;
+            }
+            if (now - _stepMs >= CAN_RECOVERY_TIMEOUT_MS) {
+                _state = State::VERIFY;
+                return CanRecoveryAction::REINSTALL;
+            }
+            return CanRecoveryAction::NONE;
+
+        case State::VERIFY:
+        default:
+            _stats.failedAttempts++;
+            return fault(now, condition);
+    }
+}
+
+uint32_t CanRecovery::backoffMs(uint8_t attempt) {
+    if (attempt <= 1) return 0;
+    uint32_t ms = CAN_RECOVERY_BACKOFF_MS;
+    for (uint8_t i = 2; i < attempt && ms < CAN_RECOVERY_BACKOFF_MAX_MS; i++) {
+        ms *= 2;
+    }
+    return ms < CAN_RECOVERY_BACKOFF_MAX_MS ? ms : CAN_RECOVERY_BACKOFF_MAX_MS;
+}
+
+// =============================================================================
+// PRIVATE FUNCTIONS
+// =============================================================================
+
+/**
+ * @brief One more consecutive fault: back off, or give up
+ */
+CanRecoveryAction CanRecovery::fault(unsigned long now, CanBusCondition condition) {
+    if (_attempts >= CAN_RECOVERY_MAX_ATTEMPTS) {
+        return CanRecoveryAction::REBOOT;
+    }
+    _attempts++;
+    _waitMs = backoffMs(_attempts);
+    _stepMs = now;
+    _state = State::BACKOFF;
+    if (_waitMs == 0) return attempt(now, condition);
+    return CanRecoveryAction::NONE;
+}
+
+/**
+ * @brief First recovery step for the current condition
+ */
+CanRecoveryAction CanRecovery::attempt(unsigned long now, CanBusCondition condition) {
+    _stepMs = now;
+    switch (condition) {
+        case CanBusCondition::BUS_OFF:
+            _state = State::RECOVERING;
+            return CanRecoveryAction::INITIATE_RECOVERY;
+        case CanBusCondition::RECOVERING:
+            _state = State::RECOVERING;     // Already under way
+            return CanRecoveryAction::NONE;
+        case CanBusCondition::STOPPED:
+            _state = State::VERIFY;
+            return CanRecoveryAction::START;
+        default:
+            _state = State::VERIFY;
+            return CanRecoveryAction::REINSTALL;
+    }
+}
+
+void CanRecovery::recovered(unsigned long now) {
+    uint32_t down = (uint32_t)(now - _downSinceMs);
+    _stats.recoveries++;
+    _stats.lastDowntimeMs = down;
+    if (down > _stats.maxDowntimeMs) _stats.maxDowntimeMs = down;
+    _stats.totalDowntimeMs += down;
+    _upSinceMs = now;
+    _state = State::RUNNING;
+}
@@ -0,0 +1,262 @@
+/**
+ * @file CanReplay.cpp
+ * @brief Replay of recorded CAN logs through the frame handler
+ */
+
+#include "CanReplay.h"
+#include "CanRecorder.h"
+#include <ctype.h>
+#include <stdlib.h>
+
+CanReplay::CanReplay()
+    : _format(CanReplayFormat::NONE)
+    , _speed(1)
+    , _loop(false)
+    , _finished(false)
+    , _haveFirst(false)
+    , _firstUs(0)
+    , _lastRecordUs(0)
+    , _recordTimeUs(0)
+    , _lastNowUs(0)
+    , _elapsedUs(0)
+    , _pending()
+    , _pendingUs(0)
+    , _hasPending(false)
+    , _stats()
+{
+}
+
+// =============================================================================
+// PUBLIC API
+// =============================================================================
+
+bool CanReplay::begin(const char* path, uint16_t speed, bool loop) {
+    end();
+
+    _file = LittleFS.open(path, "r");
+    if (!_file) return false;
+
+    // Recorder files start with the header magic, candump lines with '('
+    CanRecordHeader header;
+    if (_file.read((uint8_t*)&header, sizeof(header)) == sizeof(header) &&
+        header.magic == REC_MAGIC) {
+        if (header.version != REC_VERSION || header.recordSize != sizeof(CanRecord)) {
+            _file.close();
+            return false;
+        }
+        _format = CanReplayFormat::RECORDER;
+    } else if (_file.seek(0) && _file.peek() == '(') {
+        _format = CanReplayFormat::CANDUMP;
+    } else {
+        _file.close();
+        return false;
+    }
+
+    _speed = speed;
+    _loop = loop;
+    _finished = false;
+    _hasPending = false;
+    _haveFirst = false;
+    memset(&_stats, 0, sizeof(_stats));
+    _lastNowUs = micros();
+    _elapsedUs = 0;
+    return true;
+}
+
+void CanReplay::end() {
+    if (_file) _file.close();
+    _format = CanReplayFormat::NONE;
+    _hasPending = false;
+}
+
+uint16_t CanReplay::update(CanReplayHandler handler) {
+    if (!isActive() || _finished) return 0;
+
+    uint32_t now = micros();
+    _elapsedUs += (uint32_t)(now - _lastNowUs);
+    _lastNowUs = now;
+    uint64_t due = _speed ? _elapsedUs * _speed : UINT64_MAX;
+
+    uint16_t count = 0;
+    while (count < REPLAY_MAX_BURST) {
+        if (!_hasPending) {
+            if (!next(_pending, _pendingUs)) {
+                if (!_loop || !rewind()) {
+                    _finished = true;
+                    break;
+                }
+                _elapsedUs = 0;     // Log time restarts at 0
+                if (_speed) due = 0;
+                continue;
+            }
+            _hasPending = true;
+        }
+        if (_pendingUs > due) break;
+
+        if (_speed) {
+            uint32_t late = (uint32_t)((due - _pendingUs) / _speed);
+            if (late > _stats.maxLateUs) _stats.maxLateUs = late;
+        }
+        _hasPending = false;
+        handler(_pending);
+        count++;
+    }
+    return count;
+}
+
+uint32_t CanReplay::msUntilNext() const {
+    if (!isActive() || _finished) return UINT32_MAX;
+    if (!_hasPending || _speed == 0) return 0;
+
+    uint64_t elapsedUs = _elapsedUs + (uint32_t)(micros() - _lastNowUs);
+    uint64_t dueUs = (_pendingUs + _speed - 1) / _speed;
+    if (dueUs <= elapsedUs) return 0;
+    uint64_t ms = (dueUs - elapsedUs + 999) / 1000;     // Never wake before it
+    return ms > UINT32_MAX ? UINT32_MAX : (uint32_t)ms;
+}
+
+uint32_t CanReplay::run(CanReplayHandler handler, uint32_t maxFrames) {
+    if (!isActive()) return 0;
+
+    uint32_t count = 0;
+    CanFrame frame;
+    uint64_t timeUs;
+    while ((maxFrames == 0 || count < maxFrames) && next(frame, timeUs)) {
+        handler(frame);
+        count++;
+    }
+    if (maxFrames == 0 || count < maxFrames) _finished = true;
+    return count;
+}
+
+bool CanReplay::next(CanFrame& frame, uint64_t& timeUs) {
+    bool ok = false;
+    if (_format == CanReplayFormat::RECORDER) {
+        ok = readRecord(frame, timeUs);
+    } else if (_format == CanReplayFormat::CANDUMP) {
+        ok = readCandump(frame, timeUs);
+    }
+    if (ok) {
+        _stats.frames++;
+        _stats.logTimeUs = timeUs;
+    }
+    return ok;
+}
+
+// =============================================================================
+// PRIVATE FUNCTIONS
+// =============================================================================
+
+/**
+ * @brief Back to the first frame; false if the log has no frame at all
+ */
+bool CanReplay::rewind() {
+    if (_stats.frames == 0) return false;
+    bool ok = _file.seek(_format == CanReplayFormat::RECORDER ? sizeof(CanRecordHeader) : 0);
+    _haveFirst = false;
+    _stats.loops++;
+    return ok;
+}
+
+bool CanReplay::readRecord(CanFrame& frame, uint64_t& timeUs) {
+    CanRecord rec;
+    if (_file.read((uint8_t*)&rec, sizeof(rec)) != sizeof(rec)) return false;
+
+    // 32-bit micros() wraps every 71 min: accumulate deltas instead
+    if (!_haveFirst) {
+        _haveFirst = true;
+        _recordTimeUs = 0;
+    } else {
+        _recordTimeUs += (uint32_t)(rec.timestampUs - _lastRecordUs);
+    }
+    _lastRecordUs = rec.timestampUs;
+
+    memset(&frame, 0, sizeof(frame));
+    frame.identifier = rec.id;
+    frame.data_length_code = rec.dlc > 8 ? 8 : rec.dlc;
+    frame.rtr = (rec.flags & REC_FLAG_RTR) ? 1 : 0;
+    memcpy(frame.data, rec.data, frame.data_length_code);
+    timeUs = _recordTimeUs;
+    return true;
+}
+
+bool CanReplay::readCandump(CanFrame& frame, uint64_t& timeUs) {
+    char line[REPLAY_LINE_MAX];
+
+    for (;;) {
+        size_t len = 0;
+        int c;
+        while ((c = _file.read()) >= 0 && c != '\n') {
+            if (len < sizeof(line) - 1) line[len++] = (char)c;
+        }
+        if (c < 0 && len == 0) return false;
+        line[len] = '\0';
+        if (len && line[len - 1] == '\r') line[--len] = '\0';
+        if (len == 0) continue;
+
+        uint64_t absUs;
+        if (!parseCandump(line, frame, absUs)) {
+            _stats.skipped++;
+            continue;
+        }
+        if (!_haveFirst) {
+            _haveFirst = true;
+            _firstUs = absUs;
+        }
+        timeUs = absUs >= _firstUs ? absUs - _firstUs : 0;
+        return true;
+    }
+}
+
+/**
+ * @brief Parse "(<sec>.<usec>) <iface> <id>#<data>" (standard frames only)
+ */
+bool CanReplay::parseCandump(const char* line, CanFrame& frame, uint64_t& absUs) {
+    if (line[0] != '(') return false;
+
+    char* p;
+    uint64_t sec = strtoull(line + 1, &p, 10);
+    if (*p != '.') return false;
+    const char* frac = p + 1;
+    uint32_t usec = 0;
+    int digits = 0;
+    while (*frac >= '0' && *frac <= '9') {
+        if (digits < 6) {
+            usec = usec * 10 + (*frac - '0');
+            digits++;
+        }
+        frac++;
+    }
+    while (digits++ < 6) usec *= 10;
+    if (*frac != ')') return false;
+    absUs = sec * 1000000ULL + usec;
+
+    // Interface name, then the frame
+    const char* s = frac + 1;
+    while (*s == ' ') s++;
+    while (*s && *s != ' ') s++;
+    while (*s == ' ') s++;
+
+    unsigned long id = strtoul(s, &p, 16);
+    if (p - s == 0 || p - s > 3 || *p != '#' || id > 0x7FF) return false;  // Extended: 8 digits
+    s = p + 1;
+    if (*s == '#') return false;                                               // CAN FD
+
+    memset(&frame, 0, sizeof(frame));
+    frame.identifier = (uint32_t)id;
+    if (*s == 'R') {
+        frame.rtr = 1;
+        if (s[1] >= '0' && s[1] <= '8') frame.data_length_code = s[1] - '0';
+        return true;
+    }
+
+    uint8_t dlc = 0;
+    while (dlc < 8 && isxdigit((unsigned char)s[0]) && isxdigit((unsigned char)s[1])) {
+        char hex[3] = { s[0], s[1], '\0' };
+        frame.data[dlc++] = (uint8_t)strtoul(hex, nullptr, 16);
+        s += 2;
+    }
+    if (*s != '\0' && *s != ' ') return false;
+    frame.data_length_code = dlc;
+    return true;
+}
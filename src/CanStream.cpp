@@ -0,0 +1,197 @@
+/**
+ * @file CanStream.cpp
+ * @brief Live binary CAN streaming over USB (LOG BIN)
+ *
+ * Same single producer / single consumer ring as the recorder
+ * (CanRecorder.cpp): the ingest task only writes ringHead, loop() only
+ * writes ringTail.
+ */
+
+#include "CanStream.h"
+#include "crc32.h"
+
+#define CANSTREAM_RING_MASK  (CANSTREAM_RING_FRAMES - 1)
+#define CANSTREAM_PACKET_SIZE (CANSTREAM_PACKET_MAX + BIN_OVERHEAD)
+
+struct StreamEntry {
+    uint32_t timestampUs;
+    uint16_t idDlc;         // Record layout: ID | DLC << 11 | RTR << 15
+    uint8_t  data[8];
+};
+
+// =============================================================================
+// PRIVATE VARIABLES
+// =============================================================================
+
+static StreamEntry ring[CANSTREAM_RING_FRAMES];
+static volatile uint16_t ringHead = 0;      // Written by the ingest task
+static volatile uint16_t ringTail = 0;      // Written by loop()
+
+static volatile bool active = false;
+static uint16_t filterId = 0;
+static uint16_t filterMask = 0;
+static uint8_t decimation = 1;
+static uint8_t decimCount[2048];            // Frames seen per ID, modulo decimation
+
+static CanStreamStats stats = {};
+static uint16_t packetSeq = 0;
+
+static uint8_t packet[CANSTREAM_PACKET_SIZE];
+static size_t packetLen = 0;                // Built, waiting for USB room
+static uint16_t packetFrames = 0;
+
+// =============================================================================
+// PRIVATE FUNCTIONS
+// =============================================================================
+
+static inline void put16(uint8_t* p, uint16_t v) {
+    p[0] = v & 0xFF;
+    p[1] = v >> 8;
+}
+
+static inline void put32(uint8_t* p, uint32_t v) {
+    for (int i = 0; i < 4; i++) p[i] = (v >> (8 * i)) & 0xFF;
+}
+
+// =============================================================================
+// PUBLIC API
+// =============================================================================
+
+void canStreamStart(uint16_t id, uint16_t mask, uint8_t decim) {
+    active = false;
+    memset(&stats, 0, sizeof(stats));
+    memset(decimCount, 0, sizeof(decimCount));
+    filterId = id & 0x7FF;
+    filterMask = mask & 0x7FF;
+    decimation = decim ? decim : 1;
+    ringHead = 0;
+    ringTail = 0;
+    packetLen = 0;
+    packetSeq = 0;
+    __sync_synchronize();  // Settings and ring ready before capture starts
+    active = true;
+}
+
+void canStreamStop() {
+    active = false;
+    packetLen = 0;
+}
+
+bool canStreamIsActive() {
+    return active;
+}
+
+void canStreamCapture(const CanFrame& frame) {
+    if (!active) return;
+
+    uint16_t id = (uint16_t)(frame.identifier & 0x7FF);
+    if (frame.extd || ((id ^ filterId) & filterMask) != 0) {
+        stats.filtered++;
+        return;
+    }
+    if (decimation > 1) {
+        uint8_t n = decimCount[id];
+        decimCount[id] = (n + 1 >= decimation) ? 0 : n + 1;
+        if (n != 0) {
+            stats.decimated++;
+            return;
+        }
+    }
+
+    uint16_t head = ringHead;
+    uint16_t buffered = head - ringTail;
+    if (buffered >= CANSTREAM_RING_FRAMES) {
+        stats.dropped++;
+        return;
+    }
+
+    StreamEntry& e = ring[head & CANSTREAM_RING_MASK];
+    uint8_t dlc = frame.data_length_code > 8 ? 8 : frame.data_length_code;
+    e.timestampUs = micros();
+    e.idDlc = id | (dlc << 11) | (frame.rtr ? 0x8000 : 0);
+    if (!frame.rtr) memcpy(e.data, frame.data, dlc);
+
+    __sync_synchronize();  // Entry complete before loop() can see it
+    ringHead = head + 1;
+
+    stats.queued++;
+    if (buffered + 1 > stats.ringHighWater) stats.ringHighWater = buffered + 1;
+}
+
+size_t canStreamBuildPacket(uint8_t* out) {
+    uint16_t tail = ringTail;
+    uint16_t buffered = ringHead - tail;
+    if (buffered == 0) return 0;
+
+    uint8_t* payload = out + 7;
+    size_t len = CANSTREAM_HEADER_SIZE;
+    uint16_t count = 0;
+    uint32_t base = ring[tail & CANSTREAM_RING_MASK].timestampUs;
+    uint32_t prev = base;
+
+    while (count < buffered) {
+        const StreamEntry& e = ring[(tail + count) & CANSTREAM_RING_MASK];
+        uint8_t dlc = (e.idDlc & 0x8000) ? 0 : (e.idDlc >> 11) & 0x0F;
+        uint32_t delta = e.timestampUs - prev;
+        if (delta > 0xFFFF || len + 4 + dlc > CANSTREAM_PACKET_MAX) break;
+
+        put16(&payload[len], (uint16_t)delta);
+        put16(&payload[len + 2], e.idDlc);
+        memcpy(&payload[len + 4], e.data, dlc);
+        len += 4 + dlc;
+        prev = e.timestampUs;
+        count++;
+    }
+
+    __sync_synchronize();  // Done reading the entries before releasing them
+    ringTail = tail + count;
+
+    put32(&payload[0], base);
+    put32(&payload[4], stats.dropped);
+    put16(&payload[8], count);
+
+    out[0] = BIN_MAGIC0;
+    out[1] = BIN_MAGIC1;
+    out[2] = BIN_CAN_LOG;
+    put16(&out[3], packetSeq++);
+    put16(&out[5], (uint16_t)len);
+    uint32_t crc = crc32_le(0, &out[2], 5 + len);
+    put32(&out[7 + len], crc);
+
+    packetFrames = count;
+    return BIN_OVERHEAD + len;
+}
+
+void canStreamPoll() {
+    if (!active) return;
+
+    if (packetLen == 0) {
+        uint16_t tail = ringTail;
+        uint16_t buffered = ringHead - tail;
+        if (buffered == 0) return;
+
+        // Wait for a full packet's worth unless the oldest frame is getting stale
+        uint32_t age = micros() - ring[tail & CANSTREAM_RING_MASK].timestampUs;
+        if (buffered < CANSTREAM_PACKET_MAX / CANSTREAM_RECORD_MAX &&
+            age < CANSTREAM_FLUSH_MS * 1000UL) {
+            return;
+        }
+        packetLen = canStreamBuildPacket(packet);
+    }
+
+    // Whole packets only: text replies must not split one
+    if (Serial.availableForWrite() < (int)packetLen) return;
+    Serial.write(packet, packetLen);
+    stats.packets++;
+    stats.sent += packetFrames;
+    stats.bytes += packetLen;
+    packetLen = 0;
+}
+
+const CanStreamStats& canStreamGetStats() {
+    return stats;
+}
+
+uint16_t canStreamGetBuffered() {
+    return ringHead - ringTail;
+}
@@ -0,0 +1,346 @@
+/**
+ * @file CanStress.cpp
+ * @brief Synthetic bus load through the frame handler
+ */
+
+#include "CanStress.h"
+#include "CanDriver.h"
+#include "MockDataGenerator.h"
+
+#define STRESS_VALUE_STEP_MS      50     // Value change period, as MockDataGenerator
+#define STRESS_INDICATOR_MS       500    // Indicator flags blink
+#define STRESS_FLAG_PERIOD_MS     3000   // Other flags toggle, shifted per target
+
+CanStress::CanStress()
+    : _frameCount(0)
+    , _config()
+    , _handler(nullptr)
+    , _task(nullptr)
+    , _active(false)
+    , _stopRequest(false)
+    , _finished(false)
+    , _rate(0)
+    , _lastUs(0)
+    , _clockUs(0)
+    , _arrivalAcc(0)
+    , _nextBurstUs(0)
+    , _burstLeft(0)
+    , _nextFrame(0)
+    , _seed(0)
+    , _stepCount(0)
+    , _stepStartUs(0)
+    , _stepBaseOffered(0)
+    , _stepBaseLost(0)
+    , _maxSustained(0)
+    , _stats()
+{
+    memset(_ids, 0, sizeof(_ids));
+}
+
+// =============================================================================
+// PUBLIC API
+// =============================================================================
+
+bool CanStress::begin(const VehicleProfile& profile, const CanStressConfig& config, uint32_t nowUs) {
+    end();
+    if (profile.frameCount == 0) return false;
+
+    _frameCount = profile.frameCount;
+    memcpy(_frames, profile.frames, sizeof(FrameConfig) * profile.frameCount);
+    memcpy(_fields, profile.fields, sizeof(FieldConfig) * profile.fieldCount);
+    memset(_ids, 0, sizeof(_ids));
+    for (uint16_t i = 0; i < _frameCount; i++) {
+        uint16_t id = _frames[i].canId & 0x7FF;
+        _ids[id >> 3] |= 1 << (id & 7);
+    }
+
+    // Zero = what the ingest task has on the device
+    _config = config;
+    if (_config.rate > STRESS_LINE_RATE) _config.rate = STRESS_LINE_RATE;
+    if (_config.noisePct > 100) _config.noisePct = 100;
+    if (_config.burstPeriodMs == 0) _config.burstFrames = 0;
+    if (_config.queueLen == 0) _config.queueLen = CAN_RX_QUEUE_LEN;
+    if (_config.maxBatch == 0) _config.maxBatch = CAN_DRAIN_MAX_FRAMES;
+    if (_config.budgetUs == 0) _config.budgetUs = CAN_DRAIN_BUDGET_US;
+
+    memset(&_stats, 0, sizeof(_stats));
+    _lastUs = nowUs;
+    _clockUs = 0;
+    _arrivalAcc = 0;
+    _nextBurstUs = (uint64_t)_config.burstPeriodMs * 1000;
+    _burstLeft = 0;
+    _nextFrame = 0;
+    _seed = 0x2545F491;     // Same noise sequence on every run
+    _stepCount = 0;
+    _maxSustained = 0;
+    _rate = _config.rate;
+    if (isSweep()) startStep(0);
+
+    _finished = false;
+    _stopRequest = false;
+    _active = true;
+    return true;
+}
+
+void CanStress::end() {
+    _active = false;
+}
+
+uint16_t CanStress::service(uint32_t nowUs, CanStressHandler handler) {
+    if (!_active) return 0;
+
+    advance(nowUs);
+    uint32_t backlog = getBacklog();
+    if (backlog > _stats.queueHighWater) _stats.queueHighWater = backlog;
+
+    // Same batch limits as a drain of the RX queue
+    uint32_t timeMs = (uint32_t)(_clockUs / 1000);
+    uint32_t start = micros();
+    uint16_t count = 0;
+    while (count < _config.maxBatch && getBacklog() > 0) {
+        CanFrame frame;
+        nextFrame(frame, timeMs);
+        handler(frame);
+        _stats.handled++;
+        count++;
+        if (micros() - start >= _config.budgetUs) break;
+    }
+    _stats.busyUs += micros() - start;
+    _stats.elapsedMs = timeMs;
+
+    checkProgress();
+    return count;
+}
+
+void CanStress::nextFrame(CanFrame& frame, uint32_t timeMs) {
+    memset(&frame, 0, sizeof(frame));
+    frame.data_length_code = 8;
+
+    if (_config.noisePct && random() % 100 < _config.noisePct) {
+        uint16_t id;
+        do {
+            id = random() & 0x7FF;
+        } while (_ids[id >> 3] & (1 << (id & 7)));
+        frame.identifier = id;
+        uint32_t a = random(), b = random();
+        memcpy(frame.data, &a, 4);
+        memcpy(frame.data + 4, &b, 4);
+        _stats.noise++;
+        return;
+    }
+
+    const FrameConfig& config = _frames[_nextFrame];
+    _nextFrame = (_nextFrame + 1) % _frameCount;
+    frame.identifier = config.canId;
+    for (uint16_t i = 0; i < config.fieldCount; i++) {
+        encodeField(frame.data, _fields[config.firstField + i], timeMs);
+    }
+}
+
+bool CanStress::start(const VehicleProfile& profile, const CanStressConfig& config) {
+    if (!_handler || _active) return false;
+    if (!_task) {
+        BaseType_t ok = xTaskCreate(taskBody, "canStress", STRESS_TASK_STACK,
+                                    this, CAN_TASK_PRIORITY, &_task);
+        if (ok != pdPASS) {
+            _task = nullptr;
+            return false;
+        }
+    }
+    return begin(profile, config, micros());
+}
+
+// =============================================================================
+// SIMULATED BUS
+// =============================================================================
+
+/**
+ * @brief Bring the bus up to nowUs: arrivals at the rate, bursts at line rate
+ */
+void CanStress::advance(uint32_t nowUs) {
+    uint32_t remaining = nowUs - _lastUs;
+    _lastUs = nowUs;
+
+    while (remaining > 0) {
+        uint32_t slice = remaining;
+        if (_burstLeft == 0 && _config.burstFrames) {
+            if (_clockUs >= _nextBurstUs) {
+                _burstLeft = _config.burstFrames;
+                _nextBurstUs += (uint64_t)_config.burstPeriodMs * 1000;
+                _stats.bursts++;
+            } else if (_nextBurstUs - _clockUs < slice) {
+                slice = (uint32_t)(_nextBurstUs - _clockUs);
+            }
+        }
+
+        // A burst saturates the bus: it replaces the regular traffic
+        uint32_t rate = _burstLeft ? STRESS_LINE_RATE : _rate;
+        _arrivalAcc += (uint64_t)slice * rate;
+        uint32_t frames = (uint32_t)(_arrivalAcc / 1000000);
+        _arrivalAcc %= 1000000;
+        if (_burstLeft) {
+            if (frames >= _burstLeft) {
+                frames = _burstLeft;
+                _burstLeft = 0;
+            } else {
+                _burstLeft -= frames;
+            }
+        }
+        offer(frames);
+
+        _clockUs += slice;
+        remaining -= slice;
+    }
+}
+
+/**
+ * @brief Queue arriving frames; the ones finding the queue full are lost
+ */
+void CanStress::offer(uint32_t frames) {
+    _stats.offered += frames;
+    uint32_t backlog = getBacklog();
+    if (backlog > _config.queueLen) {
+        _stats.lost += backlog - _config.queueLen;
+    }
+}
+
+void CanStress::startStep(uint8_t index) {
+    _rate = (uint32_t)((uint64_t)STRESS_LINE_RATE * (index + 1) * STRESS_SWEEP_STEP_PCT / 100);
+    _steps[index].rate = _rate;
+    _steps[index].offered = 0;
+    _steps[index].lost = 0;
+    _stepCount = index + 1;
+    _stepStartUs = _clockUs;
+    _stepBaseOffered = _stats.offered;
+    _stepBaseLost = _stats.lost;
+}
+
+/**
+ * @brief End the run, or move the sweep to its next rate, when due
+ */
+void CanStress::checkProgress() {
+    if (isSweep()) {
+        CanStressStep& step = _steps[_stepCount - 1];
+        step.offered = _stats.offered - _stepBaseOffered;
+        step.lost = _stats.lost - _stepBaseLost;
+        if (_clockUs - _stepStartUs < (uint64_t)STRESS_SWEEP_STEP_MS * 1000) return;
+
+        if (step.lost == 0) {
+            _maxSustained = step.rate;
+            if (_stepCount < STRESS_SWEEP_STEPS) {
+                startStep(_stepCount);
+                return;
+            }
+        }
+    } else if (_config.durationMs == 0 || _clockUs < (uint64_t)_config.durationMs * 1000) {
+        return;
+    }
+    _finished = true;
+    _active = false;
+}
+
+uint32_t CanStress::random() {
+    _seed ^= _seed << 13;
+    _seed ^= _seed >> 17;
+    _seed ^= _seed << 5;
+    return _seed;
+}
+
+// =============================================================================
+// FRAME ENCODING
+// =============================================================================
+
+/**
+ * @brief Write the raw bytes that decode to the field's value at timeMs
+ *
+ * Numeric targets oscillate inside MockDataGenerator's bounds, flags
+ * toggle. The value goes through the inverse of the field's formula;
+ * BITMASK_EXTRACT fields only touch their bits, so the flags sharing a
+ * status word all land in it.
+ */
+void CanStress::encodeField(uint8_t* data, const FieldConfig& field, uint32_t timeMs) const {
+    if (field.byteCount == 0 || field.byteCount > 4 || field.startByte + field.byteCount > 8) return;
+
+    int32_t value = 0;
+    if (field.target >= OutputField::DOOR_DRIVER) {
+        bool indicator = field.target == OutputField::INDICATOR_LEFT ||
+                         field.target == OutputField::INDICATOR_RIGHT;
+        uint32_t period = indicator ? STRESS_INDICATOR_MS
+            : STRESS_FLAG_PERIOD_MS + 500 * ((uint32_t)field.target - (uint32_t)OutputField::DOOR_DRIVER);
+        value = (timeMs / period) & 1;
+    } else if (const MockFieldBounds* bounds = MockDataGenerator::getBounds(field.target)) {
+        // Triangle between the bounds, from the typical value
+        int64_t span = (int64_t)bounds->maxValue - bounds->minValue;
+        value = bounds->typicalValue;
+        if (bounds->cycleStep != 0 && span > 0) {
+            int64_t pos = ((int64_t)(timeMs / STRESS_VALUE_STEP_MS) * bounds->cycleStep +
+                           bounds->typicalValue - bounds->minValue) % (2 * span);
+            value = (int32_t)(pos <= span ? bounds->minValue + pos : bounds->maxValue - (pos - span));
+        }
+    }
+
+    uint32_t widthMask = field.byteCount == 4 ? 0xFFFFFFFFu : (1u << (8 * field.byteCount)) - 1;
+    uint32_t word;
+    if (field.formula == FormulaType::BITMASK_EXTRACT) {
+        // Current bits of the word (other fields of the same bytes)
+        word = 0;
+        for (uint8_t i = 0; i < field.byteCount; i++) {
+            uint8_t index = field.byteOrder == ByteOrder::MSB_FIRST ? i : field.byteCount - 1 - i;
+            word = (word << 8) | data[field.startByte + index];
+        }
+        uint32_t mask = (uint32_t)field.params[0];
+        word = (word & ~mask) | (((uint32_t)value << field.params[1]) & mask);
+    } else {
+        const int32_t* p = field.params;
+        int64_t raw = value;
+        if (field.formula == FormulaType::SCALE) {
+            // value = raw * p[0] / p[1] + p[2]; round away from zero so the
+            // truncating decode lands on the value
+            int64_t num = ((int64_t)value - p[2]) * p[1];
+            raw = p[0] ? num / p[0] : 0;
+            if (p[0] && num % p[0] != 0 && ((num > 0) == (p[0] > 0))) raw++;
+        } else if (field.formula == FormulaType::MAP_RANGE) {
+            // value = map(raw, p[0], p[1], p[2], p[3])
+            raw = p[3] == p[2] ? p[0]
+                : ((int64_t)value - p[2]) * ((int64_t)p[1] - p[0]) / ((int64_t)p[3] - p[2]) + p[0];
+        }
+
+        int64_t lo = 0, hi = widthMask;
+        if (field.dataType == DataType::INT8)  { lo = -128;   hi = 127; }
+        if (field.dataType == DataType::INT16) { lo = -32768; hi = 32767; }
+        raw = raw < lo ? lo : raw > hi ? hi : raw;
+        word = (uint32_t)raw & widthMask;
+    }
+
+    for (uint8_t i = 0; i < field.byteCount; i++) {
+        uint8_t index = field.byteOrder == ByteOrder::MSB_FIRST ? field.byteCount - 1 - i : i;
+        data[field.startByte + index] = (uint8_t)(word >> (8 * i));
+    }
+}
+
+// =============================================================================
+// DEVICE TASK
+// =============================================================================
+
+/**
+ * @brief Stress task body
+ *
+ * Serves the simulated bus once per tick while a run is active, so loop()
+ * (radio, serial) keeps the rest of the CPU as it does next to the ingest
+ * task. Parks between runs.
+ */
+void CanStress::taskBody(void* arg) {
+    CanStress* self = static_cast<CanStress*>(arg);
+    for (;;) {
+        if (!self->_active) {
+            vTaskDelay(pdMS_TO_TICKS(CAN_TASK_WAIT_MS));
+            continue;
+        }
+        if (self->_stopRequest) {
+            self->end();
+            continue;
+        }
+        self->service(micros(), self->_handler);
+        vTaskDelay(1);
+    }
+}
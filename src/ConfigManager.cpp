@@ -4,7 +4,10 @@
  */
 
 #include "ConfigManager.h"
+#include "crc32.h"
+#include <Arduino.h>
 #include <Preferences.h>
+#include <stddef.h>
 
 // =============================================================================
 // PRIVATE VARIABLES
@@ -15,6 +18,9 @@ static CanboxConfig config;
 static const char* NVS_NAMESPACE = "canbox";
 
 // NVS keys (max 15 chars)
+static const char* KEY_CONFIG_BLOB     = "config";
+
+// One key per value: firmware before the blob, read once for the migration
 static const char* KEY_STEER_OFFSET    = "steerOffset";
 static const char* KEY_STEER_INVERT    = "steerInvert";
 static const char* KEY_STEER_SCALE     = "steerScale";
@@ -22,10 +28,37 @@ static const char* KEY_IND_TIMEOUT     = "indTimeout";
 static const char* KEY_RPM_DIVISOR     = "rpmDiv";
 static const char* KEY_TANK_CAPACITY   = "tankCap";
 static const char* KEY_DTE_DIVISOR     = "dteDiv";
+static const char* KEY_CAN_PROMISC     = "canPromisc";
 static const char* KEY_VEHICLE_FILE    = "vehicleFile";
 
+#define CONFIG_BLOB_MAGIC   0x47464343u     // "CCFG"
+#define CONFIG_BLOB_VERSION 1
+
+/**
+ * @brief NVS image: everything persisted, in one key
+ *
+ * Built field by field into a zeroed struct so that padding is
+ * deterministic (it is covered by the CRC and the change check).
+ */
+struct ConfigBlob {
+    uint32_t     magic;
+    uint16_t     version;
+    uint16_t     size;                  // sizeof(ConfigBlob)
+    CanboxConfig config;
+    char         vehicleFile[CONFIG_VEHICLE_FILE_SIZE];
+    uint32_t     crc;                   // crc32_le(0, everything above)
+};
+
 // Buffer for vehicle config filename (max path length)
-static char vehicleFile[40] = "";
+static char vehicleFile[CONFIG_VEHICLE_FILE_SIZE] = "";
+
+static ConfigBlob saved;                // What the flash must hold
+static ConfigBlob written;              // What it holds (last read or write)
+static bool pending = false;            // saved not written yet
+static bool legacyKeys = false;         // Old per-value keys to erase on the next write
+static unsigned long firstSaveMs = 0;   // First save since the last write
+static unsigned long lastSaveMs = 0;
+static ConfigStoreStats stats;
 
 // =============================================================================
 // PRIVATE FUNCTIONS
@@ -39,6 +72,55 @@ static void loadDefaults() {
     config.rpmDivisor       = DEFAULT_RPM_DIVISOR;
     config.tankCapacity     = DEFAULT_TANK_CAPACITY;
     config.dteDivisor       = DEFAULT_DTE_DIVISOR;
+    config.canPromisc       = DEFAULT_CAN_PROMISC;
+}
+
+static uint32_t blobCrc(const ConfigBlob& blob) {
+    return crc32_le(0, (const uint8_t*)&blob, offsetof(ConfigBlob, crc));
+}
+
+/**
+ * @brief Start a persistence request: the flush timers run from the first one
+ */
+static void markPending() {
+    unsigned long now = millis();
+    if (!pending) firstSaveMs = now;
+    lastSaveMs = now;
+    pending = true;
+    saved.crc = blobCrc(saved);
+    stats.saves++;
+}
+
+/**
+ * @brief Read the blob; false if missing, truncated or corrupted
+ */
+static bool readBlob(ConfigBlob& blob) {
+    if (prefs.getBytesLength(KEY_CONFIG_BLOB) != sizeof(blob)) return false;
+    if (prefs.getBytes(KEY_CONFIG_BLOB, &blob, sizeof(blob)) != sizeof(blob)) return false;
+    return blob.magic == CONFIG_BLOB_MAGIC && blob.version == CONFIG_BLOB_VERSION &&
+           blob.size == sizeof(blob) && blob.crc == blobCrc(blob);
+}
+
+/**
+ * @brief Values written by the firmware before the blob (or defaults)
+ * @return true if any old key was found
+ */
+static bool readLegacyKeys() {
+    bool found = prefs.isKey(KEY_STEER_OFFSET) || prefs.isKey(KEY_VEHICLE_FILE);
+
+    // Load saved values (use current defaults if key doesn't exist)
+    config.steerOffset      = prefs.getShort(KEY_STEER_OFFSET, config.steerOffset);
+    config.steerInvert      = prefs.getBool(KEY_STEER_INVERT, config.steerInvert);
+    config.steerScale       = prefs.getUShort(KEY_STEER_SCALE, config.steerScale);
+    config.indicatorTimeout = prefs.getUShort(KEY_IND_TIMEOUT, config.indicatorTimeout);
+    config.rpmDivisor       = prefs.getUChar(KEY_RPM_DIVISOR, config.rpmDivisor);
+    config.tankCapacity     = prefs.getUChar(KEY_TANK_CAPACITY, config.tankCapacity);
+    config.dteDivisor       = prefs.getUShort(KEY_DTE_DIVISOR, config.dteDivisor);
+    config.canPromisc       = prefs.getBool(KEY_CAN_PROMISC, config.canPromisc);
+    if (prefs.isKey(KEY_VEHICLE_FILE)) {
+        prefs.getString(KEY_VEHICLE_FILE, vehicleFile, sizeof(vehicleFile));
+    }
+    return found;
 }
 
 // =============================================================================
@@ -48,44 +130,107 @@ static void loadDefaults() {
 void configInit() {
     // Load defaults first
     loadDefaults();
+    memset(vehicleFile, 0, sizeof(vehicleFile));
+    memset(&stats, 0, sizeof(stats));
+    pending = false;
+    legacyKeys = false;
+
+    // Written image starts invalid: the first flush always writes
+    memset(&written, 0, sizeof(written));
+    memset(&saved, 0, sizeof(saved));
+    saved.magic = CONFIG_BLOB_MAGIC;
+    saved.version = CONFIG_BLOB_VERSION;
+    saved.size = sizeof(saved);
 
     // Open NVS namespace (read-only first to check if values exist)
     if (prefs.begin(NVS_NAMESPACE, true)) {
-        // Load saved values (use current defaults if key doesn't exist)
-        config.steerOffset      = prefs.getShort(KEY_STEER_OFFSET, config.steerOffset);
-        config.steerInvert      = prefs.getBool(KEY_STEER_INVERT, config.steerInvert);
-        config.steerScale       = prefs.getUShort(KEY_STEER_SCALE, config.steerScale);
-        config.indicatorTimeout = prefs.getUShort(KEY_IND_TIMEOUT, config.indicatorTimeout);
-        config.rpmDivisor       = prefs.getUChar(KEY_RPM_DIVISOR, config.rpmDivisor);
-        config.tankCapacity     = prefs.getUChar(KEY_TANK_CAPACITY, config.tankCapacity);
-        config.dteDivisor       = prefs.getUShort(KEY_DTE_DIVISOR, config.dteDivisor);
+        ConfigBlob blob;
+        if (readBlob(blob)) {
+            config = blob.config;
+            memcpy(vehicleFile, blob.vehicleFile, sizeof(vehicleFile));
+            vehicleFile[sizeof(vehicleFile) - 1] = '\0';
+            written = blob;
+            stats.bootFromBlob = true;
+        } else {
+            legacyKeys = readLegacyKeys();
+        }
         prefs.end();
     }
     // If prefs.begin() fails, we just use defaults (already loaded)
+
+    saved.config = config;
+    memcpy(saved.vehicleFile, vehicleFile, sizeof(vehicleFile));
+    saved.crc = blobCrc(saved);
+
+    // Old keys: rewritten as a blob once the boot has settled
+    if (legacyKeys) {
+        firstSaveMs = lastSaveMs = millis();
+        pending = true;
+    }
 }
 
 void configSave() {
-    if (prefs.begin(NVS_NAMESPACE, false)) { // false = read-write mode
-        prefs.putShort(KEY_STEER_OFFSET, config.steerOffset);
-        prefs.putBool(KEY_STEER_INVERT, config.steerInvert);
-        prefs.putUShort(KEY_STEER_SCALE, config.steerScale);
-        prefs.putUShort(KEY_IND_TIMEOUT, config.indicatorTimeout);
-        prefs.putUChar(KEY_RPM_DIVISOR, config.rpmDivisor);
-        prefs.putUChar(KEY_TANK_CAPACITY, config.tankCapacity);
-        prefs.putUShort(KEY_DTE_DIVISOR, config.dteDivisor);
-        prefs.end();
-    }
+    saved.config = config;
+    markPending();
 }
 
 void configReset() {
     loadDefaults();
+    configSave();
+}
 
-    // Clear NVS namespace and save defaults
-    if (prefs.begin(NVS_NAMESPACE, false)) {
-        prefs.clear();
+void configPoll() {
+    if (configMsUntilFlush() == 0) configFlush();
+}
+
+bool configFlush() {
+    if (!pending) return true;
+
+    if (!legacyKeys && memcmp(&saved, &written, sizeof(saved)) == 0) {
+        pending = false;
+        stats.unchanged++;
+        return true;
+    }
+
+    uint32_t start = micros();
+    bool ok = prefs.begin(NVS_NAMESPACE, false);   // false = read-write mode
+    if (ok) {
+        if (legacyKeys) prefs.clear();
+        ok = prefs.putBytes(KEY_CONFIG_BLOB, &saved, sizeof(saved)) == sizeof(saved);
         prefs.end();
     }
-    configSave();
+    stats.lastFlushUs = micros() - start;
+    if (stats.lastFlushUs > stats.maxFlushUs) stats.maxFlushUs = stats.lastFlushUs;
+
+    if (!ok) {
+        // Retry after another quiet period
+        stats.failures++;
+        lastSaveMs = millis();
+        return false;
+    }
+    written = saved;
+    pending = false;
+    legacyKeys = false;
+    stats.writes++;
+    return true;
+}
+
+bool configIsPending() {
+    return pending;
+}
+
+uint32_t configMsUntilFlush() {
+    if (!pending) return UINT32_MAX;
+
+    unsigned long now = millis();
+    unsigned long quiet = now - lastSaveMs;
+    unsigned long age = now - firstSaveMs;
+    if (quiet >= CONFIG_FLUSH_QUIET_MS || age >= CONFIG_FLUSH_MAX_DELAY_MS) return 0;
+    return min(CONFIG_FLUSH_QUIET_MS - quiet, CONFIG_FLUSH_MAX_DELAY_MS - age);
+}
+
+const ConfigStoreStats& configGetStoreStats() {
+    return stats;
 }
 
 const CanboxConfig* configGet() {
@@ -124,6 +269,10 @@ uint16_t configGetDteDivisor() {
     return config.dteDivisor;
 }
 
+bool configGetCanPromisc() {
+    return config.canPromisc;
+}
+
 // =============================================================================
 // SETTERS
 // =============================================================================
@@ -156,18 +305,16 @@ void configSetDteDivisor(uint16_t value) {
     config.dteDivisor = value;
 }
 
+void configSetCanPromisc(bool value) {
+    config.canPromisc = value;
+}
+
 // =============================================================================
 // VEHICLE CONFIG FILE
 // =============================================================================
 
 const char* configGetVehicleFile() {
-    // Load from NVS if not already loaded
-    if (vehicleFile[0] == '\0') {
-        if (prefs.begin(NVS_NAMESPACE, true)) {
-            prefs.getString(KEY_VEHICLE_FILE, vehicleFile, sizeof(vehicleFile));
-            prefs.end();
-        }
-    }
+    // Loaded by configInit()
     return vehicleFile;
 }
 
@@ -176,9 +323,7 @@ void configSetVehicleFile(const char* filename) {
     strncpy(vehicleFile, filename, sizeof(vehicleFile) - 1);
     vehicleFile[sizeof(vehicleFile) - 1] = '\0';
 
-    // Save to NVS immediately
-    if (prefs.begin(NVS_NAMESPACE, false)) {
-        prefs.putString(KEY_VEHICLE_FILE, vehicleFile);
-        prefs.end();
-    }
+    // Saved with the next flush
+    memcpy(saved.vehicleFile, vehicleFile, sizeof(vehicleFile));
+    markPending();
 }
@@ -1,4 +1,6 @@
 #include "GlobalData.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
 
 // =============================================================================
 // VEHICLE DATA STORAGE (memory allocation with safe defaults)
@@ -87,6 +89,8 @@ uint16_t elapsedTime = 0;
  * @brief Reset all vehicle data to default values
  */
 void resetVehicleData() {
+    vehicleDataBeginWrite();
+
     // Vehicle data
     currentSteer = 0;
     engineRPM = 0;
@@ -115,4 +119,84 @@ void resetVehicleData() {
     // Trip computer
     averageSpeed = 0;
     elapsedTime = 0;
-}
\ No newline at end of file
+
+    // Everything must be re-sent to the head unit
+    vehicleDataMarkDirty(DIRTY_ALL);
+
+    vehicleDataEndWrite();
+}
+
+// =============================================================================
+// CONSISTENT SNAPSHOT (seqlock)
+// =============================================================================
+
+// Odd while a write is in progress, incremented twice per write section
+static volatile uint32_t vehicleDataSeq = 0;
+
+// All signals start dirty so the first radio pass sends everything
+volatile uint16_t vehicleDirty = DIRTY_ALL;
+
+// Change timestamps. TWAI frames carry no hardware timestamp: the write
+// section starts microseconds after the ingest task reads the frame.
+uint32_t vehicleDataWriteUs = 0;
+volatile uint32_t vehicleChangedUs[VEHICLE_SIGNAL_COUNT] = {};
+
+void vehicleDataBeginWrite() {
+    vTaskSuspendAll();
+    vehicleDataSeq = vehicleDataSeq + 1;
+    vehicleDataWriteUs = micros();
+    __sync_synchronize();
+}
+
+void vehicleDataEndWrite() {
+    __sync_synchronize();
+    vehicleDataSeq = vehicleDataSeq + 1;
+    xTaskResumeAll();
+}
+
+void vehicleDataSnapshot(VehicleDataSnapshot& out) {
+    uint32_t seq;
+    do {
+        seq = vehicleDataSeq;
+        __sync_synchronize();
+
+        out.currentSteer           = currentSteer;
+        out.engineRPM              = engineRPM;
+        out.vehicleSpeed           = vehicleSpeed;
+        out.currentDoors           = currentDoors;
+        out.fuelLevel              = fuelLevel;
+        out.voltBat                = voltBat;
+        out.dteValue               = dteValue;
+        out.fuelConsoMoy           = fuelConsoMoy;
+        out.tempExt                = tempExt;
+        out.currentOdo             = currentOdo;
+
+        out.indicatorLeft          = indicatorLeft;
+        out.indicatorRight         = indicatorRight;
+        out.headlightsOn           = headlightsOn;
+        out.highBeamOn             = highBeamOn;
+        out.parkingLightsOn        = parkingLightsOn;
+        out.lastLeftIndicatorTime  = lastLeftIndicatorTime;
+        out.lastRightIndicatorTime = lastRightIndicatorTime;
+
+        out.fuelConsumptionInst    = fuelConsumptionInst;
+        out.fuelConsumptionAvg     = fuelConsumptionAvg;
+        out.averageSpeed           = averageSpeed;
+        out.elapsedTime            = elapsedTime;
+
+        for (uint8_t i = 0; i < VEHICLE_SIGNAL_COUNT; i++) {
+            out.changedUs[i] = vehicleChangedUs[i];
+        }
+
+        __sync_synchronize();
+    } while ((seq & 1) || seq != vehicleDataSeq);
+}
+
+uint16_t vehicleDataTakeDirty() {
+    // Same exclusion as writers (single core: no writer can run meanwhile)
+    vTaskSuspendAll();
+    uint16_t bits = vehicleDirty;
+    vehicleDirty = 0;
+    xTaskResumeAll();
+    return bits;
+}
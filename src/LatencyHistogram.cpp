@@ -0,0 +1,63 @@
+/**
+ * @file LatencyHistogram.cpp
+ * @brief Fixed-size latency histogram with percentiles
+ */
+
+#include "LatencyHistogram.h"
+
+LatencyHistogram::LatencyHistogram() {
+    reset();
+}
+
+// =============================================================================
+// PUBLIC API
+// =============================================================================
+
+void LatencyHistogram::reset() {
+    _count = 0;
+    _max = 0;
+    memset(_buckets, 0, sizeof(_buckets));
+}
+
+void LatencyHistogram::record(uint32_t us) {
+    _buckets[bucketFor(us)]++;
+    _count++;
+    if (us > _max) _max = us;
+}
+
+uint32_t LatencyHistogram::percentile(uint8_t pct) const {
+    if (_count == 0) return 0;
+    if (pct > 100) pct = 100;
+
+    // Rank of the sample, 1-based, rounded up: p50 of 3 samples is the 2nd
+    uint32_t rank = (uint32_t)(((uint64_t)_count * pct + 99) / 100);
+    if (rank == 0) rank = 1;
+
+    uint32_t seen = 0;
+    for (uint8_t i = 0; i < LAT_HIST_BUCKETS; i++) {
+        seen += _buckets[i];
+        if (seen >= rank) {
+            uint32_t upper = bucketUpper(i);
+            return upper < _max ? upper : _max;
+        }
+    }
+    return _max;
+}
+
+uint8_t LatencyHistogram::bucketFor(uint32_t us) {
+    if (us < LAT_HIST_SUB) return (uint8_t)us;
+    if (us > LAT_HIST_MAX_US) return LAT_HIST_BUCKETS - 1;
+
+    // Octave above the exact range, then the top LAT_HIST_SUB_BITS below the MSB
+    uint8_t octave = (uint8_t)(31 - __builtin_clz(us)) - LAT_HIST_SUB_BITS;
+    uint8_t sub = (uint8_t)((us >> octave) & (LAT_HIST_SUB - 1));
+    return (uint8_t)(LAT_HIST_SUB + octave * LAT_HIST_SUB + sub);
+}
+
+uint32_t LatencyHistogram::bucketUpper(uint8_t i) {
+    if (i < LAT_HIST_SUB) return i;
+
+    uint8_t octave = (uint8_t)((i - LAT_HIST_SUB) / LAT_HIST_SUB);
+    uint32_t sub = (i - LAT_HIST_SUB) % LAT_HIST_SUB;
+    return ((LAT_HIST_SUB + sub + 1) << octave) - 1;
+}
@@ -0,0 +1,66 @@
+/**
+ * @file LoopWake.cpp
+ * @brief Event-driven loop(): task notification and RX event hooks
+ */
+
+#include "LoopWake.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+extern HardwareSerial RadioSerial;
+
+static TaskHandle_t loopTask = nullptr;
+static LoopWakeStats stats = {};
+
+#if ARDUINO_USB_MODE && ARDUINO_USB_CDC_ON_BOOT
+/**
+ * @brief USB CDC RX event (esp_event task)
+ */
+static void usbRxEvent(void* arg, esp_event_base_t base, int32_t id, void* data) {
+    (void)arg; (void)base; (void)id; (void)data;
+    loopWake();
+}
+#endif
+
+// =============================================================================
+// PUBLIC API
+// =============================================================================
+
+void loopWakeBegin() {
+    loopTask = xTaskGetCurrentTaskHandle();
+
+#if ARDUINO_USB_MODE && ARDUINO_USB_CDC_ON_BOOT
+    Serial.onEvent(ARDUINO_HW_CDC_RX_EVENT, usbRxEvent);
+#else
+    Serial.onReceive(loopWake);
+#endif
+
+    // UART event task: FIFO full or RX idle after a frame from the head unit
+    RadioSerial.onReceive(loopWake);
+}
+
+void loopWake() {
+    if (loopTask) xTaskNotifyGive(loopTask);
+}
+
+void loopWait(uint32_t timeoutMs) {
+    if (timeoutMs > LOOP_MAX_WAIT_MS) timeoutMs = LOOP_MAX_WAIT_MS;
+    TickType_t ticks = pdMS_TO_TICKS(timeoutMs);
+
+    // Always give up one tick first: under a steady stream of events the
+    // idle task (watchdog) still runs, as with the old vTaskDelay(1) loop
+    uint32_t start = micros();
+    vTaskDelay(1);
+    uint32_t notified = ulTaskNotifyTake(pdTRUE, ticks > 1 ? ticks - 1 : 0);
+    stats.sleptUs += (uint32_t)(micros() - start);
+    stats.waits++;
+    if (notified) {
+        stats.eventWakes++;
+    } else {
+        stats.timeouts++;
+    }
+}
+
+const LoopWakeStats& loopWakeGetStats() {
+    return stats;
+}
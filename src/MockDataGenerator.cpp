@@ -89,7 +89,9 @@ void MockDataGenerator::begin() {
     _currentValues[static_cast<int>(OutputField::PARKING_LIGHTS)] = 0;
 
     // Write initial values to GlobalData
+    vehicleDataBeginWrite();
     writeToGlobalData();
+    vehicleDataEndWrite();
 
     Serial.println("[MockGen] Mock data ready");
 }
@@ -150,7 +152,9 @@ void MockDataGenerator::update() {
     }
 
     // Write updated values to GlobalData
+    vehicleDataBeginWrite();
     writeToGlobalData();
+    vehicleDataEndWrite();
 }
 
 // =============================================================================
@@ -165,25 +169,26 @@ void MockDataGenerator::update() {
  */
 void MockDataGenerator::writeToGlobalData() {
     // === Numeric Values ===
-    currentSteer = (int16_t)_currentValues[static_cast<int>(OutputField::STEERING)];
-    engineRPM = (uint16_t)_currentValues[static_cast<int>(OutputField::ENGINE_RPM)];
-    vehicleSpeed = (uint8_t)_currentValues[static_cast<int>(OutputField::VEHICLE_SPEED)];
-    fuelLevel = (uint8_t)_currentValues[static_cast<int>(OutputField::FUEL_LEVEL)];
-    currentOdo = (uint32_t)_currentValues[static_cast<int>(OutputField::ODOMETER)];
-    voltBat = _currentValues[static_cast<int>(OutputField::VOLTAGE)] * 0.1f;  // Convert to volts
-    tempExt = (int8_t)_currentValues[static_cast<int>(OutputField::TEMPERATURE)];
-    dteValue = (int16_t)_currentValues[static_cast<int>(OutputField::DTE)];
-    fuelConsumptionInst = (uint16_t)_currentValues[static_cast<int>(OutputField::FUEL_CONS_INST)];
-    fuelConsumptionAvg = (uint16_t)_currentValues[static_cast<int>(OutputField::FUEL_CONS_AVG)];
+    vehicleDataStore(currentSteer, (int16_t)_currentValues[static_cast<int>(OutputField::STEERING)], DIRTY_STEERING);
+    vehicleDataStore(engineRPM, (uint16_t)_currentValues[static_cast<int>(OutputField::ENGINE_RPM)], DIRTY_RPM);
+    vehicleDataStore(vehicleSpeed, (uint8_t)_currentValues[static_cast<int>(OutputField::VEHICLE_SPEED)], DIRTY_SPEED);
+    vehicleDataStore(fuelLevel, (uint8_t)_currentValues[static_cast<int>(OutputField::FUEL_LEVEL)], DIRTY_FUEL_LEVEL);
+    vehicleDataStore(currentOdo, (uint32_t)_currentValues[static_cast<int>(OutputField::ODOMETER)], DIRTY_ODOMETER);
+    vehicleDataStore(voltBat, _currentValues[static_cast<int>(OutputField::VOLTAGE)] * 0.1f, DIRTY_VOLTAGE);  // Convert to volts
+    vehicleDataStore(tempExt, (int8_t)_currentValues[static_cast<int>(OutputField::TEMPERATURE)], DIRTY_TEMPERATURE);
+    vehicleDataStore(dteValue, (int16_t)_currentValues[static_cast<int>(OutputField::DTE)], DIRTY_DTE);
+    vehicleDataStore(fuelConsumptionInst, (uint16_t)_currentValues[static_cast<int>(OutputField::FUEL_CONS_INST)], DIRTY_FUEL_CONS_INST);
+    vehicleDataStore(fuelConsumptionAvg, (uint16_t)_currentValues[static_cast<int>(OutputField::FUEL_CONS_AVG)], DIRTY_FUEL_CONS_AVG);
 
     // === Door Bitmask ===
     // Build Toyota RAV4 format door bitmask from individual flags
-    currentDoors = 0;
-    if (_currentValues[static_cast<int>(OutputField::DOOR_DRIVER)]) currentDoors |= 0x80;
-    if (_currentValues[static_cast<int>(OutputField::DOOR_PASSENGER)]) currentDoors |= 0x40;
-    if (_currentValues[static_cast<int>(OutputField::DOOR_REAR_LEFT)]) currentDoors |= 0x20;
-    if (_currentValues[static_cast<int>(OutputField::DOOR_REAR_RIGHT)]) currentDoors |= 0x10;
-    if (_currentValues[static_cast<int>(OutputField::DOOR_BOOT)]) currentDoors |= 0x08;
+    uint8_t doors = 0;
+    if (_currentValues[static_cast<int>(OutputField::DOOR_DRIVER)]) doors |= 0x80;
+    if (_currentValues[static_cast<int>(OutputField::DOOR_PASSENGER)]) doors |= 0x40;
+    if (_currentValues[static_cast<int>(OutputField::DOOR_REAR_LEFT)]) doors |= 0x20;
+    if (_currentValues[static_cast<int>(OutputField::DOOR_REAR_RIGHT)]) doors |= 0x10;
+    if (_currentValues[static_cast<int>(OutputField::DOOR_BOOT)]) doors |= 0x08;
+    vehicleDataStore(currentDoors, doors, DIRTY_DOORS);
 
     // === Turn Indicators ===
     // Update timestamps for blink detection in RadioSend
@@ -195,9 +200,9 @@ void MockDataGenerator::writeToGlobalData() {
     }
 
     // === Light Status ===
-    headlightsOn = _currentValues[static_cast<int>(OutputField::HEADLIGHTS)] != 0;
-    highBeamOn = _currentValues[static_cast<int>(OutputField::HIGH_BEAM)] != 0;
-    parkingLightsOn = _currentValues[static_cast<int>(OutputField::PARKING_LIGHTS)] != 0;
+    vehicleDataStore(headlightsOn, _currentValues[static_cast<int>(OutputField::HEADLIGHTS)] != 0, DIRTY_LIGHTS);
+    vehicleDataStore(highBeamOn, _currentValues[static_cast<int>(OutputField::HIGH_BEAM)] != 0, DIRTY_LIGHTS);
+    vehicleDataStore(parkingLightsOn, _currentValues[static_cast<int>(OutputField::PARKING_LIGHTS)] != 0, DIRTY_LIGHTS);
 }
 
 // =============================================================================
@@ -209,7 +214,7 @@ void MockDataGenerator::writeToGlobalData() {
  * @param field OutputField enum value
  * @return Pointer to MockFieldBounds if found, nullptr otherwise
  */
-const MockFieldBounds* MockDataGenerator::getBounds(OutputField field) const {
+const MockFieldBounds* MockDataGenerator::getBounds(OutputField field) {
     for (uint8_t i = 0; i < _boundsCount; i++) {
         if (_defaultBounds[i].field == field) {
             return &_defaultBounds[i];
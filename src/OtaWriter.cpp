@@ -0,0 +1,306 @@
+/**
+ * @file OtaWriter.cpp
+ * @brief Sector-aligned, double-buffered firmware writes
+ *
+ * Buffer ownership moves through two queues of buffer indices:
+ *   freeQueue  writer → receiver (buffer can be filled)
+ *   fullQueue  receiver → writer (buffer holds a sector to write)
+ * The receiver owns at most one buffer (curBuf) outside the queues, so the
+ * session is idle once it can take every buffer back from freeQueue.
+ *
+ * An abort is queued behind the sectors in flight (OTA_ABORT_TOKEN): the
+ * writer resets Update only once its last Update.write() has returned.
+ */
+
+#include "OtaWriter.h"
+#include <Update.h>
+#include <MD5Builder.h>
+#include <esp_task_wdt.h>
+#include <freertos/queue.h>
+
+#define OTA_BUFFER_COUNT 2
+#define OTA_ABORT_TOKEN  0xFF   // fullQueue entry: reset Update, not a buffer
+#define OTA_WAIT_SLICE_MS 100   // Watchdog is fed between slices
+
+// =============================================================================
+// PRIVATE VARIABLES
+// =============================================================================
+
+static uint8_t buffers[OTA_BUFFER_COUNT][OTA_SECTOR_SIZE];
+static uint16_t bufferLen[OTA_BUFFER_COUNT];
+static int8_t curBuf = -1;              // Buffer being filled, -1 = none
+static uint16_t curLen = 0;
+
+static MD5Builder md5;                  // Only touched by whoever writes sectors
+static OtaWriterStats stats = {};
+static bool active = false;
+static volatile bool writeFailed = false;
+static volatile bool discard = false;   // Abort: writer returns buffers unwritten
+static volatile bool abortPending = false;  // Update.abort() queued, writer clears it
+static const char* failReason = nullptr;
+
+#if OTA_PIPELINED
+static TaskHandle_t writerTask = nullptr;
+static QueueHandle_t freeQueue = nullptr;
+static QueueHandle_t fullQueue = nullptr;
+#endif
+
+// =============================================================================
+// PRIVATE FUNCTIONS
+// =============================================================================
+
+/**
+ * @brief Erase + program one buffer and add it to the MD5
+ */
+static void writeSector(uint8_t idx) {
+    if (writeFailed || discard) return;
+
+    uint16_t len = bufferLen[idx];
+    uint32_t start = micros();
+    size_t written = Update.write(buffers[idx], len);
+    uint32_t elapsed = micros() - start;
+
+    if (written != len) {
+        failReason = Update.errorString();
+        writeFailed = true;
+        return;
+    }
+
+    md5.add(buffers[idx], len);
+    stats.sectors++;
+    stats.flashUs += elapsed;
+    if (elapsed > stats.flashMaxUs) stats.flashMaxUs = elapsed;
+}
+
+#if OTA_PIPELINED
+static void otaWriterTask(void* arg) {
+    (void)arg;
+    uint8_t idx;
+    for (;;) {
+        if (xQueueReceive(fullQueue, &idx, portMAX_DELAY) != pdTRUE) continue;
+        if (idx == OTA_ABORT_TOKEN) {
+            // Every sector queued before the abort has been handled
+            Update.abort();
+            abortPending = false;
+            continue;
+        }
+        writeSector(idx);
+        xQueueSend(freeQueue, &idx, 0);  // Never full: one slot per buffer
+    }
+}
+
+/**
+ * @brief Take a free buffer, feeding the watchdog while the writer is busy
+ * @return false after OTA_WRITER_TIMEOUT_MS without a free buffer
+ */
+static bool takeFree(uint8_t& idx) {
+    uint32_t start = micros();
+    uint32_t waitedMs = 0;
+    while (xQueueReceive(freeQueue, &idx, pdMS_TO_TICKS(OTA_WAIT_SLICE_MS)) != pdTRUE) {
+        esp_task_wdt_reset();
+        waitedMs += OTA_WAIT_SLICE_MS;
+        if (waitedMs >= OTA_WRITER_TIMEOUT_MS) {
+            failReason = "flash writer timeout";
+            writeFailed = true;
+            return false;
+        }
+    }
+    stats.waitUs += micros() - start;
+    return true;
+}
+
+/**
+ * @brief Wait until the writer has returned every buffer
+ */
+static bool waitIdle() {
+    uint8_t held[OTA_BUFFER_COUNT];
+    uint8_t count = 0;
+    bool ok = true;
+
+    if (curBuf >= 0) {
+        uint8_t idx = curBuf;
+        xQueueSend(freeQueue, &idx, 0);
+        curBuf = -1;
+    }
+    while (count < OTA_BUFFER_COUNT) {
+        if (!takeFree(held[count])) {
+            ok = false;
+            break;
+        }
+        count++;
+    }
+    for (uint8_t i = 0; i < count; i++) {
+        xQueueSend(freeQueue, &held[i], 0);
+    }
+    return ok;
+}
+
+/**
+ * @brief Wait for the writer to run a queued Update.abort()
+ * @return false after OTA_WRITER_TIMEOUT_MS (the abort stays queued)
+ */
+static bool waitAbort() {
+    uint32_t waitedMs = 0;
+    while (abortPending) {
+        if (waitedMs >= OTA_WRITER_TIMEOUT_MS) return false;
+        esp_task_wdt_reset();
+        vTaskDelay(pdMS_TO_TICKS(OTA_WAIT_SLICE_MS));
+        waitedMs += OTA_WAIT_SLICE_MS;
+    }
+    return true;
+}
+#endif
+
+/**
+ * @brief Hand the buffer being filled to the writer (or write it inline)
+ */
+static bool submitCurrent() {
+    if (curBuf < 0 || curLen == 0) return true;
+
+    uint8_t idx = curBuf;
+    bufferLen[idx] = curLen;
+    curBuf = -1;
+    curLen = 0;
+
+#if OTA_PIPELINED
+    xQueueSend(fullQueue, &idx, 0);      // Never full: one slot per buffer
+#else
+    esp_task_wdt_reset();
+    writeSector(idx);
+    curBuf = idx;                        // Single buffer in use
+#endif
+    return !writeFailed;
+}
+
+// =============================================================================
+// PUBLIC API
+// =============================================================================
+
+bool otaWriterBegin() {
+#if OTA_PIPELINED
+    if (abortPending) return false;
+    if (!writerTask) {
+        freeQueue = xQueueCreate(OTA_BUFFER_COUNT, sizeof(uint8_t));
+        fullQueue = xQueueCreate(OTA_BUFFER_COUNT + 1, sizeof(uint8_t));  // + abort
+        if (!freeQueue || !fullQueue) return false;
+        for (uint8_t i = 0; i < OTA_BUFFER_COUNT; i++) {
+            xQueueSend(freeQueue, &i, 0);
+        }
+        BaseType_t ok = xTaskCreate(otaWriterTask, "otaWriter", OTA_WRITER_STACK,
+                                    nullptr, OTA_WRITER_PRIORITY, &writerTask);
+        if (ok != pdPASS) {
+            writerTask = nullptr;
+            return false;
+        }
+    }
+    curBuf = -1;
+#else
+    curBuf = 0;
+#endif
+
+    curLen = 0;
+    md5.begin();
+    memset(&stats, 0, sizeof(stats));
+    stats.startMs = millis();
+    writeFailed = false;
+    discard = false;
+    failReason = nullptr;
+    active = true;
+    return true;
+}
+
+bool otaWriterWrite(const uint8_t* data, size_t len) {
+    if (!active || writeFailed) return false;
+
+    while (len > 0) {
+#if OTA_PIPELINED
+        if (curBuf < 0) {
+            uint8_t idx;
+            if (!takeFree(idx)) return false;
+            curBuf = idx;
+            curLen = 0;
+        }
+#endif
+        size_t chunk = OTA_SECTOR_SIZE - curLen;
+        if (chunk > len) chunk = len;
+        memcpy(&buffers[curBuf][curLen], data, chunk);
+        curLen += chunk;
+        data += chunk;
+        len -= chunk;
+        stats.bytes += chunk;
+
+        if (curLen == OTA_SECTOR_SIZE && !submitCurrent()) return false;
+    }
+    return !writeFailed;
+}
+
+bool otaWriterFinish() {
+    if (!active) return false;
+
+    bool ok = submitCurrent();
+#if OTA_PIPELINED
+    ok = waitIdle() && ok;
+#endif
+    ok = ok && !writeFailed;
+    if (ok) md5.calculate();
+
+    stats.endMs = millis();
+    active = false;
+    return ok;
+}
+
+bool otaWriterAbort() {
+    discard = true;
+    if (active) {
+        stats.endMs = millis();
+        active = false;
+    }
+
+#if OTA_PIPELINED
+    if (writerTask) {
+        if (!abortPending) {
+            if (curBuf >= 0) {
+                uint8_t idx = curBuf;
+                xQueueSend(freeQueue, &idx, 0);
+                curBuf = -1;
+            }
+            curLen = 0;
+            uint8_t token = OTA_ABORT_TOKEN;
+            abortPending = true;
+            xQueueSend(fullQueue, &token, 0);  // Never full: one extra slot
+        }
+        return waitAbort();
+    }
+#endif
+    curLen = 0;
+    Update.abort();
+    return true;
+}
+
+String otaWriterMD5() {
+    return md5.toString();
+}
+
+const char* otaWriterError() {
+    return writeFailed ? failReason : nullptr;
+}
+
+bool otaWriterIsBusy() {
+    return abortPending;
+}
+
+bool otaWriterIsActive() {
+    return active;
+}
+
+const OtaWriterStats& otaWriterGetStats() {
+    return stats;
+}
+
+TaskHandle_t otaWriterGetTaskHandle() {
+#if OTA_PIPELINED
+    return writerTask;
+#else
+    return nullptr;
+#endif
+}
@@ -0,0 +1,107 @@
+/**
+ * @file PerfStats.cpp
+ * @brief Hot-path cycle counters and latency histograms (SYS PERF)
+ */
+
+#include "PerfStats.h"
+
+#if PERF_STATS_ENABLED
+
+static const uint8_t STAGE_COUNT = (uint8_t)PerfStage::COUNT;
+
+static const char* const STAGE_NAMES[STAGE_COUNT] = {
+    "canRead", "processFrame", "canToUart", "serialCmd", "loopBusy", "loopPeriod",
+    "radioFlush", "txSteering", "txDoors", "txLights", "txRpm", "txSpeed",
+    "txOdometer", "txTemp", "txRange", "txFuelInst", "txFuelAvg"
+};
+
+// =============================================================================
+// PRIVATE VARIABLES
+// =============================================================================
+
+static PerfCounter counters[STAGE_COUNT];
+static uint32_t cyclesPerUs = 0;
+
+static volatile bool framePending = false;      // Set by the ingest task
+static volatile uint32_t frameCycles = 0;
+static uint32_t lastUartBytes = 0;
+static uint32_t lastLoopCycles = 0;
+static bool loopStarted = false;
+
+// =============================================================================
+// PRIVATE FUNCTIONS
+// =============================================================================
+
+static uint32_t getCyclesPerUs() {
+    if (cyclesPerUs == 0) cyclesPerUs = ESP.getCpuFreqMHz();
+    return cyclesPerUs ? cyclesPerUs : 1;
+}
+
+static uint8_t bucketFor(uint32_t cycles) {
+    uint32_t us = cycles / getCyclesPerUs();
+    uint8_t bucket = 0;
+    while (us && bucket < PERF_HIST_BUCKETS - 1) {
+        us >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+// =============================================================================
+// PUBLIC API
+// =============================================================================
+
+void perfRecord(PerfStage stage, uint32_t cycles) {
+    PerfCounter& c = counters[(uint8_t)stage];
+    c.count++;
+    c.sumCycles += cycles;
+    if (cycles > c.maxCycles) c.maxCycles = cycles;
+    c.hist[bucketFor(cycles)]++;
+}
+
+void perfMarkFrame() {
+    if (framePending) return;
+    frameCycles = perfNow();
+    __sync_synchronize();  // Timestamp before the flag loop() checks
+    framePending = true;
+}
+
+void perfMarkUart(uint32_t bytesWritten) {
+    if (bytesWritten == lastUartBytes) return;
+    lastUartBytes = bytesWritten;
+    if (!framePending) return;
+    perfRecord(PerfStage::CAN_TO_UART, perfNow() - frameCycles);
+    framePending = false;
+}
+
+void perfLoopStart() {
+    uint32_t now = perfNow();
+    if (loopStarted) perfRecord(PerfStage::LOOP_PERIOD, now - lastLoopCycles);
+    lastLoopCycles = now;
+    loopStarted = true;
+}
+
+void perfReset() {
+    // The ingest task may be mid-record: at worst one sample is lost
+    memset(counters, 0, sizeof(counters));
+    framePending = false;
+    loopStarted = false;
+}
+
+const PerfCounter& perfGet(PerfStage stage) {
+    return counters[(uint8_t)stage];
+}
+
+const char* perfStageName(PerfStage stage) {
+    return (uint8_t)stage < STAGE_COUNT ? STAGE_NAMES[(uint8_t)stage] : "?";
+}
+
+float perfCyclesToUs(uint64_t cycles) {
+    return (float)cycles / getCyclesPerUs();
+}
+
+uint32_t perfBucketLimitUs(uint8_t i) {
+    return i < PERF_HIST_BUCKETS - 1 ? (1UL << i) : 0;
+}
+
+#endif // PERF_STATS_ENABLED
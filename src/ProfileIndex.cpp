@@ -0,0 +1,381 @@
+/**
+ * @file ProfileIndex.cpp
+ * @brief Installed profile index (/profiles.idx) and bus fingerprint scoring
+ */
+
+#include "ProfileIndex.h"
+#include "crc32.h"
+#include <LittleFS.h>
+#include <ArduinoJson.h>
+
+// =============================================================================
+// INDEX FILE FORMAT
+// =============================================================================
+
+#define PROFILE_INDEX_MAGIC   0x58444950u   // "PIDX"
+#define PROFILE_INDEX_VERSION 1
+
+/**
+ * @brief Index file header, followed by count ProfileIndexEntry images
+ */
+struct ProfileIndexHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t entrySize;     // sizeof(ProfileIndexEntry)
+    uint16_t count;
+    uint16_t reserved;
+    uint32_t crc;           // crc32_le(0, entries)
+};
+
+// =============================================================================
+// PRIVATE VARIABLES
+// =============================================================================
+
+static ProfileIndexEntry entries[PROFILE_INDEX_MAX];
+static uint8_t entryCount = 0;
+static ProfileIndexStats stats = {};
+static ProfileMatch lastMatch = {};
+
+// =============================================================================
+// PRIVATE FUNCTIONS
+// =============================================================================
+
+/**
+ * @brief ArduinoJson reader computing the CRC32 of everything it reads
+ *
+ * Lets the index entry take the file hash from the same pass as the parse.
+ */
+struct CrcFileReader {
+    File&    file;
+    uint32_t crc;
+    uint32_t size;
+
+    int read() {
+        int c = file.read();
+        if (c >= 0) {
+            uint8_t b = (uint8_t)c;
+            crc = crc32_le(crc, &b, 1);
+            size++;
+        }
+        return c;
+    }
+
+    size_t readBytes(char* buffer, size_t length) {
+        size_t n = file.read((uint8_t*)buffer, length);
+        crc = crc32_le(crc, (const uint8_t*)buffer, n);
+        size += n;
+        return n;
+    }
+};
+
+/**
+ * @brief Path with a leading '/'
+ */
+static void normalizePath(const char* path, char* out, size_t outLen) {
+    snprintf(out, outLen, "%s%s", path[0] == '/' ? "" : "/", path);
+}
+
+static bool isProfileFile(const char* name) {
+    size_t len = strlen(name);
+    return len >= 5 && strcasecmp(name + len - 5, ".json") == 0;
+}
+
+static int findEntry(const char* path) {
+    char full[PROFILE_INDEX_FILE_SIZE];
+    normalizePath(path, full, sizeof(full));
+    for (uint8_t i = 0; i < entryCount; i++) {
+        if (strcmp(entries[i].file, full) == 0) return i;
+    }
+    return -1;
+}
+
+/**
+ * @brief CRC32 of a whole file, as stored in ProfileIndexEntry::jsonCrc
+ * @return false if the file cannot be read
+ */
+static bool hashFile(const char* path, uint32_t& crc) {
+    File file = LittleFS.open(path, "r");
+    if (!file) return false;
+    uint8_t buffer[256];
+    crc = 0;
+    size_t n;
+    while ((n = file.read(buffer, sizeof(buffer))) > 0) {
+        crc = crc32_le(crc, buffer, n);
+    }
+    file.close();
+    return true;
+}
+
+static void removeEntry(uint8_t index) {
+    memmove(&entries[index], &entries[index + 1],
+            (entryCount - index - 1) * sizeof(ProfileIndexEntry));
+    entryCount--;
+}
+
+/**
+ * @brief Read /profiles.idx into entries
+ * @return false if missing, from another format or corrupted (entries empty)
+ */
+static bool loadIndex() {
+    entryCount = 0;
+    File file = LittleFS.open(PROFILE_INDEX_PATH, "r");
+    if (!file) return false;
+
+    ProfileIndexHeader header;
+    bool ok = file.read((uint8_t*)&header, sizeof(header)) == sizeof(header) &&
+              header.magic == PROFILE_INDEX_MAGIC &&
+              header.version == PROFILE_INDEX_VERSION &&
+              header.entrySize == sizeof(ProfileIndexEntry) &&
+              header.count <= PROFILE_INDEX_MAX;
+    size_t bytes = ok ? header.count * sizeof(ProfileIndexEntry) : 0;
+    ok = ok && file.read((uint8_t*)entries, bytes) == bytes &&
+         crc32_le(0, (const uint8_t*)entries, bytes) == header.crc;
+    file.close();
+
+    for (uint8_t i = 0; ok && i < header.count; i++) {
+        ok = entries[i].file[PROFILE_INDEX_FILE_SIZE - 1] == '\0' &&
+             entries[i].name[PROFILE_NAME_SIZE - 1] == '\0';
+    }
+    if (!ok) {
+        Serial.println("[ProfileIndex] Index invalid, rebuilding");
+        return false;
+    }
+    entryCount = (uint8_t)header.count;
+    return true;
+}
+
+/**
+ * @brief Write entries to /profiles.idx
+ */
+static bool saveIndex() {
+    ProfileIndexHeader header = {};
+    header.magic = PROFILE_INDEX_MAGIC;
+    header.version = PROFILE_INDEX_VERSION;
+    header.entrySize = sizeof(ProfileIndexEntry);
+    header.count = entryCount;
+    size_t bytes = entryCount * sizeof(ProfileIndexEntry);
+    header.crc = crc32_le(0, (const uint8_t*)entries, bytes);
+
+    File file = LittleFS.open(PROFILE_INDEX_PATH, "w");
+    if (!file) return false;
+    bool ok = file.write((const uint8_t*)&header, sizeof(header)) == sizeof(header) &&
+              file.write((const uint8_t*)entries, bytes) == bytes;
+    file.close();
+
+    if (!ok) {
+        // A partial index would fail its CRC anyway: rebuilt at next boot
+        LittleFS.remove(PROFILE_INDEX_PATH);
+        Serial.println("[ProfileIndex] Failed to write index");
+    }
+    return ok;
+}
+
+// =============================================================================
+// PUBLIC API IMPLEMENTATION
+// =============================================================================
+
+bool profileIndexBuildEntry(const char* path, ProfileIndexEntry& entry) {
+    memset(&entry, 0, sizeof(entry));
+    normalizePath(path, entry.file, sizeof(entry.file));
+
+    File file = LittleFS.open(entry.file, "r");
+    if (!file) return false;
+
+    // Only what identifies the profile
+    JsonDocument filter;
+    filter["name"] = true;
+    filter["isMock"] = true;
+    filter["replay"] = true;
+    filter["frames"][0]["canId"] = true;
+
+    CrcFileReader reader = { file, 0, 0 };
+    JsonDocument doc;
+    DeserializationError error = deserializeJson(doc, reader, DeserializationOption::Filter(filter));
+    while (reader.read() >= 0) {}   // Hash the whole file
+    file.close();
+    entry.jsonCrc = reader.crc;
+    entry.jsonSize = reader.size;
+
+    if (error) {
+        entry.flags = PROFILE_FLAG_INVALID;
+        snprintf(entry.name, sizeof(entry.name), "%s", error.c_str());
+        return true;
+    }
+
+    snprintf(entry.name, sizeof(entry.name), "%s", doc["name"] | "Unknown");
+    if (doc["isMock"] | false) entry.flags |= PROFILE_FLAG_MOCK;
+    JsonVariantConst replay = doc["replay"];
+    const char* replayFile = replay.is<const char*>() ? replay.as<const char*>()
+                                                      : (replay["file"] | "");
+    if (replayFile[0] != '\0') entry.flags |= PROFILE_FLAG_REPLAY;
+
+    // Same ID parsing as the profile loader; extended IDs are not dispatched
+    for (JsonObjectConst frame : doc["frames"].as<JsonArrayConst>()) {
+        const char* canIdStr = frame["canId"];
+        uint32_t canId = canIdStr ? (uint32_t)strtol(canIdStr, nullptr, 0)
+                                  : frame["canId"].as<uint32_t>();
+        if (canId >= PROFILE_ID_BITMAP_SIZE * 8) continue;
+
+        uint8_t bit = 1 << (canId & 7);
+        if (!(entry.ids[canId >> 3] & bit)) {
+            entry.ids[canId >> 3] |= bit;
+            entry.idCount++;
+        }
+    }
+
+    if (!(entry.flags & PROFILE_FLAG_MOCK) && entry.idCount == 0) {
+        entry.flags |= PROFILE_FLAG_INVALID;
+    }
+    return true;
+}
+
+uint8_t profileIndexBegin() {
+    uint32_t start = micros();
+    stats = {};
+    stats.fromFile = loadIndex();
+    bool changed = !stats.fromFile;
+
+    // Profiles on the filesystem (collected first: entries are parsed with
+    // the directory closed)
+    char paths[PROFILE_INDEX_MAX][PROFILE_INDEX_FILE_SIZE];
+    uint32_t sizes[PROFILE_INDEX_MAX];
+    uint8_t fileCount = 0;
+
+    File root = LittleFS.open("/");
+    if (root && root.isDirectory()) {
+        File file = root.openNextFile();
+        while (file) {
+            const char* name = file.name();
+            if (!file.isDirectory() && isProfileFile(name) && strlen(name) + 2 <= PROFILE_INDEX_FILE_SIZE) {
+                if (fileCount < PROFILE_INDEX_MAX) {
+                    normalizePath(name, paths[fileCount], PROFILE_INDEX_FILE_SIZE);
+                    sizes[fileCount++] = file.size();
+                } else {
+                    Serial.printf("[ProfileIndex] Index full, %s not indexed\n", name);
+                }
+            }
+            file.close();
+            file = root.openNextFile();
+        }
+        root.close();
+    }
+
+    // Drop entries of deleted files
+    for (int i = entryCount - 1; i >= 0; i--) {
+        bool present = false;
+        for (uint8_t f = 0; f < fileCount && !present; f++) {
+            present = strcmp(entries[i].file, paths[f]) == 0;
+        }
+        if (!present) {
+            removeEntry((uint8_t)i);
+            changed = true;
+        }
+    }
+
+    // Index new files and files whose content changed. Same size is not
+    // enough: an edited profile often keeps its byte count
+    for (uint8_t f = 0; f < fileCount; f++) {
+        int i = findEntry(paths[f]);
+        uint32_t crc;
+        if (i >= 0 && entries[i].jsonSize == sizes[f] &&
+            hashFile(paths[f], crc) && crc == entries[i].jsonCrc) continue;
+
+        ProfileIndexEntry entry;
+        if (!profileIndexBuildEntry(paths[f], entry)) continue;
+        if (i < 0) i = entryCount++;
+        entries[i] = entry;
+        stats.parsed++;
+        changed = true;
+    }
+
+    if (changed) saveIndex();
+
+    stats.entries = entryCount;
+    stats.syncUs = micros() - start;
+    return entryCount;
+}
+
+bool profileIndexUpdate(const char* path) {
+    ProfileIndexEntry entry;
+    if (!profileIndexBuildEntry(path, entry)) return false;
+
+    int i = findEntry(path);
+    if (i < 0) {
+        if (entryCount >= PROFILE_INDEX_MAX) return false;
+        i = entryCount++;
+    }
+    entries[i] = entry;
+    return saveIndex();
+}
+
+bool profileIndexRemove(const char* path) {
+    int i = findEntry(path);
+    if (i < 0) return false;
+    removeEntry((uint8_t)i);
+    saveIndex();
+    return true;
+}
+
+uint8_t profileIndexCount() {
+    return entryCount;
+}
+
+const ProfileIndexEntry* profileIndexGet(uint8_t index) {
+    return index < entryCount ? &entries[index] : nullptr;
+}
+
+const ProfileIndexEntry* profileIndexFind(const char* path) {
+    int i = findEntry(path);
+    return i >= 0 ? &entries[i] : nullptr;
+}
+
+uint16_t profileFingerprintScore(const uint8_t* profileIds, uint16_t idCount,
+                                 const uint8_t* observed, uint16_t& matches) {
+    matches = 0;
+    for (size_t i = 0; i < PROFILE_ID_BITMAP_SIZE; i++) {
+        matches += __builtin_popcount(profileIds[i] & observed[i]);
+    }
+    return idCount ? (uint16_t)((uint32_t)matches * 1000 / idCount) : 0;
+}
+
+const ProfileMatch& profileIndexMatch(const uint8_t* observed) {
+    lastMatch = {};
+    for (size_t i = 0; i < PROFILE_ID_BITMAP_SIZE; i++) {
+        lastMatch.observedIds += __builtin_popcount(observed[i]);
+    }
+
+    int16_t best = -1;
+    uint16_t bestScore = 0, bestMatches = 0;
+    for (uint8_t i = 0; i < entryCount; i++) {
+        const ProfileIndexEntry& entry = entries[i];
+        if (entry.flags & (PROFILE_FLAG_MOCK | PROFILE_FLAG_REPLAY | PROFILE_FLAG_INVALID)) continue;
+
+        uint16_t matches;
+        uint16_t score = profileFingerprintScore(entry.ids, entry.idCount, observed, matches);
+        if (best < 0 || score > bestScore || (score == bestScore && matches > bestMatches)) {
+            if (best >= 0) lastMatch.runnerUp = bestScore;
+            best = i;
+            bestScore = score;
+            bestMatches = matches;
+        } else if (score > lastMatch.runnerUp) {
+            lastMatch.runnerUp = score;
+        }
+    }
+
+    if (best >= 0) {
+        memcpy(lastMatch.file, entries[best].file, sizeof(lastMatch.file));
+        lastMatch.score = bestScore;
+        lastMatch.matches = bestMatches;
+        lastMatch.accepted = bestScore >= AUTODETECT_MIN_SCORE &&
+                             bestMatches >= AUTODETECT_MIN_MATCHES;
+    }
+    return lastMatch;
+}
+
+const ProfileMatch& profileIndexGetLastMatch() {
+    return lastMatch;
+}
+
+const ProfileIndexStats& profileIndexGetStats() {
+    return stats;
+}
@@ -0,0 +1,143 @@
+/**
+ * @file RadioFrameParser.cpp
+ * @brief Incremental parser for the 0x2E head-unit protocol (RX side)
+ *
+ * Indices are free-running 16-bit counters masked into the ring, so
+ * head - tail is always the number of buffered bytes.
+ */
+
+#include "RadioFrameParser.h"
+
+RadioFrameParser::RadioFrameParser() {
+    reset();
+}
+
+void RadioFrameParser::reset() {
+    _head = 0;
+    _tail = 0;
+    _release = 0;
+    _noAck = 0;
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+// =============================================================================
+// INPUT
+// =============================================================================
+
+size_t RadioFrameParser::feed(const uint8_t* data, size_t len) {
+    uint16_t room = RADIO_RX_BUFFER - getBuffered();
+    if (len > room) {
+        _stats.overflows++;
+        len = room;
+    }
+
+    for (size_t i = 0; i < len; i++) {
+        _buf[(_head + i) & MASK] = data[i];
+    }
+    _head += len;
+    _stats.bytesIn += len;
+    return len;
+}
+
+size_t RadioFrameParser::pump(HardwareSerial& port) {
+    size_t total = 0;
+
+    // At most two passes: up to the end of the ring, then from its start
+    for (uint8_t pass = 0; pass < 2; pass++) {
+        int avail = port.available();
+        if (avail <= 0) break;
+
+        uint16_t room = RADIO_RX_BUFFER - getBuffered();
+        if (room == 0) {
+            _stats.overflows++;
+            break;
+        }
+
+        uint16_t idx = _head & MASK;
+        uint16_t chunk = RADIO_RX_BUFFER - idx;     // Contiguous space
+        if (chunk > room) chunk = room;
+        if (chunk > (uint16_t)avail) chunk = avail;
+
+        size_t got = port.read(&_buf[idx], chunk);
+        if (got == 0) break;
+
+        _head += got;
+        total += got;
+    }
+
+    _stats.bytesIn += total;
+    return total;
+}
+
+// =============================================================================
+// PARSING
+// =============================================================================
+
+RadioParseResult RadioFrameParser::next(RadioFrameView& frame) {
+    // The caller is done with the previous frame
+    _tail += _release;
+    _release = 0;
+
+    while (getBuffered() > 0) {
+        uint8_t b = at(0);
+
+        if (b != RADIO_FRAME_HEADER) {
+            _tail++;
+            if (_noAck) {
+                // Inside a rejected frame: 0xFF here is payload, not an ACK
+                _noAck--;
+                _stats.junkBytes++;
+                continue;
+            }
+            if (b == RADIO_ACK) {
+                _stats.acks++;
+                return RadioParseResult::ACK;
+            }
+            if (b == RADIO_NACK) {
+                _stats.nacks++;
+                return RadioParseResult::NACK;
+            }
+            _stats.junkBytes++;
+            continue;
+        }
+
+        // Header: wait for command and length, then the whole frame
+        uint16_t buffered = getBuffered();
+        if (buffered < 3) return RadioParseResult::NONE;
+
+        uint8_t len = at(2);
+        uint16_t size = (uint16_t)len + 4;
+        if (buffered < size) return RadioParseResult::NONE;
+
+        uint8_t sum = at(1) + len;
+        for (uint16_t i = 3; i < size - 1; i++) {
+            sum += at(i);
+        }
+
+        if ((uint8_t)(sum ^ 0xFF) != at(size - 1)) {
+            // Drop only the header byte: a real frame may start inside
+            _tail++;
+            _stats.badChecksums++;
+            if (_noAck < size - 1) _noAck = size - 1;
+            return RadioParseResult::BAD_CHECKSUM;
+        }
+
+        uint16_t idx = _tail & MASK;
+        uint16_t first = RADIO_RX_BUFFER - idx;
+        if (first > size) first = size;
+
+        frame.cmd = at(1);
+        frame.len = len;
+        frame.seg[0] = &_buf[idx];
+        frame.segLen[0] = first;
+        frame.seg[1] = _buf;
+        frame.segLen[1] = size - first;
+
+        _release = size;
+        _noAck = 0;
+        _stats.frames++;
+        return RadioParseResult::FRAME;
+    }
+
+    return RadioParseResult::NONE;
+}
@@ -24,11 +24,20 @@
  * - 0x28: Outside temperature (12 bytes, temp at [5])
  * - 0x29: Steering wheel angle (2 bytes LE, 0.1° units)
  * - 0x7D: Multi-function (sub-commands: 0x03=speed, 0x04=odo, 0x0A=rpm)
+ *
+ * HOST → SLAVE: frames in the same format, plus single ACK (0xFF) / NACK
+ * (0xF0) bytes. Every frame received is answered with ACK, or NACK when its
+ * checksum fails (RadioFrameParser).
  */
 
 #include <Arduino.h>
+#include <limits.h>
 #include "GlobalData.h"
 #include "ConfigManager.h"
+#include "RadioSend.h"
+#include "RadioFrameParser.h"
+#include "PerfStats.h"
+#include "LatencyHistogram.h"
 
 extern HardwareSerial RadioSerial;
 
@@ -84,39 +93,174 @@ const uint8_t MASK_DOOR_REAR_LEFT  = 0x10;  // Bit 4
 const uint8_t MASK_DOOR_REAR_RIGHT = 0x20;  // Bit 5
 const uint8_t MASK_DOOR_BOOT       = 0x08;  // Bit 3
 
-// Timer variables
-static unsigned long lastSteeringTime = 0;
-static unsigned long lastLightsTime = 0;
-static unsigned long lastDoorTime = 0;
-static unsigned long lastRpmTime = 0;
-static unsigned long lastSpeedTime = 0;
-static unsigned long lastFuelConsTime = 0;
-static unsigned long lastFuelConsAvgTime = 0;
-static unsigned long lastTempTime = 0;
-static unsigned long lastRangeTime = 0;
-static unsigned long lastOdometerTime = 0;
+// =============================================================================
+// SEND SCHEDULE
+// =============================================================================
+// Each command belongs to a RadioClass (priority in RadioTx).
+// Change-driven mode (RADIO_CHANGE_DRIVEN=1): a command goes out as soon as
+// its signal changes, but never closer than minSpacingMs to the previous one,
+// and is refreshed every keepAliveMs while unchanged. Telemetry keeps its old
+// interval as minimum spacing so a noisy signal never costs more UART time
+// than the fixed schedule did.
+// Fixed mode (RADIO_CHANGE_DRIVEN=0): previous behaviour, every intervalMs
+// (doors/lights also on change).
+
+enum RadioSlotId : uint8_t {
+    SLOT_STEERING,
+    SLOT_DOORS,
+    SLOT_LIGHTS,
+    SLOT_RPM,
+    SLOT_SPEED,
+    SLOT_FUEL_CONS,
+    SLOT_FUEL_CONS_AVG,
+    SLOT_TEMP,
+    SLOT_RANGE,
+    SLOT_ODOMETER,
+    RADIO_SLOT_COUNT
+};
+
+struct RadioSlot {
+    uint16_t      dirtyMask;        // GlobalData DIRTY_* bits feeding this command
+    uint16_t      minSpacingMs;     // Change-driven: minimum gap between sends
+    uint16_t      keepAliveMs;      // Change-driven: refresh when unchanged
+    uint16_t      intervalMs;       // Fixed mode: send period
+    bool          fixedOnChange;    // Fixed mode: also send on change
+    bool          stretch;          // Slowed down by RADIO_STRETCH_FACTOR when saturated
+    unsigned long lastSent;
+};
+
+static RadioSlot radioSlots[RADIO_SLOT_COUNT] = {
+    // dirty bits,               spacing, keep-alive, fixed interval,          on change, stretch
+    { DIRTY_STEERING,                 20,    500, STEERING_INTERVAL_MS,      false, false, 0 },
+    { DIRTY_DOORS,                    20,   1000, DOOR_INTERVAL_MS,          true,  false, 0 },
+    { DIRTY_LIGHTS,                   20,    500, LIGHTS_INTERVAL_MS,        true,  false, 0 },
+    { DIRTY_RPM,                     333,   1000, RPM_INTERVAL_MS,           false, false, 0 },
+    { DIRTY_SPEED,                   500,   1500, SPEED_INTERVAL_MS,         false, false, 0 },
+    { DIRTY_FUEL_CONS_INST,         1000,   3000, FUEL_CONS_INTERVAL_MS,     false, true,  0 },
+    { DIRTY_FUEL_CONS_AVG,          5000,  15000, FUEL_CONS_AVG_INTERVAL_MS, false, true,  0 },
+    { DIRTY_TEMPERATURE,            5000,  15000, TEMP_INTERVAL_MS,          false, true,  0 },
+    { DIRTY_DTE | DIRTY_TRIP,       5000,  15000, RANGE_INTERVAL_MS,         false, true,  0 },
+    { DIRTY_ODOMETER,              10000,  30000, ODOMETER_INTERVAL_MS,      false, true,  0 },
+};
+
+// Dirty bits taken from GlobalData but not yet sent (spacing not elapsed)
+static uint16_t pendingDirty = 0;
+
 static uint8_t lastSentDoors = 0xFF;
 static uint8_t lastSentLights = 0xFF;
 
+// Head-unit input
+static RadioFrameParser radioRx;
+static unsigned long lastAckTime = 0;
+
+// =============================================================================
+// LATENCY TRACING
+// =============================================================================
+// A command sent because its signals changed records the age of the oldest
+// change it carries: micros() at the end of the flush that writes it minus
+// the micros() of the CAN frame that changed the signal (GlobalData stamps).
+// Keep-alive resends carry no new change and are not recorded.
+
+static const char* const RADIO_SLOT_NAMES[RADIO_SLOT_COUNT] = {
+    "STEERING", "DOORS", "LIGHTS", "RPM", "SPEED",
+    "FUEL_INST", "FUEL_AVG", "TEMP", "RANGE", "ODOMETER"
+};
+
+static LatencyHistogram radioLatency[RADIO_SLOT_COUNT];
+static uint32_t latencySourceUs[RADIO_SLOT_COUNT];
+static uint16_t latencyPending = 0;     // Slots with a source time, one bit each
+static bool latencyTrace = false;
+
+/**
+ * @brief Time after the previous send at which this command is due
+ * @param changed Extra change detection done by the caller (derived values)
+ */
+static unsigned long radioPeriod(RadioSlotId id, bool changed) {
+    const RadioSlot& slot = radioSlots[id];
+
+    // Starvation guard: slow signals give way while the link is saturated
+    unsigned long factor = (slot.stretch && radioTxIsSaturated()) ? RADIO_STRETCH_FACTOR : 1;
+
+#if RADIO_CHANGE_DRIVEN
+    if (changed || (pendingDirty & slot.dirtyMask)) {
+        return slot.minSpacingMs * factor;
+    }
+    return slot.keepAliveMs * factor;
+#else
+    return (slot.fixedOnChange && changed) ? 0 : slot.intervalMs * factor;
+#endif
+}
+
+/**
+ * @brief Is this command due?
+ */
+static bool radioDue(RadioSlotId id, unsigned long now, bool changed) {
+    return now - radioSlots[id].lastSent >= radioPeriod(id, changed);
+}
+
+static void radioSent(RadioSlotId id, unsigned long now, const VehicleDataSnapshot& data) {
+    uint16_t changed = pendingDirty & radioSlots[id].dirtyMask;
+    radioSlots[id].lastSent = now;
+    pendingDirty &= ~radioSlots[id].dirtyMask;
+    if (!changed) return;
+
+    // Oldest change this command carries
+    uint32_t nowUs = micros();
+    uint32_t oldestAge = 0;
+    for (uint16_t b = changed; b; b &= b - 1) {
+        uint32_t age = nowUs - data.changedUs[__builtin_ctz(b)];
+        if (age > oldestAge) oldestAge = age;
+    }
+    latencySourceUs[id] = nowUs - oldestAge;
+    latencyPending |= (uint16_t)(1u << id);
+}
+
+/**
+ * @brief Record the commands written by this pass's flush
+ */
+static void radioRecordLatency() {
+    if (!latencyPending) return;
+
+    uint32_t nowUs = micros();
+    for (uint16_t b = latencyPending; b; b &= b - 1) {
+        uint8_t id = (uint8_t)__builtin_ctz(b);
+        uint32_t age = nowUs - latencySourceUs[id];
+        radioLatency[id].record(age);
+        if (latencyTrace) {
+            Serial.printf("LAT %s %lu\n", RADIO_SLOT_NAMES[id], (unsigned long)age);
+        }
+    }
+    latencyPending = 0;
+}
+
+void radioBegin() {
+    // Must precede begin(): the driver allocates its TX buffer there
+    RadioSerial.setTxBufferSize(RADIO_UART_TX_BUFFER);
+    RadioSerial.begin(RADIO_BAUD, SERIAL_8N1, RADIO_RX_PIN, RADIO_TX_PIN);
+    radioTxReset();
+    radioRx.reset();
+}
+
+const RadioParserStats& radioGetRxStats() {
+    return radioRx.getStats();
+}
+
+unsigned long radioGetLastAckTime() {
+    return lastAckTime;
+}
+
 /**
- * @brief Transmit a data frame to the head unit
+ * @brief Queue a data frame for the head unit
+ * @param cls Scheduling class (see RadioTx.h)
  * @param cmd Command byte
  * @param data Pointer to payload data array
  * @param len Number of bytes in payload
+ *
+ * Checksum = (cmd + len + sum(data)) XOR 0xFF, computed while the frame is
+ * built in the class queue. radioTxFlush() sends it.
  */
-void sendCanboxMessage(uint8_t cmd, const uint8_t* data, uint8_t len) {
-    // Calculate checksum: (cmd + len + sum(data)) XOR 0xFF
-    uint8_t sum = cmd + len;
-    for (uint8_t i = 0; i < len; i++) {
-        sum += data[i];
-    }
-    uint8_t checksum = sum ^ 0xFF;
-
-    RadioSerial.write(0x2E);      // Header
-    RadioSerial.write(cmd);       // Command
-    RadioSerial.write(len);       // Length
-    RadioSerial.write(data, len); // Payload
-    RadioSerial.write(checksum);  // Checksum
+void sendCanboxMessage(RadioClass cls, uint8_t cmd, const uint8_t* data, uint8_t len) {
+    radioTxQueue(cls, cmd, data, len);
 }
 
 /**
@@ -124,7 +268,8 @@ void sendCanboxMessage(uint8_t cmd, const uint8_t* data, uint8_t len) {
  * @param doorMask Bitmask of open doors
  */
 void sendDoorCommand(uint8_t doorMask) {
-    sendCanboxMessage(CMD_DOOR_STATUS, &doorMask, 1);
+    PERF_SCOPE(RADIO_DOORS);
+    sendCanboxMessage(RadioClass::LIGHTS, CMD_DOOR_STATUS, &doorMask, 1);
 }
 
 /**
@@ -135,11 +280,12 @@ void sendDoorCommand(uint8_t doorMask) {
  * Per PDF: "Steering wheel angle is -540 to 540"
  */
 void sendSteeringAngleMessage(int16_t angle) {
+    PERF_SCOPE(RADIO_STEERING);
     uint8_t payload[2] = {
         (uint8_t)(angle & 0xFF),        // LSB
         (uint8_t)((angle >> 8) & 0xFF)  // MSB
     };
-    sendCanboxMessage(CMD_STEERING_WHEEL, payload, 2);
+    sendCanboxMessage(RadioClass::STEERING, CMD_STEERING_WHEEL, payload, 2);
 }
 
 /**
@@ -149,13 +295,14 @@ void sendSteeringAngleMessage(int16_t angle) {
  * Encoding: RPM × 4, Little Endian
  */
 void sendRpmMessage(uint16_t rpm) {
+    PERF_SCOPE(RADIO_RPM);
     uint16_t encoded = rpm * 4;
     uint8_t payload[3] = {
         SUBCMD_RPM,
         (uint8_t)(encoded & 0xFF),        // LSB
         (uint8_t)((encoded >> 8) & 0xFF)  // MSB
     };
-    sendCanboxMessage(CMD_MULTI_FUNCTION, payload, 3);
+    sendCanboxMessage(RadioClass::TELEMETRY, CMD_MULTI_FUNCTION, payload, 3);
 }
 
 /**
@@ -165,6 +312,7 @@ void sendRpmMessage(uint16_t rpm) {
  * Encoding: Speed × 100, Little Endian (0.01 km/h resolution)
  */
 void sendSpeedMessage(uint16_t speed) {
+    PERF_SCOPE(RADIO_SPEED);
     uint16_t encoded = speed * 100;
     uint8_t payload[5] = {
         SUBCMD_SPEED,
@@ -173,7 +321,7 @@ void sendSpeedMessage(uint16_t speed) {
         0x00,  // Average speed LSB (not available)
         0x00   // Average speed MSB (not available)
     };
-    sendCanboxMessage(CMD_MULTI_FUNCTION, payload, 5);
+    sendCanboxMessage(RadioClass::TELEMETRY, CMD_MULTI_FUNCTION, payload, 5);
 }
 
 /**
@@ -184,6 +332,7 @@ void sendSpeedMessage(uint16_t speed) {
  * Per PDF: includes Trip 1/2 but we only have odometer
  */
 void sendOdometerMessage(uint32_t odo) {
+    PERF_SCOPE(RADIO_ODOMETER);
     uint8_t payload[12] = {
         SUBCMD_ODOMETER,
         (uint8_t)(odo & 0xFF),          // Odo LSB
@@ -193,7 +342,7 @@ void sendOdometerMessage(uint32_t odo) {
         0x00, 0x00, 0x00,               // Trip 1 (not available)
         0x00, 0x00, 0x00                // Trip 2 (not available)
     };
-    sendCanboxMessage(CMD_MULTI_FUNCTION, payload, 12);
+    sendCanboxMessage(RadioClass::TELEMETRY, CMD_MULTI_FUNCTION, payload, 12);
 }
 
 /**
@@ -204,10 +353,11 @@ void sendOdometerMessage(uint32_t odo) {
  * Per PDF: 12-byte payload, all zeros except byte 5
  */
 void sendOutsideTempMessage(int8_t temp) {
+    PERF_SCOPE(RADIO_TEMP);
     uint8_t encoded = (uint8_t)((temp + 40) * 2);
     uint8_t payload[12] = {0};
     payload[5] = encoded;
-    sendCanboxMessage(CMD_OUTSIDE_TEMP, payload, 12);
+    sendCanboxMessage(RadioClass::TELEMETRY, CMD_OUTSIDE_TEMP, payload, 12);
 }
 
 /**
@@ -224,6 +374,7 @@ void sendOutsideTempMessage(int8_t temp) {
  * - Data6: Unit (0x02 = km)
  */
 void sendTripInfoMessage(uint16_t range_km, uint16_t avg_speed_01, uint16_t elapsed_sec) {
+    PERF_SCOPE(RADIO_RANGE);
     uint8_t payload[7] = {
         (uint8_t)((avg_speed_01 >> 8) & 0xFF),  // Average Speed MSB
         (uint8_t)(avg_speed_01 & 0xFF),          // Average Speed LSB
@@ -233,7 +384,7 @@ void sendTripInfoMessage(uint16_t range_km, uint16_t avg_speed_01, uint16_t elap
         (uint8_t)(range_km & 0xFF),              // Range LSB
         0x02                                      // Unit: km
     };
-    sendCanboxMessage(CMD_REMAINING_RANGE, payload, 7);
+    sendCanboxMessage(RadioClass::TELEMETRY, CMD_REMAINING_RANGE, payload, 7);
 }
 
 /**
@@ -246,12 +397,13 @@ void sendTripInfoMessage(uint16_t range_km, uint16_t avg_speed_01, uint16_t elap
  * - Data1-2: Value (Big Endian), divide by 10 to get L/100km
  */
 void sendFuelConsumptionMessage(uint16_t consumption_01) {
+    PERF_SCOPE(RADIO_FUEL_INST);
     uint8_t payload[3] = {
         FUEL_UNIT_L100KM,                        // Unit: L/100km
         (uint8_t)((consumption_01 >> 8) & 0xFF), // Value MSB
         (uint8_t)(consumption_01 & 0xFF)         // Value LSB
     };
-    sendCanboxMessage(CMD_FUEL_CONSUMPTION, payload, 3);
+    sendCanboxMessage(RadioClass::TELEMETRY, CMD_FUEL_CONSUMPTION, payload, 3);
 }
 
 /**
@@ -264,12 +416,13 @@ void sendFuelConsumptionMessage(uint16_t consumption_01) {
  * - Data1-2: Value (Big Endian), divide by 10 to get L/100km
  */
 void sendFuelConsumptionAvgMessage(uint16_t consumption_01) {
+    PERF_SCOPE(RADIO_FUEL_AVG);
     uint8_t payload[3] = {
         FUEL_UNIT_L100KM,                        // Unit: L/100km
         (uint8_t)((consumption_01 >> 8) & 0xFF), // Value MSB
         (uint8_t)(consumption_01 & 0xFF)         // Value LSB
     };
-    sendCanboxMessage(CMD_FUEL_CONS_AVG, payload, 3);
+    sendCanboxMessage(RadioClass::TELEMETRY, CMD_FUEL_CONS_AVG, payload, 3);
 }
 
 /**
@@ -281,29 +434,53 @@ void sendFuelConsumptionAvgMessage(uint16_t consumption_01) {
  * - Bitmask: 0x08=Right, 0x10=Left, 0x20=HighBeam, 0x40=Headlights, 0x80=Parking
  */
 void sendLightsMessage(uint8_t lightMask) {
+    PERF_SCOPE(RADIO_LIGHTS);
     uint8_t payload[2] = {
         SUBCMD_LIGHTS,
         lightMask
     };
-    sendCanboxMessage(CMD_MULTI_FUNCTION, payload, 2);
+    sendCanboxMessage(RadioClass::LIGHTS, CMD_MULTI_FUNCTION, payload, 2);
 }
 
 /**
- * @brief Handle protocol handshake with the head unit (if needed)
+ * @brief Handle input from the head unit
  *
- * Toyota RAV4 protocol doesn't require explicit handshake,
- * but we still consume any incoming data.
+ * Moves whatever the UART driver has received into the parser without
+ * blocking, answers each host frame with ACK (NACK on checksum failure) and
+ * records ACKs for our own frames. The replies are sent by the radioTxFlush()
+ * at the end of this pass, well within the 10 ms the protocol allows.
+ *
+ * Host commands (0x81 start/end, 0x90 requests, media info) are only
+ * acknowledged for now: the RAV4 profile has no use for them yet.
  */
 void handshake() {
-    while (RadioSerial.available() > 0) {
-        RadioSerial.read(); // Discard incoming data
+    radioRx.pump(RadioSerial);
+
+    RadioFrameView frame;
+    for (;;) {
+        switch (radioRx.next(frame)) {
+            case RadioParseResult::NONE:
+                return;
+            case RadioParseResult::FRAME:
+                radioTxQueueAck(RADIO_ACK);
+                break;
+            case RadioParseResult::BAD_CHECKSUM:
+                radioTxQueueAck(RADIO_NACK);
+                break;
+            case RadioParseResult::ACK:
+                lastAckTime = millis();
+                break;
+            case RadioParseResult::NACK:
+                break;  // Counted by the parser
+        }
     }
 }
 
 /**
  * @brief Main update function - sends all vehicle data to the radio
  *
- * Update intervals:
+ * Timing per command comes from radioSlots[] (see SEND SCHEDULE): either
+ * on change with minimum spacing and keep-alive, or the fixed intervals:
  * - Steering angle: 200ms (fast for camera guidelines)
  * - Door status: 250ms (or on change)
  * - Lights/indicators: 200ms (or on change)
@@ -315,18 +492,27 @@ void handshake() {
  * - Odometer: 10s
  */
 void processRadioUpdates() {
+    // Dirty set first, then the snapshot: a write in between is either in
+    // the copy or still dirty on the next pass.
+    pendingDirty |= vehicleDataTakeDirty();
+
+    // Consistent copy of CAN-decoded data (the ingest task may write concurrently).
+    // Taken before millis() so indicator timestamps are never ahead of 'now'.
+    VehicleDataSnapshot data;
+    vehicleDataSnapshot(data);
+
     unsigned long now = millis();
 
     handshake();
 
     // =========================================================================
-    // 1. STEERING WHEEL ANGLE (CMD 0x29) - 200ms interval
+    // 1. STEERING WHEEL ANGLE (CMD 0x29)
     // =========================================================================
     // Per PDF: Angle in 0.1° units, range -540 to +540 (so -5400 to +5400 raw)
     // Calibration values from ConfigManager (stored in NVS)
-    if (now - lastSteeringTime >= STEERING_INTERVAL_MS) {
+    if (radioDue(SLOT_STEERING, now, false)) {
         // Step 1: Apply center offset from config
-        int32_t centered = (int32_t)currentSteer + configGetSteerOffset();
+        int32_t centered = (int32_t)data.currentSteer + configGetSteerOffset();
 
         // Step 2: Apply scale factor from config (unit x0.0001, 10000 = 1.0x)
         int32_t angleRAV4 = (centered * configGetSteerScale()) / 10000;
@@ -337,109 +523,179 @@ void processRadioUpdates() {
         }
 
         sendSteeringAngleMessage(angleRAV4);
-        lastSteeringTime = now;
+        radioSent(SLOT_STEERING, now, data);
     }
 
     // =========================================================================
-    // 2. DOOR STATUS (CMD 0x24) - 250ms interval or on change
+    // 2. DOOR STATUS (CMD 0x24) - on change
     // =========================================================================
     uint8_t doorStatus = 0;
 
-    if (currentDoors & 0x80) doorStatus |= MASK_DOOR_DRIVER;     // Front Left
-    if (currentDoors & 0x40) doorStatus |= MASK_DOOR_PASSENGER;  // Front Right
-    if (currentDoors & 0x20) doorStatus |= MASK_DOOR_REAR_LEFT;  // Rear Left
-    if (currentDoors & 0x10) doorStatus |= MASK_DOOR_REAR_RIGHT; // Rear Right
-    if (currentDoors & 0x08) doorStatus |= MASK_DOOR_BOOT;       // Trunk
+    if (data.currentDoors & 0x80) doorStatus |= MASK_DOOR_DRIVER;     // Front Left
+    if (data.currentDoors & 0x40) doorStatus |= MASK_DOOR_PASSENGER;  // Front Right
+    if (data.currentDoors & 0x20) doorStatus |= MASK_DOOR_REAR_LEFT;  // Rear Left
+    if (data.currentDoors & 0x10) doorStatus |= MASK_DOOR_REAR_RIGHT; // Rear Right
+    if (data.currentDoors & 0x08) doorStatus |= MASK_DOOR_BOOT;       // Trunk
 
-    if (doorStatus != lastSentDoors || (now - lastDoorTime >= DOOR_INTERVAL_MS)) {
+    if (radioDue(SLOT_DOORS, now, doorStatus != lastSentDoors)) {
         sendDoorCommand(doorStatus);
         lastSentDoors = doorStatus;
-        lastDoorTime = now;
+        radioSent(SLOT_DOORS, now, data);
     }
 
     // =========================================================================
-    // 3. LIGHTS & INDICATORS (CMD 0x7D, SUB 0x01) - 200ms interval or on change
+    // 3. LIGHTS & INDICATORS (CMD 0x7D, SUB 0x01) - on change
     // =========================================================================
     // Build lights bitmask from global state
-    // Indicators use timeout detection (configurable) since CAN only signals when active
+    // Indicators use timeout detection (configurable) since CAN only signals when active,
+    // so their changes are found here by comparing with the last sent mask.
     uint8_t lightStatus = 0;
 
     // Check if indicators are active (received signal within timeout)
     uint16_t indTimeout = configGetIndicatorTimeout();
-    bool leftActive = (now - lastLeftIndicatorTime) < indTimeout;
-    bool rightActive = (now - lastRightIndicatorTime) < indTimeout;
+    bool leftActive = (now - data.lastLeftIndicatorTime) < indTimeout;
+    bool rightActive = (now - data.lastRightIndicatorTime) < indTimeout;
 
     if (rightActive)      lightStatus |= MASK_LIGHT_RIGHT_IND;
     if (leftActive)       lightStatus |= MASK_LIGHT_LEFT_IND;
-    if (highBeamOn)       lightStatus |= MASK_LIGHT_HIGH_BEAM;
-    if (headlightsOn)     lightStatus |= MASK_LIGHT_HEADLIGHTS;
-    if (parkingLightsOn)  lightStatus |= MASK_LIGHT_PARKING;
+    if (data.highBeamOn)       lightStatus |= MASK_LIGHT_HIGH_BEAM;
+    if (data.headlightsOn)     lightStatus |= MASK_LIGHT_HEADLIGHTS;
+    if (data.parkingLightsOn)  lightStatus |= MASK_LIGHT_PARKING;
 
-    if (lightStatus != lastSentLights || (now - lastLightsTime >= LIGHTS_INTERVAL_MS)) {
+    if (radioDue(SLOT_LIGHTS, now, lightStatus != lastSentLights)) {
         sendLightsMessage(lightStatus);
         lastSentLights = lightStatus;
-        lastLightsTime = now;
+        radioSent(SLOT_LIGHTS, now, data);
     }
 
     // =========================================================================
-    // 4. ENGINE RPM (CMD 0x7D, SUB 0x0A) - 333ms interval
+    // 4. ENGINE RPM (CMD 0x7D, SUB 0x0A)
     // =========================================================================
-    if (now - lastRpmTime >= RPM_INTERVAL_MS) {
-        sendRpmMessage(engineRPM);
-        lastRpmTime = now;
+    if (radioDue(SLOT_RPM, now, false)) {
+        sendRpmMessage(data.engineRPM);
+        radioSent(SLOT_RPM, now, data);
     }
 
     // =========================================================================
-    // 5. VEHICLE SPEED (CMD 0x7D, SUB 0x03) - 500ms interval
+    // 5. VEHICLE SPEED (CMD 0x7D, SUB 0x03)
     // =========================================================================
-    if (now - lastSpeedTime >= SPEED_INTERVAL_MS) {
-        sendSpeedMessage(vehicleSpeed);
-        lastSpeedTime = now;
+    if (radioDue(SLOT_SPEED, now, false)) {
+        sendSpeedMessage(data.vehicleSpeed);
+        radioSent(SLOT_SPEED, now, data);
     }
 
     // =========================================================================
-    // 6. INSTANTANEOUS FUEL CONSUMPTION (CMD 0x22) - 1s interval
+    // 6. INSTANTANEOUS FUEL CONSUMPTION (CMD 0x22)
     // =========================================================================
     // Instantaneous consumption from Nissan CAN 0x580 byte[1]
-    if (now - lastFuelConsTime >= FUEL_CONS_INTERVAL_MS) {
-        sendFuelConsumptionMessage(fuelConsumptionInst);
-        lastFuelConsTime = now;
+    if (radioDue(SLOT_FUEL_CONS, now, false)) {
+        sendFuelConsumptionMessage(data.fuelConsumptionInst);
+        radioSent(SLOT_FUEL_CONS, now, data);
     }
 
     // =========================================================================
-    // 6b. AVERAGE FUEL CONSUMPTION (CMD 0x23) - 5s interval
+    // 6b. AVERAGE FUEL CONSUMPTION (CMD 0x23)
     // =========================================================================
     // Average consumption from Nissan CAN 0x580 byte[4]
-    if (now - lastFuelConsAvgTime >= FUEL_CONS_AVG_INTERVAL_MS) {
-        sendFuelConsumptionAvgMessage(fuelConsumptionAvg);
-        lastFuelConsAvgTime = now;
+    if (radioDue(SLOT_FUEL_CONS_AVG, now, false)) {
+        sendFuelConsumptionAvgMessage(data.fuelConsumptionAvg);
+        radioSent(SLOT_FUEL_CONS_AVG, now, data);
     }
 
     // =========================================================================
-    // 7. OUTSIDE TEMPERATURE (CMD 0x28) - 5s interval
+    // 7. OUTSIDE TEMPERATURE (CMD 0x28)
     // =========================================================================
     // Note: Using coolant temp as substitute (no exterior sensor on Juke CAN)
-    if (now - lastTempTime >= TEMP_INTERVAL_MS) {
-        sendOutsideTempMessage(tempExt);
-        lastTempTime = now;
+    if (radioDue(SLOT_TEMP, now, false)) {
+        sendOutsideTempMessage(data.tempExt);
+        radioSent(SLOT_TEMP, now, data);
     }
 
     // =========================================================================
-    // 8. TRIP INFO / REMAINING RANGE (CMD 0x21) - 5s interval
+    // 8. TRIP INFO / REMAINING RANGE (CMD 0x21)
     // =========================================================================
     // Contains: Average Speed, Elapsed Time, Distance to Empty
     // Average speed/elapsed time from trip computer (if available on CAN)
     // Distance to Empty from Nissan CAN 0x54C
-    if (now - lastRangeTime >= RANGE_INTERVAL_MS) {
-        sendTripInfoMessage(dteValue, averageSpeed, elapsedTime);
-        lastRangeTime = now;
+    if (radioDue(SLOT_RANGE, now, false)) {
+        sendTripInfoMessage(data.dteValue, data.averageSpeed, data.elapsedTime);
+        radioSent(SLOT_RANGE, now, data);
     }
 
     // =========================================================================
-    // 9. ODOMETER (CMD 0x7D, SUB 0x04) - 10s interval
+    // 9. ODOMETER (CMD 0x7D, SUB 0x04)
     // =========================================================================
-    if (now - lastOdometerTime >= ODOMETER_INTERVAL_MS) {
-        sendOdometerMessage(currentOdo);
-        lastOdometerTime = now;
+    if (radioDue(SLOT_ODOMETER, now, false)) {
+        sendOdometerMessage(data.currentOdo);
+        radioSent(SLOT_ODOMETER, now, data);
+    }
+
+    // Everything due this pass goes out back-to-back, by priority
+    {
+        PERF_SCOPE(RADIO_FLUSH);
+        radioTxFlush();
     }
+    PERF_MARK_UART(radioTxGetStats().bytesWritten);
+    radioRecordLatency();
+}
+
+void radioResync() {
+    // Every command overdue: the next pass sends a full set as keep-alives
+    // (no latency samples: the change stamps predate the standby)
+    unsigned long now = millis();
+    for (RadioSlot& slot : radioSlots) slot.lastSent = now - 0x7FFFFFFFUL;
+    lastSentDoors = 0xFF;
+    lastSentLights = 0xFF;
+}
+
+unsigned long radioNextDueMs() {
+    // Frames left in the queue: the UART buffer was full, come back soon
+    if (radioTxGetPending() > 0) return RADIO_DRAIN_POLL_MS;
+
+    unsigned long now = millis();
+    unsigned long wait = ULONG_MAX;
+    for (uint8_t id = 0; id < RADIO_SLOT_COUNT; id++) {
+        unsigned long elapsed = now - radioSlots[id].lastSent;
+        unsigned long period = radioPeriod((RadioSlotId)id, false);
+        if (elapsed >= period) return 0;
+        if (period - elapsed < wait) wait = period - elapsed;
+    }
+
+    // A blinker going off is a timeout, not a CAN change
+    uint16_t indTimeout = configGetIndicatorTimeout();
+    unsigned long lastInd[2] = { lastLeftIndicatorTime, lastRightIndicatorTime };
+    for (unsigned long last : lastInd) {
+        unsigned long age = now - last;
+        if (last != 0 && age < indTimeout && indTimeout - age < wait) wait = indTimeout - age;
+    }
+    return wait;
+}
+
+// =============================================================================
+// LATENCY API
+// =============================================================================
+
+uint8_t radioLatencySlotCount() {
+    return RADIO_SLOT_COUNT;
+}
+
+const char* radioLatencySlotName(uint8_t slot) {
+    return slot < RADIO_SLOT_COUNT ? RADIO_SLOT_NAMES[slot] : "?";
+}
+
+const LatencyHistogram& radioGetLatency(uint8_t slot) {
+    return radioLatency[slot < RADIO_SLOT_COUNT ? slot : 0];
+}
+
+void radioLatencyReset() {
+    for (LatencyHistogram& h : radioLatency) h.reset();
+    latencyPending = 0;
+}
+
+void radioSetLatencyTrace(bool enabled) {
+    latencyTrace = enabled;
+}
+
+bool radioIsLatencyTracing() {
+    return latencyTrace;
 }
@@ -0,0 +1,284 @@
+/**
+ * @file RadioTx.cpp
+ * @brief Priority-aware TX scheduler for the head-unit UART
+ *
+ * One ring buffer per RadioClass holds complete 0x2E frames plus the time
+ * each frame was queued. Only the loop() task queues and flushes, so no
+ * locking is needed.
+ */
+
+#include "RadioTx.h"
+#include <string.h>
+
+extern HardwareSerial RadioSerial;
+
+// =============================================================================
+// CLASS QUEUES
+// =============================================================================
+
+static const uint8_t CLASS_COUNT = (uint8_t)RadioClass::COUNT;
+
+struct ClassQueue {
+    uint8_t       buf[RADIO_TX_QUEUE_BYTES];
+    uint16_t      head;                             // Next byte to write
+    uint16_t      tail;                             // Next byte to send
+    uint16_t      used;
+    unsigned long queuedAt[RADIO_TX_QUEUE_FRAMES];  // millis() per waiting frame
+    uint8_t       frameHead;
+    uint8_t       frameTail;
+    uint8_t       frames;
+};
+
+static ClassQueue queues[CLASS_COUNT];
+static RadioClassStats classStats[CLASS_COUNT];
+static RadioTxStats linkStats;
+
+// Frame partially handed to the UART: finished before anything else
+static int8_t currentClass = -1;
+static uint16_t currentRemaining = 0;
+
+// ACK/NACK replies waiting for a frame boundary
+static uint8_t acks[RADIO_TX_ACK_SLOTS];
+static uint8_t ackCount = 0;
+
+// Utilization window
+static unsigned long windowStart = 0;
+static uint32_t windowBytes = 0;
+
+static const char* const classNames[CLASS_COUNT] = { "SAFETY", "STEER", "LIGHTS", "TELEM" };
+
+/**
+ * @brief Reserve room for one frame, or count a drop
+ */
+static bool reserveFrame(uint8_t c, uint16_t size) {
+    ClassQueue& q = queues[c];
+    if (size > RADIO_TX_QUEUE_BYTES - q.used || q.frames >= RADIO_TX_QUEUE_FRAMES) {
+        classStats[c].framesDropped++;
+        return false;
+    }
+    return true;
+}
+
+static inline void queuePut(ClassQueue& q, uint8_t b) {
+    q.buf[q.head] = b;
+    q.head = (q.head + 1) % RADIO_TX_QUEUE_BYTES;
+}
+
+static void commitFrame(uint8_t c, uint16_t size) {
+    ClassQueue& q = queues[c];
+    q.used += size;
+    q.queuedAt[q.frameHead] = millis();
+    q.frameHead = (q.frameHead + 1) % RADIO_TX_QUEUE_FRAMES;
+    q.frames++;
+
+    classStats[c].framesQueued++;
+    if (q.used > classStats[c].queueHighWater) classStats[c].queueHighWater = q.used;
+}
+
+bool radioTxQueue(RadioClass cls, uint8_t cmd, const uint8_t* payload, uint8_t len) {
+    uint8_t c = (uint8_t)cls;
+    uint16_t size = (uint16_t)len + 4;
+    if (c >= CLASS_COUNT || !reserveFrame(c, size)) return false;
+
+    ClassQueue& q = queues[c];
+    uint8_t sum = cmd + len;
+
+    queuePut(q, 0x2E);      // Header
+    queuePut(q, cmd);       // Command
+    queuePut(q, len);       // Length
+    for (uint8_t i = 0; i < len; i++) {
+        queuePut(q, payload[i]);
+        sum += payload[i];
+    }
+    queuePut(q, sum ^ 0xFF);    // Checksum
+
+    commitFrame(c, size);
+    return true;
+}
+
+bool radioTxQueueRaw(RadioClass cls, const uint8_t* frame, uint8_t size) {
+    uint8_t c = (uint8_t)cls;
+    // Frame boundaries are taken from the length byte when sending
+    if (c >= CLASS_COUNT || size < 4 || frame[0] != 0x2E || frame[2] + 4 != size) return false;
+    if (!reserveFrame(c, size)) return false;
+
+    for (uint8_t i = 0; i < size; i++) {
+        queuePut(queues[c], frame[i]);
+    }
+    commitFrame(c, size);
+    return true;
+}
+
+bool radioTxQueueAck(uint8_t code) {
+    if (ackCount >= RADIO_TX_ACK_SLOTS) return false;
+    acks[ackCount++] = code;
+    return true;
+}
+
+// =============================================================================
+// SCHEDULING
+// =============================================================================
+
+/**
+ * @brief Pick the class whose head frame goes out next
+ *
+ * Highest non-empty class, unless some frame is older than
+ * RADIO_STARVATION_MS: then the oldest such frame wins.
+ */
+static int8_t pickClass(unsigned long now) {
+    int8_t starved = -1;
+    unsigned long oldestAge = 0;
+    int8_t first = -1;
+
+    for (uint8_t c = 0; c < CLASS_COUNT; c++) {
+        const ClassQueue& q = queues[c];
+        if (!q.frames) continue;
+        if (first < 0) first = c;
+
+        unsigned long age = now - q.queuedAt[q.frameTail];
+        if (age >= RADIO_STARVATION_MS && age > oldestAge) {
+            starved = c;
+            oldestAge = age;
+        }
+    }
+
+    if (starved >= 0) {
+        if (starved != first) classStats[starved].promotions++;
+        return starved;
+    }
+    return first;
+}
+
+static void frameSent(uint8_t c, unsigned long now) {
+    ClassQueue& q = queues[c];
+    unsigned long latency = now - q.queuedAt[q.frameTail];
+    q.frameTail = (q.frameTail + 1) % RADIO_TX_QUEUE_FRAMES;
+    q.frames--;
+
+    // Boot-to-first-frame time (millis() counts from reset)
+    if (linkStats.firstFrameMs == 0) linkStats.firstFrameMs = now ? now : 1;
+
+    RadioClassStats& st = classStats[c];
+    st.framesSent++;
+    st.latencySumMs += latency;
+    if (latency > st.latencyMaxMs) st.latencyMaxMs = latency > 0xFFFF ? 0xFFFF : (uint16_t)latency;
+}
+
+static void updateUtilization(unsigned long now, uint16_t burst) {
+    windowBytes += burst;
+
+    unsigned long elapsed = now - windowStart;
+    if (elapsed < RADIO_UTIL_WINDOW_MS) return;
+
+    uint32_t capacity = (uint32_t)RADIO_LINK_BYTES_PER_SEC * elapsed / 1000;
+    uint32_t pct = capacity ? windowBytes * 100 / capacity : 0;
+    linkStats.utilization = pct > 100 ? 100 : (uint8_t)pct;
+    if (linkStats.utilization > linkStats.peakUtilization) {
+        linkStats.peakUtilization = linkStats.utilization;
+    }
+    if (linkStats.utilization >= RADIO_SATURATION_PCT) linkStats.saturatedWindows++;
+
+    windowStart = now;
+    windowBytes = 0;
+}
+
+void radioTxFlush() {
+    unsigned long now = millis();
+    uint16_t burst = 0;
+
+    for (;;) {
+        if (currentClass < 0 && ackCount) {
+            // Between frames: replies first (the head unit expects them within 10 ms)
+            int room = RadioSerial.availableForWrite();
+            if (room <= 0) break;
+            uint8_t n = room < ackCount ? (uint8_t)room : ackCount;
+            size_t written = RadioSerial.write(acks, n);
+            if (written == 0) break;
+            memmove(acks, acks + written, ackCount - written);
+            ackCount -= written;
+            linkStats.acksSent += written;
+            burst += written;
+            continue;
+        }
+
+        if (currentClass < 0) {
+            currentClass = pickClass(now);
+            if (currentClass < 0) break;
+            const ClassQueue& q = queues[currentClass];
+            currentRemaining = q.buf[(q.tail + 2) % RADIO_TX_QUEUE_BYTES] + 4;
+        }
+
+        int room = RadioSerial.availableForWrite();
+        if (room <= 0) break;
+
+        ClassQueue& q = queues[currentClass];
+        uint16_t chunk = currentRemaining;
+        if (chunk > RADIO_TX_QUEUE_BYTES - q.tail) chunk = RADIO_TX_QUEUE_BYTES - q.tail;
+        if (chunk > (uint16_t)room) chunk = (uint16_t)room;
+
+        uint32_t t0 = micros();
+        size_t written = RadioSerial.write(&q.buf[q.tail], chunk);
+        linkStats.blockedUs += micros() - t0;
+        if (written == 0) break;
+
+        q.tail = (q.tail + written) % RADIO_TX_QUEUE_BYTES;
+        q.used -= written;
+        classStats[currentClass].bytesSent += written;
+        currentRemaining -= written;
+        burst += written;
+
+        if (currentRemaining == 0) {
+            frameSent(currentClass, now);
+            currentClass = -1;
+        }
+    }
+
+    if (burst) {
+        linkStats.bursts++;
+        linkStats.bytesWritten += burst;
+        if (burst > linkStats.maxBurst) linkStats.maxBurst = burst;
+    }
+    updateUtilization(now, burst);
+}
+
+// =============================================================================
+// STATUS
+// =============================================================================
+
+bool radioTxIsSaturated() {
+    return linkStats.utilization >= RADIO_SATURATION_PCT;
+}
+
+uint16_t radioTxGetPending() {
+    uint16_t total = 0;
+    for (uint8_t c = 0; c < CLASS_COUNT; c++) total += queues[c].used;
+    return total;
+}
+
+uint16_t radioTxGetPending(RadioClass cls) {
+    return (uint8_t)cls < CLASS_COUNT ? queues[(uint8_t)cls].used : 0;
+}
+
+const RadioTxStats& radioTxGetStats() {
+    return linkStats;
+}
+
+const RadioClassStats& radioTxGetClassStats(RadioClass cls) {
+    uint8_t c = (uint8_t)cls < CLASS_COUNT ? (uint8_t)cls : 0;
+    return classStats[c];
+}
+
+const char* radioTxClassName(RadioClass cls) {
+    return (uint8_t)cls < CLASS_COUNT ? classNames[(uint8_t)cls] : "?";
+}
+
+void radioTxReset() {
+    memset(queues, 0, sizeof(queues));
+    memset(classStats, 0, sizeof(classStats));
+    memset(&linkStats, 0, sizeof(linkStats));
+    currentClass = -1;
+    currentRemaining = 0;
+    ackCount = 0;
+    windowStart = millis();
+    windowBytes = 0;
+}
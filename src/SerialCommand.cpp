@@ -9,20 +9,42 @@
 
 #include "SerialCommand.h"
 #include "base64.h"
+#include "crc32.h"
+#include "BinaryFrame.h"
 #include "ConfigManager.h"
 #include "GlobalData.h"
 #include "CanConfigProcessor.h"
+#include "CanDriver.h"
+#include "RadioSend.h"
+#include "OtaWriter.h"
+#include "CanRecorder.h"
+#include "CanStream.h"
+#include "CanReplay.h"
+#include "CanStress.h"
+#include "PerfStats.h"
+#include "LoopWake.h"
+#include "Standby.h"
+#include "ProfileIndex.h"
 #include <LittleFS.h>
 #include <ArduinoJson.h>
 #include <Update.h>
-#include <MD5Builder.h>
 #include <esp_task_wdt.h>
 #include <esp_ota_ops.h>
+#include <esp_timer.h>
 #include "soc/rtc_cntl_reg.h"  // For bootloader mode
 
 // External reference to CAN processor (defined in main.cpp)
 extern CanConfigProcessor canProcessor;
 
+// Log replay source (defined in main.cpp)
+extern CanReplay canReplay;
+
+// Synthetic bus load (defined in main.cpp)
+extern CanStress canStress;
+
+// Cumulative loop() busy time (defined in main.cpp)
+extern uint64_t loopBusyUs;
+
 // =============================================================================
 // PRIVATE VARIABLES
 // =============================================================================
@@ -36,11 +58,13 @@ static unsigned long bootTime = 0;
 // CAN UPLOAD STATE
 // =============================================================================
 
+#define CAN_UPLOAD_TEMP "/upload.tmp"  // Received bytes, renamed on a valid END
+
 static bool uploadInProgress = false;
 static char uploadFilename[32];
 static uint32_t uploadExpectedSize = 0;
 static uint32_t uploadReceivedSize = 0;
-static uint8_t* uploadBuffer = nullptr;
+static File uploadFile;
 
 // =============================================================================
 // OTA UPDATE STATE
@@ -52,19 +76,26 @@ static bool otaInProgress = false;
 static uint32_t otaExpectedSize = 0;
 static uint32_t otaReceivedSize = 0;
 static char otaExpectedMD5[33] = {0};  // 32 hex chars + null
-static MD5Builder otaMD5;
 static unsigned long otaLastDataTime = 0;  // millis() of last OTA START/DATA
 
-// Software CRC32 (ISO 3309 / ITU-T V.42) — compatible with Java CRC32 and Python binascii.crc32
-static uint32_t crc32_le(uint32_t crc, const uint8_t* buf, size_t len) {
-    for (size_t i = 0; i < len; i++) {
-        crc ^= buf[i];
-        for (int j = 0; j < 8; j++) {
-            crc = (crc >> 1) ^ (0xEDB88320U & -(crc & 1U));
-        }
-    }
-    return crc;
-}
+// =============================================================================
+// BINARY TRANSFER STATE (OTA START ... BIN / CAN UPLOAD START ... BIN)
+// =============================================================================
+
+enum BinSession : uint8_t {
+    BIN_SESSION_NONE,       // Text command mode
+    BIN_SESSION_OTA,
+    BIN_SESSION_UPLOAD
+};
+
+static BinSession binSession = BIN_SESSION_NONE;
+static BinaryFrameDecoder binDecoder;
+static uint16_t binExpectedSeq = 0;         // Next DATA frame to accept
+static bool binNakSent = false;             // One NAK per gap, not per frame
+static unsigned long binLastFrameTime = 0;
+static uint32_t binFrames = 0;
+static uint32_t binBadFrames = 0;
+static uint32_t binNaks = 0;
 
 // =============================================================================
 // PARAMETER DEFINITIONS
@@ -84,6 +115,7 @@ static const ParamDef params[] = {
     {"rpmDiv",       "RPM divisor (1-20)"},
     {"tankCap",      "Tank capacity liters (20-100)"},
     {"dteDiv",       "DTE divisor x100 (100-500)"},
+    {"canPromisc",   "Accept all CAN IDs, bypass HW filter (0/1)"},
 };
 static const uint8_t PARAM_COUNT = sizeof(params) / sizeof(params[0]);
 
@@ -97,6 +129,9 @@ static void handleCanCommand(const char* args);
 static void handleOtaCommand(const char* args);
 static void handleLogCommand(const char* args);
 static void handleSysCommand(const char* args);
+static void handlePtCommand(const char* args);
+static void handleRecCommand(const char* args);
+static void handleStressCommand(const char* args);
 static void handleHelpCommand();
 
 static void cfgGet(const char* param);
@@ -106,19 +141,38 @@ static void cfgList();
 static void canStatus();
 static void canList();
 static void canLoad(const char* filename);
+static void syncCanController();
 static void canGet();
 static void canDelete(const char* filename);
-static void canUploadStart(const char* filename, uint32_t size);
+static void canUploadStart(const char* filename, uint32_t size, bool binary);
 static void canUploadData(const char* base64Data);
 static void canUploadEnd();
 static void canUploadAbort();
+static bool uploadAppend(const uint8_t* data, size_t len);
 
-static void otaStart(uint32_t size, const char* md5);
+static void otaStart(uint32_t size, const char* md5, bool binary);
 static void otaData(const char* base64Data, bool hasCrc, uint32_t expectedCrc);
+static bool otaWrite(const uint8_t* data, size_t len);
 static void otaEnd();
 static void otaAbort();
 static void otaStatus();
 
+static void binBegin(BinSession session);
+static void binProcess();
+static void binHandleFrame(const BinFrame& frame);
+static void binNak();
+
+static void printStreamStats();
+static void stressHalt();
+static void stressStatus();
+static void recStatus();
+static void recGet(uint8_t index);
+
+static void printTaskStats();
+static void printLatencyStats();
+#if PERF_STATS_ENABLED
+static void printPerfStats();
+#endif
 static void printOK();
 static void printError(const char* msg);
 
@@ -134,6 +188,12 @@ void serialCommandInit() {
 }
 
 void serialCommandProcess() {
+    PERF_SCOPE(SERIAL_CMD);
+    if (binSession != BIN_SESSION_NONE) {
+        binProcess();
+        return;
+    }
+
     while (Serial.available()) {
         char c = Serial.read();
 
@@ -221,6 +281,15 @@ static void processCommand(const char* cmd) {
     else if (strcmp(cmdUpper, "SYS") == 0) {
         handleSysCommand(args);
     }
+    else if (strcmp(cmdUpper, "PT") == 0) {
+        handlePtCommand(args);
+    }
+    else if (strcmp(cmdUpper, "REC") == 0) {
+        handleRecCommand(args);
+    }
+    else if (strcmp(cmdUpper, "STRESS") == 0) {
+        handleStressCommand(args);
+    }
     else if (strcmp(cmdUpper, "HELP") == 0 || strcmp(cmdUpper, "?") == 0) {
         handleHelpCommand();
     }
@@ -250,7 +319,8 @@ static void handleCfgCommand(const char* args) {
     else if (n >= 1 && strcmp(subCmd, "SAVE") == 0) {
         configSave();
         printOK();
-        Serial.println("Configuration saved to NVS");
+        Serial.printf("Configuration saved to NVS (written after %d ms without changes)\n",
+                      CONFIG_FLUSH_QUIET_MS);
     }
     else if (n >= 1 && strcmp(subCmd, "RESET") == 0) {
         configReset();
@@ -297,9 +367,12 @@ static void cfgGet(const char* param) {
     else if (strcmp(paramLower, "dtediv") == 0) {
         Serial.printf("dteDiv = %d\n", configGetDteDivisor());
     }
+    else if (strcmp(paramLower, "canpromisc") == 0) {
+        Serial.printf("canPromisc = %d\n", configGetCanPromisc() ? 1 : 0);
+    }
     else {
         printError("Unknown parameter");
-        Serial.println("Valid: steerOffset, steerInvert, steerScale, indTimeout, rpmDiv, tankCap, dteDiv");
+        Serial.println("Valid: steerOffset, steerInvert, steerScale, indTimeout, rpmDiv, tankCap, dteDiv, canPromisc");
     }
 }
 
@@ -360,6 +433,14 @@ static void cfgSet(const char* param, const char* value) {
         }
         configSetDteDivisor((uint16_t)val);
     }
+    else if (strcmp(paramLower, "canpromisc") == 0) {
+        configSetCanPromisc(val != 0);
+        // Takes effect immediately: reprogram the acceptance filter
+        if (!canDriverRestart()) {
+            printError("CAN restart failed");
+            return;
+        }
+    }
     else {
         printError("Unknown parameter");
         return;
@@ -378,6 +459,7 @@ static void cfgList() {
     Serial.printf("rpmDiv       = %d    (RPM divisor)\n", configGetRpmDivisor());
     Serial.printf("tankCap      = %d    (tank liters)\n", configGetTankCapacity());
     Serial.printf("dteDiv       = %d    (DTE divisor x100)\n", configGetDteDivisor());
+    Serial.printf("canPromisc   = %d    (bypass HW filter)\n", configGetCanPromisc() ? 1 : 0);
     Serial.println("=============================");
 }
 
@@ -394,7 +476,7 @@ static void cfgList() {
  * - LOAD <file>: Load a config file
  * - GET: Output current config as JSON
  * - DELETE <file>: Delete a config file
- * - UPLOAD START <file> <size>: Begin upload
+ * - UPLOAD START <file> <size> [BIN]: Begin upload (BIN: binary frames)
  * - UPLOAD DATA <base64>: Send data chunk
  * - UPLOAD END: Finalize upload
  * - UPLOAD ABORT: Cancel upload
@@ -436,13 +518,15 @@ static void handleCanCommand(const char* args) {
         for (int i = 0; param1[i]; i++) param1[i] = toupper(param1[i]);
 
         if (strcmp(param1, "START") == 0) {
-            // Parse: UPLOAD START <filename> <size>
+            // Parse: UPLOAD START <filename> <size> [BIN]
             char filename[32];
+            char mode[4] = {0};
             uint32_t size;
-            if (sscanf(args + 13, "%31s %u", filename, &size) == 2) {
-                canUploadStart(filename, size);
+            int fields = sscanf(args + 13, "%31s %u %3s", filename, &size, mode);
+            if (fields >= 2) {
+                canUploadStart(filename, size, fields == 3 && strcasecmp(mode, "BIN") == 0);
             } else {
-                printError("Usage: CAN UPLOAD START <filename> <size>");
+                printError("Usage: CAN UPLOAD START <filename> <size> [BIN]");
             }
         }
         else if (strcmp(param1, "DATA") == 0) {
@@ -468,6 +552,8 @@ static void handleCanCommand(const char* args) {
     }
     else if (strcmp(subCmd, "RELOAD") == 0) {
         Serial.println("Reloading CAN configuration...");
+
+        // Built in the spare bank: the ingest task keeps decoding meanwhile
         if (canProcessor.begin()) {
             // Reset vehicle data to clear stale values
             resetVehicleData();
@@ -475,10 +561,11 @@ static void handleCanCommand(const char* args) {
             printOK();
             Serial.printf("Loaded: %s (%s mode)\n",
                           canProcessor.getProfileName(),
-                          canProcessor.isMockMode() ? "MOCK" : "REAL");
+                          canProcessor.getModeName());
         } else {
             Serial.println("No config found - MOCK mode active");
         }
+        syncCanController();
     }
     else {
         printError("Usage: CAN <STATUS|LIST|LOAD|GET|DELETE|UPLOAD|RELOAD>");
@@ -491,10 +578,73 @@ static void handleCanCommand(const char* args) {
 static void canStatus() {
     Serial.println("=== CAN Configuration Status ===");
     Serial.printf("Config: %s\n", configGetVehicleFile());
-    Serial.printf("Mode: %s\n", canProcessor.isMockMode() ? "MOCK (simulated data)" : "REAL (CAN bus)");
-    Serial.printf("Profile: %s\n", canProcessor.getProfileName());
+    Serial.printf("Mode: %s\n", canProcessor.isMockMode() ? "MOCK (simulated data)" :
+                  canProcessor.isReplayMode() ? "REPLAY (CAN log)" : "REAL CAN (CAN bus)");
+    Serial.printf("Profile: %s%s\n", canProcessor.getProfileName(),
+                  canProcessor.isBaked() ? " (baked)" : "");
     Serial.printf("Frames processed: %lu\n", canProcessor.getFramesProcessed());
     Serial.printf("Unknown frames: %lu\n", canProcessor.getUnknownFrames());
+    Serial.printf("Dispatch: %u IDs, %u bytes, built in %lu us\n",
+                  canProcessor.getDispatchIdCount(),
+                  (unsigned)canProcessor.getDispatchMemory(),
+                  canProcessor.getDispatchBuildTime());
+    Serial.printf("Profile arena: %u/%d frames, %u/%d fields, %u bytes used (%u reserved)\n",
+                  canProcessor.getProfileFrameCount(), PROFILE_MAX_FRAMES,
+                  canProcessor.getProfileFieldCount(), PROFILE_MAX_FIELDS,
+                  (unsigned)canProcessor.getProfileBytesUsed(),
+                  (unsigned)canProcessor.getProfileMemory());
+    const ProfileSwapStats& swap = canProcessor.getSwapStats();
+    Serial.printf("Last swap: built in %lu us, %lu frames decoded meanwhile, switched in %lu us (%lu swaps)\n",
+                  (unsigned long)swap.buildUs,
+                  (unsigned long)swap.framesDuringBuild,
+                  (unsigned long)swap.flipUs,
+                  (unsigned long)swap.swaps);
+    if (canProcessor.getFilteredFieldCount()) {
+        Serial.printf("Field filters: %u fields, %lu changes held\n",
+                      canProcessor.getFilteredFieldCount(),
+                      (unsigned long)canProcessor.getFilterHeldCount());
+    }
+    if (!canDriverIsRunning()) {
+        Serial.println("HW filter: (controller stopped)");
+    } else if (configGetCanPromisc()) {
+        Serial.println("HW filter: promiscuous (all IDs accepted)");
+    } else {
+        const CanAcceptanceFilter& filter = canDriverGetFilter();
+        Serial.printf("HW filter: %s code=0x%08lX mask=0x%08lX (%u IDs accepted)\n",
+                      filter.singleFilter ? "single" : "dual",
+                      (unsigned long)filter.code,
+                      (unsigned long)filter.mask,
+                      filter.acceptedIds);
+    }
+    const CanRxStats& rx = canDriverGetRxStats();
+    Serial.printf("RX drain: last %u, max %u/%u per batch, %lu batches\n",
+                  rx.lastBatch, rx.maxBatch, CAN_DRAIN_MAX_FRAMES, rx.batches);
+    Serial.printf("RX queue: high-water %u/%u, overruns %lu\n",
+                  rx.queueHighWater, CAN_RX_QUEUE_LEN, rx.overruns);
+    Serial.printf("RX stops: %lu frame limit, %lu time budget (%u us)\n",
+                  rx.limitStops, rx.budgetStops, CAN_DRAIN_BUDGET_US);
+    const CanRecoveryStats& rec = canDriverGetRecoveryStats();
+    Serial.printf("Bus faults: %lu bus-off, %lu error limit, %lu recovered, %lu failed attempts, %lu reboots%s\n",
+                  (unsigned long)rec.busOffs, (unsigned long)rec.errorLimits,
+                  (unsigned long)rec.recoveries, (unsigned long)rec.failedAttempts,
+                  (unsigned long)canDriverGetFaultReboots(),
+                  canDriverIsRecovering() ? " (recovering)" : "");
+    if (rec.recoveries) {
+        Serial.printf("Bus downtime: last %lu ms, max %lu ms, total %lu ms\n",
+                      (unsigned long)rec.lastDowntimeMs, (unsigned long)rec.maxDowntimeMs,
+                      (unsigned long)rec.totalDowntimeMs);
+    }
+    if (canProcessor.isReplayMode()) {
+        static const char* const formatNames[] = { "not open", "recorder", "candump" };
+        const CanReplayStats& rs = canReplay.getStats();
+        Serial.printf("Replay: %s (%s), %ux%s\n", canProcessor.getReplayFile(),
+                      formatNames[(uint8_t)canReplay.getFormat()],
+                      canProcessor.getReplaySpeed(), canProcessor.getReplayLoop() ? ", loop" : "");
+        Serial.printf("Replay: %lu frames, %lu skipped, %lu loops, at %.1f s of log, max late %lu us%s\n",
+                      (unsigned long)rs.frames, (unsigned long)rs.skipped,
+                      (unsigned long)rs.loops, rs.logTimeUs / 1e6,
+                      (unsigned long)rs.maxLateUs, canReplay.isFinished() ? ", finished" : "");
+    }
     if (uploadInProgress) {
         Serial.printf("Upload in progress: %s (%lu/%lu bytes)\n",
                       uploadFilename, uploadReceivedSize, uploadExpectedSize);
@@ -503,32 +653,29 @@ static void canStatus() {
 }
 
 /**
- * @brief List all JSON config files on LittleFS
+ * @brief List the installed profiles from the profile index (no parsing)
  */
 static void canList() {
     Serial.println("=== CAN Config Files ===");
 
-    File root = LittleFS.open("/");
-    if (!root || !root.isDirectory()) {
-        printError("Failed to open filesystem");
-        return;
-    }
-
-    int count = 0;
-    File file = root.openNextFile();
-    while (file) {
-        String name = file.name();
-        if (name.endsWith(".json")) {
-            Serial.printf("  %s (%d bytes)\n", file.name(), file.size());
-            count++;
-        }
-        file = root.openNextFile();
+    uint8_t count = profileIndexCount();
+    for (uint8_t i = 0; i < count; i++) {
+        const ProfileIndexEntry* entry = profileIndexGet(i);
+        const char* kind = (entry->flags & PROFILE_FLAG_INVALID) ? "invalid" :
+                           (entry->flags & PROFILE_FLAG_MOCK) ? "mock" :
+                           (entry->flags & PROFILE_FLAG_REPLAY) ? "replay" : "real";
+        Serial.printf("  %s (%lu bytes, crc %08lX) - %s, %s, %u IDs%s\n",
+                      entry->file + 1,
+                      (unsigned long)entry->jsonSize,
+                      (unsigned long)entry->jsonCrc,
+                      entry->name, kind, entry->idCount,
+                      strcmp(entry->file + 1, configGetVehicleFile()) == 0 ? " [active]" : "");
     }
 
     if (count == 0) {
         Serial.println("  (no config files found)");
     }
-    Serial.printf("Total: %d file(s)\n", count);
+    Serial.printf("Total: %u file(s)\n", count);
     Serial.println("========================");
 }
 
@@ -551,19 +698,56 @@ static void canLoad(const char* filename) {
         return;
     }
 
-    // Try to load the config
+    // Try to load the config (built in the spare bank: the ingest task keeps
+    // decoding with the current profile until the swap)
     if (canProcessor.loadFromJson(path)) {
         // Reset vehicle data to clear stale values from previous config
         resetVehicleData();
 
         printOK();
         Serial.printf("Loaded: %s\n", canProcessor.getProfileName());
-        Serial.printf("Mode: %s\n", canProcessor.isMockMode() ? "MOCK" : "REAL");
+        Serial.printf("Mode: %s\n", canProcessor.getModeName());
+        syncCanController();
     } else {
         printError("Failed to parse config file");
     }
 }
 
+/**
+ * @brief Start/stop/refilter the controller after a profile swap and report it
+ */
+static void syncCanController() {
+    // Bus frames and the synthetic load must not decode at the same time
+    if (canStress.isActive()) {
+        stressHalt();
+        Serial.println("Stress run stopped (profile changed)");
+    }
+
+    bool wasRunning = canDriverIsRunning();
+    CanAcceptanceFilter before = canDriverGetFilter();
+    uint32_t start = micros();
+
+    bool ok = canDriverSyncProfile();
+    uint32_t elapsed = micros() - start;
+
+    const ProfileSwapStats& swap = canProcessor.getSwapStats();
+    Serial.printf("Swap: built in %lu us with %lu frames decoded meanwhile, switched in %lu us\n",
+                  (unsigned long)swap.buildUs,
+                  (unsigned long)swap.framesDuringBuild,
+                  (unsigned long)swap.flipUs);
+
+    const CanAcceptanceFilter& after = canDriverGetFilter();
+    if (!ok) {
+        printError("CAN controller start failed");
+    } else if (wasRunning != canDriverIsRunning()) {
+        Serial.printf("CAN controller %s in %lu us\n",
+                      wasRunning ? "stopped" : "started", (unsigned long)elapsed);
+    } else if (wasRunning && (before.code != after.code || before.mask != after.mask ||
+                              before.singleFilter != after.singleFilter)) {
+        Serial.printf("CAN filter reprogrammed in %lu us (RX paused)\n", (unsigned long)elapsed);
+    }
+}
+
 /**
  * @brief Output current config file content
  */
@@ -617,6 +801,12 @@ static void canDelete(const char* filename) {
     }
 
     if (LittleFS.remove(path)) {
+        // Drop the compiled cache of that profile too
+        char cachePath[56];
+        CanConfigProcessor::cachePathFor(path, cachePath, sizeof(cachePath));
+        if (LittleFS.exists(cachePath)) LittleFS.remove(cachePath);
+        profileIndexRemove(path);
+
         printOK();
         Serial.printf("Deleted: %s\n", path);
     } else {
@@ -624,26 +814,40 @@ static void canDelete(const char* filename) {
     }
 }
 
+/**
+ * @brief Close and delete the temporary upload file
+ */
+static void uploadDiscard() {
+    if (uploadFile) uploadFile.close();
+    if (LittleFS.exists(CAN_UPLOAD_TEMP)) LittleFS.remove(CAN_UPLOAD_TEMP);
+}
+
 /**
  * @brief Start a new config file upload
+ *
+ * Data is streamed to CAN_UPLOAD_TEMP, so the file size is bounded by free
+ * filesystem space rather than free heap.
  */
-static void canUploadStart(const char* filename, uint32_t size) {
+static void canUploadStart(const char* filename, uint32_t size, bool binary) {
     // Cancel any previous upload
-    if (uploadBuffer) {
-        free(uploadBuffer);
-        uploadBuffer = nullptr;
-    }
+    uploadDiscard();
+    uploadInProgress = false;
 
     // Validate size
     if (size == 0 || size > CAN_UPLOAD_MAX_SIZE) {
-        printError("Invalid size (max 8KB)");
+        printError("Invalid size (max 64KB)");
+        return;
+    }
+    size_t fsFree = LittleFS.totalBytes() - LittleFS.usedBytes();
+    if (size > fsFree) {
+        Serial.printf("ERROR: Not enough filesystem space (%lu bytes, %u free)\n",
+                      size, (unsigned)fsFree);
         return;
     }
 
-    // Allocate buffer
-    uploadBuffer = (uint8_t*)malloc(size + 1);
-    if (!uploadBuffer) {
-        printError("Out of memory");
+    uploadFile = LittleFS.open(CAN_UPLOAD_TEMP, "w");
+    if (!uploadFile) {
+        printError("Failed to create file");
         return;
     }
 
@@ -659,32 +863,59 @@ static void canUploadStart(const char* filename, uint32_t size) {
     uploadReceivedSize = 0;
     uploadInProgress = true;
 
+    if (binary) {
+        Serial.printf("Awaiting %lu bytes for %s\n", size, uploadFilename);
+        binBegin(BIN_SESSION_UPLOAD);
+        return;
+    }
+
     Serial.println("OK READY");
     Serial.printf("Awaiting %lu bytes for %s\n", size, uploadFilename);
 }
 
+/**
+ * @brief Append decoded bytes to the temporary upload file
+ * @return false if they exceed the announced size or the write fails
+ *         (upload aborted)
+ */
+static bool uploadAppend(const uint8_t* data, size_t len) {
+    if (len > uploadExpectedSize - uploadReceivedSize) {
+        Serial.printf("ERROR: Data exceeds expected size (%lu + %u > %lu)\n",
+                      uploadReceivedSize, len, uploadExpectedSize);
+        canUploadAbort();
+        return false;
+    }
+
+    // Feed the watchdog during flash/filesystem operations
+    esp_task_wdt_reset();
+
+    if (uploadFile.write(data, len) != len) {
+        printError("File write failed");
+        canUploadAbort();
+        return false;
+    }
+    uploadReceivedSize += len;
+    return true;
+}
+
 /**
  * @brief Receive a chunk of base64-encoded data
  */
 static void canUploadData(const char* base64Data) {
-    if (!uploadInProgress || !uploadBuffer) {
+    if (!uploadInProgress) {
         printError("No upload in progress");
         return;
     }
 
-    // Decode base64 data directly into buffer
-    size_t remaining = uploadExpectedSize - uploadReceivedSize;
-    size_t decoded = base64Decode(base64Data, uploadBuffer + uploadReceivedSize, remaining);
+    static uint8_t decodeBuffer[256];
+    size_t decoded = base64Decode(base64Data, decodeBuffer, sizeof(decodeBuffer));
 
     if (decoded == 0) {
         printError("Base64 decode failed");
         return;
     }
 
-    uploadReceivedSize += decoded;
-
-    // Feed the watchdog during flash/filesystem operations
-    esp_task_wdt_reset();
+    if (!uploadAppend(decodeBuffer, decoded)) return;
 
     Serial.printf("OK %lu/%lu\n", uploadReceivedSize, uploadExpectedSize);
     Serial.flush();  // Ensure ACK is sent before processing next chunk
@@ -692,20 +923,42 @@ static void canUploadData(const char* base64Data) {
 }
 
 /**
- * @brief Finalize upload and validate JSON
+ * @brief Finalize upload: validate the temporary file, then rename it
+ *
+ * The target file is only replaced once the whole upload parsed, so a
+ * broken or interrupted upload never leaves a half-written profile.
  */
 static void canUploadEnd() {
-    if (!uploadInProgress || !uploadBuffer) {
+    if (!uploadInProgress) {
         printError("No upload in progress");
         return;
     }
 
-    // Null-terminate the buffer
-    uploadBuffer[uploadReceivedSize] = '\0';
+    uploadFile.close();
+
+    if (uploadReceivedSize != uploadExpectedSize) {
+        Serial.printf("ERROR: Incomplete data (%lu of %lu bytes)\n",
+                      uploadReceivedSize, uploadExpectedSize);
+        canUploadAbort();
+        return;
+    }
+
+    // Validate JSON, keeping only what the checks need
+    JsonDocument filter;
+    filter["name"] = true;
+    filter["frames"][0]["canId"] = true;
+
+    File file = LittleFS.open(CAN_UPLOAD_TEMP, "r");
+    if (!file) {
+        printError("Failed to reopen upload");
+        canUploadAbort();
+        return;
+    }
 
-    // Validate JSON
+    esp_task_wdt_reset();
     JsonDocument doc;
-    DeserializationError error = deserializeJson(doc, (char*)uploadBuffer);
+    DeserializationError error = deserializeJson(doc, file, DeserializationOption::Filter(filter));
+    file.close();
 
     if (error) {
         Serial.printf("ERROR: JSON parse failed: %s\n", error.c_str());
@@ -720,24 +973,19 @@ static void canUploadEnd() {
         return;
     }
 
-    // Write to file
-    File file = LittleFS.open(uploadFilename, "w");
-    if (!file) {
-        printError("Failed to create file");
+    // Move into place: LittleFS rename replaces an existing target
+    // atomically. On failure the previous file is left as it was
+    if (!LittleFS.rename(CAN_UPLOAD_TEMP, uploadFilename)) {
+        printError("Failed to save file");
         canUploadAbort();
         return;
     }
 
-    // Feed the watchdog before slow LittleFS write
-    esp_task_wdt_reset();
-
-    file.write(uploadBuffer, uploadReceivedSize);
-    file.close();
-
-    // Cleanup
-    free(uploadBuffer);
-    uploadBuffer = nullptr;
     uploadInProgress = false;
+    if (!profileIndexUpdate(uploadFilename)) {
+        Serial.printf("WARNING: %s not in the profile index (max %d profiles)\n",
+                      uploadFilename, PROFILE_INDEX_MAX);
+    }
 
     printOK();
     Serial.printf("Saved: %s (%lu bytes)\n", uploadFilename, uploadReceivedSize);
@@ -748,10 +996,8 @@ static void canUploadEnd() {
  * @brief Abort current upload
  */
 static void canUploadAbort() {
-    if (uploadBuffer) {
-        free(uploadBuffer);
-        uploadBuffer = nullptr;
-    }
+    if (binSession == BIN_SESSION_UPLOAD) binSession = BIN_SESSION_NONE;
+    uploadDiscard();
     uploadInProgress = false;
     uploadReceivedSize = 0;
     uploadExpectedSize = 0;
@@ -776,13 +1022,17 @@ static void canUploadAbort() {
  * 1. OTA START <size_bytes> [md5_hash]
  * 2. OTA DATA <base64_chunk> (repeat)
  * 3. OTA END (validates and reboots)
+ *
+ * With OTA START <size> [md5] BIN, steps 2-3 are binary frames instead
+ * (see BinaryFrame.h).
  */
 static void handleOtaCommand(const char* args) {
     char subCmd[16];
     char param1[40];
     char param2[40];
+    char param3[8];
 
-    int n = sscanf(args, "%15s %39s %39s", subCmd, param1, param2);
+    int n = sscanf(args, "%15s %39s %39s %7s", subCmd, param1, param2, param3);
 
     if (n < 1) {
         printError("Usage: OTA <START|DATA|END|ABORT|STATUS>");
@@ -794,8 +1044,11 @@ static void handleOtaCommand(const char* args) {
 
     if (strcmp(subCmd, "START") == 0 && n >= 2) {
         uint32_t size = strtoul(param1, nullptr, 10);
-        const char* md5 = (n >= 3) ? param2 : nullptr;
-        otaStart(size, md5);
+        // Optional trailing BIN, with or without an MD5 before it
+        bool binary = (n == 3 && strcasecmp(param2, "BIN") == 0) ||
+                      (n == 4 && strcasecmp(param3, "BIN") == 0);
+        const char* md5 = (n >= 3 && strcasecmp(param2, "BIN") != 0) ? param2 : nullptr;
+        otaStart(size, md5, binary);
     }
     else if (strcmp(subCmd, "DATA") == 0) {
         // Find the base64 data after "DATA "
@@ -840,13 +1093,22 @@ static void handleOtaCommand(const char* args) {
  * @brief Start OTA firmware update
  * @param size Expected firmware size in bytes
  * @param md5 Optional MD5 hash for verification (32 hex chars)
+ * @param binary Receive the image as binary frames (OK READY BIN)
  */
-static void otaStart(uint32_t size, const char* md5) {
+static void otaStart(uint32_t size, const char* md5, bool binary) {
     // Check if another update is in progress
     if (otaInProgress) {
         printError("OTA already in progress. Use OTA ABORT first.");
         return;
     }
+    if (canStress.isActive()) {
+        printError("Stress run active. Use STRESS STOP first.");
+        return;
+    }
+    if (otaWriterIsBusy()) {
+        printError("Aborted update still writing flash. Retry shortly.");
+        return;
+    }
 
     // Validate size
     if (size == 0) {
@@ -879,12 +1141,16 @@ static void otaStart(uint32_t size, const char* md5) {
         return;
     }
 
+    // Sector buffers, writer task and MD5
+    if (!otaWriterBegin()) {
+        Update.abort();
+        printError("Cannot start flash writer");
+        return;
+    }
+
     // Drain any stale bytes that arrived before the OTA session
     while (Serial.available()) Serial.read();
 
-    // Initialize MD5 calculation
-    otaMD5.begin();
-
     otaExpectedSize = size;
     otaReceivedSize = 0;
     otaInProgress = true;
@@ -897,6 +1163,11 @@ static void otaStart(uint32_t size, const char* md5) {
         Serial.printf("MD5: %s\n", otaExpectedMD5);
     }
     Serial.flush();
+
+    if (binary) {
+        binBegin(BIN_SESSION_OTA);
+        return;
+    }
     Serial.println("OK READY");
 }
 
@@ -932,36 +1203,37 @@ static void otaData(const char* base64Data, bool hasCrc, uint32_t expectedCrc) {
         }
     }
 
+    if (!otaWrite(decodeBuffer, decoded)) return;
+
+    uint8_t percent = (otaReceivedSize * 100) / otaExpectedSize;
+    Serial.printf("OK %lu/%lu (%d%%)\n", otaReceivedSize, otaExpectedSize, percent);
+}
+
+/**
+ * @brief Write verified firmware bytes to flash (text and binary paths)
+ * @return false on overflow or write failure (OTA aborted)
+ */
+static bool otaWrite(const uint8_t* data, size_t len) {
     // Check for overflow
-    if (otaReceivedSize + decoded > otaExpectedSize) {
+    if (otaReceivedSize + len > otaExpectedSize) {
         Serial.printf("ERROR: Data exceeds expected size (%lu + %u > %lu)\n",
-                      otaReceivedSize, decoded, otaExpectedSize);
+                      otaReceivedSize, len, otaExpectedSize);
         otaAbort();
-        return;
+        return false;
     }
 
-    // Feed the watchdog before the flash write — sector erase can take 20-100ms
-    esp_task_wdt_reset();
-
-    // Write to flash
-    size_t written = Update.write(decodeBuffer, decoded);
-    if (written != decoded) {
-        Serial.printf("ERROR: Write failed (wrote %u of %u): %s\n",
-                      written, decoded, Update.errorString());
+    // Buffered into 4 KB sectors; flash errors surface on a later chunk
+    if (!otaWriterWrite(data, len)) {
+        Serial.printf("ERROR: Write failed at %lu bytes: %s\n",
+                      otaReceivedSize, otaWriterError() ? otaWriterError() : "writer stopped");
         otaAbort();
-        return;
+        return false;
     }
 
-    // Update MD5 and counters
-    otaMD5.add(decodeBuffer, decoded);
-    otaReceivedSize += decoded;
+    otaReceivedSize += len;
     otaLastDataTime = millis();
-
-    // Feed the watchdog again after the write completes
     esp_task_wdt_reset();
-
-    uint8_t percent = (otaReceivedSize * 100) / otaExpectedSize;
-    Serial.printf("OK %lu/%lu (%d%%)\n", otaReceivedSize, otaExpectedSize, percent);
+    return true;
 }
 
 /**
@@ -981,10 +1253,17 @@ static void otaEnd() {
         return;
     }
 
+    // Write the last partial sector and wait for the writer
+    if (!otaWriterFinish()) {
+        Serial.printf("ERROR: Write failed: %s\n",
+                      otaWriterError() ? otaWriterError() : "writer stopped");
+        otaAbort();
+        return;
+    }
+
     // Verify MD5 if provided
     if (otaExpectedMD5[0]) {
-        otaMD5.calculate();
-        String calculatedMD5 = otaMD5.toString();
+        String calculatedMD5 = otaWriterMD5();
 
         if (calculatedMD5 != otaExpectedMD5) {
             Serial.printf("ERROR: MD5 mismatch!\n");
@@ -1014,6 +1293,7 @@ static void otaEnd() {
     printOK();
     Serial.println("Firmware updated successfully!");
     Serial.println("Rebooting in 2 seconds...");
+    configFlush();
     delay(2000);
     ESP.restart();
 }
@@ -1022,8 +1302,10 @@ static void otaEnd() {
  * @brief Abort OTA update
  */
 static void otaAbort() {
-    if (otaInProgress) {
-        Update.abort();
+    if (binSession == BIN_SESSION_OTA) binSession = BIN_SESSION_NONE;
+    if (otaInProgress && !otaWriterAbort()) {
+        // Writer stuck in a flash write: it resets Update once the write returns
+        Serial.println("WARNING: flash write pending, OTA START refused until it completes");
     }
 
     otaInProgress = false;
@@ -1048,12 +1330,152 @@ static void otaStatus() {
         if (otaExpectedMD5[0]) {
             Serial.printf("Expected MD5: %s\n", otaExpectedMD5);
         }
+        if (binSession == BIN_SESSION_OTA) {
+            Serial.printf("Transfer: binary, %lu frames, bad frames %lu, NAKs %lu\n",
+                          binFrames, binBadFrames, binNaks);
+        } else {
+            Serial.println("Transfer: text (base64)");
+        }
+    }
+
+    // Flash writer: current session, or the last one
+    const OtaWriterStats& ws = otaWriterGetStats();
+    if (ws.startMs) {
+        unsigned long end = ws.endMs ? ws.endMs : millis();
+        unsigned long elapsed = end - ws.startMs;
+        Serial.printf("Writer: %s, %lu B in %lu ms (%.1f KB/s)\n",
+                      OTA_PIPELINED ? "pipelined" : "synchronous", ws.bytes, elapsed,
+                      elapsed ? ws.bytes / 1.024 / elapsed : 0.0);
+        Serial.printf("Flash: %lu sectors, erase+write avg %.1f ms, max %.1f ms, total %lu ms\n",
+                      ws.sectors, ws.sectors ? ws.flashUs / 1000.0 / ws.sectors : 0.0,
+                      ws.flashMaxUs / 1000.0, ws.flashUs / 1000);
+        Serial.printf("Receiver waited: %lu ms\n", ws.waitUs / 1000);
     }
     Serial.printf("Free sketch space: %lu bytes\n", ESP.getFreeSketchSpace());
     Serial.printf("Current firmware size: %lu bytes\n", ESP.getSketchSize());
     Serial.println("==================");
 }
 
+// =============================================================================
+// BINARY TRANSFER (OTA / CAN UPLOAD with BIN)
+// =============================================================================
+
+/**
+ * @brief Switch serial input to binary frames for an OTA or upload session
+ *
+ * Replies "OK READY BIN <max_payload> <window>": the host may send up to
+ * <window> DATA frames ahead of the last ACK. Text commands are not parsed
+ * until END, ABORT or the idle timeout.
+ */
+static void binBegin(BinSession session) {
+    binDecoder.reset();
+    binSession = session;
+    binExpectedSeq = 0;
+    binNakSent = false;
+    binLastFrameTime = millis();
+    binFrames = 0;
+    binBadFrames = 0;
+    binNaks = 0;
+
+    Serial.printf("OK READY BIN %u %u\n", (unsigned)BIN_MAX_PAYLOAD, (unsigned)BIN_WINDOW);
+}
+
+/**
+ * @brief Feed everything USB CDC has received into the frame decoder
+ */
+static void binProcess() {
+    static uint8_t rxBuf[512];
+
+    while (binSession != BIN_SESSION_NONE) {
+        int avail = Serial.available();
+        if (avail <= 0) break;
+
+        size_t n = Serial.read(rxBuf, min((size_t)avail, sizeof(rxBuf)));
+        size_t offset = 0;
+
+        // A rejected frame's bytes are rescanned even when n is used up
+        while ((offset < n || binDecoder.hasPending()) && binSession != BIN_SESSION_NONE) {
+            size_t used = 0;
+            BinFrameResult result = binDecoder.feed(rxBuf + offset, n - offset, used);
+            offset += used;
+
+            if (result == BinFrameResult::FRAME) {
+                binHandleFrame(binDecoder.frame());
+            } else if (result != BinFrameResult::NONE) {
+                binBadFrames++;
+                binNak();
+            }
+        }
+    }
+
+    // The host gave up without ABORT: drop the session, back to text mode
+    if (binSession != BIN_SESSION_NONE && millis() - binLastFrameTime > OTA_DATA_TIMEOUT_MS) {
+        Serial.println("Binary transfer timeout: no frame for 60s, aborting");
+        if (binSession == BIN_SESSION_OTA) otaAbort();
+        else canUploadAbort();
+    }
+}
+
+/**
+ * @brief Ask the host to go back to the first frame not yet accepted
+ */
+static void binNak() {
+    if (binNakSent) return;  // Frames still in flight after the gap are dropped silently
+    binNakSent = true;
+    binNaks++;
+    Serial.printf("NAK %u\n", binExpectedSeq);
+}
+
+/**
+ * @brief Act on one valid frame (go-back-N receiver)
+ *
+ * In-order DATA is written and acknowledged with "ACK <seq> <received>/<total>"
+ * (cumulative: every frame up to <seq> is stored). A frame already stored
+ * is re-acknowledged; a frame after a gap triggers "NAK <expected>".
+ */
+static void binHandleFrame(const BinFrame& frame) {
+    binLastFrameTime = millis();
+    bool ota = binSession == BIN_SESSION_OTA;
+
+    if (frame.type == BIN_ABORT) {
+        if (ota) otaAbort();
+        else canUploadAbort();
+        return;
+    }
+
+    if (frame.seq != binExpectedSeq) {
+        uint16_t behind = binExpectedSeq - frame.seq;
+        if (behind <= BIN_WINDOW && behind <= binFrames) {
+            // Retransmission of a stored frame: repeat the cumulative ACK
+            Serial.printf("ACK %u %lu/%lu\n", (uint16_t)(binExpectedSeq - 1),
+                          ota ? otaReceivedSize : uploadReceivedSize,
+                          ota ? otaExpectedSize : uploadExpectedSize);
+        } else {
+            binNak();
+        }
+        return;
+    }
+
+    if (frame.type == BIN_END) {
+        binSession = BIN_SESSION_NONE;
+        if (ota) otaEnd();
+        else canUploadEnd();
+        return;
+    }
+
+    // BIN_DATA: a failed write aborts the session (and leaves binary mode)
+    if (ota ? !otaWrite(frame.payload, frame.len) : !uploadAppend(frame.payload, frame.len)) {
+        return;
+    }
+
+    binFrames++;
+    binExpectedSeq++;
+    binNakSent = false;
+    Serial.printf("ACK %u %lu/%lu\n", frame.seq,
+                  ota ? otaReceivedSize : uploadReceivedSize,
+                  ota ? otaExpectedSize : uploadExpectedSize);
+}
+
 // =============================================================================
 // LOG COMMAND HANDLER
 // =============================================================================
@@ -1062,27 +1484,88 @@ static void handleLogCommand(const char* args) {
     char subCmd[8];
 
     if (sscanf(args, "%7s", subCmd) != 1) {
-        printError("Usage: LOG <ON|OFF>");
+        printError("Usage: LOG <ON|OFF|BIN|STATUS>");
         return;
     }
 
     for (int i = 0; subCmd[i]; i++) subCmd[i] = toupper(subCmd[i]);
 
     if (strcmp(subCmd, "ON") == 0) {
+        canStreamStop();
         canLogEnabled = true;
         printOK();
         Serial.println("CAN logging enabled");
     }
+    else if (strcmp(subCmd, "BIN") == 0) {
+        // LOG BIN [ID <id> [mask]] [DEC <n>]
+        char words[6][8];
+        int count = sscanf(args, "%*s %7s %7s %7s %7s %7s %7s", words[0], words[1],
+                           words[2], words[3], words[4], words[5]);
+        if (count < 0) count = 0;
+        for (int w = 0; w < count; w++) {
+            for (int i = 0; words[w][i]; i++) words[w][i] = toupper(words[w][i]);
+        }
+
+        unsigned long id = 0, mask = 0, decim = 1;
+        bool ok = true;
+        char* end;
+        for (int w = 0; ok && w < count; w++) {
+            if (strcmp(words[w], "ID") == 0 && w + 1 < count) {
+                id = strtoul(words[++w], &end, 16);
+                ok = *end == '\0' && id <= 0x7FF;
+                mask = 0x7FF;
+                // Optional mask: any hex word that is not the next keyword
+                if (w + 1 < count && strcmp(words[w + 1], "DEC") != 0) {
+                    mask = strtoul(words[++w], &end, 16);
+                    ok = ok && *end == '\0' && mask <= 0x7FF;
+                }
+            } else if (strcmp(words[w], "DEC") == 0 && w + 1 < count) {
+                decim = strtoul(words[++w], &end, 10);
+                ok = *end == '\0' && decim >= 1 && decim <= 255;
+            } else {
+                ok = false;
+            }
+        }
+        if (!ok) {
+            printError("Usage: LOG BIN [ID <id hex> [mask hex]] [DEC <1-255>]");
+            return;
+        }
+        canLogEnabled = false;
+        radioSetLatencyTrace(false);    // Text lines would corrupt the packets
+        printOK();
+        Serial.printf("Binary stream: ID 0x%03lX/0x%03lX, 1 of %lu frames\n", id, mask, decim);
+        canStreamStart((uint16_t)id, (uint16_t)mask, (uint8_t)decim);
+    }
     else if (strcmp(subCmd, "OFF") == 0) {
+        bool wasStreaming = canStreamIsActive();
+        canStreamStop();
         canLogEnabled = false;
         printOK();
         Serial.println("CAN logging disabled");
+        if (wasStreaming) printStreamStats();
+    }
+    else if (strcmp(subCmd, "STATUS") == 0) {
+        Serial.printf("Mode: %s\n", canStreamIsActive() ? "BIN" : (canLogEnabled ? "ON" : "OFF"));
+        printStreamStats();
     }
     else {
-        printError("Usage: LOG <ON|OFF>");
+        printError("Usage: LOG <ON|OFF|BIN|STATUS>");
     }
 }
 
+/**
+ * @brief Counters of the current / last LOG BIN session
+ */
+static void printStreamStats() {
+    const CanStreamStats& st = canStreamGetStats();
+    Serial.printf("Stream: %lu frames sent in %lu packets (%lu B), %lu dropped\n",
+                  (unsigned long)st.sent, (unsigned long)st.packets,
+                  (unsigned long)st.bytes, (unsigned long)st.dropped);
+    Serial.printf("Skipped: %lu filtered, %lu decimated; ring %u/%d (peak %u)\n",
+                  (unsigned long)st.filtered, (unsigned long)st.decimated,
+                  canStreamGetBuffered(), CANSTREAM_RING_FRAMES, st.ringHighWater);
+}
+
 // =============================================================================
 // SYS COMMAND HANDLER
 // =============================================================================
@@ -1091,7 +1574,7 @@ static void handleSysCommand(const char* args) {
     char subCmd[8];
 
     if (sscanf(args, "%7s", subCmd) != 1) {
-        printError("Usage: SYS <INFO|REBOOT|DATA>");
+        printError("Usage: SYS <INFO|DATA|PERF|LAT|REBOOT|BOOTLOADER>");
         return;
     }
 
@@ -1105,28 +1588,116 @@ static void handleSysCommand(const char* args) {
         Serial.printf("Free heap: %d bytes\n", ESP.getFreeHeap());
         Serial.printf("CPU freq: %d MHz\n", ESP.getCpuFreqMHz());
         Serial.printf("Chip: %s rev%d\n", ESP.getChipModel(), ESP.getChipRevision());
+        printTaskStats();
+        Serial.printf("Profile load: %lu ms (%s), peak heap %lu bytes\n",
+                      (unsigned long)canProcessor.getLoadTime(),
+                      canProcessor.isBaked() ? "baked" :
+                      canProcessor.isLoadedFromCache() ? "cache" : "JSON",
+                      (unsigned long)canProcessor.getLoadPeakHeap());
+        const ProfileIndexStats& pi = profileIndexGetStats();
+        Serial.printf("Profile index: %u profiles, %s, %u parsed, synced in %lu us\n",
+                      pi.entries, pi.fromFile ? "from file" : "rebuilt", pi.parsed,
+                      (unsigned long)pi.syncUs);
+        const ProfileMatch& pm = profileIndexGetLastMatch();
+        if (pm.observedIds > 0) {
+            Serial.printf("Auto-detect: %u IDs on bus, best %s %u/1000 (%u IDs), next %u/1000, %s\n",
+                          pm.observedIds, pm.file[0] ? pm.file + 1 : "-", pm.score, pm.matches,
+                          pm.runnerUp, pm.accepted ? "accepted" : "rejected");
+        }
+        const ConfigStoreStats& cs = configGetStoreStats();
+        Serial.printf("Config NVS: %lu writes for %lu saves (%lu unchanged, %lu failed), flush last %lu us, max %lu us%s\n",
+                      (unsigned long)cs.writes, (unsigned long)cs.saves,
+                      (unsigned long)cs.unchanged, (unsigned long)cs.failures,
+                      (unsigned long)cs.lastFlushUs, (unsigned long)cs.maxFlushUs,
+                      configIsPending() ? ", write pending" : "");
+
+        const RadioTxStats& tx = radioTxGetStats();
+        Serial.printf("Radio TX: %lu B, link %u%% (peak %u%%), %u B queued, write time %lu ms\n",
+                      (unsigned long)tx.bytesWritten, tx.utilization, tx.peakUtilization,
+                      radioTxGetPending(), (unsigned long)(tx.blockedUs / 1000));
+        if (tx.firstFrameMs) {
+            Serial.printf("First radio frame: %lu ms after boot\n", (unsigned long)tx.firstFrameMs);
+        } else {
+            Serial.println("First radio frame: not sent yet");
+        }
+        const StandbyStats& sb = standbyGetStats();
+        Serial.printf("Standby: %lu sleeps (%lu s), %lu noise wakes, %lu skipped (USB open)\n",
+                      (unsigned long)sb.entries, (unsigned long)(sb.sleptMs / 1000),
+                      (unsigned long)sb.spuriousWakes, (unsigned long)sb.skippedUsb);
+        if (sb.bestWakeToSteerMs) {
+            Serial.printf("Key-on to steering: %lu ms (first frame %lu ms), best %lu, worst %lu\n",
+                          (unsigned long)sb.lastWakeToSteerMs, (unsigned long)sb.lastWakeToFrameMs,
+                          (unsigned long)sb.bestWakeToSteerMs, (unsigned long)sb.worstWakeToSteerMs);
+        }
         Serial.println("===================");
     }
     else if (strcmp(subCmd, "DATA") == 0) {
+        VehicleDataSnapshot data;
+        vehicleDataSnapshot(data);
+
         Serial.println("=== Live Vehicle Data ===");
         Serial.printf("Config:   %s\n", configGetVehicleFile());
         Serial.printf("Mode:     %s (%s)\n",
-            canProcessor.isMockMode() ? "MOCK" : "REAL",
+            canProcessor.getModeName(),
             canProcessor.getProfileName());
-        Serial.printf("RPM:      %d\n", engineRPM);
-        Serial.printf("Speed:    %d km/h\n", vehicleSpeed);
-        Serial.printf("Steering: %d\n", currentSteer);
-        Serial.printf("Fuel:     %d L\n", fuelLevel);
-        Serial.printf("Battery:  %.1f V\n", voltBat);
-        Serial.printf("DTE:      %d km\n", dteValue);
-        Serial.printf("Temp:     %d C\n", tempExt);
-        Serial.printf("Doors:    0x%02X\n", currentDoors);
+        Serial.printf("RPM:      %d\n", data.engineRPM);
+        Serial.printf("Speed:    %d km/h\n", data.vehicleSpeed);
+        Serial.printf("Steering: %d\n", data.currentSteer);
+        Serial.printf("Fuel:     %d L\n", data.fuelLevel);
+        Serial.printf("Battery:  %.1f V\n", data.voltBat);
+        Serial.printf("DTE:      %d km\n", data.dteValue);
+        Serial.printf("Temp:     %d C\n", data.tempExt);
+        Serial.printf("Doors:    0x%02X\n", data.currentDoors);
         Serial.printf("Lights:   H=%d P=%d HB=%d L=%d R=%d\n",
-            headlightsOn, parkingLightsOn, highBeamOn, indicatorLeft, indicatorRight);
+            data.headlightsOn, data.parkingLightsOn, data.highBeamOn,
+            data.indicatorLeft, data.indicatorRight);
         Serial.println("=========================");
     }
+    else if (strcmp(subCmd, "PERF") == 0) {
+        char option[8] = "";
+        sscanf(args, "%*s %7s", option);
+        for (int i = 0; option[i]; i++) option[i] = toupper(option[i]);
+#if PERF_STATS_ENABLED
+        if (strcmp(option, "RESET") == 0) {
+            perfReset();
+            printOK();
+        } else {
+            printPerfStats();
+        }
+#else
+        (void)option;
+        printError("Performance counters not built in (use env esp32-c3-perf)");
+#endif
+    }
+    else if (strcmp(subCmd, "LAT") == 0) {
+        char option[8] = "";
+        char state[4] = "";
+        sscanf(args, "%*s %7s %3s", option, state);
+        for (int i = 0; option[i]; i++) option[i] = toupper(option[i]);
+        for (int i = 0; state[i]; i++) state[i] = toupper(state[i]);
+
+        if (option[0] == '\0') {
+            printLatencyStats();
+        } else if (strcmp(option, "RESET") == 0) {
+            radioLatencyReset();
+            printOK();
+        } else if (strcmp(option, "TRACE") == 0 && strcmp(state, "ON") == 0) {
+            if (canStreamIsActive()) {
+                printError("Binary stream active (LOG OFF first)");
+                return;
+            }
+            radioSetLatencyTrace(true);
+            printOK();
+        } else if (strcmp(option, "TRACE") == 0 && strcmp(state, "OFF") == 0) {
+            radioSetLatencyTrace(false);
+            printOK();
+        } else {
+            printError("Usage: SYS LAT [RESET|TRACE ON|TRACE OFF]");
+        }
+    }
     else if (strcmp(subCmd, "REBOOT") == 0) {
         Serial.println("Rebooting...");
+        configFlush();
         delay(100);
         ESP.restart();
     }
@@ -1134,6 +1705,7 @@ static void handleSysCommand(const char* args) {
         Serial.println("Entering bootloader mode for esptool...");
         Serial.println("Use esptool.py to flash firmware.");
         Serial.flush();
+        configFlush();
         delay(100);
 
         // Force download boot mode on next restart
@@ -1141,10 +1713,518 @@ static void handleSysCommand(const char* args) {
         esp_restart();
     }
     else {
-        printError("Usage: SYS <INFO|DATA|REBOOT|BOOTLOADER>");
+        printError("Usage: SYS <INFO|DATA|PERF|LAT|REBOOT|BOOTLOADER>");
+    }
+}
+
+/**
+ * @brief Print the SYS LAT table: CAN-to-UART age per radio command
+ */
+static void printLatencyStats() {
+    Serial.println("=== CAN -> head unit latency (us) ===");
+    Serial.println("Command        count      p50      p99      max");
+    for (uint8_t s = 0; s < radioLatencySlotCount(); s++) {
+        const LatencyHistogram& h = radioGetLatency(s);
+        if (h.getCount() == 0) {
+            Serial.printf("%-10s %9s\n", radioLatencySlotName(s), "-");
+            continue;
+        }
+        Serial.printf("%-10s %9lu %8lu %8lu %8lu\n", radioLatencySlotName(s),
+                      (unsigned long)h.getCount(), (unsigned long)h.percentile(50),
+                      (unsigned long)h.percentile(99), (unsigned long)h.getMax());
+    }
+    Serial.printf("Trace: %s\n", radioIsLatencyTracing() ? "ON" : "OFF");
+    Serial.println("=====================================");
+}
+
+#if PERF_STATS_ENABLED
+/**
+ * @brief Print the SYS PERF counters: count, average, max and non-empty
+ *        histogram buckets of every stage that ran
+ */
+static void printPerfStats() {
+    Serial.println("=== Performance (us) ===");
+    for (uint8_t s = 0; s < (uint8_t)PerfStage::COUNT; s++) {
+        PerfCounter c = perfGet((PerfStage)s);  // Copy: the ingest task may update it
+        if (c.count == 0) continue;
+        Serial.printf("%-12s n=%-8lu avg %8.1f  max %8.1f |",
+                      perfStageName((PerfStage)s), (unsigned long)c.count,
+                      perfCyclesToUs(c.sumCycles) / c.count, perfCyclesToUs(c.maxCycles));
+        for (uint8_t i = 0; i < PERF_HIST_BUCKETS; i++) {
+            if (c.hist[i] == 0) continue;
+            uint32_t limit = perfBucketLimitUs(i);
+            if (limit) {
+                Serial.printf(" <%lu:%lu", (unsigned long)limit, (unsigned long)c.hist[i]);
+            } else {
+                Serial.printf(" >=%lu:%lu", (unsigned long)perfBucketLimitUs(i - 1),
+                              (unsigned long)c.hist[i]);
+            }
+        }
+        Serial.println();
+    }
+    Serial.println("========================");
+}
+#endif
+
+/**
+ * @brief Print stack high-water and CPU load of the firmware tasks
+ *
+ * CPU load is measured over the interval since the previous SYS INFO.
+ */
+static void printTaskStats() {
+    static uint64_t lastSampleUs = 0;
+    static uint64_t lastIngestBusyUs = 0;
+    static uint64_t lastLoopBusyUs = 0;
+
+    uint64_t nowUs = esp_timer_get_time();
+    uint64_t windowUs = nowUs - lastSampleUs;
+    if (windowUs == 0) windowUs = 1;
+
+    uint64_t ingestBusy = canDriverGetTaskBusyUs();
+    uint64_t loopBusy = loopBusyUs;
+
+    TaskHandle_t ingest = canDriverGetTaskHandle();
+    if (ingest) {
+        Serial.printf("Task canIngest: prio %u, stack free %u/%u B, CPU %.1f%%\n",
+                      (unsigned)uxTaskPriorityGet(ingest),
+                      (unsigned)uxTaskGetStackHighWaterMark(ingest), CAN_TASK_STACK,
+                      (ingestBusy - lastIngestBusyUs) * 100.0 / windowUs);
+    } else {
+        Serial.println("Task canIngest: not running");
+    }
+    TaskHandle_t writer = otaWriterGetTaskHandle();
+    if (writer) {
+        Serial.printf("Task otaWriter: prio %u, stack free %u/%u B\n",
+                      (unsigned)uxTaskPriorityGet(writer),
+                      (unsigned)uxTaskGetStackHighWaterMark(writer), OTA_WRITER_STACK);
+    }
+    TaskHandle_t recorder = canRecorderGetTaskHandle();
+    if (recorder) {
+        Serial.printf("Task canRecorder: prio %u, stack free %u/%u B\n",
+                      (unsigned)uxTaskPriorityGet(recorder),
+                      (unsigned)uxTaskGetStackHighWaterMark(recorder), REC_TASK_STACK);
+    }
+    Serial.printf("Task loop: prio %u, stack free %u B, CPU %.1f%%\n",
+                  (unsigned)uxTaskPriorityGet(NULL),
+                  (unsigned)uxTaskGetStackHighWaterMark(NULL),
+                  (loopBusy - lastLoopBusyUs) * 100.0 / windowUs);
+    const LoopWakeStats& wake = loopWakeGetStats();
+    Serial.printf("Loop wakes: %lu by event, %lu by deadline, asleep %.1f%% since boot\n",
+                  (unsigned long)wake.eventWakes, (unsigned long)wake.timeouts,
+                  wake.sleptUs * 100.0 / (nowUs ? nowUs : 1));
+
+    lastSampleUs = nowUs;
+    lastIngestBusyUs = ingestBusy;
+    lastLoopBusyUs = loopBusy;
+}
+
+// =============================================================================
+// PT COMMAND HANDLER
+// =============================================================================
+
+/**
+ * @brief Passthrough commands (v1.9)
+ *
+ * Only PT STATUS exists for now: it reports the head-unit TX scheduler that
+ * external frames will share with ours.
+ */
+static void handlePtCommand(const char* args) {
+    char subCmd[8];
+
+    if (sscanf(args, "%7s", subCmd) != 1) {
+        printError("Usage: PT <STATUS>");
+        return;
+    }
+
+    for (int i = 0; subCmd[i]; i++) subCmd[i] = toupper(subCmd[i]);
+
+    if (strcmp(subCmd, "STATUS") == 0) {
+        const RadioTxStats& tx = radioTxGetStats();
+
+        Serial.println("=== Passthrough Status ===");
+        Serial.println("External: not available");
+        Serial.printf("Link: %u baud, %u%% used (peak %u%%), %s\n",
+                      RADIO_LINK_BAUD, tx.utilization, tx.peakUtilization,
+                      radioTxIsSaturated() ? "SATURATED (slow signals stretched)" : "ok");
+        Serial.printf("Saturated windows: %lu, bursts: %lu (max %u B)\n",
+                      (unsigned long)tx.saturatedWindows, (unsigned long)tx.bursts, tx.maxBurst);
+        const RadioParserStats& rx = radioGetRxStats();
+        unsigned long lastAck = radioGetLastAckTime();
+        Serial.printf("Head unit RX: %lu frames, ACK %lu, NACK %lu, bad checksum %lu, junk %lu B\n",
+                      (unsigned long)rx.frames, (unsigned long)rx.acks, (unsigned long)rx.nacks,
+                      (unsigned long)rx.badChecksums, (unsigned long)rx.junkBytes);
+        if (lastAck) {
+            Serial.printf("Last ACK: %lu ms ago, replies sent: %lu\n",
+                          millis() - lastAck, (unsigned long)tx.acksSent);
+        } else {
+            Serial.printf("Last ACK: never, replies sent: %lu\n", (unsigned long)tx.acksSent);
+        }
+        Serial.println("Class   sent     drop   queued  lat avg/max ms  promoted");
+
+        for (uint8_t c = 0; c < (uint8_t)RadioClass::COUNT; c++) {
+            RadioClass cls = (RadioClass)c;
+            const RadioClassStats& st = radioTxGetClassStats(cls);
+            unsigned long avg = st.framesSent ? st.latencySumMs / st.framesSent : 0;
+            Serial.printf("%-7s %-8lu %-6lu %3u/%-4u %4lu/%-9u %lu\n",
+                          radioTxClassName(cls),
+                          (unsigned long)st.framesSent, (unsigned long)st.framesDropped,
+                          radioTxGetPending(cls), (unsigned)RADIO_TX_QUEUE_BYTES,
+                          avg, st.latencyMaxMs, (unsigned long)st.promotions);
+        }
+        Serial.println("==========================");
+    }
+    else {
+        printError("Usage: PT <STATUS>");
+    }
+}
+
+// =============================================================================
+// REC COMMAND HANDLER
+// =============================================================================
+
+/**
+ * @brief CAN frame recorder (see CanRecorder.h)
+ */
+static void handleRecCommand(const char* args) {
+    char subCmd[8];
+    char arg1[12] = "";
+    char arg2[12] = "";
+    int n = sscanf(args, "%7s %11s %11s", subCmd, arg1, arg2);
+
+    if (n < 1) {
+        printError("Usage: REC <START|TRIGGER|STOP|STATUS|FILTER|GET>");
+        return;
+    }
+
+    for (int i = 0; subCmd[i]; i++) subCmd[i] = toupper(subCmd[i]);
+    for (int i = 0; arg1[i]; i++) arg1[i] = toupper(arg1[i]);
+
+    if (strcmp(subCmd, "START") == 0 || strcmp(subCmd, "TRIGGER") == 0) {
+        int16_t trigger = -1;
+        if (subCmd[0] == 'T') {
+            char* end;
+            unsigned long id = n >= 2 ? strtoul(arg1, &end, 16) : 0x800;
+            if (n < 2 || *end != '\0' || id > 0x7FF) {
+                printError("Usage: REC TRIGGER <id hex>");
+                return;
+            }
+            trigger = (int16_t)id;
+        }
+        if (!canRecorderStart(trigger)) {
+            char msg[64];
+            snprintf(msg, sizeof(msg), "Cannot start recording: %s", canRecorderError());
+            printError(msg);
+            return;
+        }
+        printOK();
+        if (trigger >= 0) {
+            Serial.printf("Recorder armed, starts on 0x%03X\n", trigger);
+        } else {
+            Serial.println("Recording");
+        }
+    }
+    else if (strcmp(subCmd, "STOP") == 0) {
+        canRecorderStop();
+        printOK();
+        recStatus();
+    }
+    else if (strcmp(subCmd, "STATUS") == 0) {
+        recStatus();
+    }
+    else if (strcmp(subCmd, "FILTER") == 0) {
+        if (strcmp(arg1, "CLEAR") == 0) {
+            canRecorderClearFilters();
+            printOK();
+            return;
+        }
+        char* end;
+        unsigned long id = n >= 2 ? strtoul(arg1, &end, 16) : 0x800;
+        bool ok = n >= 2 && *end == '\0' && id <= 0x7FF;
+        unsigned long mask = 0x7FF;
+        if (ok && n >= 3) {
+            mask = strtoul(arg2, &end, 16);
+            ok = *end == '\0' && mask <= 0x7FF;
+        }
+        if (!ok) {
+            printError("Usage: REC FILTER <id hex> [mask hex] | REC FILTER CLEAR");
+            return;
+        }
+        if (!canRecorderAddFilter((uint16_t)id, (uint16_t)mask)) {
+            printError("Filter table full (REC FILTER CLEAR)");
+            return;
+        }
+        printOK();
+    }
+    else if (strcmp(subCmd, "GET") == 0) {
+        uint8_t index = (n >= 2 && strcmp(arg1, "1") == 0) ? 1 : 0;
+        recGet(index);
+    }
+    else {
+        printError("Usage: REC <START|TRIGGER|STOP|STATUS|FILTER|GET>");
+    }
+}
+
+static void recStatus() {
+    static const char* const stateNames[] = {"IDLE", "ARMED", "RECORDING"};
+    const CanRecorderStats& st = canRecorderGetStats();
+    CanRecorderState state = canRecorderGetState();
+
+    Serial.println("=== Recorder Status ===");
+    Serial.printf("State: %s\n", stateNames[(uint8_t)state]);
+    if (st.startMs) {
+        unsigned long end = state == CanRecorderState::IDLE ? st.stopMs : millis();
+        Serial.printf("Duration: %lu ms", end - st.startMs);
+        if (st.triggerMs) Serial.printf(" (triggered after %lu ms)", st.triggerMs - st.startMs);
+        Serial.println();
+    }
+    Serial.printf("Frames: %lu recorded, %lu written, %lu dropped, %lu filtered, %lu extended\n",
+                  (unsigned long)st.recorded, (unsigned long)st.written,
+                  (unsigned long)st.dropped, (unsigned long)st.filtered,
+                  (unsigned long)st.extended);
+    Serial.printf("Ring: %u/%d buffered (peak %u)\n",
+                  canRecorderGetBuffered(), REC_RING_FRAMES, st.ringHighWater);
+    Serial.printf("File: %s, %lu/%d bytes, %lu rotations\n",
+                  canRecorderFilePath(st.fileIndex), (unsigned long)st.fileBytes,
+                  REC_FILE_MAX_BYTES, (unsigned long)st.rotations);
+    Serial.printf("Writes: %lu (max %lu us), %lu records lost to write errors\n",
+                  (unsigned long)st.writes, (unsigned long)st.writeMaxUs,
+                  (unsigned long)st.writeErrors);
+
+    uint8_t count = canRecorderGetFilterCount();
+    if (count == 0) {
+        Serial.println("Filters: none (all standard IDs)");
+    } else {
+        Serial.print("Filters:");
+        for (uint8_t i = 0; i < count; i++) {
+            uint16_t id, mask;
+            canRecorderGetFilter(i, id, mask);
+            Serial.printf(" 0x%03X/0x%03X", id, mask);
+        }
+        Serial.println();
+    }
+    Serial.println("=======================");
+}
+
+/**
+ * @brief Stream a recording file as raw bytes
+ *
+ * "REC DATA <file> <size> <crc32>" line, exactly <size> binary bytes, then
+ * "REC END". The CRC is computed in a first pass so the host can check the
+ * transfer without framing.
+ */
+static void recGet(uint8_t index) {
+    if (canRecorderGetState() != CanRecorderState::IDLE) {
+        printError("Recording in progress (REC STOP first)");
+        return;
+    }
+
+    const char* path = canRecorderFilePath(index);
+    File file = LittleFS.open(path, "r");
+    if (!file) {
+        printError("No recording file");
+        return;
+    }
+
+    uint8_t buf[512];
+    uint32_t crc = 0;
+    size_t size = 0;
+    size_t got;
+    while ((got = file.read(buf, sizeof(buf))) > 0) {
+        crc = crc32_le(crc, buf, got);
+        size += got;
+        esp_task_wdt_reset();
+    }
+
+    file.seek(0);
+    Serial.printf("REC DATA %s %u %08lX\n", path, (unsigned)size, (unsigned long)crc);
+    size_t sent = 0;
+    while (sent < size && (got = file.read(buf, sizeof(buf))) > 0) {
+        Serial.write(buf, got);
+        sent += got;
+        esp_task_wdt_reset();
+    }
+    file.close();
+    Serial.println();
+    Serial.println("REC END");
+}
+
+// =============================================================================
+// STRESS COMMAND HANDLER
+// =============================================================================
+
+/**
+ * @brief Synthetic bus load through the decoder (see CanStress.h)
+ *
+ * The CAN controller is stopped for the run and restarted by loop() when
+ * it ends, so only the synthetic frames are decoded.
+ */
+static void handleStressCommand(const char* args) {
+    static const char* const usage =
+        "Usage: STRESS <START <fps|n%|MAX>|SWEEP> [NOISE <%>] [BURST <n> <ms>] [TIME <s>] | STOP | STATUS";
+    char buf[96];
+    strncpy(buf, args, sizeof(buf) - 1);
+    buf[sizeof(buf) - 1] = '\0';
+    for (int i = 0; buf[i]; i++) buf[i] = toupper(buf[i]);
+
+    char* subCmd = strtok(buf, " ");
+    if (!subCmd) {
+        printError(usage);
+        return;
+    }
+
+    if (strcmp(subCmd, "STOP") == 0) {
+        stressHalt();
+        printOK();
+        stressStatus();
+        return;
+    }
+    if (strcmp(subCmd, "STATUS") == 0) {
+        stressStatus();
+        return;
+    }
+
+    bool sweep = strcmp(subCmd, "SWEEP") == 0;
+    if (!sweep && strcmp(subCmd, "START") != 0) {
+        printError(usage);
+        return;
+    }
+
+    CanStressConfig cfg = {};
+    char* tok = strtok(nullptr, " ");
+    if (!sweep) {
+        char* end = nullptr;
+        unsigned long value = tok ? strtoul(tok, &end, 10) : 0;
+        if (tok && strcmp(tok, "MAX") == 0) {
+            cfg.rate = STRESS_LINE_RATE;
+        } else if (tok && *end == '%' && end[1] == '\0' && value >= 1 && value <= 100) {
+            cfg.rate = (uint32_t)((uint64_t)STRESS_LINE_RATE * value / 100);
+        } else if (tok && *end == '\0' && value >= 1) {
+            cfg.rate = value;
+        } else {
+            printError(usage);
+            return;
+        }
+        tok = strtok(nullptr, " ");
+    }
+    for (; tok; tok = strtok(nullptr, " ")) {
+        char* a = strtok(nullptr, " ");
+        if (strcmp(tok, "NOISE") == 0 && a && atoi(a) >= 0 && atoi(a) <= 100) {
+            cfg.noisePct = (uint8_t)atoi(a);
+        } else if (strcmp(tok, "BURST") == 0 && a) {
+            char* b = strtok(nullptr, " ");
+            if (!b || atoi(a) <= 0 || atoi(a) > 0xFFFF || atoi(b) <= 0 || atoi(b) > 0xFFFF) {
+                printError(usage);
+                return;
+            }
+            cfg.burstFrames = (uint16_t)atoi(a);
+            cfg.burstPeriodMs = (uint16_t)atoi(b);
+        } else if (strcmp(tok, "TIME") == 0 && a && !sweep && atoi(a) > 0) {
+            cfg.durationMs = (uint32_t)atoi(a) * 1000;
+        } else {
+            printError(usage);
+            return;
+        }
+    }
+
+    if (canStress.isActive()) {
+        printError("Stress run active (STRESS STOP first)");
+        return;
+    }
+    if (!canProcessor.usesCanBus()) {
+        printError("Needs a real CAN profile (not mock or replay)");
+        return;
+    }
+    if (canDriverIsRecovering()) {
+        printError("CAN recovery in progress");
+        return;
+    }
+
+    // Only the synthetic frames reach the decoder during the run
+    canDriverEnd();
+    if (!canStress.start(canProcessor.getProfile(), cfg)) {
+        canDriverSyncProfile();
+        printError("Cannot start the stress task");
+        return;
+    }
+    printOK();
+    if (sweep) {
+        Serial.printf("Sweep: %d steps of %d%% (%d frames/s), %d ms each, CAN controller stopped\n",
+                      STRESS_SWEEP_STEPS, STRESS_SWEEP_STEP_PCT,
+                      STRESS_LINE_RATE * STRESS_SWEEP_STEP_PCT / 100, STRESS_SWEEP_STEP_MS);
+    } else {
+        Serial.printf("Stress: %lu frames/s (%u%% bus load), CAN controller stopped\n",
+                      (unsigned long)canStress.getConfig().rate,
+                      CanStress::busLoadPct(canStress.getConfig().rate));
+    }
+}
+
+/**
+ * @brief Stop the stress run and wait for the task to let go of the decoder
+ */
+static void stressHalt() {
+    canStress.stop();
+    unsigned long start = millis();
+    while (canStress.isActive() && millis() - start < 100) {
+        delay(1);
     }
 }
 
+static void stressStatus() {
+    const CanStressStats& st = canStress.getStats();
+    const CanStressConfig& cfg = canStress.getConfig();
+
+    Serial.println("=== Stress Status ===");
+    if (!canStress.isActive() && st.offered == 0) {
+        Serial.println("State: IDLE");
+        Serial.println("=====================");
+        return;
+    }
+    Serial.printf("State: %s\n", canStress.isActive() ? "RUNNING"
+                                 : canStress.isFinished() ? "DONE" : "STOPPED");
+    if (canStress.isSweep()) {
+        Serial.printf("Load: sweep step %u/%d, %lu frames/s (%u%%)",
+                      canStress.getStepCount(), STRESS_SWEEP_STEPS,
+                      (unsigned long)canStress.getRate(), CanStress::busLoadPct(canStress.getRate()));
+    } else {
+        Serial.printf("Load: %lu frames/s (%u%% of %d kbps)",
+                      (unsigned long)cfg.rate, CanStress::busLoadPct(cfg.rate), STRESS_BUS_BITRATE / 1000);
+    }
+    Serial.printf(", noise %u%%", cfg.noisePct);
+    if (cfg.burstFrames) Serial.printf(", bursts of %u every %u ms", cfg.burstFrames, cfg.burstPeriodMs);
+    Serial.println();
+
+    Serial.printf("Frames: %lu offered, %lu handled, %lu lost (%.2f%%), %lu noise, %lu bursts\n",
+                  (unsigned long)st.offered, (unsigned long)st.handled, (unsigned long)st.lost,
+                  st.offered ? st.lost * 100.0f / st.offered : 0.0f,
+                  (unsigned long)st.noise, (unsigned long)st.bursts);
+    Serial.printf("Achieved: %lu frames/s over %lu ms, queue peak %u/%u\n",
+                  st.elapsedMs ? (unsigned long)((uint64_t)st.handled * 1000 / st.elapsedMs) : 0UL,
+                  (unsigned long)st.elapsedMs, st.queueHighWater, cfg.queueLen);
+    if (st.handled) {
+        Serial.printf("Handler: %.1f%% CPU, %.1f us/frame (~%lu frames/s capacity)\n",
+                      st.elapsedMs ? st.busyUs / (st.elapsedMs * 10.0f) : 0.0f,
+                      (float)st.busyUs / st.handled,
+                      st.busyUs ? (unsigned long)((uint64_t)st.handled * 1000000 / st.busyUs) : 0UL);
+    }
+
+    if (canStress.isSweep()) {
+        Serial.print("Sweep:");
+        for (uint8_t i = 0; i < canStress.getStepCount(); i++) {
+            const CanStressStep& step = canStress.getStep(i);
+            Serial.printf(" %lu", (unsigned long)step.rate);
+            if (step.lost) Serial.printf(" (lost %lu)", (unsigned long)step.lost);
+        }
+        Serial.println();
+        if (canStress.isFinished()) {
+            uint32_t best = canStress.getMaxSustainedRate();
+            Serial.printf("Max sustained: %lu frames/s (%u%% bus load)%s\n",
+                          (unsigned long)best, CanStress::busLoadPct(best),
+                          best == STRESS_LINE_RATE ? ", full bus" : "");
+        }
+    }
+    Serial.println("=====================");
+}
+
 // =============================================================================
 // HELP COMMAND
 // =============================================================================
@@ -1166,19 +2246,40 @@ static void handleHelpCommand() {
     Serial.println("CAN UPLOAD START/DATA/END  Upload config");
     Serial.println("CAN RELOAD            Reload configuration");
     Serial.println();
-    Serial.println("OTA START <size> [md5]       Start firmware update");
+    Serial.println("OTA START <size> [md5] [BIN] Start firmware update");
     Serial.println("OTA DATA <base64> [crc32]    Send firmware chunk");
     Serial.println("OTA END                      Finalize and reboot");
     Serial.println("OTA ABORT               Cancel update");
     Serial.println("OTA STATUS              Update status");
+    Serial.println("  (BIN: binary frames, see OTA_PROTOCOL.md; also CAN UPLOAD START ... BIN)");
     Serial.println();
-    Serial.println("LOG ON|OFF            CAN frame logging");
+    Serial.println("LOG ON|OFF            CAN frame logging (text)");
+    Serial.println("LOG BIN [ID <id> [mask]] [DEC <n>]  Binary frame stream");
+    Serial.println("LOG STATUS            Stream counters");
     Serial.println();
     Serial.println("SYS INFO              System information");
     Serial.println("SYS DATA              Live vehicle data");
+    Serial.println("SYS PERF [RESET]      Hot-path timing (perf build)");
+    Serial.println("SYS LAT [RESET]       CAN-to-head-unit latency per command");
+    Serial.println("SYS LAT TRACE ON|OFF  Stream one LAT line per sample");
     Serial.println("SYS REBOOT            Restart device");
     Serial.println("SYS BOOTLOADER        Enter esptool flash mode");
     Serial.println();
+    Serial.println("PT STATUS             Radio TX scheduler stats");
+    Serial.println();
+    Serial.println("REC START             Record CAN frames to flash");
+    Serial.println("REC TRIGGER <id>      Record from the first <id> frame");
+    Serial.println("REC STOP              Stop and write remaining frames");
+    Serial.println("REC STATUS            Recorder counters");
+    Serial.println("REC FILTER <id> [mask] | CLEAR  Record only matching IDs");
+    Serial.println("REC GET [0|1]         Download a recording file (binary)");
+    Serial.println();
+    Serial.println("STRESS START <fps|n%|MAX> [NOISE <%>] [BURST <n> <ms>] [TIME <s>]");
+    Serial.println("                      Synthetic profile frames through the decoder");
+    Serial.println("STRESS SWEEP [NOISE <%>] [BURST <n> <ms>]  Find the max loss-free rate");
+    Serial.println("STRESS STOP           End the run");
+    Serial.println("STRESS STATUS         Offered/handled/lost frames, CPU, sweep");
+    Serial.println();
     Serial.println("HELP                  This message");
     Serial.println("======================================");
 }
@@ -0,0 +1,99 @@
+/**
+ * @file SignalFilter.cpp
+ * @brief Per-field median / average / deadband / rate limit (see SignalFilter.h)
+ */
+
+#include "SignalFilter.h"
+
+// =============================================================================
+// PUBLIC API
+// =============================================================================
+
+void SignalFilter::begin(const FieldFilterConfig& config) {
+    _config = config;
+    sanitize(_config);
+    _windowFull = false;
+    _windowHead = 0;
+    _averaging = false;
+    _published = false;
+    _average = 0;
+    _last = 0;
+    _lastMs = 0;
+    _held = 0;
+}
+
+bool SignalFilter::apply(int32_t value, uint32_t nowMs, int32_t& out) {
+    if (_config.median > 1) {
+        value = median(value);
+    }
+
+    if (_config.emaShift) {
+        int64_t scaled = (int64_t)value << FILTER_EMA_FRAC_BITS;
+        if (_averaging) {
+            _average += (scaled - _average) >> _config.emaShift;
+        } else {
+            _average = scaled;
+            _averaging = true;
+        }
+        // Round to nearest (arithmetic shift floors negative values too)
+        value = (int32_t)((_average + (1 << (FILTER_EMA_FRAC_BITS - 1))) >> FILTER_EMA_FRAC_BITS);
+    }
+
+    if (_published) {
+        if (value == _last) {
+            return false;
+        }
+        int64_t delta = (int64_t)value - _last;
+        if (delta < 0) delta = -delta;
+        if (delta < _config.deadband ||
+            (uint32_t)(nowMs - _lastMs) < _config.minIntervalMs) {
+            _held++;
+            return false;
+        }
+    }
+
+    _published = true;
+    _last = value;
+    _lastMs = nowMs;
+    out = value;
+    return true;
+}
+
+bool SignalFilter::sanitize(FieldFilterConfig& config) {
+    if (config.median > FILTER_MEDIAN_MAX) config.median = FILTER_MEDIAN_MAX;
+    if (config.median == 1) config.median = 0;
+    if (config.emaShift > FILTER_EMA_MAX_SHIFT) config.emaShift = FILTER_EMA_MAX_SHIFT;
+    if (config.deadband < 0) config.deadband = 0;
+    return config.median || config.emaShift || config.deadband > 1 || config.minIntervalMs;
+}
+
+// =============================================================================
+// PRIVATE FUNCTIONS
+// =============================================================================
+
+/**
+ * @brief Add a value to the window and return the window median
+ *
+ * The first value fills the whole window, so a spike right after a
+ * profile load is filtered too. Insertion sort of at most
+ * FILTER_MEDIAN_MAX values.
+ */
+int32_t SignalFilter::median(int32_t value) {
+    if (!_windowFull) {
+        for (uint8_t i = 0; i < _config.median; i++) _window[i] = value;
+        _windowFull = true;
+    }
+    _window[_windowHead] = value;
+    _windowHead = (uint8_t)((_windowHead + 1) % _config.median);
+
+    int32_t sorted[FILTER_MEDIAN_MAX];
+    for (uint8_t i = 0; i < _config.median; i++) {
+        int32_t v = _window[i];
+        uint8_t j = i;
+        for (; j > 0 && sorted[j - 1] > v; j--) {
+            sorted[j] = sorted[j - 1];
+        }
+        sorted[j] = v;
+    }
+    return sorted[_config.median / 2];
+}
@@ -0,0 +1,104 @@
+/**
+ * @file Standby.cpp
+ * @brief Ignition-off standby: TWAI parked, light-sleep, wake on CAN activity
+ */
+
+#include "Standby.h"
+#include "CanDriver.h"
+#include "ConfigManager.h"
+#include <esp_sleep.h>
+#include <esp_task_wdt.h>
+#include <driver/gpio.h>
+
+extern HardwareSerial RadioSerial;
+
+static StandbyStats stats = {};
+static unsigned long wakeMs = 0;
+static unsigned long silenceFromMs = 0; // Wake or skipped standby: silence counts from here
+static volatile bool awaitingFrame = false; // Between a wake and its first frame
+static bool resumePending = false;      // First frame seen, radio pass not done yet
+
+// =============================================================================
+// PUBLIC API
+// =============================================================================
+
+bool standbyDue(uint32_t lastFrameMs) {
+    unsigned long now = millis();
+    if (awaitingFrame) return now - wakeMs >= STANDBY_WAKE_GRACE_MS;
+
+    unsigned long from = (long)(lastFrameMs - silenceFromMs) > 0 ? lastFrameMs : silenceFromMs;
+    return now - from >= CAN_STANDBY_TIMEOUT_MS;
+}
+
+void standbyEnter() {
+    // Ignition off: the supply may go away while asleep
+    configFlush();
+
+    if (Serial) {
+        // Host reading the port: light-sleep would drop the USB link
+        stats.skippedUsb++;
+        silenceFromMs = millis();
+        return;
+    }
+    if (awaitingFrame) stats.spuriousWakes++;
+
+    Serial.println("[Standby] CAN silent: controller parked, sleeping until bus activity");
+    Serial.flush();
+    RadioSerial.flush();
+
+    canDriverEnd();
+
+    // Dominant bits pull the transceiver RX low
+    gpio_set_direction((gpio_num_t)CAN_RX, GPIO_MODE_INPUT);
+    gpio_wakeup_enable((gpio_num_t)CAN_RX, GPIO_INTR_LOW_LEVEL);
+    esp_sleep_enable_gpio_wakeup();
+
+    stats.entries++;
+    unsigned long sleepStart = millis();
+    esp_light_sleep_start();
+    wakeMs = millis();
+    silenceFromMs = wakeMs;
+    stats.sleptMs += wakeMs - sleepStart;
+
+    gpio_wakeup_disable((gpio_num_t)CAN_RX);
+    esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_GPIO);
+    esp_task_wdt_reset();
+
+    if (!canDriverBegin()) {
+        Serial.println("CRITICAL ERROR: CAN RESTART AFTER STANDBY FAILED -> Reboot");
+        configFlush();
+        delay(100);
+        ESP.restart();
+    }
+    awaitingFrame = true;
+    resumePending = false;
+    Serial.printf("[Standby] Woken after %lu s\n", (unsigned long)((wakeMs - sleepStart) / 1000));
+}
+
+bool standbyAwaitingFrame() {
+    return awaitingFrame;
+}
+
+bool standbyCheckResume(uint32_t lastFrameMs) {
+    // Frame timestamps before the wake are from the previous drive
+    if (!awaitingFrame || (long)(lastFrameMs - wakeMs) < 0) return false;
+
+    awaitingFrame = false;
+    resumePending = true;
+    stats.lastWakeToFrameMs = lastFrameMs - wakeMs;
+    return true;
+}
+
+void standbyResumeSent() {
+    if (!resumePending) return;
+    resumePending = false;
+
+    uint32_t ms = millis() - wakeMs;
+    stats.lastWakeToSteerMs = ms;
+    if (stats.bestWakeToSteerMs == 0 || ms < stats.bestWakeToSteerMs) stats.bestWakeToSteerMs = ms;
+    if (ms > stats.worstWakeToSteerMs) stats.worstWakeToSteerMs = ms;
+}
+
+const StandbyStats& standbyGetStats() {
+    return stats;
+}
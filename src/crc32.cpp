@@ -0,0 +1,25 @@
+#include "crc32.h"
+
+// Byte-wise table, built at compile time (1 KB in flash). Same result as the
+// bit-by-bit loop, about 8x fewer operations for multi-KB binary frames.
+struct Crc32Table {
+    uint32_t v[256];
+    constexpr Crc32Table() : v() {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t crc = i;
+            for (int j = 0; j < 8; j++) {
+                crc = (crc >> 1) ^ (0xEDB88320U & -(crc & 1U));
+            }
+            v[i] = crc;
+        }
+    }
+};
+
+static constexpr Crc32Table table;
+
+uint32_t crc32_le(uint32_t crc, const uint8_t* buf, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        crc = (crc >> 8) ^ table.v[(crc ^ buf[i]) & 0xFF];
+    }
+    return crc;
+}
@@ -21,30 +21,178 @@
 #include "CanCapture.h"
 #include "RadioSend.h"
 #include "CanConfigProcessor.h"
+#include "CanDriver.h"
 #include "MockDataGenerator.h"
+#include "CanRecorder.h"
+#include "CanStream.h"
+#include "CanReplay.h"
+#include "CanStress.h"
+#include "PerfStats.h"
+#include "LoopWake.h"
+#include "Standby.h"
+#include "ProfileIndex.h"
 
 // ==============================================================================
 // SAFETY CONFIGURATION
 // ==============================================================================
 #define WDT_TIMEOUT 5       // Hardware watchdog timeout in seconds (triggers panic on CPU hang)
-#define CAN_TIMEOUT 30000   // 30s without CAN messages triggers reboot (if ignition is on)
-#define MAX_CAN_ERRORS 100  // Max error count before emergency reset (CAN passive threshold ~127)
-
-// ==============================================================================
-// HARDWARE PIN CONFIGURATION
-// ==============================================================================
-#define CAN_TX 21
-#define CAN_RX 20
+#define CAN_HEALTH_INTERVAL_MS 100  // Error counter / silence checks (not every loop pass)
 
 // ==============================================================================
 // GLOBAL VARIABLES
 // ==============================================================================
-uint32_t lastCanMessageTime = 0;
+volatile uint32_t lastCanMessageTime = 0;  // Written by the CAN ingest task
 HardwareSerial RadioSerial(1);
+uint64_t loopBusyUs = 0;                     // Cumulative loop() time (SYS INFO CPU load)
 
-// Configurable CAN processor and mock data generator
+// Configurable CAN processor and the non-bus data sources
 CanConfigProcessor canProcessor;
 MockDataGenerator mockGenerator;
+CanReplay canReplay;
+CanStress canStress;          // STRESS START / SWEEP (controller stopped meanwhile)
+
+/**
+ * @brief CAN ingest task frame handler
+ *
+ * Runs in the ingest task context (see CanDriver.h). Wakes loop() when the
+ * frame changed a signal while nothing was dirty: one wake per radio pass
+ * at most, however busy the bus. The first frame after a standby wake
+ * always wakes it (full head-unit refresh).
+ */
+static void ingestFrame(CanFrame& frame) {
+    uint16_t dirtyBefore = vehicleDirty;
+    handleCanCapture(frame);
+    lastCanMessageTime = millis();
+    if ((!dirtyBefore && vehicleDirty) || standbyAwaitingFrame()) loopWake();
+}
+
+/**
+ * @brief Wrap up a stress run that ended (time, sweep done, STRESS STOP)
+ *
+ * Synthetic values are cleared and the controller comes back for the
+ * active profile.
+ */
+static void finishStressRun() {
+    const CanStressStats& st = canStress.getStats();
+    if (canStress.isSweep() && canStress.isFinished()) {
+        Serial.printf("[Stress] Sweep done: max sustained %lu frames/s (%u%% bus load)\n",
+                      (unsigned long)canStress.getMaxSustainedRate(),
+                      CanStress::busLoadPct(canStress.getMaxSustainedRate()));
+    } else {
+        Serial.printf("[Stress] Run ended: %lu of %lu frames handled, %lu lost\n",
+                      (unsigned long)st.handled, (unsigned long)st.offered, (unsigned long)st.lost);
+    }
+    resetVehicleData();
+    canDriverSyncProfile();
+    lastCanMessageTime = millis();
+}
+
+/**
+ * @brief Start the data source of the active profile (mock or replay)
+ *
+ * Called at boot and after each profile swap; the CAN controller itself
+ * follows the profile in canDriverSyncProfile().
+ */
+static void startDataSource() {
+    if (canProcessor.isMockMode()) {
+        mockGenerator.begin();
+    }
+    if (canProcessor.isReplayMode()) {
+        if (canReplay.begin(canProcessor.getReplayFile(), canProcessor.getReplaySpeed(),
+                            canProcessor.getReplayLoop())) {
+            Serial.printf("[Replay] %s at %ux%s\n", canProcessor.getReplayFile(),
+                          canProcessor.getReplaySpeed(), canProcessor.getReplayLoop() ? ", looping" : "");
+        } else {
+            Serial.printf("[Replay] Cannot open %s (missing or not a CAN log)\n",
+                          canProcessor.getReplayFile());
+        }
+    } else {
+        canReplay.end();
+    }
+    lastCanMessageTime = millis();  // Silence timeout restarts from the switch
+}
+
+#if PROFILE_AUTODETECT
+/**
+ * @brief Switch to the installed profile whose fingerprint matches the bus
+ *
+ * Listens passively before the controller is started for the profile
+ * begin() restored. A silent bus (ignition off, bench), an unknown vehicle
+ * or a low score keeps that profile. Skipped for a replay profile: its
+ * frames come from the log.
+ */
+static void autoDetectProfile() {
+    if (canProcessor.isReplayMode() || profileIndexCount() == 0) {
+        return;
+    }
+
+    static uint8_t observed[PROFILE_ID_BITMAP_SIZE];
+    uint32_t start = millis();
+    uint32_t frames = canDriverListen(AUTODETECT_WINDOW_MS, AUTODETECT_SILENCE_MS, observed);
+    if (frames == 0) {
+        Serial.println("[Detect] Bus silent - keeping saved profile");
+        return;
+    }
+
+    const ProfileMatch& match = profileIndexMatch(observed);
+    Serial.printf("[Detect] %lu frames, %u IDs in %lu ms: best %s %u/1000 (%u IDs), next %u/1000\n",
+                  (unsigned long)frames, match.observedIds, (unsigned long)(millis() - start),
+                  match.file[0] ? match.file : "-", match.score, match.matches, match.runnerUp);
+    if (!match.accepted) {
+        Serial.println("[Detect] No confident match - keeping saved profile");
+        return;
+    }
+    if (strcmp(match.file + 1, configGetVehicleFile()) == 0) {
+        return;  // Already active
+    }
+
+    if (canProcessor.loadProfile(match.file)) {
+        Serial.printf("[Detect] Switched to %s (%s)\n", canProcessor.getProfileName(),
+                      canProcessor.isBaked() ? "baked" :
+                      canProcessor.isLoadedFromCache() ? "cache" : "JSON");
+    } else {
+        Serial.printf("[Detect] Failed to load %s - keeping saved profile\n", match.file);
+    }
+}
+#endif
+
+/**
+ * @brief Real-mode bus health: error counters, silent-bus LED, standby
+ *
+ * Runs every CAN_HEALTH_INTERVAL_MS from loop().
+ */
+static void checkCanHealth() {
+    // CAN BUS ERROR MONITORING
+    uint32_t rxErr = ESP32Can.rxErrorCounter();
+    uint32_t busErr = ESP32Can.busErrCounter();
+
+    if (isCanLogEnabled() && (rxErr > 0 || busErr > 0)) {
+        Serial.printf("Errors RX: %d | Bus: %d | State: %d\n",
+                      rxErr, busErr, ESP32Can.canState());
+    }
+
+    // Bus-off / too many errors: controller restarted in place, vehicle
+    // data and the head-unit stream are kept (reboot only as a last resort)
+    canDriverCheckHealth();
+
+    // Read the task's timestamp before millis() so it is never ahead of 'now'
+    uint32_t lastRx = lastCanMessageTime;
+    unsigned long now = millis();
+
+    // Slow heartbeat when no messages (indicates silent bus)
+    static unsigned long lastHeartbeat = 0;
+    if (now - lastRx > 200 && now - lastHeartbeat > 1000) {
+        digitalWrite(8, !digitalRead(8));
+        lastHeartbeat = now;
+    }
+
+    // IGNITION OFF (or wire disconnected): sleep until the bus wakes up.
+    // Profile and vehicle data stay in RAM, no reboot on the next key-on.
+    if (!canDriverIsRecovering() && standbyDue(lastRx)) {
+        digitalWrite(8, LOW);
+        standbyEnter();
+    }
+}
 
 /**
  * @brief System initialization
@@ -55,9 +203,9 @@ MockDataGenerator mockGenerator;
  * C. Configuration (NVS)
  * D. Serial Command Interface
  * E. Hardware Watchdog
- * F. Radio UART
- * G. CAN Configuration (JSON or Mock)
- * H. CAN Controller (if real mode)
+ * F. Radio UART, loop() wake events
+ * G. CAN Configuration (JSON or Mock), profile index, auto-detection
+ * H. CAN Controller (if real mode) + ingest task
  */
 void setup() {
     // A. Status LED - Used for boot indication and heartbeat
@@ -88,26 +236,31 @@ void setup() {
 
     // F. Radio UART - Communication with Android head unit
     // TX=GPIO5, RX=GPIO6, 38400 baud, 8N1 (Toyota RAV4 protocol)
-    RadioSerial.begin(38400, SERIAL_8N1, 6, 5);
+    radioBegin();
+    loopWakeBegin();
 
     // G. CAN Configuration - Load from JSON or use mock mode
     canProcessor.begin();  // Attempts to load /vehicle.json or /NissanJukeF15.json
+    profileIndexBegin();   // Installed profiles and their CAN ID fingerprints
+#if PROFILE_AUTODETECT
+    autoDetectProfile();   // Bus fingerprint may select another installed profile
+#endif
 
     if (canProcessor.isMockMode()) {
         Serial.println("=== MOCK MODE ACTIVE ===");
         Serial.println("No vehicle config found - using simulated data");
-        mockGenerator.begin();
         // Skip CAN hardware initialization in mock mode
+    } else if (canProcessor.isReplayMode()) {
+        Serial.printf("=== REPLAY MODE: %s ===\n", canProcessor.getProfileName());
+        // Frames come from a log file: no CAN hardware
     } else {
         Serial.printf("Vehicle config loaded: %s\n", canProcessor.getProfileName());
 
         // H. CAN Bus Initialization - TWAI controller setup (only in real mode)
-        ESP32Can.setPins(CAN_TX, CAN_RX);
-        ESP32Can.setSpeed(ESP32Can.convertSpeed(500000)); // 500kbps (Nissan Juke standard)
-
-        // Attempt CAN startup with immediate error handling
-        if (!ESP32Can.begin()) {
+        // Acceptance filter is derived from the profile's CAN IDs
+        if (!canDriverBegin()) {
             Serial.println("CRITICAL ERROR: CAN INIT FAILED -> Reboot in 3s");
+            configFlush();
             delay(3000);
             ESP.restart();
         } else {
@@ -115,7 +268,25 @@ void setup() {
         }
     }
 
-    lastCanMessageTime = millis();
+    // Frames are read and decoded by a dedicated task from here on. Started
+    // in mock mode too (it parks while the controller is stopped), so
+    // CAN LOAD of a real profile brings the bus up without a reboot.
+    if (!canDriverStartTask(ingestFrame)) {
+        Serial.println("CRITICAL ERROR: CAN TASK FAILED -> Reboot in 3s");
+        configFlush();
+        delay(3000);
+        ESP.restart();
+    }
+
+    // Synthetic load decodes like bus frames (task created by STRESS START)
+    canStress.setHandler(ingestFrame);
+
+    // Recorder writer task (idle until REC START)
+    if (!canRecorderBegin()) {
+        Serial.println("WARNING: CAN recorder task not started");
+    }
+
+    startDataSource();
     digitalWrite(8, LOW); // LED OFF = Boot complete
 }
 
@@ -125,10 +296,16 @@ void setup() {
  * Execution flow:
  * 1. Feed the watchdog
  * 2. Process serial commands
- * 3. Mode-dependent data acquisition (mock or real CAN)
+ * 3. Mode-dependent data acquisition (mock data, log replay, or CAN health
+ *    checks - bus frames themselves are ingested by the CAN task)
  * 4. Send updates to the radio
+ * 5. Write saved settings to NVS when due (see ConfigManager.h)
+ * 6. Sleep until the next deadline or a wake event (see LoopWake.h)
  */
 void loop() {
+    PERF_LOOP_START();
+    PERF_SCOPE(LOOP_BUSY);
+    uint32_t loopStart = micros();
     unsigned long now = millis();
     esp_task_wdt_reset(); // Feed the watchdog to prevent system reset
 
@@ -141,13 +318,34 @@ void loop() {
     // ==========================================================================
     if (isOtaInProgress()) {
         serialCommandCheckOtaTimeout();
-        vTaskDelay(pdMS_TO_TICKS(1));  // yield to USB CDC FreeRTOS tasks
+        loopBusyUs += micros() - loopStart;
+        loopWait(0);  // yield to USB CDC FreeRTOS tasks, back on the next chunk
         return;
     }
 
+    // A profile swap may have changed the mode (controller: canDriverSyncProfile())
+    static uint32_t seenSwaps = canProcessor.getSwapStats().swaps;
+    if (canProcessor.getSwapStats().swaps != seenSwaps) {
+        seenSwaps = canProcessor.getSwapStats().swaps;
+        startDataSource();
+    }
+
+    // Stress task ended a run: real frames again
+    static bool stressRunning = false;
+    if (canStress.isActive()) {
+        stressRunning = true;
+    } else if (stressRunning) {
+        stressRunning = false;
+        finishStressRun();
+    }
+
+    // Longest this pass may sleep (shortened below by each source's deadline)
+    unsigned long waitMs = LOOP_MAX_WAIT_MS;
+
     if (canProcessor.isMockMode()) {
         // MOCK MODE: Generate simulated data
         mockGenerator.update();
+        waitMs = min(waitMs, mockGenerator.msUntilUpdate());
         lastCanMessageTime = now;  // Prevent timeout in mock mode
 
         // Slow LED blink to indicate mock mode
@@ -156,50 +354,52 @@ void loop() {
             digitalWrite(8, !digitalRead(8));
             lastMockBlink = now;
         }
-    } else {
-        // REAL MODE: Read from CAN bus
-        CanFrame rxFrame;
-
-        // CAN BUS ERROR MONITORING
-        uint32_t rxErr = ESP32Can.rxErrorCounter();
-        uint32_t busErr = ESP32Can.busErrCounter();
-
-        if (isCanLogEnabled() && (rxErr > 0 || busErr > 0)) {
-            Serial.printf("Errors RX: %d | Bus: %d | State: %d\n",
-                          rxErr, busErr, ESP32Can.canState());
-        }
-
-        if (rxErr > MAX_CAN_ERRORS || busErr > MAX_CAN_ERRORS || ESP32Can.canState() == TWAI_STATE_BUS_OFF) {
-            Serial.printf("\n!!! CAN BUS CRASH DETECTED !!!\n");
-            Serial.printf("RX Err: %d | Bus Err: %d | State: %d\n", rxErr, busErr, ESP32Can.canState());
-            Serial.println("-> EMERGENCY CONTROLLER RESET...");
-            delay(100);
-            ESP.restart();
-        }
-
-        // CAN BUS READING
-        if (ESP32Can.readFrame(rxFrame)) {
-            handleCanCapture(rxFrame);
-            lastCanMessageTime = now;
-        } else {
-            // Slow heartbeat when no messages (indicates silent bus)
-            static unsigned long lastHeartbeat = 0;
-            if (now - lastCanMessageTime > 200 && now - lastHeartbeat > 1000) {
+    } else if (canProcessor.isReplayMode()) {
+        // REPLAY MODE: Frames from the log, through the bus frame handler
+        if (canReplay.update(handleCanCapture) > 0) {
+            static unsigned long lastReplayBlink = 0;
+            if (now - lastReplayBlink > 100) {
                 digitalWrite(8, !digitalRead(8));
-                lastHeartbeat = now;
+                lastReplayBlink = now;
             }
         }
-
-        // SAFETY: GLOBAL TIMEOUT (Engine off or wire disconnected)
-        if (now - lastCanMessageTime > CAN_TIMEOUT && voltBat > 11.0) {
-            Serial.println("CAN SILENCE TIMEOUT -> SAFETY REBOOT");
-            delay(100);
-            ESP.restart();
+        waitMs = min(waitMs, (unsigned long)canReplay.msUntilNext());
+        lastCanMessageTime = now;  // No bus: no silence timeout
+    } else {
+        // REAL MODE: Frames are decoded by the CAN ingest task
+        static unsigned long lastHealthCheck = 0;
+        if (now - lastHealthCheck >= CAN_HEALTH_INTERVAL_MS) {
+            lastHealthCheck = now;
+            checkCanHealth();
         }
     }
 
     // ==========================================================================
     // RADIO TRANSMISSION (both modes)
     // ==========================================================================
+    // First frame after a standby wake: the head unit gets a full set at once
+    bool resumed = standbyCheckResume(lastCanMessageTime);
+    if (resumed) radioResync();
+
     processRadioUpdates();
+    if (resumed) standbyResumeSent();
+
+    // LOG BIN: one packet per pass, when the USB TX buffer has room
+    canStreamPoll();
+
+    // Saved settings: one NVS write once saves settle, at once if the
+    // supply drops (ignition off, engine crank) while a write is pending
+    if (configIsPending() && voltBat > 1.0f && voltBat < CONFIG_FLUSH_LOW_VOLTAGE) {
+        configFlush();
+    }
+    configPoll();
+
+    loopBusyUs += micros() - loopStart;
+
+    // Sleep until the next deadline; CAN changes, head-unit and USB bytes
+    // end the wait early
+    waitMs = min(waitMs, radioNextDueMs());
+    waitMs = min(waitMs, (unsigned long)configMsUntilFlush());
+    if (canStreamIsActive() || Serial.available()) waitMs = 0;
+    loopWait(waitMs);
 }
@@ -19,9 +19,18 @@ private:
     std::string _s;
 };
 
-// Serial stub — printf to stdout
+// Serial stub — printf to stdout; binary writes are kept in txData, limited
+// by the free TX space a test sets (availableForWrite)
 struct SerialClass {
+    std::string txData;
+    int txRoom = 256;
+
     void begin(int) {}
+    int availableForWrite() { return txRoom; }
+    size_t write(const uint8_t* data, size_t len) {
+        txData.append((const char*)data, len);
+        return len;
+    }
     template<typename... Args>
     void printf(const char* fmt, Args... args) { ::printf(fmt, args...); }  // NOLINT
     void println(const char* s) { ::puts(s); }
@@ -51,8 +60,54 @@ using std::max;
 #endif
 #endif
 
-// millis() stub
-inline unsigned long millis() { return 0; }
+// millis() / micros() stubs — time only moves when a test sets mockMillis
+inline unsigned long mockMillis = 0;
+inline unsigned long millis() { return mockMillis; }
+inline unsigned long micros() { return mockMillis * 1000UL; }
+
+// ESP stub — free heap a test can set (sampled by CanConfigProcessor loads),
+// cycle counter a test can move (PerfStats)
+struct EspClass {
+    uint32_t freeHeap = 200000;
+    uint32_t cycleCount = 0;
+    uint32_t getFreeHeap() { return freeHeap; }
+    uint32_t getCycleCount() { return cycleCount; }
+    uint32_t getCpuFreqMHz() { return 160; }
+};
+inline EspClass ESP;
+
+// HardwareSerial stub — records written bytes, reports a configurable
+// amount of free TX space (availableForWrite), and serves bytes a test puts
+// in rx[] through available() / read()
+#define SERIAL_8N1 0x800001c
+struct HardwareSerial {
+    uint8_t  written[1024];
+    size_t   writtenLen = 0;
+    int      txRoom = 128;
+    int      writeCalls = 0;
+    uint8_t  rx[1024];
+    size_t   rxLen = 0;
+    size_t   rxPos = 0;
+
+    void setTxBufferSize(size_t) {}
+    void begin(unsigned long, uint32_t = SERIAL_8N1, int8_t = -1, int8_t = -1) {}
+    int availableForWrite() { return txRoom; }
+    size_t write(const uint8_t* data, size_t len) {
+        writeCalls++;
+        if ((int)len > txRoom) len = txRoom;
+        for (size_t i = 0; i < len && writtenLen < sizeof(written); i++) written[writtenLen++] = data[i];
+        txRoom -= (int)len;
+        return len;
+    }
+    size_t write(uint8_t b) { return write(&b, 1); }
+    int available() { return (int)(rxLen - rxPos); }
+    int read() { return rxPos < rxLen ? rx[rxPos++] : -1; }
+    size_t read(uint8_t* buf, size_t len) {
+        size_t n = 0;
+        while (n < len && rxPos < rxLen) buf[n++] = rx[rxPos++];
+        return n;
+    }
+};
 
 // Arduino map() — linear range mapping
 inline long map(long x, long in_min, long in_max, long out_min, long out_max) {
@@ -0,0 +1,113 @@
+#pragma once
+// Measurement helpers for the native_bench suites: wall time and cycles per
+// call, heap allocations (operator new) and stack depth of a hot path.
+// Include from exactly one file per suite: it replaces operator new/delete.
+
+#include <chrono>
+#include <new>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+static inline uint64_t readCycles() { return __rdtsc(); }
+#else
+static inline uint64_t readCycles() { return 0; }
+#endif
+
+// Regression thresholds are host numbers: loose enough for a slow CI runner,
+// tight enough to catch an accidental O(n) or allocation in a hot path.
+// Override with -D flags to tighten them on a known machine.
+#ifndef BENCH_STACK_PROBE
+#define BENCH_STACK_PROBE 16384   // Bytes painted below the caller for stackUsed()
+#endif
+
+// =============================================================================
+// ALLOCATION COUNTER
+// =============================================================================
+
+static uint32_t benchAllocCount = 0;
+
+void* operator new(size_t size) {
+    benchAllocCount++;
+    void* p = malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+void* operator new[](size_t size) { return operator new(size); }
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+
+// =============================================================================
+// STACK DEPTH
+// =============================================================================
+
+// Fill the stack area the measured call will use with a pattern, then see how
+// much of it was overwritten. Approximate (a few words of frame overhead) and
+// only meaningful without sanitizers.
+__attribute__((noinline)) static void paintStack() {
+    volatile uint8_t area[BENCH_STACK_PROBE];
+    for (size_t i = 0; i < sizeof(area); i++) area[i] = 0xA5;
+}
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"    // Reading what the call left is the point
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+__attribute__((noinline)) static size_t paintedDepth() {
+    volatile uint8_t area[BENCH_STACK_PROBE];
+    size_t untouched = 0;
+    while (untouched < sizeof(area) && area[untouched] == 0xA5) untouched++;
+    return sizeof(area) - untouched;
+}
+#pragma GCC diagnostic pop
+
+template <typename Fn>
+__attribute__((noinline)) static size_t stackUsed(Fn fn) {
+    paintStack();
+    fn();
+    return paintedDepth();
+}
+
+// =============================================================================
+// TIMING
+// =============================================================================
+
+struct BenchResult {
+    double nsPerCall;
+    double cyclesPerCall;
+    uint32_t allocs;          // operator new calls during the timed loop
+    size_t stackBytes;        // Deepest single call
+};
+
+/**
+ * @brief Run fn(i) `calls` times after a warm-up and measure it
+ */
+template <typename Fn>
+static BenchResult runBench(uint32_t calls, Fn fn) {
+    for (uint32_t i = 0; i < calls / 10 + 1; i++) fn(i);
+
+    BenchResult r;
+    r.stackBytes = stackUsed([&]() { fn(0); });
+
+    uint32_t allocs0 = benchAllocCount;
+    auto start = std::chrono::steady_clock::now();
+    uint64_t c0 = readCycles();
+    for (uint32_t i = 0; i < calls; i++) fn(i);
+    uint64_t c1 = readCycles();
+    auto end = std::chrono::steady_clock::now();
+
+    r.allocs = benchAllocCount - allocs0;
+    r.nsPerCall = std::chrono::duration<double, std::nano>(end - start).count() / calls;
+    r.cyclesPerCall = (double)(c1 - c0) / calls;
+    return r;
+}
+
+static void printBench(const char* name, const char* unit, const BenchResult& r) {
+    printf("[bench] %-28s %8.1f ns/%s %8.1f cycles  %u allocs  ~%u B stack\n",
+           name, r.nsPerCall, unit, r.cyclesPerCall,
+           (unsigned)r.allocs, (unsigned)r.stackBytes);
+}
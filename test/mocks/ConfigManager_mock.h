@@ -15,6 +15,7 @@ struct MockConfigState {
     uint8_t  rpmDivisor       = 0;
     uint8_t  tankCapacity     = 0;
     uint16_t dteDivisor       = 0;
+    bool     canPromisc       = false;
 
     int resetCount = 0;
     int saveCount  = 0;
@@ -0,0 +1,27 @@
+#pragma once
+// Fixture helpers shared by the suites that read profiles through the
+// LittleFS mock. Define FIXTURE_DIR before the include when the suite's
+// LittleFS.basePath is not test/fixtures.
+
+#include <unity.h>
+#include <stdio.h>
+#include <string>
+
+#ifndef FIXTURE_DIR
+#define FIXTURE_DIR "test/fixtures"
+#endif
+
+// Copy a fixture under a scratch name (cache and index tests write next to it)
+static void copyFixture(const char* from, const char* to) {
+    std::string src = std::string(FIXTURE_DIR "/") + from;
+    std::string dst = std::string(FIXTURE_DIR "/") + to;
+    FILE* in = fopen(src.c_str(), "rb");
+    FILE* out = fopen(dst.c_str(), "wb");
+    TEST_ASSERT_NOT_NULL(in);
+    TEST_ASSERT_NOT_NULL(out);
+    char buf[512];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), in)) > 0) fwrite(buf, 1, n, out);
+    fclose(in);
+    fclose(out);
+}
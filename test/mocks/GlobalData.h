@@ -29,3 +29,91 @@ extern uint16_t averageSpeed;
 extern uint16_t elapsedTime;
 
 inline void resetVehicleData() {}
+
+// Seqlock hooks are no-ops on host (single-threaded tests)
+inline void vehicleDataBeginWrite() {}
+inline void vehicleDataEndWrite() {}
+
+const uint8_t VEHICLE_SIGNAL_COUNT = 13;
+
+// Change timestamps (mirrors include/GlobalData.h). The mock write section
+// does not read the clock: tests set vehicleDataWriteUs themselves.
+inline uint32_t vehicleDataWriteUs = 0;
+inline volatile uint32_t vehicleChangedUs[VEHICLE_SIGNAL_COUNT] = {};
+
+// Consistent copy for readers (mirrors include/GlobalData.h)
+struct VehicleDataSnapshot {
+    int16_t  currentSteer;
+    uint16_t engineRPM;
+    uint8_t  vehicleSpeed;
+    uint8_t  currentDoors;
+    uint8_t  fuelLevel;
+    float    voltBat;
+    int16_t  dteValue;
+    float    fuelConsoMoy;
+    int8_t   tempExt;
+    uint32_t currentOdo;
+
+    bool indicatorLeft;
+    bool indicatorRight;
+    bool headlightsOn;
+    bool highBeamOn;
+    bool parkingLightsOn;
+    unsigned long lastLeftIndicatorTime;
+    unsigned long lastRightIndicatorTime;
+
+    uint16_t fuelConsumptionInst;
+    uint16_t fuelConsumptionAvg;
+    uint16_t averageSpeed;
+    uint16_t elapsedTime;
+
+    uint32_t changedUs[VEHICLE_SIGNAL_COUNT];
+};
+
+inline void vehicleDataSnapshot(VehicleDataSnapshot& out) {
+    out = { currentSteer, engineRPM, vehicleSpeed, currentDoors, fuelLevel, voltBat,
+            dteValue, fuelConsoMoy, tempExt, currentOdo,
+            indicatorLeft, indicatorRight, headlightsOn, highBeamOn, parkingLightsOn,
+            lastLeftIndicatorTime, lastRightIndicatorTime,
+            fuelConsumptionInst, fuelConsumptionAvg, averageSpeed, elapsedTime, {} };
+    for (uint8_t i = 0; i < VEHICLE_SIGNAL_COUNT; i++) out.changedUs[i] = vehicleChangedUs[i];
+}
+
+// Dirty set (mirrors include/GlobalData.h)
+const uint16_t DIRTY_STEERING       = 0x0001;
+const uint16_t DIRTY_RPM            = 0x0002;
+const uint16_t DIRTY_SPEED          = 0x0004;
+const uint16_t DIRTY_DOORS          = 0x0008;
+const uint16_t DIRTY_LIGHTS         = 0x0010;
+const uint16_t DIRTY_FUEL_LEVEL     = 0x0020;
+const uint16_t DIRTY_ODOMETER       = 0x0040;
+const uint16_t DIRTY_VOLTAGE        = 0x0080;
+const uint16_t DIRTY_TEMPERATURE    = 0x0100;
+const uint16_t DIRTY_DTE            = 0x0200;
+const uint16_t DIRTY_FUEL_CONS_INST = 0x0400;
+const uint16_t DIRTY_FUEL_CONS_AVG  = 0x0800;
+const uint16_t DIRTY_TRIP           = 0x1000;
+const uint16_t DIRTY_ALL            = 0x1FFF;
+
+extern volatile uint16_t vehicleDirty;
+
+inline void vehicleDataMarkDirty(uint16_t bits) {
+    vehicleDirty = vehicleDirty | bits;
+    for (uint16_t b = bits & DIRTY_ALL; b; b &= b - 1) {
+        vehicleChangedUs[__builtin_ctz(b)] = vehicleDataWriteUs;
+    }
+}
+
+template <typename T>
+inline void vehicleDataStore(T& dst, T value, uint16_t dirtyBit) {
+    if (dst != value) {
+        dst = value;
+        vehicleDataMarkDirty(dirtyBit);
+    }
+}
+
+inline uint16_t vehicleDataTakeDirty() {
+    uint16_t bits = vehicleDirty;
+    vehicleDirty = 0;
+    return bits;
+}
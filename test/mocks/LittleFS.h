@@ -2,25 +2,59 @@
 #include <stdio.h>
 #include <string.h>
 #include <string>
+#include <dirent.h>
 
-// File — thin wrapper around POSIX FILE* for native test builds
+// File — thin wrapper around POSIX FILE* for native test builds. A directory
+// (open("/")) wraps a DIR* and lists its regular files with openNextFile().
 class File {
 public:
     File() : _fp(nullptr) {}
-    explicit File(FILE* fp) : _fp(fp) {}
+    explicit File(FILE* fp, const char* name = "") : _fp(fp), _name(name) {}
+    File(DIR* dir, const std::string& path) : _fp(nullptr), _dir(dir), _path(path) {}
 
-    operator bool() const { return _fp != nullptr; }
+    operator bool() const { return _fp != nullptr || _dir != nullptr; }
+
+    bool isDirectory() const { return _dir != nullptr; }
+    const char* name() const { return _name.c_str(); }
+
+    File openNextFile() {
+        if (!_dir) return File();
+        while (struct dirent* e = readdir(_dir)) {
+            std::string full = _path + "/" + e->d_name;
+            DIR* sub = opendir(full.c_str());
+            if (sub) { closedir(sub); continue; }   // "." / ".." / subdirectories
+            FILE* fp = fopen(full.c_str(), "rb");
+            if (fp) return File(fp, e->d_name);
+        }
+        return File();
+    }
 
     size_t read(uint8_t* buf, size_t len) {
         return _fp ? fread(buf, 1, len, _fp) : 0;
     }
 
+    size_t write(const uint8_t* buf, size_t len) {
+        return _fp ? fwrite(buf, 1, len, _fp) : 0;
+    }
+
     int read() {
         if (!_fp) return -1;
         int c = fgetc(_fp);
         return (c == EOF) ? -1 : c;
     }
 
+    int peek() {
+        if (!_fp) return -1;
+        int c = fgetc(_fp);
+        if (c == EOF) return -1;
+        ungetc(c, _fp);
+        return c;
+    }
+
+    bool seek(size_t pos) {
+        return _fp && fseek(_fp, (long)pos, SEEK_SET) == 0;
+    }
+
     bool available() {
         if (!_fp) return false;
         return !feof(_fp);
@@ -28,6 +62,7 @@ public:
 
     void close() {
         if (_fp) { fclose(_fp); _fp = nullptr; }
+        if (_dir) { closedir(_dir); _dir = nullptr; }
     }
 
     size_t size() {
@@ -41,12 +76,23 @@ public:
 
 private:
     FILE* _fp;
+    DIR* _dir = nullptr;
+    std::string _path;
+    std::string _name;
 };
 
 // Minimal FS stub backed by POSIX filesystem
 // Fixture JSON files live in test/fixtures/ and are accessed by name (no leading /).
+// Writes (open "w", remove) are refused unless a test sets writable, so the
+// profile cache is never written next to the fixtures by accident.
 class FS {
 public:
+    bool writable = false;
+
+    // Reported partition size / usage (real files are not counted)
+    size_t mockTotalBytes = 1536 * 1024;
+    size_t mockUsedBytes = 0;
+
     bool begin(bool) { return true; }
     bool begin() { return true; }
 
@@ -61,11 +107,23 @@ public:
     }
 
     File open(const char* path, const char* mode = "r") {
+        if (!writable && strpbrk(mode, "wa+")) return File();
         std::string full = _fullPath(path);
+        if (strcmp(mode, "r") == 0) {
+            DIR* dir = opendir(full.c_str());
+            if (dir) return File(dir, full);
+        }
         FILE* fp = fopen(full.c_str(), mode);
         return File(fp);
     }
 
+    size_t totalBytes() { return mockTotalBytes; }
+    size_t usedBytes() { return mockUsedBytes; }
+
+    bool remove(const char* path) {
+        return writable && ::remove(_fullPath(path).c_str()) == 0;
+    }
+
 private:
     std::string _fullPath(const char* path) const {
         // Strip leading '/' and prefix with basePath
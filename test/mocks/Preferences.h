@@ -0,0 +1,100 @@
+#pragma once
+#include <stdint.h>
+#include <string.h>
+#include <map>
+#include <string>
+#include <vector>
+
+// Preferences (NVS) mock — one in-memory namespace shared by every instance.
+// Counts write operations so tests can check coalescing; mockNvsFail makes
+// begin() in read-write mode fail (flash error).
+inline std::map<std::string, std::vector<uint8_t>> mockNvs;
+inline uint32_t mockNvsWrites = 0;
+inline bool mockNvsFail = false;
+
+inline void mockNvsReset() {
+    mockNvs.clear();
+    mockNvsWrites = 0;
+    mockNvsFail = false;
+}
+
+class Preferences {
+public:
+    bool begin(const char*, bool readOnly = false) {
+        if (!readOnly && mockNvsFail) return false;
+        _readOnly = readOnly;
+        _open = true;
+        return true;
+    }
+    void end() { _open = false; }
+
+    bool clear() {
+        if (!writable()) return false;
+        mockNvs.clear();
+        mockNvsWrites++;
+        return true;
+    }
+    bool remove(const char* key) {
+        if (!writable()) return false;
+        mockNvsWrites++;
+        return mockNvs.erase(key) > 0;
+    }
+    bool isKey(const char* key) { return _open && mockNvs.count(key) > 0; }
+
+    size_t putBytes(const char* key, const void* value, size_t len) {
+        if (!writable()) return 0;
+        const uint8_t* p = (const uint8_t*)value;
+        mockNvs[key] = std::vector<uint8_t>(p, p + len);
+        mockNvsWrites++;
+        return len;
+    }
+    size_t getBytesLength(const char* key) {
+        auto it = find(key);
+        return it ? it->size() : 0;
+    }
+    size_t getBytes(const char* key, void* buf, size_t maxLen) {
+        auto it = find(key);
+        if (!it || it->size() > maxLen) return 0;
+        memcpy(buf, it->data(), it->size());
+        return it->size();
+    }
+
+    size_t putString(const char* key, const char* value) { return putBytes(key, value, strlen(value) + 1); }
+    size_t getString(const char* key, char* value, size_t maxLen) {
+        auto it = find(key);
+        if (!it || it->size() > maxLen) return 0;
+        memcpy(value, it->data(), it->size());
+        return it->size();
+    }
+
+    size_t putShort(const char* key, int16_t v) { return putBytes(key, &v, sizeof(v)); }
+    size_t putUShort(const char* key, uint16_t v) { return putBytes(key, &v, sizeof(v)); }
+    size_t putUChar(const char* key, uint8_t v) { return putBytes(key, &v, sizeof(v)); }
+    size_t putBool(const char* key, bool v) { return putUChar(key, v ? 1 : 0); }
+
+    int16_t getShort(const char* key, int16_t def = 0) { return get(key, def); }
+    uint16_t getUShort(const char* key, uint16_t def = 0) { return get(key, def); }
+    uint8_t getUChar(const char* key, uint8_t def = 0) { return get(key, def); }
+    bool getBool(const char* key, bool def = false) { return get<uint8_t>(key, def ? 1 : 0) != 0; }
+
+private:
+    bool _open = false;
+    bool _readOnly = true;
+
+    bool writable() const { return _open && !_readOnly; }
+
+    const std::vector<uint8_t>* find(const char* key) const {
+        if (!_open) return nullptr;
+        auto it = mockNvs.find(key);
+        return it == mockNvs.end() ? nullptr : &it->second;
+    }
+
+    template <typename T>
+    T get(const char* key, T def) const {
+        auto it = find(key);
+        if (!it || it->size() != sizeof(T)) return def;
+        T v;
+        memcpy(&v, it->data(), sizeof(T));
+        return v;
+    }
+};
@@ -0,0 +1,11 @@
+#pragma once
+#include "FreeRTOS.h"
+
+// Task creation fails, so modules fall back to their inline paths
+typedef void (*TaskFunction_t)(void*);
+inline BaseType_t xTaskCreate(TaskFunction_t, const char*, uint32_t, void*,
+                              UBaseType_t, TaskHandle_t* handle) {
+    if (handle) *handle = nullptr;
+    return pdFAIL;
+}
+inline void vTaskDelay(TickType_t) {}
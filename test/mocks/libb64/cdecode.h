@@ -0,0 +1,89 @@
+// libb64 decoder for native builds — same API and behaviour as the copy in the
+// ESP32 Arduino core (public domain, http://libb64.sourceforge.net/):
+// characters outside the alphabet are skipped, '=' ends nothing by itself.
+#pragma once
+
+typedef enum { step_a, step_b, step_c, step_d } base64_decodestep;
+
+typedef struct {
+    base64_decodestep step;
+    char plainchar;
+} base64_decodestate;
+
+static inline int base64_decode_value(char value_in) {
+    static const signed char decoding[] = {
+        62,-1,-1,-1,63,52,53,54,55,56,57,58,59,60,61,-1,-1,-1,-2,-1,-1,-1, 0, 1,
+         2, 3, 4, 5, 6, 7, 8, 9,10,11,12,13,14,15,16,17,18,19,20,21,22,23,24,25,
+        -1,-1,-1,-1,-1,-1,26,27,28,29,30,31,32,33,34,35,36,37,38,39,40,41,42,43,
+        44,45,46,47,48,49,50,51
+    };
+    int v = (unsigned char)value_in - 43;
+    if (v < 0 || v >= (int)sizeof(decoding)) return -1;
+    return decoding[v];
+}
+
+static inline void base64_init_decodestate(base64_decodestate* state_in) {
+    state_in->step = step_a;
+    state_in->plainchar = 0;
+}
+
+static inline int base64_decode_block(const char* code_in, const int length_in,
+                                      char* plaintext_out, base64_decodestate* state_in) {
+    const char* codechar = code_in;
+    const char* end = code_in + length_in;
+    char* plainchar = plaintext_out;
+    signed char fragment;
+
+    *plainchar = state_in->plainchar;
+
+    switch (state_in->step) {
+        while (1) {
+    case step_a:
+            do {
+                if (codechar == end) {
+                    state_in->step = step_a;
+                    state_in->plainchar = *plainchar;
+                    return (int)(plainchar - plaintext_out);
+                }
+                fragment = (signed char)base64_decode_value(*codechar++);
+            } while (fragment < 0);
+            *plainchar = (char)((fragment & 0x3f) << 2);
+            // fall through
+    case step_b:
+            do {
+                if (codechar == end) {
+                    state_in->step = step_b;
+                    state_in->plainchar = *plainchar;
+                    return (int)(plainchar - plaintext_out);
+                }
+                fragment = (signed char)base64_decode_value(*codechar++);
+            } while (fragment < 0);
+            *plainchar++ |= (char)((fragment & 0x30) >> 4);
+            *plainchar = (char)((fragment & 0x0f) << 4);
+            // fall through
+    case step_c:
+            do {
+                if (codechar == end) {
+                    state_in->step = step_c;
+                    state_in->plainchar = *plainchar;
+                    return (int)(plainchar - plaintext_out);
+                }
+                fragment = (signed char)base64_decode_value(*codechar++);
+            } while (fragment < 0);
+            *plainchar++ |= (char)((fragment & 0x3c) >> 2);
+            *plainchar = (char)((fragment & 0x03) << 6);
+            // fall through
+    case step_d:
+            do {
+                if (codechar == end) {
+                    state_in->step = step_d;
+                    state_in->plainchar = *plainchar;
+                    return (int)(plainchar - plaintext_out);
+                }
+                fragment = (signed char)base64_decode_value(*codechar++);
+            } while (fragment < 0);
+            *plainchar++ |= (char)(fragment & 0x3f);
+        }
+    }
+    return (int)(plainchar - plaintext_out);
+}
@@ -0,0 +1,189 @@
+/**
+ * @file test_bench_decode.cpp
+ * @brief Host benchmark: CanConfigProcessor::processFrame() hot path
+ *
+ * Benchmarks:
+ *   - compiled field decoders vs the reference interpreter
+ *   - baked profile (generated switch decoder) vs the compiled decoders,
+ *     when built with PROFILE_BAKED=1
+ *   - traffic mixes: every Juke ID in turn, 90% unknown IDs (unfiltered
+ *     bus), 0x60D-heavy (the 10-field body frame at 80% of the traffic)
+ *
+ * Each reports time, cycles, heap allocations and stack depth per frame and
+ * fails on a regression: any allocation, or more than the BENCH_MAX_* limits
+ * below. Absolute numbers are host numbers; compare runs on one machine.
+ *
+ * Run: pio test -e native_bench
+ */
+
+#include <unity.h>
+#include "BenchSupport.h"
+#include "CanConfigProcessor.h"
+#include "ConfigManager_mock.h"
+#include "GlobalData.h"
+#include "LittleFS.h"
+
+#define BENCH_FRAMES 500000
+#define TRAFFIC_LEN  100
+
+#ifndef BENCH_MAX_NS_PER_FRAME
+#define BENCH_MAX_NS_PER_FRAME    500     // Any mix, -O2 host build
+#endif
+#ifndef BENCH_MAX_STACK_PER_FRAME
+#define BENCH_MAX_STACK_PER_FRAME 512     // Bytes: processFrame runs in the ingest task
+#endif
+
+static CanConfigProcessor proc;
+static CanFrame traffic[TRAFFIC_LEN];
+
+static const uint16_t JUKE_IDS[] = {0x002, 0x180, 0x284, 0x5C5, 0x6F6, 0x551, 0x60D, 0x54C, 0x580};
+static const size_t JUKE_ID_COUNT = sizeof(JUKE_IDS) / sizeof(JUKE_IDS[0]);
+
+static uint32_t seed = 0xC0FFEE;
+
+static uint32_t nextRandom() {
+    seed = seed * 1664525u + 1013904223u;
+    return seed >> 8;
+}
+
+static CanFrame makeFrame(uint16_t id) {
+    CanFrame frame = {};
+    frame.identifier = id;
+    frame.data_length_code = 8;
+    for (uint8_t& b : frame.data) b = (uint8_t)nextRandom();
+    return frame;
+}
+
+static bool isJukeId(uint16_t id) {
+    for (uint16_t known : JUKE_IDS) {
+        if (known == id) return true;
+    }
+    return false;
+}
+
+// =============================================================================
+// TRAFFIC MIXES
+// =============================================================================
+
+static void buildAllKnown() {
+    for (size_t i = 0; i < TRAFFIC_LEN; i++) traffic[i] = makeFrame(JUKE_IDS[i % JUKE_ID_COUNT]);
+}
+
+static void buildMostlyUnknown() {
+    for (size_t i = 0; i < TRAFFIC_LEN; i++) {
+        if (i % 10 == 0) {
+            traffic[i] = makeFrame(JUKE_IDS[(i / 10) % JUKE_ID_COUNT]);
+            continue;
+        }
+        uint16_t id;
+        do {
+            id = (uint16_t)(nextRandom() & 0x7FF);
+        } while (isJukeId(id));
+        traffic[i] = makeFrame(id);
+    }
+}
+
+static void buildBodyHeavy() {
+    for (size_t i = 0; i < TRAFFIC_LEN; i++) {
+        traffic[i] = makeFrame(i % 5 == 4 ? JUKE_IDS[(i / 5) % JUKE_ID_COUNT] : 0x60D);
+    }
+}
+
+static BenchResult benchProcessFrame() {
+    return runBench(BENCH_FRAMES, [](uint32_t i) { proc.processFrame(traffic[i % TRAFFIC_LEN]); });
+}
+
+static void checkLimits(const BenchResult& r) {
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, r.allocs, "processFrame() allocated");
+    TEST_ASSERT_TRUE_MESSAGE(r.nsPerCall < BENCH_MAX_NS_PER_FRAME, "slower than BENCH_MAX_NS_PER_FRAME");
+    TEST_ASSERT_TRUE_MESSAGE(r.stackBytes < BENCH_MAX_STACK_PER_FRAME, "deeper than BENCH_MAX_STACK_PER_FRAME");
+}
+
+void setUp() {
+    mockReset();
+    LittleFS.basePath = "data";
+    proc = CanConfigProcessor();
+    proc.loadFromJson("/NissanJukeF15.json");
+    seed = 0xC0FFEE;
+}
+
+void tearDown() {}
+
+// =============================================================================
+// BENCHMARKS
+// =============================================================================
+
+void bench_compiled_vs_reference_decoders() {
+    buildAllKnown();
+    BenchResult ref = runBench(BENCH_FRAMES, [](uint32_t i) {
+        proc.processFrameReference(traffic[i % TRAFFIC_LEN]);
+    });
+    BenchResult compiled = benchProcessFrame();
+
+    printBench("reference interpreter", "frame", ref);
+    printBench("compiled decoders", "frame", compiled);
+    printf("[bench] speedup: %.2fx\n", ref.nsPerCall / compiled.nsPerCall);
+
+    // The speedup is reported, not asserted: two wall-clock runs on a shared
+    // runner can swap order. The absolute limits still catch a regression
+    checkLimits(compiled);
+}
+
+#if PROFILE_BAKED
+void bench_baked_vs_compiled_decoders() {
+    static CanConfigProcessor baked;
+    TEST_ASSERT_TRUE(baked.loadBaked());
+
+    buildAllKnown();
+    BenchResult compiled = benchProcessFrame();
+    BenchResult all = runBench(BENCH_FRAMES, [](uint32_t i) { baked.processFrame(traffic[i % TRAFFIC_LEN]); });
+    buildBodyHeavy();
+    BenchResult compiledBody = benchProcessFrame();
+    BenchResult body = runBench(BENCH_FRAMES, [](uint32_t i) { baked.processFrame(traffic[i % TRAFFIC_LEN]); });
+
+    printBench("compiled decoders", "frame", compiled);
+    printBench("baked decoder", "frame", all);
+    printf("[bench] speedup: %.2fx\n", compiled.nsPerCall / all.nsPerCall);
+    printBench("compiled: 80% 0x60D", "frame", compiledBody);
+    printBench("baked: 80% 0x60D", "frame", body);
+    printf("[bench] speedup: %.2fx\n", compiledBody.nsPerCall / body.nsPerCall);
+
+    checkLimits(all);
+    checkLimits(body);
+}
+#endif
+
+void bench_mix_all_known() {
+    buildAllKnown();
+    BenchResult r = benchProcessFrame();
+    printBench("mix: all known IDs", "frame", r);
+    checkLimits(r);
+}
+
+void bench_mix_90_percent_unknown() {
+    buildMostlyUnknown();
+    uint32_t unknown0 = proc.getUnknownFrames();
+    BenchResult r = benchProcessFrame();
+    printBench("mix: 90% unknown IDs", "frame", r);
+    TEST_ASSERT_TRUE(proc.getUnknownFrames() - unknown0 > BENCH_FRAMES * 8 / 10);
+    checkLimits(r);
+}
+
+void bench_mix_0x60D_heavy() {
+    buildBodyHeavy();
+    BenchResult r = benchProcessFrame();
+    printBench("mix: 80% 0x60D (10 fields)", "frame", r);
+    checkLimits(r);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(bench_compiled_vs_reference_decoders);
+#if PROFILE_BAKED
+    RUN_TEST(bench_baked_vs_compiled_decoders);
+#endif
+    RUN_TEST(bench_mix_all_known);
+    RUN_TEST(bench_mix_90_percent_unknown);
+    RUN_TEST(bench_mix_0x60D_heavy);
+    return UNITY_END();
+}
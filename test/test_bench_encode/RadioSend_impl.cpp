@@ -0,0 +1,13 @@
+// Include the head-unit encoder, its TX scheduler, the upload decoders and
+// the shared native stubs into this test build
+// (see test_vehicle_params/CanConfigProcessor_impl.cpp).
+#include "../../src/RadioSend.cpp"
+#include "../../src/RadioTx.cpp"
+#include "../../src/RadioFrameParser.cpp"
+#include "../../src/LatencyHistogram.cpp"
+#include "../../src/base64.cpp"
+#include "../../src/crc32.cpp"
+#include "../test_vehicle_params/ConfigManager_stub.cpp"
+#include "../test_vehicle_params/GlobalData_stub.cpp"
+
+HardwareSerial RadioSerial;
@@ -0,0 +1,170 @@
+/**
+ * @file test_bench_encode.cpp
+ * @brief Host benchmark: head-unit encoding and upload decoding hot paths
+ *
+ * Benchmarks:
+ *   - sendCanboxMessage() + radioTxFlush() into the mock RadioSerial
+ *   - processRadioUpdates(): idle pass, and a pass with every slot due
+ *   - base64Decode() of one CAN UPLOAD / OTA DATA line (240 chars)
+ *   - crc32_le() over a text chunk and a full binary frame payload
+ *
+ * Same report and regression checks as test_bench_decode: time, cycles,
+ * heap allocations and stack depth per call; fails on any allocation or
+ * beyond the BENCH_MAX_* limits below.
+ *
+ * Run: pio test -e native_bench
+ */
+
+#include <unity.h>
+#include "BenchSupport.h"
+#include "RadioSend.h"
+#include "RadioTx.h"
+#include "base64.h"
+#include "crc32.h"
+#include "ConfigManager_mock.h"
+#include "GlobalData.h"
+
+extern HardwareSerial RadioSerial;
+
+// Internal to RadioSend.cpp (not in RadioSend.h)
+void sendCanboxMessage(RadioClass cls, uint8_t cmd, const uint8_t* data, uint8_t len);
+
+#define BENCH_CALLS 200000
+
+#ifndef BENCH_MAX_NS_PER_RADIO_FRAME
+#define BENCH_MAX_NS_PER_RADIO_FRAME  1000    // Queue + flush of one 12-byte frame
+#endif
+#ifndef BENCH_MAX_NS_PER_RADIO_PASS
+#define BENCH_MAX_NS_PER_RADIO_PASS   5000    // processRadioUpdates(), every slot due
+#endif
+#ifndef BENCH_MAX_NS_PER_B64_BYTE
+#define BENCH_MAX_NS_PER_B64_BYTE     20      // Per decoded byte
+#endif
+#ifndef BENCH_MAX_NS_PER_CRC_BYTE
+#define BENCH_MAX_NS_PER_CRC_BYTE     10
+#endif
+#ifndef BENCH_MAX_STACK
+#define BENCH_MAX_STACK               1024    // Bytes: these run in loop()
+#endif
+
+#define B64_LINE_CHARS  240           // Longest base64 run in a command line
+#define B64_LINE_BYTES  (B64_LINE_CHARS / 4 * 3)
+#define CRC_BIN_BYTES   4096          // BIN_MAX_PAYLOAD
+
+static char b64Line[B64_LINE_CHARS + 1];
+static uint8_t decodeBuffer[256];
+static uint8_t crcData[CRC_BIN_BYTES];
+static volatile uint32_t sink;
+
+static void resetRadioSerial() {
+    RadioSerial.writtenLen = 0;
+    RadioSerial.txRoom = sizeof(RadioSerial.written);
+}
+
+static void checkLimits(const BenchResult& r, double maxNs) {
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, r.allocs, "hot path allocated");
+    TEST_ASSERT_TRUE_MESSAGE(r.nsPerCall < maxNs, "slower than its BENCH_MAX_NS_* limit");
+    TEST_ASSERT_TRUE_MESSAGE(r.stackBytes < BENCH_MAX_STACK, "deeper than BENCH_MAX_STACK");
+}
+
+void setUp() {
+    mockReset();
+    mockMillis = 1000;
+    radioTxReset();
+    resetRadioSerial();
+
+    static const char alphabet[] =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    uint32_t seed = 0xC0FFEE;
+    for (size_t i = 0; i < B64_LINE_CHARS; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        b64Line[i] = alphabet[(seed >> 24) & 0x3F];
+    }
+    b64Line[B64_LINE_CHARS] = '\0';
+    for (size_t i = 0; i < sizeof(crcData); i++) {
+        seed = seed * 1664525u + 1013904223u;
+        crcData[i] = (uint8_t)(seed >> 24);
+    }
+}
+
+void tearDown() {}
+
+// =============================================================================
+// HEAD-UNIT ENCODING
+// =============================================================================
+
+void bench_canbox_message_encode() {
+    static const uint8_t payload[12] = {0, 0, 0, 0, 0, 21, 0, 0, 0, 0, 0, 0};
+    BenchResult r = runBench(BENCH_CALLS, [](uint32_t) {
+        resetRadioSerial();
+        sendCanboxMessage(RadioClass::TELEMETRY, 0x28, payload, sizeof(payload));
+        radioTxFlush();
+    });
+    printBench("sendCanboxMessage + flush", "frame", r);
+
+    TEST_ASSERT_EQUAL_size_t(16, RadioSerial.writtenLen);
+    checkLimits(r, BENCH_MAX_NS_PER_RADIO_FRAME);
+}
+
+void bench_radio_pass_idle() {
+    BenchResult r = runBench(BENCH_CALLS, [](uint32_t) {
+        resetRadioSerial();
+        processRadioUpdates();
+    });
+    printBench("processRadioUpdates (idle)", "pass", r);
+    checkLimits(r, BENCH_MAX_NS_PER_RADIO_PASS);
+}
+
+void bench_radio_pass_all_due() {
+    BenchResult r = runBench(BENCH_CALLS / 10, [](uint32_t) {
+        mockMillis += 10000;               // Longest slot period: everything is due
+        engineRPM = (uint16_t)(engineRPM + 1);
+        vehicleDataMarkDirty(DIRTY_ALL);
+        resetRadioSerial();
+        processRadioUpdates();
+    });
+    printBench("processRadioUpdates (all due)", "pass", r);
+
+    TEST_ASSERT_TRUE(RadioSerial.writtenLen > 0);
+    checkLimits(r, BENCH_MAX_NS_PER_RADIO_PASS);
+}
+
+// =============================================================================
+// UPLOAD DECODING
+// =============================================================================
+
+void bench_base64_decode_line() {
+    BenchResult r = runBench(BENCH_CALLS, [](uint32_t) {
+        sink = (uint32_t)base64Decode(b64Line, decodeBuffer, sizeof(decodeBuffer));
+    });
+    printBench("base64Decode (240 chars)", "line", r);
+    printf("[bench]   %.2f ns/byte\n", r.nsPerCall / B64_LINE_BYTES);
+
+    TEST_ASSERT_EQUAL_UINT32(B64_LINE_BYTES, sink);
+    checkLimits(r, BENCH_MAX_NS_PER_B64_BYTE * B64_LINE_BYTES);
+}
+
+void bench_crc32_chunk_and_frame() {
+    BenchResult chunk = runBench(BENCH_CALLS, [](uint32_t i) {
+        sink = crc32_le(i, crcData, B64_LINE_BYTES);
+    });
+    BenchResult frame = runBench(BENCH_CALLS / 20, [](uint32_t i) {
+        sink = crc32_le(i, crcData, CRC_BIN_BYTES);
+    });
+    printBench("crc32_le (180 B chunk)", "call", chunk);
+    printBench("crc32_le (4 KB frame)", "call", frame);
+    printf("[bench]   %.2f ns/byte\n", frame.nsPerCall / CRC_BIN_BYTES);
+
+    checkLimits(chunk, BENCH_MAX_NS_PER_CRC_BYTE * B64_LINE_BYTES);
+    checkLimits(frame, BENCH_MAX_NS_PER_CRC_BYTE * CRC_BIN_BYTES);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(bench_canbox_message_encode);
+    RUN_TEST(bench_radio_pass_idle);
+    RUN_TEST(bench_radio_pass_all_due);
+    RUN_TEST(bench_base64_decode_line);
+    RUN_TEST(bench_crc32_chunk_and_frame);
+    return UNITY_END();
+}
@@ -0,0 +1,4 @@
+// Include the binary frame decoder and CRC32 implementations into this test
+// build (see test_vehicle_params/CanConfigProcessor_impl.cpp).
+#include "../../src/crc32.cpp"
+#include "../../src/BinaryFrame.cpp"
@@ -0,0 +1,218 @@
+/**
+ * @file test_binary_frame.cpp
+ * @brief Unit tests for the binary transfer frames (BinaryFrameDecoder, crc32_le)
+ *
+ * Tests:
+ *   - table CRC32 matches the reference value of the bit-by-bit version
+ *   - complete frame, frame split byte by byte, END without payload
+ *   - several frames in one buffer (pipelined window)
+ *   - CRC mismatch and oversized length are rejected, decoder resynchronizes
+ *   - a corrupted length or a stray magic does not swallow the frames behind
+ *     it: the rejected bytes are scanned again
+ *
+ * Run: pio test -e native
+ */
+
+#include <unity.h>
+#include "BinaryFrame.h"
+#include "crc32.h"
+
+static BinaryFrameDecoder decoder;
+
+/**
+ * @brief Build a frame as the host does; returns its size
+ */
+static size_t buildFrame(uint8_t* out, uint8_t type, uint16_t seq,
+                         const uint8_t* payload, uint16_t len) {
+    out[0] = BIN_MAGIC0;
+    out[1] = BIN_MAGIC1;
+    out[2] = type;
+    out[3] = seq & 0xFF;
+    out[4] = seq >> 8;
+    out[5] = len & 0xFF;
+    out[6] = len >> 8;
+    if (len) memcpy(&out[7], payload, len);
+    uint32_t crc = crc32_le(0, &out[2], 5 + len);
+    for (int i = 0; i < 4; i++) out[7 + len + i] = (crc >> (8 * i)) & 0xFF;
+    return BIN_OVERHEAD + len;
+}
+
+void setUp() {
+    decoder.reset();
+}
+
+void tearDown() {}
+
+// =============================================================================
+// CRC32
+// =============================================================================
+
+void test_crc32_table_matches_reference() {
+    // Same vector as test_ota_logic (bit-by-bit implementation)
+    const uint8_t data[] = {'1','2','3','4','5','6','7','8','9'};
+    TEST_ASSERT_EQUAL_HEX32(0x2DFD2D88U, crc32_le(0, data, sizeof(data)));
+    TEST_ASSERT_EQUAL_HEX32(crc32_le(crc32_le(0, data, 4), data + 4, 5),
+                            crc32_le(0, data, sizeof(data)));
+}
+
+// =============================================================================
+// FRAMING
+// =============================================================================
+
+void test_complete_frame() {
+    static uint8_t payload[BIN_MAX_PAYLOAD];
+    for (size_t i = 0; i < sizeof(payload); i++) payload[i] = (uint8_t)i;
+    static uint8_t buf[BIN_MAX_PAYLOAD + BIN_OVERHEAD];
+    size_t size = buildFrame(buf, BIN_DATA, 7, payload, BIN_MAX_PAYLOAD);
+
+    size_t used = 0;
+    TEST_ASSERT_EQUAL(BinFrameResult::FRAME, decoder.feed(buf, size, used));
+    TEST_ASSERT_EQUAL_size_t(size, used);
+    TEST_ASSERT_EQUAL_UINT8(BIN_DATA, decoder.frame().type);
+    TEST_ASSERT_EQUAL_UINT16(7, decoder.frame().seq);
+    TEST_ASSERT_EQUAL_UINT16(BIN_MAX_PAYLOAD, decoder.frame().len);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(payload, decoder.frame().payload, BIN_MAX_PAYLOAD);
+}
+
+void test_frame_split_byte_by_byte() {
+    const uint8_t payload[3] = {0x10, 0x20, 0x30};
+    uint8_t buf[32];
+    size_t size = buildFrame(buf, BIN_DATA, 1, payload, 3);
+
+    size_t used = 0;
+    for (size_t i = 0; i < size - 1; i++) {
+        TEST_ASSERT_EQUAL(BinFrameResult::NONE, decoder.feed(&buf[i], 1, used));
+        TEST_ASSERT_EQUAL_size_t(1, used);
+    }
+    TEST_ASSERT_EQUAL(BinFrameResult::FRAME, decoder.feed(&buf[size - 1], 1, used));
+    TEST_ASSERT_EQUAL_HEX8(0x30, decoder.frame().payload[2]);
+}
+
+void test_end_frame_without_payload() {
+    uint8_t buf[16];
+    size_t size = buildFrame(buf, BIN_END, 300, nullptr, 0);
+
+    size_t used = 0;
+    TEST_ASSERT_EQUAL(BinFrameResult::FRAME, decoder.feed(buf, size, used));
+    TEST_ASSERT_EQUAL_UINT8(BIN_END, decoder.frame().type);
+    TEST_ASSERT_EQUAL_UINT16(300, decoder.frame().seq);
+    TEST_ASSERT_EQUAL_UINT16(0, decoder.frame().len);
+}
+
+void test_pipelined_frames_in_one_buffer() {
+    const uint8_t payload[4] = {1, 2, 3, 4};
+    uint8_t buf[3 * (4 + BIN_OVERHEAD) + 2];
+    size_t size = 0;
+    buf[size++] = '\n';                     // Stray byte left by the text command
+    for (uint16_t seq = 0; seq < 3; seq++) {
+        size += buildFrame(&buf[size], BIN_DATA, seq, payload, 4);
+    }
+
+    size_t offset = 0, used = 0;
+    for (uint16_t seq = 0; seq < 3; seq++) {
+        TEST_ASSERT_EQUAL(BinFrameResult::FRAME, decoder.feed(buf + offset, size - offset, used));
+        TEST_ASSERT_EQUAL_UINT16(seq, decoder.frame().seq);
+        offset += used;
+    }
+    TEST_ASSERT_EQUAL_size_t(size, offset);
+}
+
+// =============================================================================
+// ERRORS
+// =============================================================================
+
+void test_bad_crc_then_resync() {
+    const uint8_t payload[4] = {1, 2, 3, 4};
+    uint8_t buf[64];
+    size_t first = buildFrame(buf, BIN_DATA, 0, payload, 4);
+    buf[8] ^= 0x01;                         // Corrupt one payload byte
+    size_t size = first + buildFrame(&buf[first], BIN_DATA, 1, payload, 4);
+
+    size_t used = 0;
+    TEST_ASSERT_EQUAL(BinFrameResult::BAD_CRC, decoder.feed(buf, size, used));
+    TEST_ASSERT_EQUAL_size_t(first, used);
+    TEST_ASSERT_EQUAL(BinFrameResult::FRAME, decoder.feed(buf + used, size - used, used));
+    TEST_ASSERT_EQUAL_UINT16(1, decoder.frame().seq);
+}
+
+void test_oversized_length_is_rejected() {
+    uint8_t header[7] = {BIN_MAGIC0, BIN_MAGIC1, BIN_DATA, 0, 0,
+                         (BIN_MAX_PAYLOAD + 1) & 0xFF, (BIN_MAX_PAYLOAD + 1) >> 8};
+    size_t used = 0;
+    TEST_ASSERT_EQUAL(BinFrameResult::BAD_HEADER, decoder.feed(header, sizeof(header), used));
+
+    uint8_t unknown[7] = {BIN_MAGIC0, BIN_MAGIC1, 0x7F, 0, 0, 0, 0};
+    TEST_ASSERT_EQUAL(BinFrameResult::BAD_HEADER, decoder.feed(unknown, sizeof(unknown), used));
+}
+
+/**
+ * @brief Feed a buffer to the end, recording the seq of every valid frame
+ * @return Number of frames, bad ones counted in `bad`
+ */
+static uint8_t feedAll(const uint8_t* buf, size_t size, uint16_t* seqs, uint8_t& bad) {
+    uint8_t frames = 0;
+    size_t offset = 0;
+    bad = 0;
+    while (offset < size || decoder.hasPending()) {
+        size_t used = 0;
+        BinFrameResult result = decoder.feed(buf + offset, size - offset, used);
+        offset += used;
+        if (result == BinFrameResult::FRAME) seqs[frames++] = decoder.frame().seq;
+        else if (result != BinFrameResult::NONE) bad++;
+    }
+    return frames;
+}
+
+void test_corrupted_length_does_not_swallow_next_frames() {
+    const uint8_t payload[4] = {1, 2, 3, 4};
+    uint8_t buf[128];
+    size_t size = buildFrame(buf, BIN_DATA, 0, payload, 4);
+    buf[5] = 40;                            // Length 4 -> 40: runs into seq 1..3
+    for (uint16_t seq = 1; seq <= 3; seq++) {
+        size += buildFrame(&buf[size], BIN_DATA, seq, payload, 4);
+    }
+
+    uint16_t seqs[4];
+    uint8_t bad;
+    TEST_ASSERT_EQUAL_UINT8(3, feedAll(buf, size, seqs, bad));
+    TEST_ASSERT_EQUAL_UINT8(1, bad);
+    TEST_ASSERT_EQUAL_UINT16(1, seqs[0]);
+    TEST_ASSERT_EQUAL_UINT16(2, seqs[1]);
+    TEST_ASSERT_EQUAL_UINT16(3, seqs[2]);   // Starts in the rescan, ends in new data
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(payload, decoder.frame().payload, 4);
+}
+
+void test_magic_inside_bad_header_is_found() {
+    const uint8_t payload[4] = {5, 6, 7, 8};
+    uint8_t buf[32] = {BIN_MAGIC0, BIN_MAGIC1};  // Stray magic: header type 0xA5
+    size_t size = 2 + buildFrame(&buf[2], BIN_DATA, 7, payload, 4);
+
+    uint16_t seqs[2];
+    uint8_t bad;
+    TEST_ASSERT_EQUAL_UINT8(1, feedAll(buf, size, seqs, bad));
+    TEST_ASSERT_EQUAL_UINT8(1, bad);
+    TEST_ASSERT_EQUAL_UINT16(7, seqs[0]);
+}
+
+// =============================================================================
+// ENTRY POINT
+// =============================================================================
+
+int main(int argc, char** argv) {
+    (void)argc; (void)argv;
+    UNITY_BEGIN();
+
+    RUN_TEST(test_crc32_table_matches_reference);
+
+    RUN_TEST(test_complete_frame);
+    RUN_TEST(test_frame_split_byte_by_byte);
+    RUN_TEST(test_end_frame_without_payload);
+    RUN_TEST(test_pipelined_frames_in_one_buffer);
+
+    RUN_TEST(test_bad_crc_then_resync);
+    RUN_TEST(test_oversized_length_is_rejected);
+    RUN_TEST(test_corrupted_length_does_not_swallow_next_frames);
+    RUN_TEST(test_magic_inside_bad_header_is_found);
+
+    return UNITY_END();
+}
@@ -0,0 +1,7 @@
+// Include the recorder implementation into this test build
+// (see test_vehicle_params/CanConfigProcessor_impl.cpp).
+#include "../../src/CanRecorder.cpp"
+
+// Arduino and filesystem globals (SerialClass and FS are defined in Arduino.h/LittleFS.h mocks)
+SerialClass Serial;
+FS LittleFS;
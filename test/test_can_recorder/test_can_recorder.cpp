@@ -0,0 +1,242 @@
+/**
+ * @file test_can_recorder.cpp
+ * @brief Unit tests for the CAN frame recorder (ring, filters, file writes)
+ *
+ * No writer task in native builds: the tests call canRecorderFlush() where
+ * the task would, and canRecorderStop() drains the ring inline.
+ *
+ * Tests:
+ *   - standard frames are recorded, extended frames counted and skipped
+ *   - ID/mask filters, trigger frame starts the capture and is flagged
+ *   - full ring counts drops instead of overwriting
+ *   - only full chunks are written until REC_FLUSH_MAX_MS, file layout
+ *   - rotation to the second file, start refused without space
+ *
+ * Run: pio test -e native
+ */
+
+#include <unity.h>
+#include "CanRecorder.h"
+#include "LittleFS.h"
+
+static CanFrame makeFrame(uint16_t id, uint8_t b0, uint8_t dlc = 8) {
+    CanFrame f = {};
+    f.identifier = id;
+    f.data_length_code = dlc;
+    for (uint8_t i = 0; i < dlc; i++) f.data[i] = b0 + i;
+    return f;
+}
+
+/**
+ * @brief Read record `index` of recording file `file`
+ */
+static bool readRecord(uint8_t file, uint32_t index, CanRecord& rec) {
+    File f = LittleFS.open(canRecorderFilePath(file), "r");
+    if (!f) return false;
+    bool ok = f.seek(sizeof(CanRecordHeader) + index * sizeof(CanRecord)) &&
+              f.read((uint8_t*)&rec, sizeof(rec)) == sizeof(rec);
+    f.close();
+    return ok;
+}
+
+void setUp() {
+    LittleFS.basePath = "test/fixtures";
+    LittleFS.writable = true;
+    LittleFS.mockUsedBytes = 0;
+    mockMillis = 1000;
+    canRecorderClearFilters();
+}
+
+void tearDown() {
+    canRecorderStop();
+    LittleFS.remove(REC_FILE_0);
+    LittleFS.remove(REC_FILE_1);
+    LittleFS.writable = false;
+}
+
+// =============================================================================
+// CAPTURE
+// =============================================================================
+
+void test_records_standard_frames_and_skips_extended() {
+    TEST_ASSERT_TRUE(canRecorderStart());
+    TEST_ASSERT_EQUAL(CanRecorderState::RECORDING, canRecorderGetState());
+
+    canRecorderCapture(makeFrame(0x180, 0x10));
+    CanFrame ext = makeFrame(0x123, 0x20);
+    ext.extd = 1;
+    ext.identifier = 0x18DAF110;
+    canRecorderCapture(ext);
+    canRecorderCapture(makeFrame(0x5C5, 0x30, 3));
+
+    const CanRecorderStats& st = canRecorderGetStats();
+    TEST_ASSERT_EQUAL_UINT32(2, st.recorded);
+    TEST_ASSERT_EQUAL_UINT32(1, st.extended);
+    TEST_ASSERT_EQUAL_UINT16(2, canRecorderGetBuffered());
+
+    canRecorderStop();
+    TEST_ASSERT_EQUAL(CanRecorderState::IDLE, canRecorderGetState());
+    TEST_ASSERT_EQUAL_UINT32(2, st.written);
+    TEST_ASSERT_EQUAL_UINT16(0, canRecorderGetBuffered());
+
+    CanRecord rec;
+    TEST_ASSERT_TRUE(readRecord(0, 1, rec));
+    TEST_ASSERT_EQUAL_HEX16(0x5C5, rec.id);
+    TEST_ASSERT_EQUAL_UINT8(3, rec.dlc);
+    TEST_ASSERT_EQUAL_HEX8(0x32, rec.data[2]);
+    TEST_ASSERT_EQUAL_HEX8(0x00, rec.data[3]);
+    TEST_ASSERT_EQUAL_UINT32(1000000, rec.timestampUs);
+}
+
+void test_filters_select_ids_by_mask() {
+    TEST_ASSERT_TRUE(canRecorderAddFilter(0x180, 0x7F0));  // 0x180-0x18F
+    TEST_ASSERT_TRUE(canRecorderAddFilter(0x5C5, 0x7FF));
+    TEST_ASSERT_TRUE(canRecorderStart());
+
+    canRecorderCapture(makeFrame(0x180, 0));
+    canRecorderCapture(makeFrame(0x18F, 0));
+    canRecorderCapture(makeFrame(0x190, 0));
+    canRecorderCapture(makeFrame(0x5C5, 0));
+    canRecorderCapture(makeFrame(0x5C4, 0));
+
+    TEST_ASSERT_EQUAL_UINT32(3, canRecorderGetStats().recorded);
+    TEST_ASSERT_EQUAL_UINT32(2, canRecorderGetStats().filtered);
+
+    for (uint8_t i = 2; i < REC_MAX_FILTERS; i++) {
+        TEST_ASSERT_TRUE(canRecorderAddFilter(0x100 + i, 0x7FF));
+    }
+    TEST_ASSERT_FALSE(canRecorderAddFilter(0x300, 0x7FF));
+    TEST_ASSERT_EQUAL_UINT8(REC_MAX_FILTERS, canRecorderGetFilterCount());
+}
+
+void test_trigger_id_starts_capture() {
+    TEST_ASSERT_TRUE(canRecorderStart(0x60D));
+    TEST_ASSERT_EQUAL(CanRecorderState::ARMED, canRecorderGetState());
+
+    canRecorderCapture(makeFrame(0x180, 0));
+    canRecorderCapture(makeFrame(0x5C5, 0));
+    TEST_ASSERT_EQUAL_UINT32(0, canRecorderGetStats().recorded);
+
+    mockMillis = 1500;
+    canRecorderCapture(makeFrame(0x60D, 0));
+    canRecorderCapture(makeFrame(0x180, 0));
+    TEST_ASSERT_EQUAL(CanRecorderState::RECORDING, canRecorderGetState());
+    TEST_ASSERT_EQUAL_UINT32(2, canRecorderGetStats().recorded);
+    TEST_ASSERT_EQUAL_UINT32(2, canRecorderGetStats().filtered);
+    TEST_ASSERT_EQUAL_UINT32(1500, canRecorderGetStats().triggerMs);
+
+    canRecorderStop();
+    CanRecord rec;
+    TEST_ASSERT_TRUE(readRecord(0, 0, rec));
+    TEST_ASSERT_EQUAL_HEX16(0x60D, rec.id);
+    TEST_ASSERT_EQUAL_HEX8(REC_FLAG_TRIGGER, rec.flags);
+    TEST_ASSERT_TRUE(readRecord(0, 1, rec));
+    TEST_ASSERT_EQUAL_HEX8(0, rec.flags);
+}
+
+void test_full_ring_counts_drops() {
+    TEST_ASSERT_TRUE(canRecorderStart());
+    for (uint16_t i = 0; i < REC_RING_FRAMES + 10; i++) {
+        canRecorderCapture(makeFrame(0x100, (uint8_t)i));
+    }
+
+    const CanRecorderStats& st = canRecorderGetStats();
+    TEST_ASSERT_EQUAL_UINT32(REC_RING_FRAMES, st.recorded);
+    TEST_ASSERT_EQUAL_UINT32(10, st.dropped);
+    TEST_ASSERT_EQUAL_UINT16(REC_RING_FRAMES, st.ringHighWater);
+
+    // Oldest records are kept: the first one is still i = 0
+    canRecorderStop();
+    CanRecord rec;
+    TEST_ASSERT_TRUE(readRecord(0, 0, rec));
+    TEST_ASSERT_EQUAL_HEX8(0x00, rec.data[0]);
+    TEST_ASSERT_EQUAL_UINT32(REC_RING_FRAMES, st.written);
+}
+
+// =============================================================================
+// FILE WRITES
+// =============================================================================
+
+void test_flush_writes_full_chunks_or_after_timeout() {
+    TEST_ASSERT_TRUE(canRecorderStart());
+    for (uint16_t i = 0; i < REC_FLUSH_FRAMES - 1; i++) {
+        canRecorderCapture(makeFrame(0x100, 0));
+    }
+    TEST_ASSERT_EQUAL_UINT16(0, canRecorderFlush(false));
+
+    canRecorderCapture(makeFrame(0x100, 0));
+    canRecorderCapture(makeFrame(0x100, 0));
+    TEST_ASSERT_EQUAL_UINT16(REC_FLUSH_FRAMES, canRecorderFlush(false));
+    TEST_ASSERT_EQUAL_UINT16(0, canRecorderFlush(false));
+
+    mockMillis += REC_FLUSH_MAX_MS;
+    TEST_ASSERT_EQUAL_UINT16(1, canRecorderFlush(false));
+    TEST_ASSERT_EQUAL_UINT32(2, canRecorderGetStats().writes);
+
+    File f = LittleFS.open(REC_FILE_0, "r");
+    CanRecordHeader header;
+    TEST_ASSERT_EQUAL(sizeof(header), f.read((uint8_t*)&header, sizeof(header)));
+    TEST_ASSERT_EQUAL_HEX32(REC_MAGIC, header.magic);
+    TEST_ASSERT_EQUAL_UINT16(REC_VERSION, header.version);
+    TEST_ASSERT_EQUAL_UINT16(sizeof(CanRecord), header.recordSize);
+    TEST_ASSERT_EQUAL_UINT16(0, header.sequence);
+    f.close();
+    TEST_ASSERT_EQUAL_UINT32(sizeof(header) + (REC_FLUSH_FRAMES + 1) * sizeof(CanRecord),
+                             canRecorderGetStats().fileBytes);
+}
+
+void test_full_file_rotates_to_other_file() {
+    const uint32_t perFile = (REC_FILE_MAX_BYTES - sizeof(CanRecordHeader)) / sizeof(CanRecord);
+    TEST_ASSERT_TRUE(canRecorderStart());
+
+    for (uint32_t i = 0; i < perFile + 5; i++) {
+        canRecorderCapture(makeFrame(0x100 + (i & 0xFF), 0));
+        if (canRecorderGetBuffered() == REC_FLUSH_FRAMES) canRecorderFlush(false);
+    }
+    canRecorderStop();
+
+    const CanRecorderStats& st = canRecorderGetStats();
+    TEST_ASSERT_EQUAL_UINT32(perFile + 5, st.written);
+    TEST_ASSERT_EQUAL_UINT32(1, st.rotations);
+    TEST_ASSERT_EQUAL_UINT8(1, st.fileIndex);
+    TEST_ASSERT_EQUAL_UINT32(0, st.dropped);
+
+    File f = LittleFS.open(REC_FILE_0, "r");
+    TEST_ASSERT_TRUE(f.size() <= REC_FILE_MAX_BYTES);
+    f.close();
+
+    CanRecordHeader header;
+    f = LittleFS.open(REC_FILE_1, "r");
+    TEST_ASSERT_EQUAL(sizeof(header), f.read((uint8_t*)&header, sizeof(header)));
+    TEST_ASSERT_EQUAL_UINT16(1, header.sequence);
+    TEST_ASSERT_EQUAL(sizeof(header) + 5 * sizeof(CanRecord), f.size());
+    f.close();
+
+    CanRecord rec;
+    TEST_ASSERT_TRUE(readRecord(1, 0, rec));
+    TEST_ASSERT_EQUAL_HEX16(0x100 + (perFile & 0xFF), rec.id);
+}
+
+void test_start_refused_without_space() {
+    LittleFS.mockUsedBytes = LittleFS.mockTotalBytes - REC_FILE_MAX_BYTES;
+    TEST_ASSERT_FALSE(canRecorderStart());
+    TEST_ASSERT_NOT_NULL(canRecorderError());
+    TEST_ASSERT_EQUAL(CanRecorderState::IDLE, canRecorderGetState());
+
+    canRecorderCapture(makeFrame(0x100, 0));
+    TEST_ASSERT_EQUAL_UINT16(0, canRecorderGetBuffered());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_records_standard_frames_and_skips_extended);
+    RUN_TEST(test_filters_select_ids_by_mask);
+    RUN_TEST(test_trigger_id_starts_capture);
+    RUN_TEST(test_full_ring_counts_drops);
+    RUN_TEST(test_flush_writes_full_chunks_or_after_timeout);
+    RUN_TEST(test_full_file_rotates_to_other_file);
+    RUN_TEST(test_start_refused_without_space);
+
+    return UNITY_END();
+}
@@ -0,0 +1,3 @@
+// Include the recovery policy into this test build
+// (see test_vehicle_params/CanConfigProcessor_impl.cpp).
+#include "../../src/CanRecovery.cpp"
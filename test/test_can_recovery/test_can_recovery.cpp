@@ -0,0 +1,162 @@
+/**
+ * @file test_can_recovery.cpp
+ * @brief Unit tests for the bus-off / error-limit recovery policy
+ *
+ * Tests:
+ *   - a healthy bus needs no action
+ *   - bus-off: initiate recovery, start once STOPPED, downtime recorded
+ *   - bus-off recovery that never completes falls back to a reinstall
+ *   - error limit: reinstall, a failed reinstall is retried
+ *   - consecutive faults back off exponentially, then reboot
+ *   - a stable period resets the attempt count
+ *
+ * Run: pio test -e native
+ */
+
+#include <unity.h>
+#include "CanRecovery.h"
+
+#define ASSERT_ACTION(expected, actual) \
+    TEST_ASSERT_EQUAL_UINT8((uint8_t)CanRecoveryAction::expected, (uint8_t)(actual))
+
+static CanRecovery rec;
+static unsigned long now;
+
+/**
+ * @brief One health check, 100 ms (CAN_HEALTH_INTERVAL_MS) after the previous
+ */
+static CanRecoveryAction check(CanBusCondition condition, unsigned long stepMs = 100) {
+    now += stepMs;
+    return rec.update(now, condition);
+}
+
+/**
+ * @brief Bus-off cleared by recovery + restart, with no backoff wait
+ */
+static void busOffRecovered() {
+    ASSERT_ACTION(INITIATE_RECOVERY, check(CanBusCondition::BUS_OFF));
+    ASSERT_ACTION(START, check(CanBusCondition::STOPPED));
+    ASSERT_ACTION(NONE, check(CanBusCondition::OK));
+}
+
+void setUp() {
+    rec.reset();
+    now = 1000;
+}
+
+void tearDown() {}
+
+// =============================================================================
+// TESTS
+// =============================================================================
+
+void test_healthy_bus_no_action() {
+    for (int i = 0; i < 100; i++) {
+        ASSERT_ACTION(NONE, check(CanBusCondition::OK));
+    }
+    TEST_ASSERT_FALSE(rec.isRecovering());
+    TEST_ASSERT_EQUAL_UINT32(0, rec.getStats().busOffs);
+    TEST_ASSERT_EQUAL_UINT32(0, rec.getStats().recoveries);
+}
+
+void test_bus_off_recovery_and_downtime() {
+    ASSERT_ACTION(NONE, check(CanBusCondition::OK));
+    ASSERT_ACTION(INITIATE_RECOVERY, check(CanBusCondition::BUS_OFF));
+    TEST_ASSERT_TRUE(rec.isRecovering());
+
+    // 128 x 11 recessive bits take a few ms at 500 kbps: still under way
+    ASSERT_ACTION(NONE, check(CanBusCondition::RECOVERING));
+    ASSERT_ACTION(START, check(CanBusCondition::STOPPED));
+    ASSERT_ACTION(NONE, check(CanBusCondition::OK));
+    TEST_ASSERT_FALSE(rec.isRecovering());
+
+    const CanRecoveryStats& s = rec.getStats();
+    TEST_ASSERT_EQUAL_UINT32(1, s.busOffs);
+    TEST_ASSERT_EQUAL_UINT32(1, s.recoveries);
+    TEST_ASSERT_EQUAL_UINT32(0, s.failedAttempts);
+    TEST_ASSERT_EQUAL_UINT32(300, s.lastDowntimeMs);
+    TEST_ASSERT_EQUAL_UINT32(300, s.maxDowntimeMs);
+    TEST_ASSERT_EQUAL_UINT32(300, (uint32_t)s.totalDowntimeMs);
+}
+
+void test_stuck_bus_off_recovery_reinstalls() {
+    ASSERT_ACTION(INITIATE_RECOVERY, check(CanBusCondition::BUS_OFF));
+    for (unsigned long t = 100; t < CAN_RECOVERY_TIMEOUT_MS; t += 100) {
+        ASSERT_ACTION(NONE, check(CanBusCondition::RECOVERING));
+    }
+    ASSERT_ACTION(REINSTALL, check(CanBusCondition::RECOVERING));
+    ASSERT_ACTION(NONE, check(CanBusCondition::OK));
+    TEST_ASSERT_EQUAL_UINT32(1, rec.getStats().recoveries);
+    TEST_ASSERT_EQUAL_UINT32(CAN_RECOVERY_TIMEOUT_MS + 100, rec.getStats().lastDowntimeMs);
+}
+
+void test_error_limit_reinstalls_and_retries() {
+    ASSERT_ACTION(REINSTALL, check(CanBusCondition::ERROR_LIMIT));
+    TEST_ASSERT_EQUAL_UINT32(1, rec.getStats().errorLimits);
+
+    // Reinstall failed: retried after the second attempt's backoff
+    ASSERT_ACTION(NONE, check(CanBusCondition::OFFLINE));
+    TEST_ASSERT_EQUAL_UINT32(1, rec.getStats().failedAttempts);
+    TEST_ASSERT_EQUAL_UINT8(2, rec.getAttempts());
+    ASSERT_ACTION(REINSTALL, check(CanBusCondition::OFFLINE, CAN_RECOVERY_BACKOFF_MS));
+    ASSERT_ACTION(NONE, check(CanBusCondition::OK));
+
+    TEST_ASSERT_FALSE(rec.isRecovering());
+    TEST_ASSERT_EQUAL_UINT32(1, rec.getStats().recoveries);
+    TEST_ASSERT_EQUAL_UINT32(1, rec.getStats().errorLimits);    // One fault, two attempts
+}
+
+void test_backoff_doubles_then_reboots() {
+    TEST_ASSERT_EQUAL_UINT32(0, CanRecovery::backoffMs(1));
+    TEST_ASSERT_EQUAL_UINT32(CAN_RECOVERY_BACKOFF_MS, CanRecovery::backoffMs(2));
+    TEST_ASSERT_EQUAL_UINT32(CAN_RECOVERY_BACKOFF_MS * 2, CanRecovery::backoffMs(3));
+    TEST_ASSERT_EQUAL_UINT32(CAN_RECOVERY_BACKOFF_MS * 4, CanRecovery::backoffMs(4));
+    TEST_ASSERT_EQUAL_UINT32(CAN_RECOVERY_BACKOFF_MAX_MS, CanRecovery::backoffMs(20));
+
+    // Bus-off again right after every recovery
+    busOffRecovered();
+    for (uint8_t n = 2; n <= CAN_RECOVERY_MAX_ATTEMPTS; n++) {
+        ASSERT_ACTION(NONE, check(CanBusCondition::BUS_OFF));
+        TEST_ASSERT_EQUAL_UINT8(n, rec.getAttempts());
+        uint32_t wait = CanRecovery::backoffMs(n);
+        if (wait > 1) {
+            ASSERT_ACTION(NONE, check(CanBusCondition::BUS_OFF, wait - 1));
+            ASSERT_ACTION(INITIATE_RECOVERY, check(CanBusCondition::BUS_OFF, 1));
+        } else {
+            ASSERT_ACTION(INITIATE_RECOVERY, check(CanBusCondition::BUS_OFF, wait));
+        }
+        ASSERT_ACTION(START, check(CanBusCondition::STOPPED));
+        ASSERT_ACTION(NONE, check(CanBusCondition::OK));
+    }
+    TEST_ASSERT_EQUAL_UINT32(CAN_RECOVERY_MAX_ATTEMPTS, rec.getStats().recoveries);
+
+    ASSERT_ACTION(REBOOT, check(CanBusCondition::BUS_OFF));
+}
+
+void test_stable_bus_resets_attempts() {
+    busOffRecovered();
+    ASSERT_ACTION(NONE, check(CanBusCondition::BUS_OFF));     // Second fault: backoff
+    ASSERT_ACTION(INITIATE_RECOVERY, check(CanBusCondition::BUS_OFF, CAN_RECOVERY_BACKOFF_MS));
+    ASSERT_ACTION(START, check(CanBusCondition::STOPPED));
+    ASSERT_ACTION(NONE, check(CanBusCondition::OK));
+    TEST_ASSERT_EQUAL_UINT8(2, rec.getAttempts());
+
+    ASSERT_ACTION(NONE, check(CanBusCondition::OK, CAN_RECOVERY_STABLE_MS));
+    TEST_ASSERT_EQUAL_UINT8(0, rec.getAttempts());
+
+    // Next fault is a first attempt again: no wait
+    busOffRecovered();
+    TEST_ASSERT_EQUAL_UINT8(1, rec.getAttempts());
+    TEST_ASSERT_EQUAL_UINT32(3, rec.getStats().recoveries);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_healthy_bus_no_action);
+    RUN_TEST(test_bus_off_recovery_and_downtime);
+    RUN_TEST(test_stuck_bus_off_recovery_reinstalls);
+    RUN_TEST(test_error_limit_reinstalls_and_retries);
+    RUN_TEST(test_backoff_doubles_then_reboots);
+    RUN_TEST(test_stable_bus_resets_attempts);
+    return UNITY_END();
+}
@@ -0,0 +1,7 @@
+// Include the stream implementation and CRC32 into this test build
+// (see test_vehicle_params/CanConfigProcessor_impl.cpp).
+#include "../../src/crc32.cpp"
+#include "../../src/CanStream.cpp"
+
+// Arduino global (SerialClass is defined in the Arduino.h mock)
+SerialClass Serial;
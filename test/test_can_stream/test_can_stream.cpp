@@ -0,0 +1,176 @@
+/**
+ * @file test_can_stream.cpp
+ * @brief Unit tests for the LOG BIN stream (packet layout, filter, loss counters)
+ *
+ * Tests:
+ *   - packet framing, CRC, base time and delta-encoded records
+ *   - ID/mask filter and per-ID decimation
+ *   - ring overflow is reported in the packet's dropped counter
+ *   - a gap longer than 65 ms starts a new packet
+ *   - poll waits for a batch or CANSTREAM_FLUSH_MS, and for USB room
+ *
+ * Run: pio test -e native
+ */
+
+#include <unity.h>
+#include "CanStream.h"
+#include "crc32.h"
+
+static uint8_t buf[CANSTREAM_PACKET_MAX + BIN_OVERHEAD];
+
+static CanFrame makeFrame(uint16_t id, uint8_t dlc, uint8_t b0 = 0) {
+    CanFrame f = {};
+    f.identifier = id;
+    f.data_length_code = dlc;
+    for (uint8_t i = 0; i < dlc; i++) f.data[i] = b0 + i;
+    return f;
+}
+
+static uint16_t get16(const uint8_t* p) { return p[0] | (p[1] << 8); }
+static uint32_t get32(const uint8_t* p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+ * @brief Check framing and CRC; returns the payload
+ */
+static const uint8_t* checkFrame(const uint8_t* frame, size_t len, uint16_t seq) {
+    TEST_ASSERT_EQUAL_HEX8(BIN_MAGIC0, frame[0]);
+    TEST_ASSERT_EQUAL_HEX8(BIN_MAGIC1, frame[1]);
+    TEST_ASSERT_EQUAL_HEX8(BIN_CAN_LOG, frame[2]);
+    TEST_ASSERT_EQUAL_UINT16(seq, get16(&frame[3]));
+    uint16_t payloadLen = get16(&frame[5]);
+    TEST_ASSERT_EQUAL(BIN_OVERHEAD + payloadLen, len);
+    TEST_ASSERT_EQUAL_HEX32(crc32_le(0, &frame[2], 5 + payloadLen), get32(&frame[7 + payloadLen]));
+    return &frame[7];
+}
+
+void setUp() {
+    mockMillis = 1000;
+    Serial.txData.clear();
+    Serial.txRoom = 256;
+    canStreamStart();
+}
+
+void tearDown() {
+    canStreamStop();
+}
+
+void test_packet_layout_and_deltas() {
+    canStreamCapture(makeFrame(0x180, 8, 0x10));
+    mockMillis = 1002;
+    canStreamCapture(makeFrame(0x5C5, 2, 0x20));
+    CanFrame rtr = makeFrame(0x60D, 4);
+    rtr.rtr = 1;
+    canStreamCapture(rtr);
+
+    size_t len = canStreamBuildPacket(buf);
+    const uint8_t* p = checkFrame(buf, len, 0);
+
+    TEST_ASSERT_EQUAL_UINT32(1000000, get32(&p[0]));
+    TEST_ASSERT_EQUAL_UINT32(0, get32(&p[4]));
+    TEST_ASSERT_EQUAL_UINT16(3, get16(&p[8]));
+    TEST_ASSERT_EQUAL(CANSTREAM_HEADER_SIZE + 12 + 6 + 4, get16(&buf[5]));
+
+    const uint8_t* r = &p[CANSTREAM_HEADER_SIZE];
+    TEST_ASSERT_EQUAL_UINT16(0, get16(&r[0]));
+    TEST_ASSERT_EQUAL_HEX16(0x180 | (8 << 11), get16(&r[2]));
+    TEST_ASSERT_EQUAL_HEX8(0x17, r[11]);
+    r += 12;
+    TEST_ASSERT_EQUAL_UINT16(2000, get16(&r[0]));
+    TEST_ASSERT_EQUAL_HEX16(0x5C5 | (2 << 11), get16(&r[2]));
+    TEST_ASSERT_EQUAL_HEX8(0x21, r[5]);
+    r += 6;
+    TEST_ASSERT_EQUAL_UINT16(0, get16(&r[0]));
+    TEST_ASSERT_EQUAL_HEX16(0x60D | (4 << 11) | 0x8000, get16(&r[2]));
+
+    TEST_ASSERT_EQUAL_UINT16(0, canStreamGetBuffered());
+    TEST_ASSERT_EQUAL(0, canStreamBuildPacket(buf));
+}
+
+void test_filter_and_decimation() {
+    canStreamStart(0x180, 0x7F0, 3);
+    for (int i = 0; i < 6; i++) {
+        canStreamCapture(makeFrame(0x180, 8));
+        canStreamCapture(makeFrame(0x181, 8));
+        canStreamCapture(makeFrame(0x5C5, 8));
+    }
+    CanFrame ext = makeFrame(0x180, 8);
+    ext.extd = 1;
+    canStreamCapture(ext);
+
+    const CanStreamStats& st = canStreamGetStats();
+    TEST_ASSERT_EQUAL_UINT32(4, st.queued);      // 2 of 6 for each matching ID
+    TEST_ASSERT_EQUAL_UINT32(8, st.decimated);
+    TEST_ASSERT_EQUAL_UINT32(7, st.filtered);
+}
+
+void test_ring_overflow_reported_as_dropped() {
+    for (int i = 0; i < CANSTREAM_RING_FRAMES + 5; i++) {
+        canStreamCapture(makeFrame(0x100, 0));
+    }
+    TEST_ASSERT_EQUAL_UINT32(5, canStreamGetStats().dropped);
+    TEST_ASSERT_EQUAL_UINT16(CANSTREAM_RING_FRAMES, canStreamGetStats().ringHighWater);
+
+    size_t len = canStreamBuildPacket(buf);
+    const uint8_t* p = checkFrame(buf, len, 0);
+    TEST_ASSERT_EQUAL_UINT32(5, get32(&p[4]));
+    TEST_ASSERT_EQUAL_UINT16((CANSTREAM_PACKET_MAX - CANSTREAM_HEADER_SIZE) / 4, get16(&p[8]));
+
+    len = canStreamBuildPacket(buf);
+    checkFrame(buf, len, 1);
+}
+
+void test_long_gap_starts_new_packet() {
+    canStreamCapture(makeFrame(0x100, 1));
+    mockMillis += 70;   // 70000 us: does not fit a 16-bit delta
+    canStreamCapture(makeFrame(0x101, 1));
+
+    size_t len = canStreamBuildPacket(buf);
+    const uint8_t* p = checkFrame(buf, len, 0);
+    TEST_ASSERT_EQUAL_UINT16(1, get16(&p[8]));
+
+    len = canStreamBuildPacket(buf);
+    p = checkFrame(buf, len, 1);
+    TEST_ASSERT_EQUAL_UINT16(1, get16(&p[8]));
+    TEST_ASSERT_EQUAL_UINT32(1070000, get32(&p[0]));
+}
+
+void test_poll_batches_and_waits_for_usb_room() {
+    canStreamCapture(makeFrame(0x100, 8));
+    canStreamPoll();
+    TEST_ASSERT_EQUAL(0, Serial.txData.size());   // Batch not full, frame still fresh
+
+    mockMillis += CANSTREAM_FLUSH_MS;
+    Serial.txRoom = 10;
+    canStreamPoll();
+    TEST_ASSERT_EQUAL(0, Serial.txData.size());   // Built, no room for the whole packet
+    TEST_ASSERT_EQUAL_UINT32(0, canStreamGetStats().packets);
+
+    Serial.txRoom = 256;
+    canStreamPoll();
+    checkFrame((const uint8_t*)Serial.txData.data(), Serial.txData.size(), 0);
+    TEST_ASSERT_EQUAL_UINT32(1, canStreamGetStats().packets);
+    TEST_ASSERT_EQUAL_UINT32(1, canStreamGetStats().sent);
+    TEST_ASSERT_EQUAL_UINT32(Serial.txData.size(), canStreamGetStats().bytes);
+
+    // A full batch goes out at once
+    Serial.txData.clear();
+    for (int i = 0; i < CANSTREAM_PACKET_MAX / CANSTREAM_RECORD_MAX; i++) {
+        canStreamCapture(makeFrame(0x100, 8));
+    }
+    canStreamPoll();
+    checkFrame((const uint8_t*)Serial.txData.data(), Serial.txData.size(), 1);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_packet_layout_and_deltas);
+    RUN_TEST(test_filter_and_decimation);
+    RUN_TEST(test_ring_overflow_reported_as_dropped);
+    RUN_TEST(test_long_gap_starts_new_packet);
+    RUN_TEST(test_poll_batches_and_waits_for_usb_room);
+
+    return UNITY_END();
+}
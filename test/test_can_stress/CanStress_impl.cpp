@@ -0,0 +1,10 @@
+// Include the load generator, the mock bounds it encodes, the processor and
+// the shared native stubs into this test build
+// (see test_vehicle_params/CanConfigProcessor_impl.cpp).
+#include "../../src/CanStress.cpp"
+#include "../../src/MockDataGenerator.cpp"
+#include "../../src/CanConfigProcessor.cpp"
+#include "../../src/SignalFilter.cpp"
+#include "../test_vehicle_params/ConfigManager_stub.cpp"
+#include "../test_vehicle_params/GlobalData_stub.cpp"
+#include "../../src/crc32.cpp"
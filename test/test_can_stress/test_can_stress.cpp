@@ -0,0 +1,300 @@
+/**
+ * @file test_can_stress.cpp
+ * @brief Unit tests for CanStress (synthetic bus load through the processor)
+ *
+ * Tests:
+ *   - every profile ID is sent in turn, noise IDs are never profile IDs
+ *   - synthesized frames decode to values inside MockDataGenerator's bounds,
+ *     moving over time; flags sharing a status word all toggle
+ *   - below the handler's capacity nothing is lost, above it the RX queue
+ *     fills and the excess is counted as lost
+ *   - bursts arrive at line rate
+ *   - a sweep stops at the first lossy rate and reports the previous one
+ *
+ * Run: pio test -e native
+ */
+
+#include <unity.h>
+#include "CanStress.h"
+#include "CanDriver.h"
+#include "CanConfigProcessor.h"
+#include "MockDataGenerator.h"
+#include "ConfigManager_mock.h"
+#include "GlobalData.h"
+#include "LittleFS.h"
+
+static CanConfigProcessor proc;
+static CanStress stress;
+static uint32_t handled = 0;
+static uint32_t nowUs = 0;
+
+static void processHandler(CanFrame& frame) {
+    proc.processFrame(frame);
+    handled++;
+}
+
+static void countHandler(CanFrame& frame) {
+    (void)frame;
+    handled++;
+}
+
+/**
+ * @brief Run the simulated bus for ms, one service() call per millisecond
+ */
+static void runFor(uint32_t ms, CanStressHandler handler) {
+    for (uint32_t i = 0; i < ms && stress.isActive(); i++) {
+        nowUs += 1000;
+        stress.service(nowUs, handler);
+    }
+}
+
+static CanStressConfig load(uint32_t rate, uint16_t maxBatch = 0) {
+    CanStressConfig config = {};
+    config.rate = rate;
+    config.maxBatch = maxBatch;
+    return config;
+}
+
+void setUp() {
+    LittleFS.basePath = "data";
+    LittleFS.writable = false;
+    mockMillis = 1000;
+    handled = 0;
+    nowUs = 5000000;
+    TEST_ASSERT_TRUE(proc.loadFromJson("/NissanJukeF15.json"));
+}
+
+void tearDown() {
+    stress.end();
+}
+
+// =============================================================================
+// FRAME SYNTHESIS
+// =============================================================================
+
+void test_every_profile_id_in_turn() {
+    const VehicleProfile& profile = proc.getProfile();
+    TEST_ASSERT_TRUE(stress.begin(profile, load(1000), nowUs));
+
+    for (uint8_t round = 0; round < 2; round++) {
+        for (uint16_t i = 0; i < profile.frameCount; i++) {
+            CanFrame frame;
+            stress.nextFrame(frame, 0);
+            TEST_ASSERT_EQUAL_HEX32(profile.frames[i].canId, frame.identifier);
+            TEST_ASSERT_EQUAL_UINT8(8, frame.data_length_code);
+            TEST_ASSERT_FALSE(frame.extd);
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, stress.getStats().noise);
+}
+
+void test_noise_ids_are_not_decoded() {
+    CanStressConfig config = load(1000);
+    config.noisePct = 50;
+    TEST_ASSERT_TRUE(stress.begin(proc.getProfile(), config, nowUs));
+
+    uint32_t unknownBefore = proc.getUnknownFrames();
+    for (uint16_t i = 0; i < 1000; i++) {
+        CanFrame frame;
+        stress.nextFrame(frame, 0);
+        proc.processFrame(frame);
+    }
+    uint32_t noise = stress.getStats().noise;
+    TEST_ASSERT_UINT32_WITHIN(100, 500, noise);
+    TEST_ASSERT_EQUAL_UINT32(noise, proc.getUnknownFrames() - unknownBefore);
+}
+
+void test_decoded_values_stay_in_mock_bounds() {
+    const VehicleProfile& profile = proc.getProfile();
+    TEST_ASSERT_TRUE(stress.begin(profile, load(1000), nowUs));
+
+    uint16_t rpmMin = 0xFFFF, rpmMax = 0;
+    for (uint32_t t = 0; t <= 120000; t += 250) {
+        for (uint16_t i = 0; i < profile.frameCount; i++) {
+            CanFrame frame;
+            stress.nextFrame(frame, t);
+            processHandler(frame);
+        }
+        TEST_ASSERT_TRUE(engineRPM >= 800 && engineRPM <= 6000);
+        TEST_ASSERT_TRUE(vehicleSpeed <= 120);
+        TEST_ASSERT_TRUE(currentSteer >= -5400 && currentSteer <= 5400);
+        TEST_ASSERT_TRUE(tempExt >= 70 && tempExt <= 95);
+        TEST_ASSERT_TRUE(currentOdo >= 85000 && currentOdo <= 85100);
+        TEST_ASSERT_INT_WITHIN(1, 30, fuelLevel);          // Static: typical value
+        TEST_ASSERT_INT_WITHIN(1, 350, dteValue);
+        TEST_ASSERT_UINT16_WITHIN(45, 75, fuelConsumptionInst);
+        if (engineRPM < rpmMin) rpmMin = engineRPM;
+        if (engineRPM > rpmMax) rpmMax = engineRPM;
+    }
+    // Oscillates over the whole range (50 RPM per 50 ms)
+    TEST_ASSERT_EQUAL_UINT16(800, rpmMin);
+    TEST_ASSERT_EQUAL_UINT16(6000, rpmMax);
+}
+
+void test_flags_sharing_a_word_toggle() {
+    const VehicleProfile& profile = proc.getProfile();
+    TEST_ASSERT_TRUE(stress.begin(profile, load(1000), nowUs));
+
+    auto round = [&](uint32_t t) {
+        for (uint16_t i = 0; i < profile.frameCount; i++) {
+            CanFrame frame;
+            stress.nextFrame(frame, t);
+            processHandler(frame);
+        }
+    };
+
+    round(0);
+    TEST_ASSERT_EQUAL_HEX8(0, currentDoors);
+    TEST_ASSERT_FALSE(headlightsOn);
+
+    // Driver door after 3 s, passenger door 500 ms later (same status word)
+    round(3000);
+    TEST_ASSERT_EQUAL_HEX8(0x80, currentDoors);
+    round(3500);
+    TEST_ASSERT_EQUAL_HEX8(0xC0, currentDoors);
+
+    // Indicator blinks every 500 ms
+    lastLeftIndicatorTime = 0;
+    round(500);
+    TEST_ASSERT_EQUAL_UINT32(mockMillis, lastLeftIndicatorTime);
+}
+
+// =============================================================================
+// LOAD AND LOSS
+// =============================================================================
+
+void test_line_rate_is_full_bus_load() {
+    TEST_ASSERT_EQUAL_UINT32(4504, STRESS_LINE_RATE);
+    TEST_ASSERT_EQUAL_UINT8(100, CanStress::busLoadPct(STRESS_LINE_RATE));
+    TEST_ASSERT_EQUAL_UINT8(50, CanStress::busLoadPct(STRESS_LINE_RATE / 2));
+
+    // Rates above the bus are capped
+    TEST_ASSERT_TRUE(stress.begin(proc.getProfile(), load(100000), nowUs));
+    TEST_ASSERT_EQUAL_UINT32(STRESS_LINE_RATE, stress.getRate());
+}
+
+void test_rate_within_capacity_loses_nothing() {
+    TEST_ASSERT_TRUE(stress.begin(proc.getProfile(), load(2000), nowUs));
+    runFor(2000, processHandler);
+
+    const CanStressStats& st = stress.getStats();
+    TEST_ASSERT_EQUAL_UINT32(4000, st.offered);
+    TEST_ASSERT_EQUAL_UINT32(4000, st.handled);
+    TEST_ASSERT_EQUAL_UINT32(0, st.lost);
+    TEST_ASSERT_EQUAL_UINT32(2000, st.elapsedMs);
+    TEST_ASSERT_TRUE(st.queueHighWater <= 2);
+    TEST_ASSERT_EQUAL_UINT32(4000, handled);
+}
+
+void test_overload_fills_queue_then_loses() {
+    // Handler serves 1 frame per ms (1000 frames/s), bus offers 3000
+    TEST_ASSERT_TRUE(stress.begin(proc.getProfile(), load(3000, 1), nowUs));
+    runFor(1000, countHandler);
+
+    const CanStressStats& st = stress.getStats();
+    TEST_ASSERT_EQUAL_UINT32(3000, st.offered);
+    TEST_ASSERT_EQUAL_UINT32(1000, st.handled);
+    TEST_ASSERT_EQUAL_UINT16(CAN_RX_QUEUE_LEN, st.queueHighWater);
+    TEST_ASSERT_EQUAL_UINT32(CAN_RX_QUEUE_LEN - 1, stress.getBacklog());  // One handled since full
+    TEST_ASSERT_EQUAL_UINT32(3000 - 1000 - (CAN_RX_QUEUE_LEN - 1), st.lost);
+}
+
+void test_bursts_arrive_at_line_rate() {
+    CanStressConfig config = load(100);
+    config.burstFrames = 100;
+    config.burstPeriodMs = 1000;
+
+    // 32 frames per ms drain a line-rate burst as it comes
+    TEST_ASSERT_TRUE(stress.begin(proc.getProfile(), config, nowUs));
+    runFor(2500, countHandler);
+    const CanStressStats& st = stress.getStats();
+    TEST_ASSERT_EQUAL_UINT32(2, st.bursts);
+    TEST_ASSERT_EQUAL_UINT32(0, st.lost);
+    TEST_ASSERT_UINT32_WITHIN(10, 250 + 200, st.offered);
+    TEST_ASSERT_TRUE(st.queueHighWater >= 4);       // 4.5 frames per ms
+
+    // 1 frame per ms: the queue overflows halfway through each burst
+    config.maxBatch = 1;
+    TEST_ASSERT_TRUE(stress.begin(proc.getProfile(), config, nowUs));
+    runFor(1500, countHandler);
+    TEST_ASSERT_EQUAL_UINT32(1, stress.getStats().bursts);
+    TEST_ASSERT_TRUE(stress.getStats().lost > 0);
+    TEST_ASSERT_TRUE(stress.getStats().lost < 100 - CAN_RX_QUEUE_LEN);
+}
+
+void test_duration_ends_the_run() {
+    CanStressConfig config = load(1000);
+    config.durationMs = 500;
+    TEST_ASSERT_TRUE(stress.begin(proc.getProfile(), config, nowUs));
+    runFor(499, countHandler);
+    TEST_ASSERT_TRUE(stress.isActive());
+    runFor(10, countHandler);
+    TEST_ASSERT_FALSE(stress.isActive());
+    TEST_ASSERT_TRUE(stress.isFinished());
+    TEST_ASSERT_EQUAL_UINT32(500, stress.getStats().offered);
+
+    // Counters stay after the run, service() does nothing
+    TEST_ASSERT_EQUAL_UINT16(0, stress.service(nowUs + 1000000, countHandler));
+    TEST_ASSERT_EQUAL_UINT32(500, stress.getStats().offered);
+}
+
+void test_sweep_reports_max_sustainable_rate() {
+    // Handler capacity: 3 frames per ms = 3000 frames/s
+    TEST_ASSERT_TRUE(stress.begin(proc.getProfile(), load(0, 3), nowUs));
+    TEST_ASSERT_TRUE(stress.isSweep());
+    TEST_ASSERT_EQUAL_UINT32(STRESS_LINE_RATE / 10, stress.getRate());
+
+    runFor(STRESS_SWEEP_STEPS * STRESS_SWEEP_STEP_MS + 10, countHandler);
+    TEST_ASSERT_FALSE(stress.isActive());
+    TEST_ASSERT_TRUE(stress.isFinished());
+
+    // 10%..60% (2702 frames/s) clean, 70% (3152) loses frames and ends it
+    TEST_ASSERT_EQUAL_UINT8(7, stress.getStepCount());
+    for (uint8_t i = 0; i < 6; i++) {
+        TEST_ASSERT_EQUAL_UINT32(0, stress.getStep(i).lost);
+    }
+    TEST_ASSERT_EQUAL_UINT32(3152, stress.getStep(6).rate);
+    TEST_ASSERT_TRUE(stress.getStep(6).lost > 0);
+    TEST_ASSERT_EQUAL_UINT32(2702, stress.getMaxSustainedRate());
+    TEST_ASSERT_EQUAL_UINT8(60, CanStress::busLoadPct(stress.getMaxSustainedRate()));
+}
+
+void test_sweep_can_sustain_full_bus() {
+    TEST_ASSERT_TRUE(stress.begin(proc.getProfile(), load(0), nowUs));
+    runFor(STRESS_SWEEP_STEPS * STRESS_SWEEP_STEP_MS + 10, countHandler);
+    TEST_ASSERT_TRUE(stress.isFinished());
+    TEST_ASSERT_EQUAL_UINT8(STRESS_SWEEP_STEPS, stress.getStepCount());
+    TEST_ASSERT_EQUAL_UINT32(STRESS_LINE_RATE, stress.getMaxSustainedRate());
+    TEST_ASSERT_EQUAL_UINT32(0, stress.getStats().lost);
+}
+
+void test_profile_without_frames_is_rejected() {
+    VehicleProfile empty;
+    memset(&empty, 0, sizeof(empty));
+    TEST_ASSERT_FALSE(stress.begin(empty, load(1000), nowUs));
+    TEST_ASSERT_FALSE(stress.isActive());
+
+    // No device task on the host
+    TEST_ASSERT_FALSE(stress.start(proc.getProfile(), load(1000)));
+}
+
+// =============================================================================
+// MAIN
+// =============================================================================
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_every_profile_id_in_turn);
+    RUN_TEST(test_noise_ids_are_not_decoded);
+    RUN_TEST(test_decoded_values_stay_in_mock_bounds);
+    RUN_TEST(test_flags_sharing_a_word_toggle);
+    RUN_TEST(test_line_rate_is_full_bus_load);
+    RUN_TEST(test_rate_within_capacity_loses_nothing);
+    RUN_TEST(test_overload_fills_queue_then_loses);
+    RUN_TEST(test_bursts_arrive_at_line_rate);
+    RUN_TEST(test_duration_ends_the_run);
+    RUN_TEST(test_sweep_reports_max_sustainable_rate);
+    RUN_TEST(test_sweep_can_sustain_full_bus);
+    RUN_TEST(test_profile_without_frames_is_rejected);
+    return UNITY_END();
+}
@@ -0,0 +1,4 @@
+// Include the NVS persistence into this test build (Preferences is mocked)
+// (see test_vehicle_params/CanConfigProcessor_impl.cpp).
+#include "../../src/ConfigManager.cpp"
+#include "../../src/crc32.cpp"
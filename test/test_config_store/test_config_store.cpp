@@ -0,0 +1,199 @@
+/**
+ * @file test_config_store.cpp
+ * @brief Unit tests for the deferred, coalesced NVS persistence of ConfigManager
+ *
+ * Tests:
+ *   - first boot: defaults, nothing written
+ *   - saves in short succession cost one write, after the quiet period
+ *   - continuous saves are still written after the maximum delay
+ *   - the blob restores calibration and vehicle file; a corrupted one is ignored
+ *   - settings of the per-key firmware are migrated and their keys erased
+ *   - a flush with nothing changed does not write
+ *   - the vehicle file is saved without unsaved calibration
+ *   - a failed write stays pending and is retried
+ *
+ * Run: pio test -e native
+ */
+
+#include <unity.h>
+#include <Arduino.h>
+#include <Preferences.h>
+#include "ConfigManager.h"
+
+/**
+ * @brief Advance the clock and run one loop() poll
+ */
+static void pollAfter(unsigned long ms) {
+    mockMillis += ms;
+    configPoll();
+}
+
+void setUp() {
+    mockNvsReset();
+    mockMillis = 1000;
+    configInit();
+}
+
+void tearDown() {}
+
+// =============================================================================
+// BOOT
+// =============================================================================
+
+void test_first_boot_uses_defaults_without_writing() {
+    TEST_ASSERT_EQUAL_UINT16(DEFAULT_STEER_SCALE, configGetSteerScale());
+    TEST_ASSERT_EQUAL_STRING("", configGetVehicleFile());
+    TEST_ASSERT_FALSE(configIsPending());
+    TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, configMsUntilFlush());
+    TEST_ASSERT_FALSE(configGetStoreStats().bootFromBlob);
+
+    pollAfter(60000);
+    TEST_ASSERT_EQUAL_UINT32(0, mockNvsWrites);
+}
+
+void test_blob_restores_config_and_vehicle_file() {
+    configSetSteerScale(512);
+    configSetTankCapacity(60);
+    configSave();
+    configSetVehicleFile("NissanJukeF15.json");
+    TEST_ASSERT_TRUE(configFlush());
+
+    configInit();
+    TEST_ASSERT_TRUE(configGetStoreStats().bootFromBlob);
+    TEST_ASSERT_FALSE(configIsPending());
+    TEST_ASSERT_EQUAL_UINT16(512, configGetSteerScale());
+    TEST_ASSERT_EQUAL_UINT8(60, configGetTankCapacity());
+    TEST_ASSERT_EQUAL_STRING("NissanJukeF15.json", configGetVehicleFile());
+}
+
+void test_corrupted_blob_falls_back_to_defaults() {
+    configSetSteerScale(512);
+    configSave();
+    configFlush();
+    mockNvs["config"][10] ^= 0x01;
+
+    configInit();
+    TEST_ASSERT_FALSE(configGetStoreStats().bootFromBlob);
+    TEST_ASSERT_EQUAL_UINT16(DEFAULT_STEER_SCALE, configGetSteerScale());
+}
+
+void test_legacy_keys_are_migrated_to_the_blob() {
+    Preferences old;
+    old.begin("canbox", false);
+    old.putUShort("steerScale", 777);
+    old.putBool("steerInvert", false);
+    old.putString("vehicleFile", "Old.json");
+    old.end();
+
+    configInit();
+    TEST_ASSERT_EQUAL_UINT16(777, configGetSteerScale());
+    TEST_ASSERT_FALSE(configGetSteerInvert());
+    TEST_ASSERT_EQUAL_STRING("Old.json", configGetVehicleFile());
+    TEST_ASSERT_TRUE(configIsPending());
+
+    pollAfter(CONFIG_FLUSH_QUIET_MS);
+    TEST_ASSERT_FALSE(configIsPending());
+    TEST_ASSERT_EQUAL_size_t(1, mockNvs.size());     // Old keys erased
+    TEST_ASSERT_EQUAL(1, (int)mockNvs.count("config"));
+
+    configInit();
+    TEST_ASSERT_TRUE(configGetStoreStats().bootFromBlob);
+    TEST_ASSERT_EQUAL_UINT16(777, configGetSteerScale());
+    TEST_ASSERT_EQUAL_STRING("Old.json", configGetVehicleFile());
+}
+
+// =============================================================================
+// COALESCING
+// =============================================================================
+
+void test_vehicle_switch_costs_one_write() {
+    // configReset() + vehicleParams + configSave() + configSetVehicleFile()
+    configReset();
+    configSetSteerScale(300);
+    configSave();
+    configSetVehicleFile("NissanJukeF15.json");
+    TEST_ASSERT_EQUAL_UINT32(0, mockNvsWrites);
+    TEST_ASSERT_EQUAL_UINT32(CONFIG_FLUSH_QUIET_MS, configMsUntilFlush());
+
+    pollAfter(CONFIG_FLUSH_QUIET_MS - 1);
+    TEST_ASSERT_EQUAL_UINT32(0, mockNvsWrites);
+    pollAfter(1);
+    TEST_ASSERT_EQUAL_UINT32(1, mockNvsWrites);
+
+    const ConfigStoreStats& stats = configGetStoreStats();
+    TEST_ASSERT_EQUAL_UINT32(3, stats.saves);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.writes);
+    TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, configMsUntilFlush());
+}
+
+void test_continuous_saves_written_after_max_delay() {
+    unsigned long elapsed = 0;
+    while (mockNvsWrites == 0) {
+        configSetSteerOffset((int16_t)elapsed);
+        configSave();
+        pollAfter(CONFIG_FLUSH_QUIET_MS / 2);
+        elapsed += CONFIG_FLUSH_QUIET_MS / 2;
+        TEST_ASSERT_TRUE(elapsed <= CONFIG_FLUSH_MAX_DELAY_MS);
+    }
+    TEST_ASSERT_EQUAL_UINT32(CONFIG_FLUSH_MAX_DELAY_MS, elapsed);
+}
+
+void test_flush_without_changes_does_not_write() {
+    configSetSteerScale(512);
+    configSave();
+    configFlush();
+    uint32_t writes = mockNvsWrites;
+
+    // Same values saved again (CFG SAVE twice, same vehicle reloaded)
+    configSave();
+    configSetVehicleFile("");
+    pollAfter(CONFIG_FLUSH_QUIET_MS);
+    TEST_ASSERT_EQUAL_UINT32(writes, mockNvsWrites);
+    TEST_ASSERT_EQUAL_UINT32(1, configGetStoreStats().unchanged);
+    TEST_ASSERT_FALSE(configIsPending());
+}
+
+void test_vehicle_file_saved_without_unsaved_calibration() {
+    configSetSteerScale(999);      // CFG SET, no CFG SAVE
+    configSetVehicleFile("MockDemo.json");
+    configFlush();
+
+    configInit();
+    TEST_ASSERT_EQUAL_UINT16(DEFAULT_STEER_SCALE, configGetSteerScale());
+    TEST_ASSERT_EQUAL_STRING("MockDemo.json", configGetVehicleFile());
+}
+
+void test_failed_write_is_retried() {
+    configSetSteerScale(512);
+    configSave();
+    mockNvsFail = true;
+    TEST_ASSERT_FALSE(configFlush());
+    TEST_ASSERT_TRUE(configIsPending());
+    TEST_ASSERT_EQUAL_UINT32(1, configGetStoreStats().failures);
+
+    mockNvsFail = false;
+    pollAfter(CONFIG_FLUSH_QUIET_MS);
+    TEST_ASSERT_FALSE(configIsPending());
+    TEST_ASSERT_EQUAL_UINT32(1, configGetStoreStats().writes);
+
+    configInit();
+    TEST_ASSERT_EQUAL_UINT16(512, configGetSteerScale());
+}
+
+// =============================================================================
+// MAIN
+// =============================================================================
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_first_boot_uses_defaults_without_writing);
+    RUN_TEST(test_blob_restores_config_and_vehicle_file);
+    RUN_TEST(test_corrupted_blob_falls_back_to_defaults);
+    RUN_TEST(test_legacy_keys_are_migrated_to_the_blob);
+    RUN_TEST(test_vehicle_switch_costs_one_write);
+    RUN_TEST(test_continuous_saves_written_after_max_delay);
+    RUN_TEST(test_flush_without_changes_does_not_write);
+    RUN_TEST(test_vehicle_file_saved_without_unsaved_calibration);
+    RUN_TEST(test_failed_write_is_retried);
+    return UNITY_END();
+}
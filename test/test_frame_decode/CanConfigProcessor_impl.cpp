@@ -0,0 +1,7 @@
+// Include CanConfigProcessor implementation and the shared native stubs into
+// this test build (see test_vehicle_params/CanConfigProcessor_impl.cpp).
+#include "../../src/CanConfigProcessor.cpp"
+#include "../../src/SignalFilter.cpp"
+#include "../test_vehicle_params/ConfigManager_stub.cpp"
+#include "../test_vehicle_params/GlobalData_stub.cpp"
+#include "../../src/crc32.cpp"
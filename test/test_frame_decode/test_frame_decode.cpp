@@ -0,0 +1,768 @@
+/**
+ * @file test_frame_decode.cpp
+ * @brief Unit tests for CanConfigProcessor frame lookup and decoding
+ *
+ * Loads the shipped data/NissanJukeF15.json profile through the LittleFS mock
+ * and feeds hand-built frames through processFrame().
+ *
+ * Run: pio test -e native
+ */
+
+#include <unity.h>
+#include "CanConfigProcessor.h"
+#include "ConfigManager_mock.h"
+#include "GlobalData.h"
+#include "LittleFS.h"
+#include "FixtureSupport.h"
+
+static CanConfigProcessor proc;
+
+static CanFrame makeFrame(uint32_t id, const uint8_t* data, uint8_t len, bool extd = false) {
+    CanFrame frame = {};
+    frame.identifier = id;
+    frame.data_length_code = len;
+    frame.extd = extd;
+    memcpy(frame.data, data, len);
+    return frame;
+}
+
+// Copy of every GlobalData field written by the decoders
+struct DecodedState {
+    int16_t steer; uint16_t rpm; uint8_t speed, doors, fuel; float volt;
+    int16_t dte; int8_t temp; uint32_t odo; bool head, high, park;
+    unsigned long leftTime, rightTime; uint16_t consInst, consAvg;
+};
+
+static DecodedState captureState() {
+    return { currentSteer, engineRPM, vehicleSpeed, currentDoors, fuelLevel, voltBat,
+             dteValue, tempExt, currentOdo, headlightsOn, highBeamOn, parkingLightsOn,
+             lastLeftIndicatorTime, lastRightIndicatorTime, fuelConsumptionInst, fuelConsumptionAvg };
+}
+
+static void clearState(uint8_t doors) {
+    currentSteer = 0; engineRPM = 0; vehicleSpeed = 0; currentDoors = doors; fuelLevel = 0;
+    voltBat = 0.0f; dteValue = 0; tempExt = 0; currentOdo = 0;
+    headlightsOn = highBeamOn = parkingLightsOn = false;
+    lastLeftIndicatorTime = lastRightIndicatorTime = 0;
+    fuelConsumptionInst = fuelConsumptionAvg = 0;
+}
+
+static void assertStateEqual(const DecodedState& a, const DecodedState& b) {
+    TEST_ASSERT_EQUAL_INT16(a.steer, b.steer);
+    TEST_ASSERT_EQUAL_UINT16(a.rpm, b.rpm);
+    TEST_ASSERT_EQUAL_UINT8(a.speed, b.speed);
+    TEST_ASSERT_EQUAL_HEX8(a.doors, b.doors);
+    TEST_ASSERT_EQUAL_UINT8(a.fuel, b.fuel);
+    TEST_ASSERT_EQUAL_FLOAT(a.volt, b.volt);
+    TEST_ASSERT_EQUAL_INT16(a.dte, b.dte);
+    TEST_ASSERT_EQUAL_INT8(a.temp, b.temp);
+    TEST_ASSERT_EQUAL_UINT32(a.odo, b.odo);
+    TEST_ASSERT_EQUAL(a.head, b.head);
+    TEST_ASSERT_EQUAL(a.high, b.high);
+    TEST_ASSERT_EQUAL(a.park, b.park);
+    TEST_ASSERT_EQUAL_UINT32(a.leftTime, b.leftTime);
+    TEST_ASSERT_EQUAL_UINT32(a.rightTime, b.rightTime);
+    TEST_ASSERT_EQUAL_UINT16(a.consInst, b.consInst);
+    TEST_ASSERT_EQUAL_UINT16(a.consAvg, b.consAvg);
+}
+
+// Feed pseudo-random payloads through both decode paths and compare results
+static void checkCompiledMatchesReference(CanConfigProcessor& p, const uint16_t* ids, size_t count) {
+    uint32_t seed = 0x12345678;
+    for (int round = 0; round < 200; round++) {
+        uint8_t data[8];
+        for (uint8_t& b : data) {
+            seed = seed * 1664525u + 1013904223u;
+            b = (uint8_t)(seed >> 24);
+        }
+        uint8_t doors = data[7] & 0xF8;
+
+        for (size_t i = 0; i < count; i++) {
+            CanFrame frame = makeFrame(ids[i], data, 8);
+
+            clearState(doors);
+            TEST_ASSERT_TRUE(p.processFrameReference(frame));
+            DecodedState expected = captureState();
+
+            clearState(doors);
+            TEST_ASSERT_TRUE(p.processFrame(frame));
+            assertStateEqual(expected, captureState());
+        }
+    }
+}
+
+void setUp() {
+    mockReset();
+    LittleFS.basePath = "data";
+    proc = CanConfigProcessor();
+    proc.loadFromJson("/NissanJukeF15.json");
+}
+
+void tearDown() {
+    LittleFS.basePath = "test/fixtures";
+    LittleFS.writable = false;
+}
+
+// =============================================================================
+// DISPATCH TABLE
+// =============================================================================
+
+void test_dispatch_indexes_all_profile_ids() {
+    TEST_ASSERT_EQUAL_UINT16(9, proc.getDispatchIdCount());
+    TEST_ASSERT_EQUAL_size_t(CAN_DISPATCH_SIZE, proc.getDispatchMemory());
+}
+
+void test_unknown_id_is_rejected_and_counted() {
+    const uint8_t data[8] = {0};
+    CanFrame frame = makeFrame(0x123, data, 8);
+
+    TEST_ASSERT_FALSE(proc.processFrame(frame));
+    TEST_ASSERT_EQUAL_UINT32(1, proc.getUnknownFrames());
+    TEST_ASSERT_EQUAL_UINT32(0, proc.getFramesProcessed());
+}
+
+void test_extended_id_never_matches_standard_entry() {
+    const uint8_t data[8] = {0x44, 0x5C};
+    CanFrame frame = makeFrame(0x180, data, 8, true);
+
+    TEST_ASSERT_FALSE(proc.processFrame(frame));
+    TEST_ASSERT_EQUAL_UINT32(1, proc.getUnknownFrames());
+}
+
+void test_id_above_11_bits_is_rejected() {
+    const uint8_t data[8] = {0x44, 0x5C};
+    CanFrame frame = makeFrame(0x10180, data, 8);
+
+    TEST_ASSERT_FALSE(proc.processFrame(frame));
+}
+
+// =============================================================================
+// HARDWARE ACCEPTANCE FILTER
+// =============================================================================
+
+void test_filter_accepts_every_profile_id() {
+    static const uint16_t ids[] = {0x002, 0x180, 0x284, 0x5C5, 0x6F6, 0x551, 0x60D, 0x54C, 0x580};
+    CanAcceptanceFilter filter = proc.computeAcceptanceFilter();
+
+    for (uint16_t id : ids) {
+        TEST_ASSERT_TRUE(CanConfigProcessor::filterAccepts(filter, id));
+    }
+}
+
+void test_filter_accepted_count_is_exact_and_tight() {
+    CanAcceptanceFilter filter = proc.computeAcceptanceFilter();
+
+    uint16_t passing = 0;
+    for (uint16_t id = 0; id < CAN_DISPATCH_SIZE; id++) {
+        if (CanConfigProcessor::filterAccepts(filter, id)) passing++;
+    }
+    TEST_ASSERT_EQUAL_UINT16(filter.acceptedIds, passing);
+    // A single filter over the Juke IDs would accept all 2048 IDs
+    TEST_ASSERT_FALSE(filter.singleFilter);
+    TEST_ASSERT_LESS_THAN_UINT16(CAN_DISPATCH_SIZE, filter.acceptedIds);
+}
+
+void test_filter_dual_layout_ignores_data_bits() {
+    CanAcceptanceFilter filter = proc.computeAcceptanceFilter();
+
+    // RTR/data nibble bits must be "don't care" in both halves
+    TEST_ASSERT_EQUAL_HEX32(0x001F001F, filter.mask & 0x001F001F);
+}
+
+void test_filter_single_id_is_exact() {
+    CanConfigProcessor single;
+    LittleFS.basePath = "test/fixtures";
+    TEST_ASSERT_TRUE(single.loadFromJson("/full_params.json"));  // only 0x002
+
+    CanAcceptanceFilter filter = single.computeAcceptanceFilter();
+    TEST_ASSERT_TRUE(filter.singleFilter);
+    TEST_ASSERT_EQUAL_UINT16(1, filter.acceptedIds);
+    TEST_ASSERT_EQUAL_HEX32(0x002u << 21, filter.code);
+    TEST_ASSERT_EQUAL_HEX32(0x001FFFFF, filter.mask);
+}
+
+void test_filter_empty_profile_accepts_all() {
+    CanConfigProcessor empty;
+    CanAcceptanceFilter filter = empty.computeAcceptanceFilter();
+
+    TEST_ASSERT_TRUE(filter.singleFilter);
+    TEST_ASSERT_EQUAL_HEX32(0xFFFFFFFF, filter.mask);
+    TEST_ASSERT_EQUAL_UINT16(CAN_DISPATCH_SIZE, filter.acceptedIds);
+}
+
+// =============================================================================
+// PROFILE LOADING
+// =============================================================================
+
+void test_load_streams_only_top_level_frames() {
+    // "frames" also appears as a string, inside a key and in a nested object
+    CanConfigProcessor layout;
+    LittleFS.basePath = "test/fixtures";
+    TEST_ASSERT_TRUE(layout.loadFromJson("/stream_layout.json"));
+
+    TEST_ASSERT_EQUAL_STRING("Layout \"frames\" test", layout.getProfileName());
+    TEST_ASSERT_FALSE(layout.isMockMode());
+    TEST_ASSERT_EQUAL_UINT16(3, layout.getDispatchIdCount());
+    TEST_ASSERT_EQUAL_UINT16(2, layout.getCompiledFieldCount());
+
+    const uint8_t rpm[] = { 0x1E, 0x0A };  // 7690 / 7 = 1098
+    TEST_ASSERT_TRUE(layout.processFrame(makeFrame(0x180, rpm, 2)));
+    TEST_ASSERT_EQUAL_UINT16(1098, engineRPM);
+
+    const uint8_t any[] = { 0 };
+    TEST_ASSERT_FALSE(layout.processFrame(makeFrame(0x7FF, any, 1)));
+}
+
+void test_parse_error_keeps_current_profile() {
+    uint16_t ids = proc.getDispatchIdCount();
+    uint16_t fields = proc.getCompiledFieldCount();
+
+    LittleFS.basePath = "test/fixtures";
+    TEST_ASSERT_FALSE(proc.loadFromJson("/broken_frames.json"));
+
+    TEST_ASSERT_EQUAL_STRING("Nissan Juke F15", proc.getProfileName());
+    TEST_ASSERT_EQUAL_UINT16(ids, proc.getDispatchIdCount());
+    TEST_ASSERT_EQUAL_UINT16(fields, proc.getCompiledFieldCount());
+
+    const uint8_t data[] = { 0x1E, 0x0A, 0, 0, 0, 0, 0, 0 };
+    TEST_ASSERT_TRUE(proc.processFrame(makeFrame(0x180, data, 8)));
+}
+
+void test_profile_arena_holds_frames_in_order() {
+    // Juke: 9 frames, 20 fields, stored back to back after the name
+    TEST_ASSERT_EQUAL_UINT16(9, proc.getProfileFrameCount());
+    TEST_ASSERT_EQUAL_UINT16(20, proc.getProfileFieldCount());
+    TEST_ASSERT_EQUAL_UINT32(PROFILE_NAME_SIZE + 9 * sizeof(FrameConfig) + 20 * sizeof(FieldConfig),
+                             proc.getProfileBytesUsed());
+
+    // Reload reuses the arena
+    size_t memory = proc.getProfileMemory();
+    TEST_ASSERT_TRUE(proc.loadFromJson("/NissanJukeF15.json"));
+    TEST_ASSERT_EQUAL_UINT16(20, proc.getProfileFieldCount());
+    TEST_ASSERT_EQUAL_UINT32(memory, proc.getProfileMemory());
+}
+
+void test_oversized_profile_is_rejected() {
+    // 65 frames / 130 fields: above PROFILE_MAX_FRAMES and PROFILE_MAX_FIELDS
+    LittleFS.basePath = "test/fixtures";
+    TEST_ASSERT_FALSE(proc.loadFromJson("/oversized_profile.json"));
+
+    TEST_ASSERT_EQUAL_STRING("Nissan Juke F15", proc.getProfileName());
+    TEST_ASSERT_EQUAL_UINT16(9, proc.getProfileFrameCount());
+    const uint8_t data[] = { 0x1E, 0x0A, 0, 0, 0, 0, 0, 0 };
+    TEST_ASSERT_TRUE(proc.processFrame(makeFrame(0x180, data, 8)));
+}
+
+void test_swap_replaces_profile_between_frames() {
+    const uint8_t any[] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+    uint32_t swaps = proc.getSwapStats().swaps;
+    TEST_ASSERT_TRUE(proc.processFrame(makeFrame(0x5C5, any, 8)));
+
+    LittleFS.basePath = "test/fixtures";
+    TEST_ASSERT_TRUE(proc.loadFromJson("/stream_layout.json"));
+    TEST_ASSERT_EQUAL_UINT32(swaps + 1, proc.getSwapStats().swaps);
+    TEST_ASSERT_EQUAL_UINT32(0, proc.getSwapStats().framesDuringBuild);
+
+    // Next frame uses the new bank only
+    TEST_ASSERT_FALSE(proc.processFrame(makeFrame(0x5C5, any, 8)));
+    const uint8_t rpm[] = { 0x1E, 0x0A };
+    TEST_ASSERT_TRUE(proc.processFrame(makeFrame(0x180, rpm, 2)));
+    TEST_ASSERT_EQUAL_UINT16(1098, engineRPM);
+
+    // Swapping back reuses the first bank
+    LittleFS.basePath = "data";
+    TEST_ASSERT_TRUE(proc.loadFromJson("/NissanJukeF15.json"));
+    TEST_ASSERT_EQUAL_UINT32(swaps + 2, proc.getSwapStats().swaps);
+    TEST_ASSERT_TRUE(proc.processFrame(makeFrame(0x5C5, any, 8)));
+    TEST_ASSERT_EQUAL_UINT16(9, proc.getDispatchIdCount());
+}
+
+void test_failed_load_does_not_swap() {
+    uint32_t swaps = proc.getSwapStats().swaps;
+    LittleFS.basePath = "test/fixtures";
+    TEST_ASSERT_FALSE(proc.loadFromJson("/broken_frames.json"));
+    TEST_ASSERT_FALSE(proc.loadFromJson("/oversized_profile.json"));
+    TEST_ASSERT_FALSE(proc.loadFromJson("/empty_frames.json"));
+    TEST_ASSERT_EQUAL_UINT32(swaps, proc.getSwapStats().swaps);
+    TEST_ASSERT_EQUAL_STRING("Nissan Juke F15", proc.getProfileName());
+}
+
+// =============================================================================
+// COMPILED PROFILE CACHE
+// =============================================================================
+
+void test_cache_restores_identical_profile() {
+    static const uint16_t ids[] = {0x100, 0x101, 0x102, 0x103, 0x104, 0x105};
+    LittleFS.basePath = "test/fixtures";
+    LittleFS.writable = true;
+    copyFixture("decoder_shapes.json", "cache_tmp.json");
+
+    CanConfigProcessor parsed;
+    TEST_ASSERT_TRUE(parsed.loadFromJson("/cache_tmp.json"));
+    TEST_ASSERT_FALSE(parsed.isLoadedFromCache());
+    TEST_ASSERT_TRUE(LittleFS.exists("/cache_tmp.pcache"));
+
+    CanConfigProcessor cached;
+    TEST_ASSERT_TRUE(cached.loadFromCache("/cache_tmp.json"));
+    TEST_ASSERT_TRUE(cached.isLoadedFromCache());
+    TEST_ASSERT_EQUAL_STRING(parsed.getProfileName(), cached.getProfileName());
+    TEST_ASSERT_EQUAL(parsed.isMockMode(), cached.isMockMode());
+    TEST_ASSERT_EQUAL_UINT16(parsed.getDispatchIdCount(), cached.getDispatchIdCount());
+    TEST_ASSERT_EQUAL_UINT16(parsed.getCompiledFieldCount(), cached.getCompiledFieldCount());
+    TEST_ASSERT_EQUAL_UINT16(parsed.getSpecializedFieldCount(), cached.getSpecializedFieldCount());
+    TEST_ASSERT_EQUAL_UINT16(parsed.getSharedWordGroupCount(), cached.getSharedWordGroupCount());
+    checkCompiledMatchesReference(cached, ids, sizeof(ids) / sizeof(ids[0]));
+
+    LittleFS.remove("/cache_tmp.pcache");
+    LittleFS.remove("/cache_tmp.json");
+}
+
+void test_cache_rejected_after_json_change() {
+    LittleFS.basePath = "test/fixtures";
+    LittleFS.writable = true;
+    copyFixture("decoder_shapes.json", "cache_tmp.json");
+
+    CanConfigProcessor parsed;
+    TEST_ASSERT_TRUE(parsed.loadFromJson("/cache_tmp.json"));
+
+    // Same size, one byte different
+    FILE* fp = fopen("test/fixtures/cache_tmp.json", "r+b");
+    TEST_ASSERT_NOT_NULL(fp);
+    fseek(fp, 12, SEEK_SET);
+    fputc('d', fp);
+    fclose(fp);
+
+    CanConfigProcessor cached;
+    TEST_ASSERT_FALSE(cached.loadFromCache("/cache_tmp.json"));
+    TEST_ASSERT_FALSE(cached.isLoadedFromCache());
+
+    LittleFS.remove("/cache_tmp.pcache");
+    LittleFS.remove("/cache_tmp.json");
+}
+
+void test_cache_rejected_when_corrupted() {
+    LittleFS.basePath = "test/fixtures";
+    LittleFS.writable = true;
+    copyFixture("decoder_shapes.json", "cache_tmp.json");
+
+    CanConfigProcessor parsed;
+    TEST_ASSERT_TRUE(parsed.loadFromJson("/cache_tmp.json"));
+
+    // Flip a byte inside the dispatch table
+    FILE* fp = fopen("test/fixtures/cache_tmp.pcache", "r+b");
+    TEST_ASSERT_NOT_NULL(fp);
+    fseek(fp, 200, SEEK_SET);
+    int c = fgetc(fp);
+    fseek(fp, 200, SEEK_SET);
+    fputc(c ^ 0x01, fp);
+    fclose(fp);
+
+    CanConfigProcessor cached;
+    TEST_ASSERT_FALSE(cached.loadFromCache("/cache_tmp.json"));
+    TEST_ASSERT_EQUAL_UINT16(0, cached.getDispatchIdCount());
+
+    LittleFS.remove("/cache_tmp.pcache");
+    LittleFS.remove("/cache_tmp.json");
+}
+
+void test_cache_path_replaces_json_extension() {
+    char path[56];
+    CanConfigProcessor::cachePathFor("/NissanJukeF15.json", path, sizeof(path));
+    TEST_ASSERT_EQUAL_STRING("/NissanJukeF15.pcache", path);
+    CanConfigProcessor::cachePathFor("/profile", path, sizeof(path));
+    TEST_ASSERT_EQUAL_STRING("/profile.pcache", path);
+}
+
+// =============================================================================
+// FIELD DECODING
+// =============================================================================
+
+void test_rpm_scale_decode() {
+    // 0x445C = 17500 → 17500 / 7 = 2500 RPM
+    const uint8_t data[8] = {0x44, 0x5C};
+    CanFrame frame = makeFrame(0x180, data, 8);
+
+    TEST_ASSERT_TRUE(proc.processFrame(frame));
+    TEST_ASSERT_EQUAL_UINT16(2500, engineRPM);
+    TEST_ASSERT_EQUAL_UINT32(1, proc.getFramesProcessed());
+}
+
+void test_signed_steering_decode() {
+    // Bytes [1-2] = 0xFF38 → -200 (INT16 sign extension)
+    const uint8_t data[8] = {0x00, 0xFF, 0x38};
+    CanFrame frame = makeFrame(0x002, data, 8);
+
+    TEST_ASSERT_TRUE(proc.processFrame(frame));
+    TEST_ASSERT_EQUAL_INT16(-200, currentSteer);
+}
+
+void test_multi_field_frame_fuel_and_odometer() {
+    // Fuel 0x00 (full) → 45 L, odometer 0x014C08 = 85000 km
+    const uint8_t data[8] = {0x00, 0x01, 0x4C, 0x08};
+    CanFrame frame = makeFrame(0x5C5, data, 8);
+
+    TEST_ASSERT_TRUE(proc.processFrame(frame));
+    TEST_ASSERT_EQUAL_UINT8(45, fuelLevel);
+    TEST_ASSERT_EQUAL_UINT32(85000, currentOdo);
+}
+
+void test_body_frame_doors_and_lights() {
+    // 24-bit word 0x160800: driver door (bit 20), parking (bit 18),
+    // headlights (bit 17), high beam (bit 11)
+    const uint8_t data[8] = {0x16, 0x08, 0x00};
+    CanFrame frame = makeFrame(0x60D, data, 8);
+    currentDoors = 0x40;  // Passenger door previously open
+
+    TEST_ASSERT_TRUE(proc.processFrame(frame));
+    TEST_ASSERT_EQUAL_HEX8(0x80, currentDoors);
+    TEST_ASSERT_TRUE(headlightsOn);
+    TEST_ASSERT_TRUE(parkingLightsOn);
+    TEST_ASSERT_TRUE(highBeamOn);
+}
+
+// =============================================================================
+// COMPILED DECODERS
+// =============================================================================
+
+void test_juke_fields_all_specialized() {
+    TEST_ASSERT_EQUAL_UINT16(20, proc.getCompiledFieldCount());
+    TEST_ASSERT_EQUAL_UINT16(20, proc.getSpecializedFieldCount());
+}
+
+void test_compiled_matches_reference_juke() {
+    static const uint16_t ids[] = {0x002, 0x180, 0x284, 0x5C5, 0x6F6, 0x551, 0x60D, 0x54C, 0x580};
+    checkCompiledMatchesReference(proc, ids, sizeof(ids) / sizeof(ids[0]));
+}
+
+void test_compiled_matches_reference_uncommon_shapes() {
+    // LE / signed / UINT32 / MAP_RANGE shapes plus fields left on the generic kernel
+    // 0x104/0x105 exercise shared-word groups (LE word, bit 31, duplicate targets)
+    static const uint16_t ids[] = {0x100, 0x101, 0x102, 0x103, 0x104, 0x105};
+    CanConfigProcessor shapes;
+    LittleFS.basePath = "test/fixtures";
+    TEST_ASSERT_TRUE(shapes.loadFromJson("/decoder_shapes.json"));
+
+    TEST_ASSERT_EQUAL_UINT16(26, shapes.getCompiledFieldCount());
+    TEST_ASSERT_EQUAL_UINT16(23, shapes.getSpecializedFieldCount());
+    checkCompiledMatchesReference(shapes, ids, sizeof(ids) / sizeof(ids[0]));
+}
+
+// =============================================================================
+// SHARED-WORD GROUPS
+// =============================================================================
+
+void test_juke_body_frame_uses_one_shared_word() {
+    // 0x60D: 10 fields on the same 24-bit BE word -> a single group
+    TEST_ASSERT_EQUAL_UINT16(1, proc.getSharedWordGroupCount());
+}
+
+void test_door_fold_keeps_unrelated_bits() {
+    // Only the five door bits belong to the group; low bits must survive
+    const uint8_t data[8] = {0x90, 0x00, 0x00};  // boot (bit 23) + driver (bit 20)
+    CanFrame frame = makeFrame(0x60D, data, 8);
+    currentDoors = 0x67;  // passenger + rear left + unrelated 0x07
+
+    TEST_ASSERT_TRUE(proc.processFrame(frame));
+    TEST_ASSERT_EQUAL_HEX8(0x80 | 0x08 | 0x07, currentDoors);
+}
+
+void test_shared_word_groups_skip_duplicate_targets() {
+    CanConfigProcessor shapes;
+    LittleFS.basePath = "test/fixtures";
+    TEST_ASSERT_TRUE(shapes.loadFromJson("/decoder_shapes.json"));
+
+    // 0x104 has two groups (LE word at 0, BE word at 2); 0x105 writes
+    // TEMPERATURE twice, so its order-sensitive fields stay stand-alone
+    TEST_ASSERT_EQUAL_UINT16(2, shapes.getSharedWordGroupCount());
+
+    const uint8_t data[8] = {0x3F, 0x00};  // NONE -> 63, mask 0x0F -> 15
+    CanFrame frame = makeFrame(0x105, data, 8);
+    TEST_ASSERT_TRUE(shapes.processFrame(frame));
+    TEST_ASSERT_EQUAL_INT8(15, tempExt);  // last writer in profile order
+}
+
+// =============================================================================
+// DIRTY SET
+// =============================================================================
+
+void test_decoder_marks_dirty_only_on_change() {
+    // RPM raw 0x4D6C = 19820 -> 2831 RPM
+    const uint8_t data[8] = {0x4D, 0x6C};
+    CanFrame frame = makeFrame(0x180, data, 8);
+
+    TEST_ASSERT_TRUE(proc.processFrame(frame));
+    vehicleDataTakeDirty();
+
+    // Same payload again: value unchanged, nothing to send
+    TEST_ASSERT_TRUE(proc.processFrame(frame));
+    TEST_ASSERT_EQUAL_HEX16(0, vehicleDataTakeDirty());
+
+    const uint8_t faster[8] = {0x4E, 0x00};
+    frame = makeFrame(0x180, faster, 8);
+    TEST_ASSERT_TRUE(proc.processFrame(frame));
+    TEST_ASSERT_EQUAL_HEX16(DIRTY_RPM, vehicleDataTakeDirty());
+}
+
+void test_door_group_marks_doors_dirty() {
+    const uint8_t data[8] = {0x10, 0x00, 0x00};  // driver door
+    CanFrame frame = makeFrame(0x60D, data, 8);
+    currentDoors = 0;
+    headlightsOn = highBeamOn = parkingLightsOn = false;
+    vehicleDataTakeDirty();
+
+    TEST_ASSERT_TRUE(proc.processFrame(frame));
+    TEST_ASSERT_EQUAL_HEX16(DIRTY_DOORS, vehicleDataTakeDirty());
+
+    TEST_ASSERT_TRUE(proc.processFrame(frame));
+    TEST_ASSERT_EQUAL_HEX16(0, vehicleDataTakeDirty());
+}
+
+void test_indicator_marks_lights_dirty_when_blinking_starts() {
+    const uint8_t data[8] = {0x00, 0x20, 0x00};  // left indicator
+    CanFrame frame = makeFrame(0x60D, data, 8);
+    currentDoors = 0;
+    headlightsOn = highBeamOn = parkingLightsOn = false;
+    g_mock.indicatorTimeout = 500;
+    mockMillis = 10000;
+    vehicleDataTakeDirty();
+
+    TEST_ASSERT_TRUE(proc.processFrame(frame));
+    TEST_ASSERT_EQUAL_HEX16(DIRTY_LIGHTS, vehicleDataTakeDirty());
+    TEST_ASSERT_EQUAL_UINT32(10000, lastLeftIndicatorTime);
+
+    // Still blinking: timestamp moves, nothing new for the radio
+    mockMillis += 400;
+    TEST_ASSERT_TRUE(proc.processFrame(frame));
+    TEST_ASSERT_EQUAL_HEX16(0, vehicleDataTakeDirty());
+    TEST_ASSERT_EQUAL_UINT32(10400, lastLeftIndicatorTime);
+
+    // After the timeout it is a new blink sequence
+    mockMillis += 600;
+    TEST_ASSERT_TRUE(proc.processFrame(frame));
+    TEST_ASSERT_EQUAL_HEX16(DIRTY_LIGHTS, vehicleDataTakeDirty());
+}
+
+// =============================================================================
+// FIELD FILTERS
+// =============================================================================
+
+static CanFrame filteredFrame(int16_t steer, uint8_t fuelRaw, uint16_t rpm) {
+    const uint8_t data[8] = { (uint8_t)(steer >> 8), (uint8_t)steer, fuelRaw, 0x00,
+                              (uint8_t)(rpm >> 8), (uint8_t)rpm };
+    return makeFrame(0x300, data, 8);
+}
+
+void test_field_filter_applied_before_dirty() {
+    LittleFS.basePath = "test/fixtures";
+    CanConfigProcessor p;
+    TEST_ASSERT_TRUE(p.loadFromJson("/filtered_fields.json"));
+
+    // "median": 1 alone is no filter: the door fields still share one word
+    TEST_ASSERT_EQUAL_UINT8(2, p.getFilteredFieldCount());
+    TEST_ASSERT_EQUAL_UINT16(1, p.getSharedWordGroupCount());
+
+    mockMillis = 10000;
+    TEST_ASSERT_TRUE(p.processFrame(filteredFrame(100, 0, 800)));
+    TEST_ASSERT_EQUAL_INT16(100, currentSteer);
+    TEST_ASSERT_EQUAL_UINT8(45, fuelLevel);
+    vehicleDataTakeDirty();
+
+    // Steering spike (median) and fuel slosh (rate limit): nothing changes
+    mockMillis += 100;
+    TEST_ASSERT_TRUE(p.processFrame(filteredFrame(900, 255, 800)));
+    TEST_ASSERT_EQUAL_INT16(100, currentSteer);
+    TEST_ASSERT_EQUAL_UINT8(45, fuelLevel);
+    TEST_ASSERT_EQUAL_HEX16(0, vehicleDataTakeDirty());
+
+    // Steering jitter inside the deadband; unfiltered RPM still goes through
+    mockMillis += 100;
+    TEST_ASSERT_TRUE(p.processFrame(filteredFrame(103, 0, 810)));
+    TEST_ASSERT_TRUE(p.processFrame(filteredFrame(97, 0, 810)));
+    TEST_ASSERT_EQUAL_INT16(100, currentSteer);
+    TEST_ASSERT_EQUAL_UINT16(810, engineRPM);
+    TEST_ASSERT_EQUAL_HEX16(DIRTY_RPM, vehicleDataTakeDirty());
+    TEST_ASSERT_TRUE(p.getFilterHeldCount() > 0);
+
+    // A real turn is published and marks the signal dirty
+    TEST_ASSERT_TRUE(p.processFrame(filteredFrame(300, 0, 810)));
+    TEST_ASSERT_TRUE(p.processFrame(filteredFrame(300, 0, 810)));
+    TEST_ASSERT_EQUAL_INT16(300, currentSteer);
+    TEST_ASSERT_EQUAL_HEX16(DIRTY_STEERING, vehicleDataTakeDirty());
+
+    // A lasting fuel change lands once the interval has passed
+    for (int i = 0; i < 10; i++) {
+        mockMillis += 100;
+        p.processFrame(filteredFrame(300, 85, 810));
+    }
+    TEST_ASSERT_EQUAL_UINT8(30, fuelLevel);
+    TEST_ASSERT_EQUAL_HEX16(DIRTY_FUEL_LEVEL, vehicleDataTakeDirty());
+}
+
+void test_field_filter_survives_cache() {
+    LittleFS.basePath = "test/fixtures";
+    LittleFS.writable = true;
+    copyFixture("filtered_fields.json", "cache_tmp.json");
+
+    CanConfigProcessor parsed;
+    TEST_ASSERT_TRUE(parsed.loadFromJson("/cache_tmp.json"));
+    CanConfigProcessor cached;
+    TEST_ASSERT_TRUE(cached.loadFromCache("/cache_tmp.json"));
+    TEST_ASSERT_EQUAL_UINT8(2, cached.getFilteredFieldCount());
+    TEST_ASSERT_EQUAL_size_t(parsed.getProfileBytesUsed(), cached.getProfileBytesUsed());
+
+    TEST_ASSERT_TRUE(cached.processFrame(filteredFrame(100, 0, 0)));
+    TEST_ASSERT_TRUE(cached.processFrame(filteredFrame(900, 0, 0)));
+    TEST_ASSERT_EQUAL_INT16(100, currentSteer);
+
+    LittleFS.remove("/cache_tmp.pcache");
+    LittleFS.remove("/cache_tmp.json");
+}
+
+// =============================================================================
+// BAKED PROFILE (PROFILE_BAKED=1, header from tools/bake_profile.py)
+// =============================================================================
+
+#if PROFILE_BAKED
+
+void test_baked_matches_reference() {
+    CanConfigProcessor baked;
+    TEST_ASSERT_TRUE(baked.loadBaked());
+    TEST_ASSERT_TRUE(baked.isBaked());
+
+    static const uint16_t ids[] = {0x002, 0x180, 0x284, 0x5C5, 0x6F6, 0x551, 0x60D, 0x54C, 0x580};
+    checkCompiledMatchesReference(baked, ids, sizeof(ids) / sizeof(ids[0]));
+}
+
+void test_baked_matches_json_profile() {
+    CanConfigProcessor baked;
+    TEST_ASSERT_TRUE(baked.loadBaked());
+    TEST_ASSERT_FALSE(proc.isBaked());
+    TEST_ASSERT_EQUAL_STRING(proc.getProfileName(), baked.getProfileName());
+    TEST_ASSERT_EQUAL_UINT16(proc.getDispatchIdCount(), baked.getDispatchIdCount());
+    TEST_ASSERT_EQUAL_size_t(proc.getProfileBytesUsed(), baked.getProfileBytesUsed());
+    TEST_ASSERT_FALSE(baked.isMockMode());
+
+    uint32_t seed = 0xBA4ED;
+    for (int i = 0; i < 2000; i++) {
+        uint8_t data[8];
+        for (uint8_t& b : data) {
+            seed = seed * 1664525u + 1013904223u;
+            b = (uint8_t)(seed >> 24);
+        }
+        // Mostly configured IDs, some unknown ones
+        uint16_t id = (i % 4) ? (uint16_t)(seed % CAN_DISPATCH_SIZE) : 0x60D;
+        CanFrame frame = makeFrame(id, data, 8);
+
+        clearState(data[7] & 0xF8);
+        bool known = proc.processFrame(frame);
+        DecodedState expected = captureState();
+
+        clearState(data[7] & 0xF8);
+        TEST_ASSERT_EQUAL(known, baked.processFrame(frame));
+        assertStateEqual(expected, captureState());
+    }
+    TEST_ASSERT_EQUAL_UINT32(proc.getUnknownFrames(), baked.getUnknownFrames());
+}
+
+void test_baked_vehicle_switch_applies_params() {
+    CanConfigProcessor baked;
+    baked.loadBaked();
+    TEST_ASSERT_EQUAL_STRING("NissanJukeF15.json", g_mock.vehicleFile);
+    TEST_ASSERT_EQUAL_UINT16(300, g_mock.steerScale);
+    TEST_ASSERT_TRUE(g_mock.steerInvert);
+
+    // Same vehicle on the next boot: calibration kept
+    int resets = g_mock.resetCount;
+    g_mock.steerScale = 1234;
+    baked.loadBaked();
+    TEST_ASSERT_EQUAL_INT(resets, g_mock.resetCount);
+    TEST_ASSERT_EQUAL_UINT16(1234, g_mock.steerScale);
+}
+
+void test_begin_prefers_baked_without_override() {
+    CanConfigProcessor p;
+    g_mock.vehicleFile[0] = '\0';
+    TEST_ASSERT_TRUE(p.begin());
+    TEST_ASSERT_TRUE(p.isBaked());
+
+    // A vehicle loaded with CAN LOAD overrides it
+    strcpy(g_mock.vehicleFile, "MockDemo.json");
+    TEST_ASSERT_TRUE(p.begin());
+    TEST_ASSERT_FALSE(p.isBaked());
+    TEST_ASSERT_TRUE(p.isMockMode());
+
+    // Saved file that no longer exists: baked again
+    strcpy(g_mock.vehicleFile, "gone.json");
+    TEST_ASSERT_TRUE(p.begin());
+    TEST_ASSERT_TRUE(p.isBaked());
+}
+
+void test_json_load_replaces_baked() {
+    CanConfigProcessor p;
+    p.loadBaked();
+    TEST_ASSERT_TRUE(p.loadFromJson("/NissanJukeF15.json"));
+    TEST_ASSERT_FALSE(p.isBaked());
+    TEST_ASSERT_EQUAL_UINT16(20, p.getSpecializedFieldCount());
+}
+
+#endif // PROFILE_BAKED
+
+// =============================================================================
+// MAIN
+// =============================================================================
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_dispatch_indexes_all_profile_ids);
+    RUN_TEST(test_unknown_id_is_rejected_and_counted);
+    RUN_TEST(test_extended_id_never_matches_standard_entry);
+    RUN_TEST(test_id_above_11_bits_is_rejected);
+
+    RUN_TEST(test_filter_accepts_every_profile_id);
+    RUN_TEST(test_filter_accepted_count_is_exact_and_tight);
+    RUN_TEST(test_filter_dual_layout_ignores_data_bits);
+    RUN_TEST(test_filter_single_id_is_exact);
+    RUN_TEST(test_filter_empty_profile_accepts_all);
+
+    RUN_TEST(test_load_streams_only_top_level_frames);
+    RUN_TEST(test_parse_error_keeps_current_profile);
+    RUN_TEST(test_profile_arena_holds_frames_in_order);
+    RUN_TEST(test_oversized_profile_is_rejected);
+    RUN_TEST(test_swap_replaces_profile_between_frames);
+    RUN_TEST(test_failed_load_does_not_swap);
+
+    RUN_TEST(test_cache_restores_identical_profile);
+    RUN_TEST(test_cache_rejected_after_json_change);
+    RUN_TEST(test_cache_rejected_when_corrupted);
+    RUN_TEST(test_cache_path_replaces_json_extension);
+
+    RUN_TEST(test_rpm_scale_decode);
+    RUN_TEST(test_signed_steering_decode);
+    RUN_TEST(test_multi_field_frame_fuel_and_odometer);
+    RUN_TEST(test_body_frame_doors_and_lights);
+
+    RUN_TEST(test_juke_fields_all_specialized);
+    RUN_TEST(test_compiled_matches_reference_juke);
+    RUN_TEST(test_compiled_matches_reference_uncommon_shapes);
+
+    RUN_TEST(test_juke_body_frame_uses_one_shared_word);
+    RUN_TEST(test_door_fold_keeps_unrelated_bits);
+    RUN_TEST(test_shared_word_groups_skip_duplicate_targets);
+
+    RUN_TEST(test_decoder_marks_dirty_only_on_change);
+    RUN_TEST(test_door_group_marks_doors_dirty);
+    RUN_TEST(test_indicator_marks_lights_dirty_when_blinking_starts);
+    RUN_TEST(test_field_filter_applied_before_dirty);
+    RUN_TEST(test_field_filter_survives_cache);
+
+#if PROFILE_BAKED
+    RUN_TEST(test_baked_matches_reference);
+    RUN_TEST(test_baked_matches_json_profile);
+    RUN_TEST(test_baked_vehicle_switch_applies_params);
+    RUN_TEST(test_begin_prefers_baked_without_override);
+    RUN_TEST(test_json_load_replaces_baked);
+#endif
+
+    return UNITY_END();
+}
@@ -0,0 +1,4 @@
+// Include PerfStats with the counters built in
+// (see test_vehicle_params/CanConfigProcessor_impl.cpp).
+#define PERF_STATS_ENABLED 1
+#include "../../src/PerfStats.cpp"
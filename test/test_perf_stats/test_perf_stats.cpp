@@ -0,0 +1,129 @@
+/**
+ * @file test_perf_stats.cpp
+ * @brief Unit tests for the SYS PERF counters (PerfStats)
+ *
+ * Tests:
+ *   - count / sum / max per stage, reset
+ *   - log2 µs histogram buckets (160 MHz mock clock)
+ *   - PerfScope measures its lifetime
+ *   - CAN-to-UART latency: first decoded frame to the next radio write
+ *   - loop period between loop() starts
+ *
+ * Run: pio test -e native
+ */
+
+#define PERF_STATS_ENABLED 1
+
+#include <unity.h>
+#include "PerfStats.h"
+
+static const uint32_t MHZ = 160;
+
+void setUp() {
+    ESP.cycleCount = 1000000;
+    perfReset();
+}
+
+void tearDown() {}
+
+// =============================================================================
+// COUNTERS
+// =============================================================================
+
+void test_record_count_sum_max() {
+    perfRecord(PerfStage::PROCESS_FRAME, 5 * MHZ);
+    perfRecord(PerfStage::PROCESS_FRAME, 20 * MHZ);
+    perfRecord(PerfStage::PROCESS_FRAME, 2 * MHZ);
+
+    const PerfCounter& c = perfGet(PerfStage::PROCESS_FRAME);
+    TEST_ASSERT_EQUAL_UINT32(3, c.count);
+    TEST_ASSERT_EQUAL_UINT32(27 * MHZ, (uint32_t)c.sumCycles);
+    TEST_ASSERT_EQUAL_UINT32(20 * MHZ, c.maxCycles);
+    TEST_ASSERT_EQUAL_FLOAT(20.0f, perfCyclesToUs(c.maxCycles));
+    TEST_ASSERT_EQUAL_UINT32(0, perfGet(PerfStage::CAN_READ).count);
+
+    perfReset();
+    TEST_ASSERT_EQUAL_UINT32(0, perfGet(PerfStage::PROCESS_FRAME).count);
+    TEST_ASSERT_EQUAL_UINT32(0, perfGet(PerfStage::PROCESS_FRAME).maxCycles);
+}
+
+void test_histogram_buckets() {
+    perfRecord(PerfStage::SERIAL_CMD, MHZ / 2);         // 0.5 µs -> < 1
+    perfRecord(PerfStage::SERIAL_CMD, 1 * MHZ);         // 1 µs   -> < 2
+    perfRecord(PerfStage::SERIAL_CMD, 3 * MHZ);         // 3 µs   -> < 4
+    perfRecord(PerfStage::SERIAL_CMD, 4 * MHZ);         // 4 µs   -> < 8
+    perfRecord(PerfStage::SERIAL_CMD, 0xFFFFFFFF);      // 26 s   -> open bucket
+
+    const PerfCounter& c = perfGet(PerfStage::SERIAL_CMD);
+    TEST_ASSERT_EQUAL_UINT32(1, c.hist[0]);
+    TEST_ASSERT_EQUAL_UINT32(1, c.hist[1]);
+    TEST_ASSERT_EQUAL_UINT32(1, c.hist[2]);
+    TEST_ASSERT_EQUAL_UINT32(1, c.hist[3]);
+    TEST_ASSERT_EQUAL_UINT32(1, c.hist[PERF_HIST_BUCKETS - 1]);
+
+    TEST_ASSERT_EQUAL_UINT32(1, perfBucketLimitUs(0));
+    TEST_ASSERT_EQUAL_UINT32(8, perfBucketLimitUs(3));
+    TEST_ASSERT_EQUAL_UINT32(0, perfBucketLimitUs(PERF_HIST_BUCKETS - 1));
+}
+
+void test_scope_measures_lifetime() {
+    {
+        PERF_SCOPE(RADIO_RPM);
+        ESP.cycleCount += 7 * MHZ;
+    }
+    TEST_ASSERT_EQUAL_UINT32(1, perfGet(PerfStage::RADIO_RPM).count);
+    TEST_ASSERT_EQUAL_UINT32(7 * MHZ, perfGet(PerfStage::RADIO_RPM).maxCycles);
+    TEST_ASSERT_EQUAL_STRING("txRpm", perfStageName(PerfStage::RADIO_RPM));
+    TEST_ASSERT_EQUAL_STRING("txFuelAvg", perfStageName(PerfStage::RADIO_FUEL_AVG));
+}
+
+// =============================================================================
+// END-TO-END
+// =============================================================================
+
+void test_can_to_uart_from_first_frame() {
+    perfMarkUart(100);                   // Earlier traffic: nothing pending
+    TEST_ASSERT_EQUAL_UINT32(0, perfGet(PerfStage::CAN_TO_UART).count);
+
+    perfMarkFrame();
+    ESP.cycleCount += 300 * MHZ;
+    perfMarkFrame();                     // Later frame: the first one counts
+    ESP.cycleCount += 200 * MHZ;
+    perfMarkUart(100);                   // Nothing written yet
+    TEST_ASSERT_EQUAL_UINT32(0, perfGet(PerfStage::CAN_TO_UART).count);
+
+    perfMarkUart(116);
+    const PerfCounter& c = perfGet(PerfStage::CAN_TO_UART);
+    TEST_ASSERT_EQUAL_UINT32(1, c.count);
+    TEST_ASSERT_EQUAL_UINT32(500 * MHZ, c.maxCycles);
+
+    perfMarkUart(132);                   // No new frame since
+    TEST_ASSERT_EQUAL_UINT32(1, c.count);
+}
+
+void test_loop_period() {
+    perfLoopStart();
+    TEST_ASSERT_EQUAL_UINT32(0, perfGet(PerfStage::LOOP_PERIOD).count);
+    ESP.cycleCount += 1000 * MHZ;
+    perfLoopStart();
+    ESP.cycleCount += 3000 * MHZ;
+    perfLoopStart();
+
+    const PerfCounter& c = perfGet(PerfStage::LOOP_PERIOD);
+    TEST_ASSERT_EQUAL_UINT32(2, c.count);
+    TEST_ASSERT_EQUAL_UINT32(3000 * MHZ, c.maxCycles);
+    TEST_ASSERT_EQUAL_UINT32(1, c.hist[10]);    // 1000 µs -> < 1024
+    TEST_ASSERT_EQUAL_UINT32(1, c.hist[12]);    // 3000 µs -> < 4096
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_record_count_sum_max);
+    RUN_TEST(test_histogram_buckets);
+    RUN_TEST(test_scope_measures_lifetime);
+    RUN_TEST(test_can_to_uart_from_first_frame);
+    RUN_TEST(test_loop_period);
+
+    return UNITY_END();
+}
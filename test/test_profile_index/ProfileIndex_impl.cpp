@@ -0,0 +1,8 @@
+// Include the profile index implementation into this test build
+// (see test_vehicle_params/CanConfigProcessor_impl.cpp).
+#include "../../src/ProfileIndex.cpp"
+#include "../../src/crc32.cpp"
+
+// Arduino and filesystem globals (SerialClass and FS are defined in Arduino.h/LittleFS.h mocks)
+SerialClass Serial;
+FS LittleFS;
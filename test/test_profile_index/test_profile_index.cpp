@@ -0,0 +1,345 @@
+/**
+ * @file test_profile_index.cpp
+ * @brief Unit tests for the installed profile index and bus fingerprinting
+ *
+ * Tests:
+ *   - an entry holds name, hash, size, kind and the standard ID set
+ *   - broken, mock and replay profiles are flagged
+ *   - boot builds the index once, then reads it without parsing
+ *   - only new or changed profiles are parsed again, deleted ones dropped;
+ *     an edit keeping the file size is caught by its CRC
+ *   - a corrupted index is rebuilt
+ *   - upload / delete update the index in place
+ *   - scoring: coverage of the profile IDs, extra bus IDs do not count
+ *   - the best real profile wins, a superset profile wins a tie
+ *   - unknown, sparse and silent buses do not match; mock/replay never do
+ *
+ * Run: pio test -e native
+ */
+
+#include <unity.h>
+#include "ProfileIndex.h"
+#include "crc32.h"
+#include "LittleFS.h"
+
+#define FIXTURE_DIR "test/fixtures/profiles"
+#include "FixtureSupport.h"
+
+static void setId(uint8_t* bits, uint16_t id) {
+    bits[id >> 3] |= 1 << (id & 7);
+}
+
+static bool hasId(const ProfileIndexEntry* entry, uint16_t id) {
+    return (entry->ids[id >> 3] >> (id & 7)) & 1;
+}
+
+/**
+ * @brief Match a bus carrying the given IDs
+ */
+static const ProfileMatch& matchBus(const uint16_t* ids, size_t count) {
+    static uint8_t observed[PROFILE_ID_BITMAP_SIZE];
+    memset(observed, 0, sizeof(observed));
+    for (size_t i = 0; i < count; i++) setId(observed, ids[i]);
+    return profileIndexMatch(observed);
+}
+
+void setUp() {
+    LittleFS.basePath = FIXTURE_DIR;
+    LittleFS.writable = true;
+    LittleFS.remove(PROFILE_INDEX_PATH);
+}
+
+void tearDown() {
+    LittleFS.remove(PROFILE_INDEX_PATH);
+    LittleFS.remove("/tmp_profile.json");
+    LittleFS.writable = false;
+}
+
+// =============================================================================
+// ENTRIES
+// =============================================================================
+
+void test_entry_holds_name_hash_and_id_set() {
+    ProfileIndexEntry entry;
+    TEST_ASSERT_TRUE(profileIndexBuildEntry("vehicle_a.json", entry));
+
+    TEST_ASSERT_EQUAL_STRING("/vehicle_a.json", entry.file);
+    TEST_ASSERT_EQUAL_STRING("Vehicle A", entry.name);
+    TEST_ASSERT_EQUAL_UINT8(0, entry.flags);
+
+    FILE* fp = fopen(FIXTURE_DIR "/vehicle_a.json", "rb");
+    TEST_ASSERT_NOT_NULL(fp);
+    uint8_t buf[2048];
+    size_t size = fread(buf, 1, sizeof(buf), fp);
+    fclose(fp);
+    TEST_ASSERT_EQUAL_UINT32(size, entry.jsonSize);
+    TEST_ASSERT_EQUAL_HEX32(crc32_le(0, buf, size), entry.jsonCrc);
+
+    // 0x180 twice (string and integer), extended ID skipped
+    TEST_ASSERT_EQUAL_UINT16(4, entry.idCount);
+    TEST_ASSERT_TRUE(hasId(&entry, 0x180));
+    TEST_ASSERT_TRUE(hasId(&entry, 0x1F9));
+    TEST_ASSERT_TRUE(hasId(&entry, 0x280));
+    TEST_ASSERT_TRUE(hasId(&entry, 0x60D));
+    TEST_ASSERT_FALSE(hasId(&entry, 0x110));
+}
+
+void test_entry_flags_broken_mock_and_replay() {
+    ProfileIndexEntry entry;
+    TEST_ASSERT_TRUE(profileIndexBuildEntry("/broken.json", entry));
+    TEST_ASSERT_EQUAL_UINT8(PROFILE_FLAG_INVALID, entry.flags);
+
+    TEST_ASSERT_TRUE(profileIndexBuildEntry("/demo_mock.json", entry));
+    TEST_ASSERT_EQUAL_UINT8(PROFILE_FLAG_MOCK, entry.flags);
+
+    TEST_ASSERT_TRUE(profileIndexBuildEntry("/drive_replay.json", entry));
+    TEST_ASSERT_EQUAL_UINT8(PROFILE_FLAG_REPLAY, entry.flags);
+    TEST_ASSERT_EQUAL_UINT16(4, entry.idCount);
+
+    TEST_ASSERT_FALSE(profileIndexBuildEntry("/missing.json", entry));
+}
+
+// =============================================================================
+// BOOT SYNC
+// =============================================================================
+
+void test_first_boot_builds_index_then_reads_it() {
+    TEST_ASSERT_EQUAL_UINT8(6, profileIndexBegin());    // notes.txt ignored
+    TEST_ASSERT_FALSE(profileIndexGetStats().fromFile);
+    TEST_ASSERT_EQUAL_UINT8(6, profileIndexGetStats().parsed);
+    TEST_ASSERT_TRUE(LittleFS.exists(PROFILE_INDEX_PATH));
+
+    TEST_ASSERT_EQUAL_UINT8(6, profileIndexBegin());
+    TEST_ASSERT_TRUE(profileIndexGetStats().fromFile);
+    TEST_ASSERT_EQUAL_UINT8(0, profileIndexGetStats().parsed);
+
+    const ProfileIndexEntry* entry = profileIndexFind("vehicle_b.json");
+    TEST_ASSERT_NOT_NULL(entry);
+    TEST_ASSERT_EQUAL_STRING("Vehicle B", entry->name);
+    TEST_ASSERT_EQUAL_UINT16(3, entry->idCount);
+    TEST_ASSERT_NULL(profileIndexFind("/notes.txt"));
+}
+
+void test_only_changed_profiles_are_parsed_again() {
+    copyFixture("vehicle_b.json", "tmp_profile.json");
+    TEST_ASSERT_EQUAL_UINT8(7, profileIndexBegin());
+
+    // Same file with one more frame: size changes
+    copyFixture("vehicle_a_full.json", "tmp_profile.json");
+    TEST_ASSERT_EQUAL_UINT8(7, profileIndexBegin());
+    TEST_ASSERT_TRUE(profileIndexGetStats().fromFile);
+    TEST_ASSERT_EQUAL_UINT8(1, profileIndexGetStats().parsed);
+    TEST_ASSERT_EQUAL_UINT16(6, profileIndexFind("/tmp_profile.json")->idCount);
+
+    LittleFS.remove("/tmp_profile.json");
+    TEST_ASSERT_EQUAL_UINT8(6, profileIndexBegin());
+    TEST_ASSERT_EQUAL_UINT8(0, profileIndexGetStats().parsed);
+    TEST_ASSERT_NULL(profileIndexFind("/tmp_profile.json"));
+
+    // The shrunk index was written back
+    profileIndexBegin();
+    TEST_ASSERT_EQUAL_UINT8(6, profileIndexGetStats().entries);
+    TEST_ASSERT_EQUAL_UINT8(0, profileIndexGetStats().parsed);
+}
+
+void test_same_size_edit_is_parsed_again() {
+    copyFixture("vehicle_a.json", "tmp_profile.json");
+    TEST_ASSERT_EQUAL_UINT8(7, profileIndexBegin());
+    TEST_ASSERT_TRUE(hasId(profileIndexFind("/tmp_profile.json"), 0x1F9));
+
+    // 0x1F9 -> 0x2F9 in place: same byte count, other ID set
+    FILE* fp = fopen(FIXTURE_DIR "/tmp_profile.json", "r+b");
+    TEST_ASSERT_NOT_NULL(fp);
+    char buf[2048];
+    size_t size = fread(buf, 1, sizeof(buf) - 1, fp);
+    buf[size] = '\0';
+    const char* at = strstr(buf, "0x1F9");
+    TEST_ASSERT_NOT_NULL(at);
+    fseek(fp, (long)(at - buf) + 2, SEEK_SET);
+    fputc('2', fp);
+    fclose(fp);
+
+    TEST_ASSERT_EQUAL_UINT8(7, profileIndexBegin());
+    TEST_ASSERT_EQUAL_UINT8(1, profileIndexGetStats().parsed);
+    const ProfileIndexEntry* entry = profileIndexFind("/tmp_profile.json");
+    TEST_ASSERT_EQUAL_UINT32(size, entry->jsonSize);
+    TEST_ASSERT_FALSE(hasId(entry, 0x1F9));
+    TEST_ASSERT_TRUE(hasId(entry, 0x2F9));
+    TEST_ASSERT_EQUAL_UINT16(4, entry->idCount);
+}
+
+void test_corrupted_index_is_rebuilt() {
+    profileIndexBegin();
+
+    FILE* fp = fopen(FIXTURE_DIR "/profiles.idx", "r+b");
+    TEST_ASSERT_NOT_NULL(fp);
+    fseek(fp, 40, SEEK_SET);
+    int c = fgetc(fp);
+    fseek(fp, 40, SEEK_SET);
+    fputc(c ^ 0x01, fp);
+    fclose(fp);
+
+    TEST_ASSERT_EQUAL_UINT8(6, profileIndexBegin());
+    TEST_ASSERT_FALSE(profileIndexGetStats().fromFile);
+    TEST_ASSERT_EQUAL_UINT8(6, profileIndexGetStats().parsed);
+    TEST_ASSERT_EQUAL_STRING("Vehicle A", profileIndexFind("/vehicle_a.json")->name);
+}
+
+void test_upload_and_delete_update_index() {
+    profileIndexBegin();
+    copyFixture("vehicle_b.json", "tmp_profile.json");
+
+    TEST_ASSERT_TRUE(profileIndexUpdate("/tmp_profile.json"));
+    TEST_ASSERT_EQUAL_UINT8(7, profileIndexCount());
+    TEST_ASSERT_EQUAL_STRING("Vehicle B", profileIndexFind("tmp_profile.json")->name);
+
+    // Replaced by another upload: same entry, new content
+    copyFixture("vehicle_a.json", "tmp_profile.json");
+    TEST_ASSERT_TRUE(profileIndexUpdate("/tmp_profile.json"));
+    TEST_ASSERT_EQUAL_UINT8(7, profileIndexCount());
+    TEST_ASSERT_EQUAL_STRING("Vehicle A", profileIndexFind("tmp_profile.json")->name);
+
+    // Persisted: the next boot parses nothing
+    profileIndexBegin();
+    TEST_ASSERT_TRUE(profileIndexGetStats().fromFile);
+    TEST_ASSERT_EQUAL_UINT8(0, profileIndexGetStats().parsed);
+
+    LittleFS.remove("/tmp_profile.json");
+    TEST_ASSERT_TRUE(profileIndexRemove("/tmp_profile.json"));
+    TEST_ASSERT_FALSE(profileIndexRemove("/tmp_profile.json"));
+    TEST_ASSERT_EQUAL_UINT8(6, profileIndexCount());
+}
+
+// =============================================================================
+// SCORING
+// =============================================================================
+
+void test_score_is_coverage_of_profile_ids() {
+    uint8_t profile[PROFILE_ID_BITMAP_SIZE] = {};
+    uint8_t observed[PROFILE_ID_BITMAP_SIZE] = {};
+    setId(profile, 0x100);
+    setId(profile, 0x200);
+    setId(profile, 0x300);
+    setId(profile, 0x400);
+
+    uint16_t matches;
+    TEST_ASSERT_EQUAL_UINT16(0, profileFingerprintScore(profile, 4, observed, matches));
+    TEST_ASSERT_EQUAL_UINT16(0, matches);
+
+    setId(observed, 0x100);
+    setId(observed, 0x300);
+    setId(observed, 0x7FF);     // Not in the profile: no penalty
+    setId(observed, 0x001);
+    TEST_ASSERT_EQUAL_UINT16(500, profileFingerprintScore(profile, 4, observed, matches));
+    TEST_ASSERT_EQUAL_UINT16(2, matches);
+
+    setId(observed, 0x200);
+    setId(observed, 0x400);
+    TEST_ASSERT_EQUAL_UINT16(1000, profileFingerprintScore(profile, 4, observed, matches));
+
+    TEST_ASSERT_EQUAL_UINT16(0, profileFingerprintScore(profile, 0, observed, matches));
+}
+
+void test_bus_matches_its_vehicle() {
+    profileIndexBegin();
+
+    // Vehicle B bus plus IDs no profile decodes
+    static const uint16_t busB[] = {0x2A0, 0x3B0, 0x4C0, 0x011, 0x7DF, 0x500};
+    const ProfileMatch& match = matchBus(busB, 6);
+    TEST_ASSERT_TRUE(match.accepted);
+    TEST_ASSERT_EQUAL_STRING("/vehicle_b.json", match.file);
+    TEST_ASSERT_EQUAL_UINT16(1000, match.score);
+    TEST_ASSERT_EQUAL_UINT16(3, match.matches);
+    TEST_ASSERT_EQUAL_UINT16(6, match.observedIds);
+    TEST_ASSERT_EQUAL_UINT16(0, match.runnerUp);
+    TEST_ASSERT_EQUAL_STRING("/vehicle_b.json", profileIndexGetLastMatch().file);
+}
+
+void test_superset_profile_wins_tie() {
+    profileIndexBegin();
+
+    // Everything vehicle_a_full decodes: both A profiles fully covered
+    static const uint16_t full[] = {0x180, 0x1F9, 0x280, 0x358, 0x5C5, 0x60D};
+    const ProfileMatch& match = matchBus(full, 6);
+    TEST_ASSERT_TRUE(match.accepted);
+    TEST_ASSERT_EQUAL_STRING("/vehicle_a_full.json", match.file);
+    TEST_ASSERT_EQUAL_UINT16(6, match.matches);
+    TEST_ASSERT_EQUAL_UINT16(1000, match.runnerUp);
+
+    // Only the IDs of the smaller profile: it covers them all, full 4/6
+    static const uint16_t partial[] = {0x180, 0x1F9, 0x280, 0x60D};
+    const ProfileMatch& smaller = matchBus(partial, 4);
+    TEST_ASSERT_TRUE(smaller.accepted);
+    TEST_ASSERT_EQUAL_STRING("/vehicle_a.json", smaller.file);
+    TEST_ASSERT_EQUAL_UINT16(666, smaller.runnerUp);
+}
+
+void test_weak_or_unknown_bus_does_not_match() {
+    profileIndexBegin();
+
+    // One vehicle B ID among unknown traffic: 333/1000
+    static const uint16_t sparse[] = {0x2A0, 0x011, 0x022, 0x033};
+    const ProfileMatch& weak = matchBus(sparse, 4);
+    TEST_ASSERT_FALSE(weak.accepted);
+    TEST_ASSERT_EQUAL_STRING("/vehicle_b.json", weak.file);
+    TEST_ASSERT_EQUAL_UINT16(333, weak.score);
+
+    static const uint16_t unknown[] = {0x011, 0x022, 0x033};
+    TEST_ASSERT_FALSE(matchBus(unknown, 3).accepted);
+    TEST_ASSERT_EQUAL_UINT16(0, profileIndexGetLastMatch().score);
+
+    TEST_ASSERT_FALSE(matchBus(nullptr, 0).accepted);
+    TEST_ASSERT_EQUAL_UINT16(0, profileIndexGetLastMatch().observedIds);
+}
+
+void test_min_matches_required() {
+    profileIndexBegin();
+
+    // A one-ID profile fully covered is not enough evidence
+    FILE* fp = fopen(FIXTURE_DIR "/tmp_profile.json", "wb");
+    TEST_ASSERT_NOT_NULL(fp);
+    fputs("{\"name\":\"One ID\",\"frames\":[{\"canId\":\"0x6F0\",\"fields\":[]}]}", fp);
+    fclose(fp);
+    TEST_ASSERT_TRUE(profileIndexUpdate("/tmp_profile.json"));
+
+    static const uint16_t bus[] = {0x6F0, 0x011};
+    const ProfileMatch& match = matchBus(bus, 2);
+    TEST_ASSERT_EQUAL_STRING("/tmp_profile.json", match.file);
+    TEST_ASSERT_EQUAL_UINT16(1000, match.score);
+    TEST_ASSERT_FALSE(match.accepted);
+}
+
+void test_mock_and_replay_profiles_never_match() {
+    profileIndexBegin();
+    TEST_ASSERT_TRUE(profileIndexRemove("/vehicle_a.json"));
+    TEST_ASSERT_TRUE(profileIndexRemove("/vehicle_a_full.json"));
+
+    // Exactly the replay profile's IDs: only real profiles compete
+    static const uint16_t bus[] = {0x180, 0x1F9, 0x280, 0x60D};
+    const ProfileMatch& match = matchBus(bus, 4);
+    TEST_ASSERT_FALSE(match.accepted);
+    TEST_ASSERT_EQUAL_STRING("/vehicle_b.json", match.file);
+    TEST_ASSERT_EQUAL_UINT16(0, match.score);
+}
+
+// =============================================================================
+// MAIN
+// =============================================================================
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_entry_holds_name_hash_and_id_set);
+    RUN_TEST(test_entry_flags_broken_mock_and_replay);
+    RUN_TEST(test_first_boot_builds_index_then_reads_it);
+    RUN_TEST(test_only_changed_profiles_are_parsed_again);
+    RUN_TEST(test_same_size_edit_is_parsed_again);
+    RUN_TEST(test_corrupted_index_is_rebuilt);
+    RUN_TEST(test_upload_and_delete_update_index);
+    RUN_TEST(test_score_is_coverage_of_profile_ids);
+    RUN_TEST(test_bus_matches_its_vehicle);
+    RUN_TEST(test_superset_profile_wins_tie);
+    RUN_TEST(test_weak_or_unknown_bus_does_not_match);
+    RUN_TEST(test_min_matches_required);
+    RUN_TEST(test_mock_and_replay_profiles_never_match);
+    return UNITY_END();
+}
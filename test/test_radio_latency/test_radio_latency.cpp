@@ -0,0 +1,185 @@
+/**
+ * @file test_radio_latency.cpp
+ * @brief Unit tests for CAN-to-head-unit latency tracing (SYS LAT)
+ *
+ * Tests:
+ *   - LatencyHistogram buckets: exact below 4 µs, <= 25% wide above,
+ *     contiguous, clamped at LAT_HIST_MAX_US
+ *   - percentiles and max
+ *   - a change is recorded with its age when its command is flushed
+ *   - the age includes the minimum spacing wait
+ *   - keep-alive resends are not recorded
+ *   - a command fed by two signals records the oldest change
+ *
+ * Run: pio test -e native
+ */
+
+#include <unity.h>
+#include "RadioSend.h"
+#include "RadioTx.h"
+#include "ConfigManager_mock.h"
+#include "GlobalData.h"
+
+extern HardwareSerial RadioSerial;
+
+// Slot numbers as in RadioSend.cpp
+static const uint8_t SLOT_RPM_ID = 3;
+static const uint8_t SLOT_RANGE_ID = 8;
+
+/**
+ * @brief One radio pass at the current mock time with room on the UART
+ */
+static void radioPass() {
+    RadioSerial.writtenLen = 0;
+    RadioSerial.txRoom = sizeof(RadioSerial.written);
+    processRadioUpdates();
+}
+
+/**
+ * @brief A decoded CAN frame changing some signals at the current mock time
+ */
+static void canWrite(uint16_t dirtyBits) {
+    vehicleDataWriteUs = micros();
+    vehicleDataMarkDirty(dirtyBits);
+}
+
+void setUp() {
+    mockReset();
+    radioTxReset();
+
+    // Slot timers persist between tests: move past every keep-alive and send
+    // everything once, then start from empty histograms.
+    mockMillis += 100000;
+    vehicleDataMarkDirty(DIRTY_ALL);
+    radioPass();
+    radioLatencyReset();
+}
+
+void tearDown() {}
+
+// =============================================================================
+// HISTOGRAM
+// =============================================================================
+
+void test_buckets_are_exact_then_log_linear() {
+    for (uint32_t us = 0; us < 4; us++) {
+        TEST_ASSERT_EQUAL_UINT8(us, LatencyHistogram::bucketFor(us));
+        TEST_ASSERT_EQUAL_UINT32(us, LatencyHistogram::bucketUpper((uint8_t)us));
+    }
+
+    // Every value falls in a bucket whose range holds it, buckets are
+    // contiguous and never wider than a quarter of their lower bound
+    uint8_t prev = 3;
+    for (uint32_t us = 4; us < 300000; us++) {
+        uint8_t b = LatencyHistogram::bucketFor(us);
+        TEST_ASSERT_TRUE(b == prev || b == prev + 1);
+        TEST_ASSERT_TRUE(us <= LatencyHistogram::bucketUpper(b));
+        TEST_ASSERT_TRUE(us > LatencyHistogram::bucketUpper(b - 1));
+        uint32_t lower = LatencyHistogram::bucketUpper(b - 1) + 1;
+        TEST_ASSERT_TRUE(LatencyHistogram::bucketUpper(b) - lower + 1 <= lower / 4 + 1);
+        prev = b;
+    }
+
+    TEST_ASSERT_EQUAL_UINT8(LAT_HIST_BUCKETS - 1, LatencyHistogram::bucketFor(LAT_HIST_MAX_US));
+    TEST_ASSERT_EQUAL_UINT8(LAT_HIST_BUCKETS - 1, LatencyHistogram::bucketFor(0xFFFFFFFF));
+    TEST_ASSERT_EQUAL_UINT32(LAT_HIST_MAX_US, LatencyHistogram::bucketUpper(LAT_HIST_BUCKETS - 1));
+}
+
+void test_percentiles_and_max() {
+    LatencyHistogram h;
+    TEST_ASSERT_EQUAL_UINT32(0, h.percentile(50));
+
+    // 98 fast samples, 2 slow ones
+    for (int i = 0; i < 98; i++) h.record(1000);
+    h.record(40000);
+    h.record(50000);
+
+    TEST_ASSERT_EQUAL_UINT32(100, h.getCount());
+    TEST_ASSERT_EQUAL_UINT32(50000, h.getMax());
+    uint32_t p50 = h.percentile(50);
+    TEST_ASSERT_TRUE(p50 >= 1000 && p50 <= 1250);
+    uint32_t p99 = h.percentile(99);
+    TEST_ASSERT_TRUE(p99 >= 40000 && p99 <= 50000);
+    TEST_ASSERT_EQUAL_UINT32(50000, h.percentile(100));   // Capped at the exact max
+
+    h.reset();
+    TEST_ASSERT_EQUAL_UINT32(0, h.getCount());
+    TEST_ASSERT_EQUAL_UINT32(0, h.getMax());
+}
+
+// =============================================================================
+// END TO END
+// =============================================================================
+
+void test_change_is_recorded_when_flushed() {
+    mockMillis += 1000;                     // Past the RPM spacing
+    engineRPM = 2500;
+    canWrite(DIRTY_RPM);
+
+    mockMillis += 7;                        // Next loop() pass
+    radioPass();
+
+    const LatencyHistogram& h = radioGetLatency(SLOT_RPM_ID);
+    TEST_ASSERT_EQUAL_UINT32(1, h.getCount());
+    TEST_ASSERT_EQUAL_UINT32(7000, h.getMax());
+    TEST_ASSERT_EQUAL_STRING("RPM", radioLatencySlotName(SLOT_RPM_ID));
+}
+
+void test_age_includes_spacing_wait() {
+    mockMillis += 1000;
+    engineRPM = 2000;
+    canWrite(DIRTY_RPM);
+    radioPass();                            // Sent at once
+    TEST_ASSERT_EQUAL_UINT32(0, radioGetLatency(SLOT_RPM_ID).getMax());
+
+    mockMillis += 10;
+    engineRPM = 2100;
+    canWrite(DIRTY_RPM);                    // Held back by the 333 ms spacing
+
+    for (int i = 0; i < 40; i++) {
+        mockMillis += 10;
+        radioPass();
+    }
+
+    const LatencyHistogram& h = radioGetLatency(SLOT_RPM_ID);
+    TEST_ASSERT_EQUAL_UINT32(2, h.getCount());
+    TEST_ASSERT_EQUAL_UINT32(330000, h.getMax());   // First pass 333 ms after the send
+}
+
+void test_keep_alive_is_not_recorded() {
+    for (int i = 0; i < 50; i++) {
+        mockMillis += 1000;                 // Every keep-alive fires, nothing changed
+        radioPass();
+    }
+    TEST_ASSERT_TRUE(radioTxGetStats().bytesWritten > 0);
+    for (uint8_t s = 0; s < radioLatencySlotCount(); s++) {
+        TEST_ASSERT_EQUAL_UINT32(0, radioGetLatency(s).getCount());
+    }
+}
+
+void test_oldest_change_of_a_command_is_recorded() {
+    mockMillis += 1000;
+    dteValue = 119;
+    canWrite(DIRTY_DTE);                    // Range: held back by the 5 s spacing
+    mockMillis += 2000;
+    elapsedTime = 42;
+    canWrite(DIRTY_TRIP);
+
+    mockMillis += 5000;
+    radioPass();
+
+    const LatencyHistogram& h = radioGetLatency(SLOT_RANGE_ID);
+    TEST_ASSERT_EQUAL_UINT32(1, h.getCount());
+    TEST_ASSERT_EQUAL_UINT32(7000000, h.getMax());  // From the DTE change, not the trip one
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_buckets_are_exact_then_log_linear);
+    RUN_TEST(test_percentiles_and_max);
+    RUN_TEST(test_change_is_recorded_when_flushed);
+    RUN_TEST(test_age_includes_spacing_wait);
+    RUN_TEST(test_keep_alive_is_not_recorded);
+    RUN_TEST(test_oldest_change_of_a_command_is_recorded);
+    return UNITY_END();
+}
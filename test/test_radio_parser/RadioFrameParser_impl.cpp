@@ -0,0 +1,3 @@
+// Include the frame parser implementation into this test build
+// (see test_vehicle_params/CanConfigProcessor_impl.cpp).
+#include "../../src/RadioFrameParser.cpp"
@@ -0,0 +1,192 @@
+/**
+ * @file test_radio_parser.cpp
+ * @brief Unit tests for the 0x2E protocol RX parser (RadioFrameParser)
+ *
+ * Tests:
+ *   - complete frame, frame fed byte by byte, empty payload
+ *   - zero-copy view of a frame wrapping around the ring end
+ *   - resynchronization after a checksum failure
+ *   - ACK / NACK bytes between frames, not inside rejected frames
+ *   - ring full: feed() accepts what fits, pump() leaves the rest in the UART
+ *
+ * Run: pio test -e native
+ */
+
+#include <unity.h>
+#include "RadioFrameParser.h"
+
+static RadioFrameParser parser;
+
+// Steering frame: checksum = (0x29 + 0x02 + 0x34 + 0x12) ^ 0xFF = 0x8E
+static const uint8_t STEER[6] = {0x2E, 0x29, 0x02, 0x34, 0x12, 0x8E};
+
+void setUp() {
+    parser.reset();
+}
+
+void tearDown() {}
+
+// =============================================================================
+// FRAMING
+// =============================================================================
+
+void test_complete_frame_is_parsed() {
+    RadioFrameView f;
+    parser.feed(STEER, sizeof(STEER));
+
+    TEST_ASSERT_EQUAL(RadioParseResult::FRAME, parser.next(f));
+    TEST_ASSERT_EQUAL_HEX8(0x29, f.cmd);
+    TEST_ASSERT_EQUAL_UINT8(2, f.len);
+    TEST_ASSERT_EQUAL_UINT16(6, f.size());
+    TEST_ASSERT_EQUAL_HEX8(0x34, f.payload(0));
+    TEST_ASSERT_EQUAL_HEX8(0x12, f.payload(1));
+
+    TEST_ASSERT_EQUAL(RadioParseResult::NONE, parser.next(f));
+    TEST_ASSERT_EQUAL_UINT16(0, parser.getBuffered());
+}
+
+void test_frame_fed_byte_by_byte() {
+    RadioFrameView f;
+    for (uint8_t i = 0; i < sizeof(STEER) - 1; i++) {
+        parser.feed(&STEER[i], 1);
+        TEST_ASSERT_EQUAL(RadioParseResult::NONE, parser.next(f));
+    }
+    parser.feed(&STEER[5], 1);
+    TEST_ASSERT_EQUAL(RadioParseResult::FRAME, parser.next(f));
+    TEST_ASSERT_EQUAL_UINT32(1, parser.getStats().frames);
+}
+
+void test_empty_payload() {
+    const uint8_t frame[4] = {0x2E, 0x81, 0x00, 0x7E};   // (0x81 + 0) ^ 0xFF
+    RadioFrameView f;
+    parser.feed(frame, sizeof(frame));
+
+    TEST_ASSERT_EQUAL(RadioParseResult::FRAME, parser.next(f));
+    TEST_ASSERT_EQUAL_HEX8(0x81, f.cmd);
+    TEST_ASSERT_EQUAL_UINT8(0, f.len);
+}
+
+void test_view_spans_ring_wrap() {
+    RadioFrameView f;
+    uint8_t filler[RADIO_RX_BUFFER - 3];
+    memset(filler, 0x00, sizeof(filler));
+
+    // Junk up to 3 bytes before the ring end, then the frame across it
+    parser.feed(filler, sizeof(filler));
+    TEST_ASSERT_EQUAL(RadioParseResult::NONE, parser.next(f));
+    parser.feed(STEER, sizeof(STEER));
+
+    TEST_ASSERT_EQUAL(RadioParseResult::FRAME, parser.next(f));
+    TEST_ASSERT_EQUAL_UINT16(3, f.segLen[0]);
+    TEST_ASSERT_EQUAL_UINT16(3, f.segLen[1]);
+    TEST_ASSERT_EQUAL_HEX8(0x34, f.payload(0));
+    TEST_ASSERT_EQUAL_HEX8(0x12, f.payload(1));
+
+    uint8_t copy[6];
+    f.copyTo(copy);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(STEER, copy, 6);
+}
+
+// =============================================================================
+// RESYNCHRONIZATION
+// =============================================================================
+
+void test_resync_after_bad_checksum() {
+    // Corrupted frame whose payload hides a valid one
+    uint8_t stream[4 + 6 + 1];
+    stream[0] = 0x2E;
+    stream[1] = 0x7D;
+    stream[2] = 0x06;           // Claims 6 bytes: STEER + 1
+    memcpy(&stream[3], STEER, 6);
+    stream[9] = 0x00;           // Payload tail
+    stream[10] = 0x00;          // Wrong checksum
+
+    RadioFrameView f;
+    parser.feed(stream, sizeof(stream));
+
+    TEST_ASSERT_EQUAL(RadioParseResult::BAD_CHECKSUM, parser.next(f));
+    TEST_ASSERT_EQUAL(RadioParseResult::FRAME, parser.next(f));
+    TEST_ASSERT_EQUAL_HEX8(0x29, f.cmd);
+    TEST_ASSERT_EQUAL(RadioParseResult::NONE, parser.next(f));
+    TEST_ASSERT_EQUAL_UINT32(1, parser.getStats().badChecksums);
+}
+
+void test_ack_and_nack_between_frames() {
+    const uint8_t stream[] = {0xFF, 0x2E, 0x29, 0x02, 0x34, 0x12, 0x8E, 0xF0, 0x55};
+    RadioFrameView f;
+    parser.feed(stream, sizeof(stream));
+
+    TEST_ASSERT_EQUAL(RadioParseResult::ACK, parser.next(f));
+    TEST_ASSERT_EQUAL(RadioParseResult::FRAME, parser.next(f));
+    TEST_ASSERT_EQUAL(RadioParseResult::NACK, parser.next(f));
+    TEST_ASSERT_EQUAL(RadioParseResult::NONE, parser.next(f));
+    TEST_ASSERT_EQUAL_UINT32(1, parser.getStats().junkBytes);
+}
+
+void test_no_ack_inside_rejected_frame() {
+    const uint8_t stream[] = {0x2E, 0x40, 0x02, 0xFF, 0xF0, 0x00,  0xFF};
+    RadioFrameView f;
+    parser.feed(stream, sizeof(stream));
+
+    TEST_ASSERT_EQUAL(RadioParseResult::BAD_CHECKSUM, parser.next(f));
+    // Payload 0xFF/0xF0 skipped as junk; the byte after the frame is an ACK
+    TEST_ASSERT_EQUAL(RadioParseResult::ACK, parser.next(f));
+    TEST_ASSERT_EQUAL_UINT32(1, parser.getStats().acks);
+    TEST_ASSERT_EQUAL_UINT32(0, parser.getStats().nacks);
+}
+
+// =============================================================================
+// BUFFER LIMITS
+// =============================================================================
+
+void test_feed_stops_when_ring_is_full() {
+    static uint8_t junk[RADIO_RX_BUFFER + 10];
+    memset(junk, 0x00, sizeof(junk));
+
+    TEST_ASSERT_EQUAL_size_t(RADIO_RX_BUFFER, parser.feed(junk, sizeof(junk)));
+    TEST_ASSERT_EQUAL_UINT32(1, parser.getStats().overflows);
+
+    // Parsing frees the ring again
+    RadioFrameView f;
+    TEST_ASSERT_EQUAL(RadioParseResult::NONE, parser.next(f));
+    TEST_ASSERT_EQUAL_size_t(6, parser.feed(STEER, sizeof(STEER)));
+    TEST_ASSERT_EQUAL(RadioParseResult::FRAME, parser.next(f));
+}
+
+void test_pump_reads_only_what_fits() {
+    static HardwareSerial port;
+    memset(port.rx, 0x00, sizeof(port.rx));
+    port.rxLen = RADIO_RX_BUFFER + 100;
+    port.rxPos = 0;
+
+    TEST_ASSERT_EQUAL_size_t(RADIO_RX_BUFFER, parser.pump(port));
+    TEST_ASSERT_EQUAL_INT(100, port.available());
+
+    RadioFrameView f;
+    parser.next(f);
+    TEST_ASSERT_EQUAL_size_t(100, parser.pump(port));
+    TEST_ASSERT_EQUAL_INT(0, port.available());
+}
+
+// =============================================================================
+// ENTRY POINT
+// =============================================================================
+
+int main(int argc, char** argv) {
+    (void)argc; (void)argv;
+    UNITY_BEGIN();
+
+    RUN_TEST(test_complete_frame_is_parsed);
+    RUN_TEST(test_frame_fed_byte_by_byte);
+    RUN_TEST(test_empty_payload);
+    RUN_TEST(test_view_spans_ring_wrap);
+
+    RUN_TEST(test_resync_after_bad_checksum);
+    RUN_TEST(test_ack_and_nack_between_frames);
+    RUN_TEST(test_no_ack_inside_rejected_frame);
+
+    RUN_TEST(test_feed_stops_when_ring_is_full);
+    RUN_TEST(test_pump_reads_only_what_fits);
+
+    return UNITY_END();
+}
@@ -0,0 +1,11 @@
+// Include the head-unit encoder, its TX scheduler, the latency histogram and
+// the shared native stubs into this test build
+// (see test_vehicle_params/CanConfigProcessor_impl.cpp).
+#include "../../src/RadioSend.cpp"
+#include "../../src/RadioTx.cpp"
+#include "../../src/RadioFrameParser.cpp"
+#include "../../src/LatencyHistogram.cpp"
+#include "../test_vehicle_params/ConfigManager_stub.cpp"
+#include "../test_vehicle_params/GlobalData_stub.cpp"
+
+HardwareSerial RadioSerial;
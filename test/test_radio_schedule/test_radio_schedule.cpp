@@ -0,0 +1,115 @@
+/**
+ * @file test_radio_schedule.cpp
+ * @brief Unit tests for the radio deadline loop() sleeps on (radioNextDueMs)
+ *
+ * Tests:
+ *   - idle: next keep-alive of the fastest command
+ *   - a pending change waits for its minimum spacing only
+ *   - nothing is ever overdue after a pass with UART room
+ *   - a blinker timing out is a deadline (no CAN change announces it)
+ *   - frames left in the TX queue: short drain poll
+ *
+ * Run: pio test -e native
+ */
+
+#include <unity.h>
+#include "RadioSend.h"
+#include "RadioTx.h"
+#include "ConfigManager_mock.h"
+#include "GlobalData.h"
+
+extern HardwareSerial RadioSerial;
+
+static void radioPass(int txRoom = sizeof(RadioSerial.written)) {
+    RadioSerial.writtenLen = 0;
+    RadioSerial.txRoom = txRoom;
+    processRadioUpdates();
+}
+
+void setUp() {
+    mockReset();
+    radioTxReset();
+    lastLeftIndicatorTime = 0;
+    lastRightIndicatorTime = 0;
+
+    // Slot timers persist between tests: move past every keep-alive and
+    // send everything at the same time
+    mockMillis += 100000;
+    vehicleDataMarkDirty(DIRTY_ALL);
+    radioPass();
+}
+
+void tearDown() {}
+
+void test_idle_waits_for_fastest_keep_alive() {
+    TEST_ASSERT_EQUAL_UINT32(500, radioNextDueMs());       // Steering / lights keep-alive
+    mockMillis += 120;
+    TEST_ASSERT_EQUAL_UINT32(380, radioNextDueMs());
+    mockMillis += 380;
+    TEST_ASSERT_EQUAL_UINT32(0, radioNextDueMs());
+}
+
+void test_pending_change_waits_for_spacing() {
+    mockMillis += 400;
+    engineRPM = 3100;
+    vehicleDataMarkDirty(DIRTY_RPM | DIRTY_STEERING | DIRTY_LIGHTS);
+    radioPass();                                            // All three out at once
+    TEST_ASSERT_EQUAL_UINT32(500, radioNextDueMs());       // Steering / lights keep-alive
+
+    mockMillis += 10;
+    engineRPM = 3200;
+    vehicleDataMarkDirty(DIRTY_RPM);
+    radioPass();                                            // Held by the 333 ms spacing
+    TEST_ASSERT_EQUAL_UINT32(323, radioNextDueMs());
+}
+
+void test_no_command_overdue_after_pass() {
+    for (int i = 0; i < 200; i++) {
+        mockMillis += 37;
+        if (i % 3 == 0) {
+            currentSteer = (int16_t)(currentSteer + 5);
+            vehicleDataMarkDirty(DIRTY_STEERING | DIRTY_SPEED);
+        }
+        radioPass();
+        TEST_ASSERT_TRUE(radioNextDueMs() > 0);
+    }
+}
+
+void test_blinker_timeout_is_a_deadline() {
+    g_mock.indicatorTimeout = 300;
+    mockMillis += 450;
+    lastLeftIndicatorTime = mockMillis;
+    vehicleDataMarkDirty(DIRTY_LIGHTS | DIRTY_STEERING);
+    radioPass();                                            // Left blinker on, keep-alives restart
+
+    // Next: the blinker going off 300 ms after the last CAN pulse, before
+    // any keep-alive (500 ms)
+    mockMillis += 20;
+    TEST_ASSERT_EQUAL_UINT32(280, radioNextDueMs());
+    mockMillis += 280;
+    radioPass();                                            // Lights out without the blinker
+    TEST_ASSERT_EQUAL_size_t(6, RadioSerial.writtenLen);    // The lights frame only
+    TEST_ASSERT_EQUAL_UINT32(200, radioNextDueMs());       // Back to the keep-alives
+}
+
+void test_queued_frames_poll_soon() {
+    mockMillis += 1000;
+    vehicleDataMarkDirty(DIRTY_ALL);
+    radioPass(4);                                           // UART almost full
+    TEST_ASSERT_TRUE(radioTxGetPending() > 0);
+    TEST_ASSERT_EQUAL_UINT32(RADIO_DRAIN_POLL_MS, radioNextDueMs());
+
+    radioPass();
+    TEST_ASSERT_EQUAL_UINT16(0, radioTxGetPending());
+    TEST_ASSERT_TRUE(radioNextDueMs() > RADIO_DRAIN_POLL_MS);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_idle_waits_for_fastest_keep_alive);
+    RUN_TEST(test_pending_change_waits_for_spacing);
+    RUN_TEST(test_no_command_overdue_after_pass);
+    RUN_TEST(test_blinker_timeout_is_a_deadline);
+    RUN_TEST(test_queued_frames_poll_soon);
+    return UNITY_END();
+}
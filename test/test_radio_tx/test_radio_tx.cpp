@@ -0,0 +1,224 @@
+/**
+ * @file test_radio_tx.cpp
+ * @brief Unit tests for the head-unit TX scheduler (RadioTx)
+ *
+ * Tests:
+ *   - frame encoding (header, length, checksum)
+ *   - priority order between classes
+ *   - a started frame is finished before a higher class (no interleaving)
+ *   - starvation guard promotes old low-priority frames
+ *   - drops when a class queue is full, raw frame validation
+ *   - ACK/NACK replies go out at the next frame boundary
+ *   - link utilization accounting, first-frame timestamp
+ *
+ * Run: pio test -e native
+ */
+
+#include <unity.h>
+#include "RadioTx.h"
+
+HardwareSerial RadioSerial;
+
+static const uint8_t PAYLOAD[2] = {0x34, 0x12};
+
+void setUp() {
+    mockMillis = 1000;
+    RadioSerial = HardwareSerial();
+    radioTxReset();
+}
+
+void tearDown() {}
+
+// =============================================================================
+// ENCODING
+// =============================================================================
+
+void test_frame_is_built_with_checksum() {
+    TEST_ASSERT_TRUE(radioTxQueue(RadioClass::STEERING, 0x29, PAYLOAD, 2));
+    TEST_ASSERT_EQUAL_UINT16(6, radioTxGetPending());
+
+    radioTxFlush();
+
+    // Checksum = (0x29 + 0x02 + 0x34 + 0x12) ^ 0xFF = 0x71 ^ 0xFF = 0x8E
+    const uint8_t expected[6] = {0x2E, 0x29, 0x02, 0x34, 0x12, 0x8E};
+    TEST_ASSERT_EQUAL_size_t(6, RadioSerial.writtenLen);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, RadioSerial.written, 6);
+    TEST_ASSERT_EQUAL_UINT16(0, radioTxGetPending());
+    TEST_ASSERT_EQUAL_UINT32(1, radioTxGetClassStats(RadioClass::STEERING).framesSent);
+}
+
+void test_first_frame_time_is_kept() {
+    TEST_ASSERT_EQUAL_UINT32(0, radioTxGetStats().firstFrameMs);
+
+    radioTxQueue(RadioClass::STEERING, 0x29, PAYLOAD, 2);
+    radioTxFlush();
+    TEST_ASSERT_EQUAL_UINT32(1000, radioTxGetStats().firstFrameMs);
+
+    mockMillis = 1500;
+    radioTxQueue(RadioClass::STEERING, 0x29, PAYLOAD, 2);
+    radioTxFlush();
+    TEST_ASSERT_EQUAL_UINT32(1000, radioTxGetStats().firstFrameMs);
+}
+
+void test_due_frames_are_coalesced_into_one_write() {
+    radioTxQueue(RadioClass::TELEMETRY, 0x7D, PAYLOAD, 2);
+    radioTxQueue(RadioClass::TELEMETRY, 0x22, PAYLOAD, 2);
+    radioTxQueue(RadioClass::TELEMETRY, 0x23, PAYLOAD, 2);
+
+    radioTxFlush();
+
+    // One burst per flush, one driver call per frame
+    TEST_ASSERT_EQUAL_size_t(18, RadioSerial.writtenLen);
+    TEST_ASSERT_EQUAL_INT(3, RadioSerial.writeCalls);
+    TEST_ASSERT_EQUAL_UINT32(1, radioTxGetStats().bursts);
+}
+
+// =============================================================================
+// PRIORITY
+// =============================================================================
+
+void test_higher_class_goes_first() {
+    radioTxQueue(RadioClass::TELEMETRY, 0x7D, PAYLOAD, 2);
+    radioTxQueue(RadioClass::LIGHTS, 0x24, PAYLOAD, 1);
+    radioTxQueue(RadioClass::STEERING, 0x29, PAYLOAD, 2);
+
+    radioTxFlush();
+
+    TEST_ASSERT_EQUAL_HEX8(0x29, RadioSerial.written[1]);   // steering
+    TEST_ASSERT_EQUAL_HEX8(0x24, RadioSerial.written[7]);   // doors
+    TEST_ASSERT_EQUAL_HEX8(0x7D, RadioSerial.written[12]);  // telemetry
+}
+
+void test_started_frame_is_finished_before_higher_class() {
+    radioTxQueue(RadioClass::TELEMETRY, 0x7D, PAYLOAD, 2);
+
+    RadioSerial.txRoom = 3;     // Only half the frame fits
+    radioTxFlush();
+    TEST_ASSERT_EQUAL_size_t(3, RadioSerial.writtenLen);
+
+    radioTxQueue(RadioClass::SAFETY, 0x40, PAYLOAD, 2);
+    RadioSerial.txRoom = 128;
+    radioTxFlush();
+
+    // Rest of the telemetry frame, then the safety frame
+    TEST_ASSERT_EQUAL_size_t(12, RadioSerial.writtenLen);
+    TEST_ASSERT_EQUAL_HEX8(0x2E, RadioSerial.written[6]);
+    TEST_ASSERT_EQUAL_HEX8(0x40, RadioSerial.written[7]);
+}
+
+void test_starved_frame_is_promoted() {
+    radioTxQueue(RadioClass::TELEMETRY, 0x7D, PAYLOAD, 2);
+
+    mockMillis += RADIO_STARVATION_MS;
+    radioTxQueue(RadioClass::STEERING, 0x29, PAYLOAD, 2);
+    radioTxFlush();
+
+    TEST_ASSERT_EQUAL_HEX8(0x7D, RadioSerial.written[1]);
+    TEST_ASSERT_EQUAL_UINT32(1, radioTxGetClassStats(RadioClass::TELEMETRY).promotions);
+    TEST_ASSERT_EQUAL_UINT16(RADIO_STARVATION_MS, radioTxGetClassStats(RadioClass::TELEMETRY).latencyMaxMs);
+}
+
+// =============================================================================
+// BACKPRESSURE
+// =============================================================================
+
+void test_full_queue_drops_and_counts() {
+    RadioSerial.txRoom = 0;     // UART stalled
+    uint8_t big[60] = {0};
+
+    uint8_t accepted = 0;
+    for (int i = 0; i < 10; i++) {
+        if (radioTxQueue(RadioClass::TELEMETRY, 0x28, big, sizeof(big))) accepted++;
+    }
+
+    // 64-byte frames: exactly RADIO_TX_QUEUE_BYTES / 64 fit
+    TEST_ASSERT_EQUAL_UINT8(RADIO_TX_QUEUE_BYTES / 64, accepted);
+    TEST_ASSERT_EQUAL_UINT32(10 - accepted, radioTxGetClassStats(RadioClass::TELEMETRY).framesDropped);
+
+    // Other classes keep their own room
+    TEST_ASSERT_TRUE(radioTxQueue(RadioClass::STEERING, 0x29, PAYLOAD, 2));
+}
+
+void test_raw_frame_must_be_well_formed() {
+    const uint8_t good[6] = {0x2E, 0x40, 0x02, 0x01, 0x02, 0xBA};
+    const uint8_t badLen[6] = {0x2E, 0x40, 0x05, 0x01, 0x02, 0xBA};
+    const uint8_t badHead[6] = {0x2F, 0x40, 0x02, 0x01, 0x02, 0xBA};
+
+    TEST_ASSERT_TRUE(radioTxQueueRaw(RadioClass::SAFETY, good, 6));
+    TEST_ASSERT_FALSE(radioTxQueueRaw(RadioClass::SAFETY, badLen, 6));
+    TEST_ASSERT_FALSE(radioTxQueueRaw(RadioClass::SAFETY, badHead, 6));
+    TEST_ASSERT_EQUAL_UINT16(6, radioTxGetPending(RadioClass::SAFETY));
+}
+
+void test_ack_waits_for_frame_boundary() {
+    radioTxQueue(RadioClass::TELEMETRY, 0x7D, PAYLOAD, 2);
+    RadioSerial.txRoom = 3;
+    radioTxFlush();
+
+    TEST_ASSERT_TRUE(radioTxQueueAck(0xFF));
+    radioTxQueue(RadioClass::STEERING, 0x29, PAYLOAD, 2);
+    RadioSerial.txRoom = 128;
+    radioTxFlush();
+
+    // Rest of the started frame, the ACK, then the next frame
+    TEST_ASSERT_EQUAL_size_t(13, RadioSerial.writtenLen);
+    TEST_ASSERT_EQUAL_HEX8(0xFF, RadioSerial.written[6]);
+    TEST_ASSERT_EQUAL_HEX8(0x2E, RadioSerial.written[7]);
+    TEST_ASSERT_EQUAL_UINT32(1, radioTxGetStats().acksSent);
+}
+
+// =============================================================================
+// LINK UTILIZATION
+// =============================================================================
+
+void test_utilization_and_saturation() {
+    // Half a window's capacity → 50 %
+    uint32_t half = (uint32_t)RADIO_LINK_BYTES_PER_SEC * RADIO_UTIL_WINDOW_MS / 1000 / 2;
+    uint8_t payload[60] = {0};
+    RadioSerial.txRoom = 4096;
+    for (uint32_t sent = 0; sent + 64 <= half; sent += 64) {
+        radioTxQueue(RadioClass::TELEMETRY, 0x28, payload, sizeof(payload));
+        radioTxFlush();
+    }
+    mockMillis += RADIO_UTIL_WINDOW_MS;
+    radioTxFlush();
+
+    TEST_ASSERT_UINT8_WITHIN(5, 50, radioTxGetStats().utilization);
+    TEST_ASSERT_FALSE(radioTxIsSaturated());
+
+    // Full window → saturated
+    for (uint32_t sent = 0; sent < half * 2; sent += 64) {
+        radioTxQueue(RadioClass::TELEMETRY, 0x28, payload, sizeof(payload));
+        radioTxFlush();
+    }
+    mockMillis += RADIO_UTIL_WINDOW_MS;
+    radioTxFlush();
+
+    TEST_ASSERT_TRUE(radioTxIsSaturated());
+    TEST_ASSERT_EQUAL_UINT32(1, radioTxGetStats().saturatedWindows);
+}
+
+// =============================================================================
+// ENTRY POINT
+// =============================================================================
+
+int main(int argc, char** argv) {
+    (void)argc; (void)argv;
+    UNITY_BEGIN();
+
+    RUN_TEST(test_frame_is_built_with_checksum);
+    RUN_TEST(test_first_frame_time_is_kept);
+    RUN_TEST(test_due_frames_are_coalesced_into_one_write);
+
+    RUN_TEST(test_higher_class_goes_first);
+    RUN_TEST(test_started_frame_is_finished_before_higher_class);
+    RUN_TEST(test_starved_frame_is_promoted);
+
+    RUN_TEST(test_full_queue_drops_and_counts);
+    RUN_TEST(test_raw_frame_must_be_well_formed);
+    RUN_TEST(test_ack_waits_for_frame_boundary);
+
+    RUN_TEST(test_utilization_and_saturation);
+
+    return UNITY_END();
+}
@@ -0,0 +1,263 @@
+/**
+ * @file test_replay.cpp
+ * @brief Unit tests for CanReplay (candump / recorder logs into the processor)
+ *
+ * Tests:
+ *   - candump log: frames decoded, extended / CAN FD / bad lines skipped
+ *   - recorder file written by CanRecorder replays identically
+ *   - update() follows the log timing at 1x and faster, and loops;
+ *     msUntilNext() gives loop() the wait for the next frame
+ *   - "replay" profile settings, also restored from the compiled cache
+ *   - host replay of any log (CANBOX_REPLAY_LOG, see below)
+ *
+ * Replaying your own drive log on the host:
+ *   CANBOX_REPLAY_PROFILE=data/NissanJukeF15.json CANBOX_REPLAY_LOG=drive.log \
+ *   CANBOX_REPLAY_TRACE=/tmp/trace.csv pio test -e native -f test_replay
+ * writes one CSV line per change of the decoded vehicle data; diff two
+ * traces to compare profiles or firmware versions.
+ *
+ * Run: pio test -e native
+ */
+
+#include <unity.h>
+#include <stdlib.h>
+#include "CanReplay.h"
+#include "CanRecorder.h"
+#include "CanConfigProcessor.h"
+#include "ConfigManager_mock.h"
+#include "GlobalData.h"
+#include "LittleFS.h"
+
+static CanConfigProcessor proc;
+static CanReplay replay;
+static uint32_t handled = 0;
+
+static void processHandler(CanFrame& frame) {
+    proc.processFrame(frame);
+    handled++;
+}
+
+static void countHandler(CanFrame& frame) {
+    (void)frame;
+    handled++;
+}
+
+void setUp() {
+    LittleFS.basePath = "test/fixtures";
+    LittleFS.writable = false;
+    mockMillis = 1000;
+    handled = 0;
+    engineRPM = 0;
+}
+
+void tearDown() {
+    replay.end();
+}
+
+// =============================================================================
+// LOG FORMATS
+// =============================================================================
+
+void test_candump_log_feeds_processor() {
+    TEST_ASSERT_TRUE(proc.loadFromJson("/decoder_shapes.json"));
+    uint32_t unknownBefore = proc.getUnknownFrames();
+
+    TEST_ASSERT_TRUE(replay.begin("/replay_drive.log", 0));
+    TEST_ASSERT_EQUAL(CanReplayFormat::CANDUMP, replay.getFormat());
+    TEST_ASSERT_EQUAL_UINT32(4, replay.run(processHandler));
+    TEST_ASSERT_TRUE(replay.isFinished());
+
+    const CanReplayStats& st = replay.getStats();
+    TEST_ASSERT_EQUAL_UINT32(4, st.frames);
+    TEST_ASSERT_EQUAL_UINT32(3, st.skipped);        // Extended, CAN FD, not candump
+    TEST_ASSERT_EQUAL_UINT32(100000, st.logTimeUs);
+    TEST_ASSERT_EQUAL_UINT16(2000 * 3 / 2 + 10, engineRPM);
+    TEST_ASSERT_EQUAL_UINT32(unknownBefore + 2, proc.getUnknownFrames());  // 0x7FF, 0x123
+}
+
+void test_candump_parses_remote_and_timestamps() {
+    TEST_ASSERT_TRUE(replay.begin("/replay_drive.log"));
+    CanFrame frame;
+    uint64_t t;
+    TEST_ASSERT_TRUE(replay.next(frame, t));
+    TEST_ASSERT_EQUAL_HEX32(0x100, frame.identifier);
+    TEST_ASSERT_EQUAL_UINT8(8, frame.data_length_code);
+    TEST_ASSERT_EQUAL_HEX8(0xE8, frame.data[0]);
+    TEST_ASSERT_EQUAL_UINT32(0, (uint32_t)t);
+    TEST_ASSERT_TRUE(replay.next(frame, t));
+    TEST_ASSERT_EQUAL_UINT32(10000, (uint32_t)t);
+    TEST_ASSERT_TRUE(replay.next(frame, t));
+    TEST_ASSERT_EQUAL_UINT32(50000, (uint32_t)t);
+    TEST_ASSERT_TRUE(replay.next(frame, t));
+    TEST_ASSERT_EQUAL_HEX32(0x123, frame.identifier);
+    TEST_ASSERT_EQUAL(1, frame.rtr);
+    TEST_ASSERT_FALSE(replay.next(frame, t));
+}
+
+void test_recorder_file_replays() {
+    LittleFS.writable = true;
+    TEST_ASSERT_TRUE(canRecorderStart());
+    for (uint8_t i = 0; i < 10; i++) {
+        CanFrame f = {};
+        f.identifier = 0x100;
+        f.data_length_code = 8;
+        f.data[0] = i;
+        canRecorderCapture(f);
+        mockMillis += 5;
+    }
+    canRecorderStop();
+
+    TEST_ASSERT_TRUE(replay.begin(REC_FILE_0, 0));
+    TEST_ASSERT_EQUAL(CanReplayFormat::RECORDER, replay.getFormat());
+    CanFrame frame;
+    uint64_t t = 0;
+    uint8_t n = 0;
+    while (replay.next(frame, t)) {
+        TEST_ASSERT_EQUAL_HEX32(0x100, frame.identifier);
+        TEST_ASSERT_EQUAL_HEX8(n, frame.data[0]);
+        n++;
+    }
+    TEST_ASSERT_EQUAL_UINT8(10, n);
+    TEST_ASSERT_EQUAL_UINT32(45000, (uint32_t)t);
+
+    replay.end();
+    LittleFS.remove(REC_FILE_0);
+    LittleFS.remove(REC_FILE_1);
+}
+
+void test_rejects_unknown_file() {
+    TEST_ASSERT_FALSE(replay.begin("/decoder_shapes.json"));
+    TEST_ASSERT_FALSE(replay.begin("/missing.log"));
+    TEST_ASSERT_FALSE(replay.isActive());
+}
+
+// =============================================================================
+// TIMING
+// =============================================================================
+
+void test_update_follows_log_timing() {
+    TEST_ASSERT_TRUE(replay.begin("/replay_drive.log", 1));
+    TEST_ASSERT_EQUAL_UINT16(1, replay.update(countHandler));     // t = 0
+    TEST_ASSERT_EQUAL_UINT32(10, replay.msUntilNext());
+    mockMillis += 9;
+    TEST_ASSERT_EQUAL_UINT32(1, replay.msUntilNext());
+    TEST_ASSERT_EQUAL_UINT16(0, replay.update(countHandler));
+    mockMillis += 1;
+    TEST_ASSERT_EQUAL_UINT32(0, replay.msUntilNext());
+    TEST_ASSERT_EQUAL_UINT16(1, replay.update(countHandler));     // t = 10 ms
+    mockMillis += 100;
+    TEST_ASSERT_EQUAL_UINT16(2, replay.update(countHandler));     // 50 and 100 ms, late
+    TEST_ASSERT_EQUAL_UINT32(60000, replay.getStats().maxLateUs);
+    TEST_ASSERT_EQUAL_UINT16(0, replay.update(countHandler));
+    TEST_ASSERT_TRUE(replay.isFinished());
+    TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, replay.msUntilNext());
+
+    // 10x: the whole 100 ms log in 10 ms
+    TEST_ASSERT_TRUE(replay.begin("/replay_drive.log", 10));
+    replay.update(countHandler);
+    mockMillis += 10;
+    TEST_ASSERT_EQUAL_UINT16(3, replay.update(countHandler));
+}
+
+void test_update_loops_at_end() {
+    TEST_ASSERT_TRUE(replay.begin("/replay_drive.log", 0, true));
+    TEST_ASSERT_EQUAL_UINT16(REPLAY_MAX_BURST, replay.update(countHandler));
+    TEST_ASSERT_FALSE(replay.isFinished());
+    TEST_ASSERT_EQUAL_UINT32(REPLAY_MAX_BURST / 4 - 1, replay.getStats().loops);
+}
+
+// =============================================================================
+// PROFILE
+// =============================================================================
+
+void test_profile_replay_settings_survive_cache() {
+    TEST_ASSERT_TRUE(proc.loadFromJson("/replay_profile.json"));
+    TEST_ASSERT_TRUE(proc.isReplayMode());
+    TEST_ASSERT_FALSE(proc.usesCanBus());
+    TEST_ASSERT_EQUAL_STRING("REPLAY", proc.getModeName());
+    TEST_ASSERT_EQUAL_STRING("/replay_drive.log", proc.getReplayFile());
+    TEST_ASSERT_EQUAL_UINT16(4, proc.getReplaySpeed());
+    TEST_ASSERT_TRUE(proc.getReplayLoop());
+
+    LittleFS.writable = true;
+    FILE* src = fopen("test/fixtures/replay_profile.json", "rb");
+    FILE* dst = fopen("test/fixtures/replay_tmp.json", "wb");
+    int c;
+    while ((c = fgetc(src)) != EOF) fputc(c, dst);
+    fclose(src);
+    fclose(dst);
+
+    CanConfigProcessor parsed;
+    TEST_ASSERT_TRUE(parsed.loadFromJson("/replay_tmp.json"));
+    CanConfigProcessor cached;
+    TEST_ASSERT_TRUE(cached.loadFromCache("/replay_tmp.json"));
+    TEST_ASSERT_EQUAL_STRING("/replay_drive.log", cached.getReplayFile());
+    TEST_ASSERT_EQUAL_UINT16(4, cached.getReplaySpeed());
+    TEST_ASSERT_TRUE(cached.getReplayLoop());
+
+    LittleFS.remove("/replay_tmp.pcache");
+    LittleFS.remove("/replay_tmp.json");
+    LittleFS.writable = false;
+
+    TEST_ASSERT_TRUE(proc.loadFromJson("/decoder_shapes.json"));
+    TEST_ASSERT_FALSE(proc.isReplayMode());
+    TEST_ASSERT_TRUE(proc.usesCanBus());
+}
+
+// =============================================================================
+// HOST REPLAY
+// =============================================================================
+
+static FILE* trace = nullptr;
+
+static void traceHandler(CanFrame& frame) {
+    uint16_t before = vehicleDirty;
+    processHandler(frame);
+    if (vehicleDirty == before && handled > 1) return;
+    vehicleDirty = 0;
+    fprintf(trace, "%.6f,%d,%u,%u,%u,%u,%.1f,%d,%d,%lu,%d%d%d,%u,%u\n",
+            replay.getStats().logTimeUs / 1e6, currentSteer, engineRPM, vehicleSpeed,
+            currentDoors, fuelLevel, voltBat, dteValue, tempExt, (unsigned long)currentOdo,
+            headlightsOn, highBeamOn, parkingLightsOn, fuelConsumptionInst, fuelConsumptionAvg);
+}
+
+void test_host_replay_from_environment() {
+    const char* log = getenv("CANBOX_REPLAY_LOG");
+    const char* profile = getenv("CANBOX_REPLAY_PROFILE");
+    if (!log || !profile) {
+        TEST_IGNORE_MESSAGE("set CANBOX_REPLAY_LOG and CANBOX_REPLAY_PROFILE to replay a log");
+    }
+    const char* tracePath = getenv("CANBOX_REPLAY_TRACE");
+
+    LittleFS.basePath = ".";
+    TEST_ASSERT_TRUE_MESSAGE(proc.loadFromJson(profile), "profile did not load");
+    TEST_ASSERT_TRUE_MESSAGE(replay.begin(log, 0), "not a candump/recorder log");
+    uint32_t unknownBefore = proc.getUnknownFrames();
+
+    trace = tracePath ? fopen(tracePath, "w") : stdout;
+    TEST_ASSERT_NOT_NULL(trace);
+    fprintf(trace, "time,steer,rpm,speed,doors,fuel,volt,dte,temp,odo,lights,consInst,consAvg\n");
+    vehicleDirty = 0;
+    replay.run(traceHandler);
+    if (trace != stdout) fclose(trace);
+
+    const CanReplayStats& st = replay.getStats();
+    printf("Replayed %lu frames (%.1f s of log), %lu skipped, %lu not in the profile\n",
+           (unsigned long)st.frames, st.logTimeUs / 1e6, (unsigned long)st.skipped,
+           (unsigned long)(proc.getUnknownFrames() - unknownBefore));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_candump_log_feeds_processor);
+    RUN_TEST(test_candump_parses_remote_and_timestamps);
+    RUN_TEST(test_recorder_file_replays);
+    RUN_TEST(test_rejects_unknown_file);
+    RUN_TEST(test_update_follows_log_timing);
+    RUN_TEST(test_update_loops_at_end);
+    RUN_TEST(test_profile_replay_settings_survive_cache);
+    RUN_TEST(test_host_replay_from_environment);
+
+    return UNITY_END();
+}
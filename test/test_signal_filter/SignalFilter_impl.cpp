@@ -0,0 +1,3 @@
+// Include the field filter into this test build
+// (see test_vehicle_params/CanConfigProcessor_impl.cpp).
+#include "../../src/SignalFilter.cpp"
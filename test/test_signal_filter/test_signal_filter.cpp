@@ -0,0 +1,136 @@
+/**
+ * @file test_signal_filter.cpp
+ * @brief Unit tests for the per-field signal filter
+ *
+ * Tests:
+ *   - the first value is always published
+ *   - median drops single-frame spikes
+ *   - EMA converges with rounding, negative values included
+ *   - deadband holds small changes, publishes large ones
+ *   - rate limit publishes a held change once the interval passed
+ *   - sanitize clamps the configuration and detects an empty filter
+ *
+ * Run: pio test -e native
+ */
+
+#include <unity.h>
+#include "SignalFilter.h"
+
+static SignalFilter filter;
+
+static FieldFilterConfig makeConfig(uint8_t median, uint8_t emaShift,
+                                    int32_t deadband, uint16_t minIntervalMs) {
+    FieldFilterConfig c;
+    c.median = median;
+    c.emaShift = emaShift;
+    c.deadband = deadband;
+    c.minIntervalMs = minIntervalMs;
+    return c;
+}
+
+/**
+ * @brief Feed a value; returns the published value or INT32_MIN if held
+ */
+static int32_t feed(int32_t value, uint32_t nowMs = 0) {
+    int32_t out;
+    return filter.apply(value, nowMs, out) ? out : INT32_MIN;
+}
+
+void setUp() {}
+void tearDown() {}
+
+// =============================================================================
+// TESTS
+// =============================================================================
+
+void test_first_value_published() {
+    filter.begin(makeConfig(0, 0, 50, 1000));
+    TEST_ASSERT_EQUAL_INT32(-7, feed(-7));
+    TEST_ASSERT_EQUAL_INT32(INT32_MIN, feed(-7));     // Unchanged: nothing to store
+    TEST_ASSERT_EQUAL_UINT32(0, filter.getHeld());
+}
+
+void test_median_drops_spikes() {
+    filter.begin(makeConfig(3, 0, 0, 0));
+    TEST_ASSERT_EQUAL_INT32(100, feed(100));
+    TEST_ASSERT_EQUAL_INT32(INT32_MIN, feed(100));
+    TEST_ASSERT_EQUAL_INT32(INT32_MIN, feed(900));    // Spike: median still 100
+    TEST_ASSERT_EQUAL_INT32(INT32_MIN, feed(100));
+    TEST_ASSERT_EQUAL_INT32(INT32_MIN, feed(0));      // Dip: median still 100
+
+    // A real step shows up once it is the majority of the window
+    TEST_ASSERT_EQUAL_INT32(INT32_MIN, feed(200));    // {100, 0, 200} -> 100
+    TEST_ASSERT_EQUAL_INT32(200, feed(200));          // {0, 200, 200} -> 200
+}
+
+void test_ema_converges_with_rounding() {
+    filter.begin(makeConfig(0, 2, 0, 0));
+    TEST_ASSERT_EQUAL_INT32(0, feed(0));
+    TEST_ASSERT_EQUAL_INT32(25, feed(100));           // 0 + 100/4
+    TEST_ASSERT_EQUAL_INT32(44, feed(100));           // 25 + 75/4 = 43.75
+    int32_t last = 44;
+    for (int i = 0; i < 40; i++) {
+        int32_t v = feed(100);
+        if (v != INT32_MIN) last = v;
+    }
+    TEST_ASSERT_EQUAL_INT32(100, last);
+
+    filter.begin(makeConfig(0, 1, 0, 0));
+    TEST_ASSERT_EQUAL_INT32(-10, feed(-10));
+    TEST_ASSERT_EQUAL_INT32(-15, feed(-20));
+    TEST_ASSERT_EQUAL_INT32(-17, feed(-20));          // -17.5: halves round up
+}
+
+void test_deadband_holds_small_changes() {
+    filter.begin(makeConfig(0, 0, 5, 0));
+    TEST_ASSERT_EQUAL_INT32(1000, feed(1000));
+    TEST_ASSERT_EQUAL_INT32(INT32_MIN, feed(1004));
+    TEST_ASSERT_EQUAL_INT32(INT32_MIN, feed(996));
+    TEST_ASSERT_EQUAL_INT32(1005, feed(1005));
+    TEST_ASSERT_EQUAL_INT32(INT32_MIN, feed(1001));   // Relative to the new value
+    TEST_ASSERT_EQUAL_INT32(998, feed(998));
+    TEST_ASSERT_EQUAL_UINT32(3, filter.getHeld());
+}
+
+void test_rate_limit_publishes_after_interval() {
+    filter.begin(makeConfig(0, 0, 0, 200));
+    TEST_ASSERT_EQUAL_INT32(10, feed(10, 1000));
+    TEST_ASSERT_EQUAL_INT32(INT32_MIN, feed(11, 1050));
+    TEST_ASSERT_EQUAL_INT32(INT32_MIN, feed(12, 1199));
+    TEST_ASSERT_EQUAL_INT32(12, feed(12, 1200));      // Held change lands on the next frame
+    TEST_ASSERT_EQUAL_INT32(INT32_MIN, feed(12, 1210));
+    TEST_ASSERT_EQUAL_INT32(INT32_MIN, feed(13, 1300));
+    TEST_ASSERT_EQUAL_INT32(14, feed(14, 1400));
+    TEST_ASSERT_EQUAL_UINT32(3, filter.getHeld());
+
+    // millis() wrap
+    filter.begin(makeConfig(0, 0, 0, 200));
+    TEST_ASSERT_EQUAL_INT32(1, feed(1, 0xFFFFFFA0u));
+    TEST_ASSERT_EQUAL_INT32(INT32_MIN, feed(2, 0xFFFFFFF0u));
+    TEST_ASSERT_EQUAL_INT32(2, feed(2, 0x00000068u));
+}
+
+void test_sanitize_clamps_config() {
+    FieldFilterConfig c = makeConfig(9, 30, -4, 0);
+    TEST_ASSERT_TRUE(SignalFilter::sanitize(c));
+    TEST_ASSERT_EQUAL_UINT8(FILTER_MEDIAN_MAX, c.median);
+    TEST_ASSERT_EQUAL_UINT8(FILTER_EMA_MAX_SHIFT, c.emaShift);
+    TEST_ASSERT_EQUAL_INT32(0, c.deadband);
+
+    // Median of 1 and a deadband of 1 change nothing
+    c = makeConfig(1, 0, 1, 0);
+    TEST_ASSERT_FALSE(SignalFilter::sanitize(c));
+    c = makeConfig(0, 0, 0, 0);
+    TEST_ASSERT_FALSE(SignalFilter::sanitize(c));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_first_value_published);
+    RUN_TEST(test_median_drops_spikes);
+    RUN_TEST(test_ema_converges_with_rounding);
+    RUN_TEST(test_deadband_holds_small_changes);
+    RUN_TEST(test_rate_limit_publishes_after_interval);
+    RUN_TEST(test_sanitize_clamps_config);
+    return UNITY_END();
+}
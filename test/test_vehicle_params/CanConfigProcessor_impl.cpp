@@ -2,3 +2,5 @@
 // PlatformIO native test mode does not automatically compile src/ files,
 // so we pull the implementation in explicitly here.
 #include "../../src/CanConfigProcessor.cpp"
+#include "../../src/SignalFilter.cpp"
+#include "../../src/crc32.cpp"
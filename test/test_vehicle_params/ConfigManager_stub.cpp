@@ -20,6 +20,7 @@ void configReset() {
     g_mock.rpmDivisor       = 7;
     g_mock.tankCapacity     = 45;
     g_mock.dteDivisor       = 283;
+    g_mock.canPromisc       = false;
     g_mock.steerScaleSet       = false;
     g_mock.steerOffsetSet      = false;
     g_mock.steerInvertSet      = false;
@@ -49,6 +50,7 @@ uint16_t configGetIndicatorTimeout() { return g_mock.indicatorTimeout; }
 uint8_t  configGetRpmDivisor()       { return g_mock.rpmDivisor; }
 uint8_t  configGetTankCapacity()     { return g_mock.tankCapacity; }
 uint16_t configGetDteDivisor()       { return g_mock.dteDivisor; }
+bool     configGetCanPromisc()       { return g_mock.canPromisc; }
 
 void configSetSteerOffset(int16_t v)      { g_mock.steerOffset = v; g_mock.steerOffsetSet = true; }
 void configSetSteerInvert(bool v)         { g_mock.steerInvert = v; g_mock.steerInvertSet = true; }
@@ -57,3 +59,4 @@ void configSetIndicatorTimeout(uint16_t v){ g_mock.indicatorTimeout = v; g_mock.
 void configSetRpmDivisor(uint8_t v)       { g_mock.rpmDivisor = v; g_mock.rpmDivisorSet = true; }
 void configSetTankCapacity(uint8_t v)     { g_mock.tankCapacity = v; g_mock.tankCapacitySet = true; }
 void configSetDteDivisor(uint16_t v)      { g_mock.dteDivisor = v; g_mock.dteDivisorSet = true; }
+void configSetCanPromisc(bool v)          { g_mock.canPromisc = v; }
@@ -27,6 +27,8 @@ uint16_t fuelConsumptionAvg  = 0;
 uint16_t averageSpeed        = 0;
 uint16_t elapsedTime         = 0;
 
+volatile uint16_t vehicleDirty = 0;
+
 // Arduino and filesystem globals (SerialClass and FS are defined in Arduino.h/LittleFS.h mocks)
 SerialClass Serial;
 FS LittleFS;
@@ -12,6 +12,7 @@
 #include "CanConfigProcessor.h"
 #include "ConfigManager_mock.h"
 #include "LittleFS.h"
+#include "FixtureSupport.h"
 
 // Globals are defined in GlobalData_stub.cpp
 
@@ -167,6 +168,40 @@ void test_mock_mode_flag_from_json() {
     TEST_ASSERT_TRUE(proc.isMockMode());
 }
 
+// =============================================================================
+// COMPILED CACHE: vehicleParams cached with the profile
+// =============================================================================
+
+void test_cache_switch_applies_vehicle_params() {
+    LittleFS.writable = true;
+    copyFixture("full_params.json", "params_tmp.json");
+    CanConfigProcessor parsed;
+    TEST_ASSERT_TRUE(parsed.loadFromJson("/params_tmp.json"));
+
+    // Another vehicle active since: the cached load is a vehicle switch
+    mockReset();
+    strncpy(g_mock.vehicleFile, "other_vehicle.json", sizeof(g_mock.vehicleFile));
+    CanConfigProcessor cached;
+    TEST_ASSERT_TRUE(cached.loadFromCache("/params_tmp.json"));
+    TEST_ASSERT_TRUE(cached.isLoadedFromCache());
+    TEST_ASSERT_EQUAL_INT(1, g_mock.resetCount);
+    TEST_ASSERT_EQUAL_INT(1, g_mock.saveCount);
+    TEST_ASSERT_EQUAL_UINT16(500, g_mock.steerScale);
+    TEST_ASSERT_EQUAL_UINT16(200, g_mock.dteDivisor);
+    TEST_ASSERT_EQUAL_STRING("params_tmp.json", g_mock.vehicleFile);
+
+    // Same vehicle again: calibration untouched
+    g_mock.steerScale = 9999;
+    CanConfigProcessor again;
+    TEST_ASSERT_TRUE(again.loadFromCache("/params_tmp.json"));
+    TEST_ASSERT_EQUAL_INT(1, g_mock.resetCount);
+    TEST_ASSERT_EQUAL_UINT16(9999, g_mock.steerScale);
+
+    LittleFS.remove("/params_tmp.pcache");
+    LittleFS.remove("/params_tmp.json");
+    LittleFS.writable = false;
+}
+
 void test_real_can_mode_flag_from_json() {
     g_mock.vehicleFile[0] = '\0';
 
@@ -192,6 +227,7 @@ int main(int argc, char** argv) {
     RUN_TEST(test_profile_name_loaded_correctly);
     RUN_TEST(test_mock_mode_flag_from_json);
     RUN_TEST(test_real_can_mode_flag_from_json);
+    RUN_TEST(test_cache_switch_applies_vehicle_params);
 
     return UNITY_END();
 }
@@ -0,0 +1,368 @@
+"""
+Profile baking for ESP32 CANBox: vehicle JSON -> generated C++ decoder.
+
+Turns one vehicle profile into include/BakedProfile.h: constexpr frame,
+field and filter tables (the same VehicleConfig.h structures the JSON
+parser fills) plus bakedDecode(), a switch(canId) with every field's
+extraction and formula inlined as constants. CanConfigProcessor uses it
+when built with PROFILE_BAKED=1 (see CanConfigProcessor::loadBaked()).
+
+PlatformIO pre-script: does nothing unless the environment sets
+    custom_bake_profile = data/NissanJukeF15.json
+in which case the header is regenerated and PROFILE_BAKED=1 is defined.
+
+Standalone:
+    python tools/bake_profile.py data/NissanJukeF15.json include/BakedProfile.h
+
+Parsing mirrors parseFrameConfig() in CanConfigProcessor.cpp (same
+defaults for missing keys, same fallbacks for unknown names), so a baked
+profile decodes exactly like the JSON it came from.
+"""
+
+import json
+import os
+import sys
+
+# ---------------------------------------------------------------------------
+# Configuration — must match firmware constants
+# ---------------------------------------------------------------------------
+
+PROFILE_MAX_FRAMES = 64
+PROFILE_MAX_FIELDS = 128
+PROFILE_MAX_FILTERS = 16
+FILTER_MEDIAN_MAX = 5
+FILTER_EMA_MAX_SHIFT = 8
+CAN_DISPATCH_SIZE = 2048
+
+TARGETS = [
+    "STEERING", "ENGINE_RPM", "VEHICLE_SPEED", "FUEL_LEVEL", "ODOMETER",
+    "VOLTAGE", "TEMPERATURE", "DTE", "FUEL_CONS_INST", "FUEL_CONS_AVG",
+    "DOOR_DRIVER", "DOOR_PASSENGER", "DOOR_REAR_LEFT", "DOOR_REAR_RIGHT", "DOOR_BOOT",
+    "INDICATOR_LEFT", "INDICATOR_RIGHT", "HEADLIGHTS", "HIGH_BEAM", "PARKING_LIGHTS",
+]
+DOOR_BITS = {
+    "DOOR_DRIVER": 0x80, "DOOR_PASSENGER": 0x40, "DOOR_REAR_LEFT": 0x20,
+    "DOOR_REAR_RIGHT": 0x10, "DOOR_BOOT": 0x08,
+}
+DATA_TYPES = ["UINT8", "INT8", "UINT16", "INT16", "UINT24", "UINT32", "BITMASK"]
+FORMULAS = ["NONE", "SCALE", "MAP_RANGE", "BITMASK_EXTRACT"]
+LITTLE_ENDIAN_NAMES = ("LE", "LITTLE_ENDIAN", "LSB_FIRST")
+
+HEADER_NAME = "BakedProfile.h"
+
+
+class BakeError(Exception):
+    pass
+
+
+# ---------------------------------------------------------------------------
+# Profile parsing (mirrors parseFrameConfig)
+# ---------------------------------------------------------------------------
+
+def parse_int(value, default=0) -> int:
+    if value is None:
+        return default
+    if isinstance(value, bool):
+        return int(value)
+    if isinstance(value, str):
+        return int(value, 0)
+    return int(value)
+
+
+def sanitize_filter(obj: dict):
+    """SignalFilter::sanitize(): None if every stage is disabled."""
+    median = min(parse_int(obj.get("median")) & 0xFF, FILTER_MEDIAN_MAX)
+    if median == 1:
+        median = 0
+    ema = min(parse_int(obj.get("emaShift")) & 0xFF, FILTER_EMA_MAX_SHIFT)
+    deadband = max(parse_int(obj.get("deadband")), 0)
+    interval = parse_int(obj.get("minIntervalMs")) & 0xFFFF
+    if not (median or ema or deadband > 1 or interval):
+        return None
+    return {"deadband": deadband, "minIntervalMs": interval, "median": median, "emaShift": ema}
+
+
+def parse_profile(doc: dict) -> dict:
+    if doc.get("isMock", False):
+        raise BakeError("mock profiles have no frames to bake")
+    if doc.get("replay"):
+        raise BakeError("replay profiles cannot be baked")
+
+    frames, fields, filters = [], [], []
+    for frame_obj in doc.get("frames", []):
+        can_id = parse_int(frame_obj.get("canId")) & 0xFFFF
+        field_objs = frame_obj.get("fields", [])
+        frame = {"canId": can_id, "firstField": len(fields), "fieldCount": len(field_objs)}
+        frames.append(frame)
+
+        for obj in field_objs:
+            target = obj.get("target", "STEERING")
+            field = {
+                "target": target if target in TARGETS else "STEERING",
+                "startByte": parse_int(obj.get("startByte")) & 0xFF,
+                "byteCount": parse_int(obj.get("byteCount"), 1) & 0xFF,
+                "littleEndian": obj.get("byteOrder", "BE") in LITTLE_ENDIAN_NAMES,
+                "dataType": obj.get("dataType", "UINT8"),
+                "formula": obj.get("formula", "NONE"),
+                "params": [0, 0, 0, 0],
+                "filter": 0,
+            }
+            if field["dataType"] not in DATA_TYPES:
+                field["dataType"] = "UINT8"
+            if field["formula"] not in FORMULAS:
+                field["formula"] = "NONE"
+            for i, p in enumerate(obj.get("params", [])[:4]):
+                field["params"][i] = parse_int(p)
+
+            if not 1 <= field["byteCount"] <= 4 or field["startByte"] + field["byteCount"] > 8:
+                raise BakeError(f"0x{can_id:03X} {target}: bytes {field['startByte']}+{field['byteCount']} "
+                                "outside the 8-byte payload")
+            if field["formula"] == "BITMASK_EXTRACT" and not 0 <= field["params"][1] < 32:
+                raise BakeError(f"0x{can_id:03X} {target}: shift {field['params'][1]} out of range")
+
+            if isinstance(obj.get("filter"), dict):
+                flt = sanitize_filter(obj["filter"])
+                if flt:
+                    filters.append(flt)
+                    field["filter"] = len(filters)
+            fields.append(field)
+
+    if not frames:
+        raise BakeError("profile has no frames")
+    if len(frames) > PROFILE_MAX_FRAMES or len(fields) > PROFILE_MAX_FIELDS or len(filters) > PROFILE_MAX_FILTERS:
+        raise BakeError(f"profile too large: max {PROFILE_MAX_FRAMES} frames, {PROFILE_MAX_FIELDS} fields, "
+                        f"{PROFILE_MAX_FILTERS} filters")
+
+    return {
+        "name": str(doc.get("name", "Unknown")),
+        "vehicleParams": doc.get("vehicleParams"),
+        "frames": frames,
+        "fields": fields,
+        "filters": filters,
+    }
+
+
+# ---------------------------------------------------------------------------
+# Code generation
+# ---------------------------------------------------------------------------
+
+def c_string(text: str) -> str:
+    return json.dumps(text, ensure_ascii=True)
+
+
+def word_expr(field: dict) -> str:
+    """Unsigned word read by the field (Extract<> in CanConfigProcessor.cpp)."""
+    start, count = field["startByte"], field["byteCount"]
+    order = range(count - 1, -1, -1) if field["littleEndian"] else range(count)
+    parts = []
+    for shift, i in zip(range(8 * (count - 1), -1, -8), order):
+        byte = f"d[{start + i}]"
+        parts.append(f"((uint32_t){byte} << {shift})" if shift else f"(uint32_t){byte}")
+    return " | ".join(parts)
+
+
+def value_expr(field: dict, word: str) -> str:
+    """Raw value after sign extension, then the formula, as an int32_t expression."""
+    if field["dataType"] == "INT8":
+        v = f"(int32_t)(int8_t){word}"
+    elif field["dataType"] == "INT16":
+        v = f"(int32_t)(int16_t){word}"
+    else:
+        v = f"(int32_t){word}"
+
+    p = field["params"]
+    formula = field["formula"]
+    if formula == "SCALE":
+        mult = p[0] or 1
+        div = p[1] or 1
+        expr = v
+        if mult != 1:
+            expr = f"{expr} * {mult}"
+        if div != 1:
+            expr = f"({expr}) / {div}"
+        if p[2]:
+            expr = f"{expr} + ({p[2]})"
+        return expr
+    if formula == "MAP_RANGE":
+        return f"(int32_t)map({v}, {p[0]}, {p[1]}, {p[2]}, {p[3]})"
+    if formula == "BITMASK_EXTRACT":
+        return f"({v} & {p[0]}) >> {p[1]}"
+    return v
+
+
+def frame_body(profile: dict, frame: dict) -> list:
+    fields = profile["fields"][frame["firstField"]:frame["firstField"] + frame["fieldCount"]]
+    lines = []
+
+    # One local per distinct word
+    words = {}
+    for field in fields:
+        key = (field["startByte"], field["byteCount"], field["littleEndian"])
+        if key not in words:
+            words[key] = f"w{len(words)}"
+            lines.append(f"const uint32_t {words[key]} = {word_expr(field)};")
+
+    # Doors: folded into one currentDoors store when each door appears once
+    # and none is filtered (otherwise the profile order of the writes matters)
+    doors = [f for f in fields if f["target"] in DOOR_BITS]
+    door_targets = [f["target"] for f in doors]
+    fold = (len(doors) >= 2 and len(set(door_targets)) == len(door_targets)
+            and not any(f["filter"] for f in doors))
+    door_mask = sum(DOOR_BITS[t] for t in door_targets)
+
+    for field in fields:
+        if fold and field in doors:
+            continue
+        word = words[(field["startByte"], field["byteCount"], field["littleEndian"])]
+        expr = value_expr(field, word)
+        target = f"OutputField::{field['target']}"
+        if field["filter"]:
+            lines.append(f"bakedStoreFiltered<{target}>(filters[{field['filter'] - 1}], {expr});")
+        else:
+            lines.append(f"bakedStore<{target}>({expr});")
+
+    if fold:
+        lines.append(f"uint8_t doors = (uint8_t)(currentDoors & ~0x{door_mask:02X});")
+        for field in doors:
+            word = words[(field["startByte"], field["byteCount"], field["littleEndian"])]
+            lines.append(f"if ({value_expr(field, word)}) doors |= 0x{DOOR_BITS[field['target']]:02X};")
+        lines.append("vehicleDataStore(currentDoors, doors, DIRTY_DOORS);")
+    return lines
+
+
+def generate(profile: dict, source: str) -> str:
+    frames, fields, filters = profile["frames"], profile["fields"], profile["filters"]
+    params = profile["vehicleParams"]
+    params_json = json.dumps(params, separators=(",", ":")) if isinstance(params, dict) else ""
+
+    out = []
+    w = out.append
+    w(f"// Generated by tools/bake_profile.py from {source} - do not edit")
+    w("//")
+    w("// Included by CanConfigProcessor.cpp when PROFILE_BAKED=1, after the")
+    w("// bakedStore() / bakedStoreFiltered() helpers it uses.")
+    w("")
+    w("#ifndef BAKED_PROFILE_H")
+    w("#define BAKED_PROFILE_H")
+    w("")
+    w('#include "VehicleConfig.h"')
+    w('#include "SignalFilter.h"')
+    w("")
+    w(f"#define BAKED_PROFILE_FILE   {c_string(os.path.basename(source))}")
+    w(f"#define BAKED_PROFILE_NAME   {c_string(profile['name'])}")
+    w(f"#define BAKED_FRAME_COUNT    {len(frames)}")
+    w(f"#define BAKED_FIELD_COUNT    {len(fields)}")
+    w(f"#define BAKED_FILTER_COUNT   {len(filters)}")
+    w("")
+    w("static_assert(BAKED_FRAME_COUNT <= PROFILE_MAX_FRAMES && BAKED_FIELD_COUNT <= PROFILE_MAX_FIELDS &&")
+    w("              BAKED_FILTER_COUNT <= PROFILE_MAX_FILTERS, \"baked profile exceeds the profile arena\");")
+    w("")
+    w("// vehicleParams, applied on a vehicle switch like the JSON ones (\"\" = none)")
+    w(f"static const char BAKED_VEHICLE_PARAMS[] = {c_string(params_json)};")
+    w("")
+
+    w("static constexpr FrameConfig BAKED_FRAMES[BAKED_FRAME_COUNT] = {")
+    for f in frames:
+        w(f"    {{ 0x{f['canId']:03X}, {f['firstField']}, {f['fieldCount']} }},")
+    w("};")
+    w("")
+
+    w("static constexpr FieldConfig BAKED_FIELDS[BAKED_FIELD_COUNT] = {")
+    for f in fields:
+        order = "LSB_FIRST" if f["littleEndian"] else "MSB_FIRST"
+        p = ", ".join(str(v) for v in f["params"])
+        w(f"    {{ OutputField::{f['target']}, {f['startByte']}, {f['byteCount']}, ByteOrder::{order}, "
+          f"DataType::{f['dataType']}, FormulaType::{f['formula']}, {f['filter']}, {{ {p} }} }},")
+    w("};")
+    w("")
+
+    w("static constexpr FieldFilterConfig BAKED_FILTERS[BAKED_FILTER_COUNT ? BAKED_FILTER_COUNT : 1] = {")
+    for f in filters or [{"deadband": 0, "minIntervalMs": 0, "median": 0, "emaShift": 0}]:
+        w(f"    {{ {f['deadband']}, {f['minIntervalMs']}, {f['median']}, {f['emaShift']} }},")
+    w("};")
+    w("")
+
+    w("/**")
+    w(" * @brief Decode one frame of the baked profile")
+    w(" * @param d Frame payload (8 bytes)")
+    w(" * @param canId Standard CAN identifier")
+    w(" * @param filters Filter state, indexed like BAKED_FILTERS")
+    w(" * @return false if the ID is not in the profile")
+    w(" */")
+    w("static inline bool bakedDecode(const uint8_t* d, uint32_t canId, SignalFilter* filters) {")
+    w("    (void)filters;")
+    w("    switch (canId) {")
+    seen = set()
+    for frame in frames:
+        # Duplicate IDs keep the first definition, like the dispatch table
+        if frame["canId"] in seen or frame["canId"] >= CAN_DISPATCH_SIZE:
+            continue
+        seen.add(frame["canId"])
+        w(f"        case 0x{frame['canId']:03X}: {{")
+        for line in frame_body(profile, frame):
+            w(f"            {line}")
+        w("            return true;")
+        w("        }")
+    w("        default:")
+    w("            return false;")
+    w("    }")
+    w("}")
+    w("")
+    w("#endif // BAKED_PROFILE_H")
+    w("")
+    return "\n".join(out)
+
+
+def bake(source: str, output: str, label: str = None) -> None:
+    with open(source, "r", encoding="utf-8") as f:
+        doc = json.load(f)
+    text = generate(parse_profile(doc), label or source)
+
+    # Leave the file alone when nothing changed (no needless rebuild)
+    if os.path.exists(output):
+        with open(output, "r", encoding="utf-8") as f:
+            if f.read() == text:
+                return
+    os.makedirs(os.path.dirname(output) or ".", exist_ok=True)
+    with open(output, "w", encoding="utf-8") as f:
+        f.write(text)
+
+
+# ---------------------------------------------------------------------------
+# Entry points
+# ---------------------------------------------------------------------------
+
+def run_platformio(env) -> None:
+    source = env.GetProjectOption("custom_bake_profile", "")
+    if not source:
+        return
+    project_dir = env.subst("$PROJECT_DIR")
+    path = os.path.join(project_dir, source)
+    output = os.path.join(project_dir, "include", HEADER_NAME)
+    try:
+        bake(path, output, source)
+    except (OSError, ValueError, BakeError) as e:
+        sys.stderr.write(f"\n--- [PROFILE BAKER] {source}: {e} ---\n")
+        env.Exit(1)
+    print(f"\n--- [PROFILE BAKER] {source} -> include/{HEADER_NAME} ---\n")
+    env.Append(CPPDEFINES=[("PROFILE_BAKED", 1)])
+
+
+def main(argv) -> int:
+    if len(argv) != 3:
+        sys.stderr.write("usage: bake_profile.py <profile.json> <BakedProfile.h>\n")
+        return 2
+    try:
+        bake(argv[1], argv[2])
+    except (OSError, ValueError, BakeError) as e:
+        sys.stderr.write(f"{argv[1]}: {e}\n")
+        return 1
+    return 0
+
+
+try:
+    Import("env")  # noqa: F821 - SCons builtin when run by PlatformIO
+    run_platformio(env)  # noqa: F821
+except NameError:
+    if __name__ == "__main__":
+        sys.exit(main(sys.argv))
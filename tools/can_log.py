@@ -0,0 +1,236 @@
+"""
+CAN capture tool for ESP32 CANBox: live LOG BIN stream and REC recordings.
+
+Commands:
+    stream   Send LOG BIN, decode packets, print frames and loss counters
+    get      Download a recording file (REC GET) and check its CRC32
+    decode   Print the frames of a downloaded recording file
+
+Prerequisites (stream / get):
+    pip install pyserial
+
+Usage:
+    python tools/can_log.py stream /dev/ttyACM0
+    python tools/can_log.py stream /dev/ttyACM0 --id 180 --mask 7F0 --dec 2 -o drive.log
+    python tools/can_log.py get /dev/ttyACM0 0 rec0.bin
+    python tools/can_log.py decode rec0.bin rec1.bin
+
+Output lines are "<seconds> <id> [<dlc>] <data>", timestamps in device
+micros() (wraps after ~71 minutes).
+
+Formats: include/CanStream.h (LOG BIN), include/CanRecorder.h (REC files).
+"""
+
+import argparse
+import struct
+import sys
+import time
+import zlib
+
+# ---------------------------------------------------------------------------
+# Configuration — must match firmware constants
+# ---------------------------------------------------------------------------
+
+SERIAL_BAUD = 115200
+BIN_MAGIC = b"\xA5\x5A"
+BIN_CAN_LOG = 0x10
+BIN_MAX_PAYLOAD = 4096
+STREAM_HEADER = struct.Struct("<IIH")         # base time, dropped, count
+REC_HEADER = struct.Struct("<IHHIHH")         # magic, version, record size, start, sequence, reserved
+REC_RECORD = struct.Struct("<IHBB8s")         # time, id, dlc, flags, data
+REC_MAGIC = 0x43455243
+REC_FLAG_RTR, REC_FLAG_TRIGGER = 0x01, 0x02
+
+
+def format_frame(ts_us: int, can_id: int, dlc: int, data: bytes, rtr: bool, note: str = "") -> str:
+    body = "R" if rtr else " ".join(f"{b:02X}" for b in data[:dlc])
+    return f"{ts_us / 1e6:12.6f}  {can_id:03X}  [{dlc}]  {body}{note}"
+
+
+# ---------------------------------------------------------------------------
+# LOG BIN stream
+# ---------------------------------------------------------------------------
+
+class StreamDecoder:
+    """Byte-fed decoder for BIN_CAN_LOG packets; text lines in between are kept."""
+
+    def __init__(self) -> None:
+        self.buf = bytearray()
+        self.next_seq: int | None = None
+        self.lost_packets = 0
+        self.bad_crc = 0
+        self.dropped = 0
+        self.frames = 0
+
+    def feed(self, data: bytes):
+        """Yield ("frame", ts, id, dlc, data, rtr) and ("text", line) events."""
+        self.buf += data
+        while True:
+            start = self.buf.find(BIN_MAGIC)
+            text_end = start if start >= 0 else len(self.buf)
+            nl = self.buf.find(b"\n", 0, text_end)
+            if nl >= 0:
+                line = self.buf[:nl].decode(errors="replace").strip()
+                del self.buf[:nl + 1]
+                if line:
+                    yield ("text", line)
+                continue
+            if start < 0:
+                return
+            del self.buf[:start]
+            if len(self.buf) < 7:
+                return
+            ftype, seq, length = struct.unpack_from("<BHH", self.buf, 2)
+            if ftype != BIN_CAN_LOG or length > BIN_MAX_PAYLOAD:
+                del self.buf[:1]
+                continue
+            if len(self.buf) < 11 + length:
+                return
+            frame = bytes(self.buf[:11 + length])
+            del self.buf[:11 + length]
+            (crc,) = struct.unpack_from("<I", frame, 7 + length)
+            if zlib.crc32(frame[2:7 + length]) != crc:
+                self.bad_crc += 1
+                continue
+            yield from self._packet(seq, frame[7:7 + length])
+
+    def _packet(self, seq: int, payload: bytes):
+        if self.next_seq is not None and seq != self.next_seq:
+            self.lost_packets += (seq - self.next_seq) & 0xFFFF
+        self.next_seq = (seq + 1) & 0xFFFF
+
+        ts, dropped, count = STREAM_HEADER.unpack_from(payload)
+        if dropped != self.dropped:
+            yield ("text", f"# device dropped {dropped - self.dropped} frames")
+            self.dropped = dropped
+        pos = STREAM_HEADER.size
+        for _ in range(count):
+            delta, id_dlc = struct.unpack_from("<HH", payload, pos)
+            rtr = bool(id_dlc & 0x8000)
+            dlc = (id_dlc >> 11) & 0x0F
+            n = 0 if rtr else dlc
+            ts = (ts + delta) & 0xFFFFFFFF
+            yield ("frame", ts, id_dlc & 0x7FF, dlc, payload[pos + 4:pos + 4 + n], rtr)
+            pos += 4 + n
+            self.frames += 1
+
+
+def cmd_stream(args) -> None:
+    import serial
+
+    ser = serial.Serial(args.port, SERIAL_BAUD, timeout=0.1)
+    cmd = "LOG BIN"
+    if args.id is not None:
+        cmd += f" ID {args.id} {args.mask}"
+    if args.dec > 1:
+        cmd += f" DEC {args.dec}"
+    ser.write(f"{cmd}\n".encode())
+
+    out = open(args.output, "w") if args.output else None
+    dec = StreamDecoder()
+    start = time.time()
+    try:
+        while not args.seconds or time.time() - start < args.seconds:
+            for ev in dec.feed(ser.read(4096)):
+                line = format_frame(*ev[1:]) if ev[0] == "frame" else ev[1]
+                if out:
+                    out.write(line + "\n")
+                if not args.quiet or ev[0] == "text":
+                    print(line)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        ser.write(b"LOG OFF\n")
+        ser.close()
+        if out:
+            out.close()
+
+    elapsed = max(time.time() - start, 1e-3)
+    print(f"# {dec.frames} frames in {elapsed:.1f} s ({dec.frames / elapsed:.0f}/s), "
+          f"device dropped {dec.dropped}, lost packets {dec.lost_packets}, bad CRC {dec.bad_crc}",
+          file=sys.stderr)
+
+
+# ---------------------------------------------------------------------------
+# REC files
+# ---------------------------------------------------------------------------
+
+def cmd_get(args) -> None:
+    import serial
+
+    ser = serial.Serial(args.port, SERIAL_BAUD, timeout=5)
+    ser.reset_input_buffer()
+    ser.write(f"REC GET {args.file}\n".encode())
+    while True:
+        line = ser.readline().decode(errors="replace").strip()
+        if not line:
+            sys.exit("ERROR: no answer")
+        if line.startswith("ERROR"):
+            sys.exit(line)
+        if line.startswith("REC DATA"):
+            break
+    _, _, path, size, crc = line.split()
+    size, crc = int(size), int(crc, 16)
+    data = ser.read(size)
+    ser.close()
+
+    if len(data) != size:
+        sys.exit(f"ERROR: got {len(data)} of {size} bytes")
+    if zlib.crc32(data) != crc:
+        sys.exit("ERROR: CRC32 mismatch")
+    with open(args.output, "wb") as f:
+        f.write(data)
+    print(f"{path}: {size} bytes -> {args.output} ({(size - REC_HEADER.size) // REC_RECORD.size} frames)")
+
+
+def read_recording(path: str):
+    with open(path, "rb") as f:
+        data = f.read()
+    magic, version, rec_size, start_ms, seq, _ = REC_HEADER.unpack_from(data)
+    if magic != REC_MAGIC or version != 1 or rec_size != REC_RECORD.size:
+        sys.exit(f"ERROR: {path} is not a recording file")
+    records = [REC_RECORD.unpack_from(data, off)
+               for off in range(REC_HEADER.size, len(data) - rec_size + 1, rec_size)]
+    return seq, start_ms, records
+
+
+def cmd_decode(args) -> None:
+    # Rotation: the file with the lower sequence number is older
+    files = sorted((read_recording(p) + (p,) for p in args.files), key=lambda r: r[0])
+    for seq, start_ms, records, path in files:
+        print(f"# {path}: sequence {seq}, recording started at {start_ms} ms, {len(records)} frames")
+        for ts, can_id, dlc, flags, data in records:
+            note = "  # trigger" if flags & REC_FLAG_TRIGGER else ""
+            print(format_frame(ts, can_id, dlc, data, bool(flags & REC_FLAG_RTR), note))
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser(description="ESP32 CANBox CAN capture tool.")
+    sub = parser.add_subparsers(dest="command", required=True)
+
+    p = sub.add_parser("stream", help="Live capture with LOG BIN")
+    p.add_argument("port", help="Serial port, e.g. /dev/ttyACM0 or COM3")
+    p.add_argument("--id", help="Only this ID (hex)")
+    p.add_argument("--mask", default="7FF", help="ID mask (hex, default 7FF)")
+    p.add_argument("--dec", type=int, default=1, help="Keep 1 frame in N of each ID")
+    p.add_argument("--seconds", type=float, default=0, help="Stop after this long (default: Ctrl+C)")
+    p.add_argument("-o", "--output", help="Also write frames to this file")
+    p.add_argument("-q", "--quiet", action="store_true", help="Do not print frames")
+    p.set_defaults(fn=cmd_stream)
+
+    p = sub.add_parser("get", help="Download a REC file")
+    p.add_argument("port", help="Serial port")
+    p.add_argument("file", choices=["0", "1"], help="Recording file index")
+    p.add_argument("output", help="Local file name")
+    p.set_defaults(fn=cmd_get)
+
+    p = sub.add_parser("decode", help="Print frames from REC files")
+    p.add_argument("files", nargs="+", help="Downloaded rec0.bin / rec1.bin")
+    p.set_defaults(fn=cmd_decode)
+
+    args = parser.parse_args()
+    args.fn(args)
+
+
+if __name__ == "__main__":
+    main()
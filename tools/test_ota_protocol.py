@@ -18,6 +18,7 @@ The test requires the ESP32 to be connected and running the v2 firmware.
 import argparse
 import base64
 import hashlib
+import struct
 import sys
 import time
 import zlib
@@ -34,6 +35,8 @@ OTA_TIMEOUT_S = 60        # matches OTA_DATA_TIMEOUT_MS in SerialCommand.cpp
 SERIAL_BAUD = 115200
 SERIAL_READLINE_TIMEOUT = 0.1  # seconds per readline poll
 CMD_TIMEOUT_S = 5.0       # default timeout for a command/response exchange
+BIN_CHUNK_SIZE = 256      # payload per binary DATA frame in these tests (max BIN_MAX_PAYLOAD)
+BIN_DATA, BIN_END, BIN_ABORT = 0x01, 0x02, 0x03
 
 
 # ---------------------------------------------------------------------------
@@ -111,6 +114,37 @@ def send_chunk(ser: serial.Serial, chunk: bytes, with_crc: bool = True) -> list[
     return send_cmd(ser, f"OTA DATA {b64}")
 
 
+def crc32_fw(data: bytes) -> int:
+    """Firmware crc32_le(0, data): init 0, no final XOR."""
+    return zlib.crc32(data, 0xFFFFFFFF) ^ 0xFFFFFFFF
+
+
+def bin_frame(ftype: int, seq: int, payload: bytes = b"") -> bytes:
+    """Binary transfer frame: A5 5A type seq(LE16) len(LE16) payload crc32(LE32)."""
+    body = struct.pack("<BHH", ftype, seq, len(payload)) + payload
+    return b"\xA5\x5A" + body + struct.pack("<I", crc32_fw(body))
+
+
+def read_line_starting(ser: serial.Serial, prefixes: tuple[str, ...],
+                       timeout_s: float = CMD_TIMEOUT_S) -> str | None:
+    """Return the first line starting with one of prefixes, or None on timeout."""
+    deadline = time.time() + timeout_s
+    while time.time() < deadline:
+        line = ser.readline().decode(errors="replace").strip()
+        if line.startswith(prefixes):
+            return line
+    return None
+
+
+def start_ota_bin(ser: serial.Serial, payload: bytes) -> tuple[int, int]:
+    """OTA START ... BIN; returns (max_payload, window) from OK READY BIN."""
+    lines = send_cmd(ser, f"OTA START {len(payload)} {md5_hex(payload)} BIN")
+    tl = assert_ok(lines, "start_ota_bin")
+    parts = tl.split()
+    assert parts[:3] == ["OK", "READY", "BIN"], f"Expected OK READY BIN, got: {tl!r}"
+    return int(parts[3]), int(parts[4])
+
+
 def corrupt_crc(chunk: bytes) -> str:
     """Return a wrong CRC32 for the given chunk."""
     correct = zlib.crc32(chunk) & 0xFFFFFFFF
@@ -338,6 +372,66 @@ def test_timeout_auto_abort(ser: serial.Serial) -> None:
         f"Expected auto-abort after {OTA_TIMEOUT_S}s, STATUS still shows: {lines}"
 
 
+def test_bin_start_ready(ser: serial.Serial) -> None:
+    """OTA START ... BIN must answer OK READY BIN <max_payload> <window>."""
+    preflight_abort(ser)
+    max_payload, window = start_ota_bin(ser, DUMMY_PAYLOAD)
+    assert max_payload >= BIN_CHUNK_SIZE, f"max payload too small: {max_payload}"
+    assert window >= 1, f"window must be >= 1: {window}"
+    ser.write(bin_frame(BIN_ABORT, 0))
+    drain(ser, 0.5)
+
+
+def test_bin_pipelined_window(ser: serial.Serial) -> None:
+    """Frames sent a full window ahead must all be acknowledged in order."""
+    preflight_abort(ser)
+    _, window = start_ota_bin(ser, DUMMY_PAYLOAD)
+    chunks = [DUMMY_PAYLOAD[i:i + BIN_CHUNK_SIZE]
+              for i in range(0, len(DUMMY_PAYLOAD), BIN_CHUNK_SIZE)]
+
+    acked = -1
+    next_seq = 0
+    while acked < len(chunks) - 1:
+        while next_seq < len(chunks) and next_seq - acked <= window:
+            ser.write(bin_frame(BIN_DATA, next_seq, chunks[next_seq]))
+            next_seq += 1
+        line = read_line_starting(ser, ("ACK", "NAK", "ERROR"))
+        assert line is not None and line.startswith("ACK"), f"Expected ACK, got: {line!r}"
+        acked = int(line.split()[1])
+
+    assert line.endswith(f"{len(DUMMY_PAYLOAD)}/{len(DUMMY_PAYLOAD)}"), f"Bad progress: {line!r}"
+    ser.write(bin_frame(BIN_ABORT, next_seq))
+    drain(ser, 0.5)
+
+
+def test_bin_bad_crc_nak(ser: serial.Serial) -> None:
+    """A corrupted frame must be answered NAK <expected_seq>, nothing written."""
+    preflight_abort(ser)
+    start_ota_bin(ser, DUMMY_PAYLOAD)
+    frame = bytearray(bin_frame(BIN_DATA, 0, DUMMY_PAYLOAD[:BIN_CHUNK_SIZE]))
+    frame[10] ^= 0xFF
+    ser.write(bytes(frame))
+    line = read_line_starting(ser, ("ACK", "NAK", "ERROR"))
+    assert line == "NAK 0", f"Expected NAK 0, got: {line!r}"
+
+    # Retransmission is accepted
+    ser.write(bin_frame(BIN_DATA, 0, DUMMY_PAYLOAD[:BIN_CHUNK_SIZE]))
+    line = read_line_starting(ser, ("ACK", "NAK", "ERROR"))
+    assert line is not None and line.startswith("ACK 0"), f"Expected ACK 0, got: {line!r}"
+    ser.write(bin_frame(BIN_ABORT, 1))
+    drain(ser, 0.5)
+
+
+def test_bin_abort_returns_to_text(ser: serial.Serial) -> None:
+    """An ABORT frame must leave binary mode: text commands work again."""
+    preflight_abort(ser)
+    start_ota_bin(ser, DUMMY_PAYLOAD)
+    ser.write(bin_frame(BIN_ABORT, 0))
+    drain(ser, 0.5)
+    lines = send_cmd(ser, "OTA STATUS")
+    assert any("NO" in l for l in lines), f"OTA should be inactive after ABORT frame: {lines}"
+
+
 # ---------------------------------------------------------------------------
 # Main
 # ---------------------------------------------------------------------------
@@ -356,6 +450,10 @@ ALL_TESTS = [
     ("abort_mid_transfer",                       test_abort_mid_transfer),
     ("status_idle",                              test_status_idle),
     ("status_in_progress",                       test_status_in_progress),
+    ("bin_start_ready",                          test_bin_start_ready),
+    ("bin_pipelined_window",                     test_bin_pipelined_window),
+    ("bin_bad_crc_nak",                          test_bin_bad_crc_nak),
+    ("bin_abort_returns_to_text",                test_bin_abort_returns_to_text),
 ]
 
 SLOW_TESTS = [